@@ -33,6 +33,7 @@ extern "C"
 {
 #endif	/* __cplusplus */
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <net/ethernet.h> /* for ETHER_ADDR_LEN */
@@ -218,6 +219,24 @@ struct acm_config;
 int64_t __must_check acm_read_status_item(enum acm_module_id module_id,
         enum acm_status_item status_id);
 
+/**
+ * @ingroup acmstatusarea
+ * @brief Read all status items of one or both modules at once
+ *
+ * The function reads all status items of the selected modules with a single access to each
+ * item and stores them in a caller-provided structure. The error items are only read if
+ * ACM_STATUS_SELECT_ERRORS is selected. The status is stamped with the time reading started
+ * and the time it took, so callers can judge how consistent the values are. The files of the
+ * status items stay open after the first call, which makes the function suitable for polling
+ * the status with a high frequency.
+ *
+ * @param select combination of enum acm_status_select, at least one module has to be selected
+ * @param status address where the status items are stored
+ *
+ * @return 0 on success. Negative values represent an error.
+ */
+int __must_check acm_read_status(uint32_t select, struct acm_status *status);
+
 /**
  * @ingroup acmstatusarea
  * @brief Read ACM configuration id
@@ -226,6 +245,46 @@ int64_t __must_check acm_read_status_item(enum acm_module_id module_id,
  */
 int64_t __must_check acm_read_config_identifier();
 
+/**
+ * @ingroup acmstatusarea
+ * @brief Wait until the last applied schedule is active
+ *
+ * The driver detects when the scheduler of a module switches to the schedule table started
+ * last, e.g. by acm_apply_schedule(), and publishes the switch as pollable event. The
+ * function blocks until this event is available. If the switch has already been detected,
+ * the function returns immediately.
+ *
+ * @param module_id identifier of the module to wait for
+ * @param timeout_ms maximum time to wait in milliseconds. A negative value waits without
+ *          limit.
+ * @param event address where the switch event is stored, may be NULL
+ *
+ * @return 0 if the schedule is active, -ETIMEDOUT if either the timeout expired or the driver
+ * did not see the table becoming active. Other negative values represent an error.
+ */
+int __must_check acm_wait_schedule_active(enum acm_module_id module_id, int timeout_ms,
+        struct acm_schedule_event *event);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Asynchronously wait until the last applied schedule is active
+ *
+ * The function starts a detached thread which executes acm_wait_schedule_active() and
+ * calls the callback function with its result afterwards. The callback is executed in
+ * context of that thread.
+ *
+ * @param module_id identifier of the module to wait for
+ * @param timeout_ms maximum time to wait in milliseconds. A negative value waits without
+ *          limit.
+ * @param cb callback function called when the wait finished
+ * @param arg argument passed to the callback function
+ *
+ * @return 0 if the wait has been started. Negative values represent an error, in this case
+ * the callback is not called.
+ */
+int __must_check acm_wait_schedule_active_async(enum acm_module_id module_id, int timeout_ms,
+        acm_schedule_event_cb cb, void *arg);
+
 /**
  * @ingroup acmdiagarea
  * @brief Read a diagnostic data of a specific module
@@ -253,6 +312,146 @@ struct acm_diagnostic* __must_check acm_read_diagnostics(enum acm_module_id modu
  */
 int __must_check acm_set_diagnostics_poll_time(enum acm_module_id module_id, uint16_t interval_ms);
 
+/**
+ * @ingroup acmdiagarea
+ * @brief Read the FRER statistics
+ *
+ * The driver derives per redundancy table entry counters (frames passed, recoveries,
+ * duplicates, errors, out-of-order sequence numbers, resets and receive timeouts) and
+ * rates from the redundancy status table, sampled with each recovery tick.
+ *
+ * @param stats returns the statistics
+ *
+ * @return 0 will be returned in case of success. Negative values represent an error.
+ */
+int __must_check acm_read_redundancy_stats(struct acm_redundancy_stats *stats);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Reset the FRER statistics
+ *
+ * @return 0 will be returned in case of success. Negative values represent an error.
+ */
+int __must_check acm_reset_redundancy_stats(void);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Read the diagnostic counter thresholds of a module
+ *
+ * @param module_id identifier of the module
+ * @param thresholds returns the thresholds
+ *
+ * @return 0 will be returned in case of success. Negative values represent an error.
+ */
+int __must_check acm_read_diag_thresholds(enum acm_module_id module_id,
+        struct acm_diag_thresholds *thresholds);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Write the diagnostic counter thresholds of a module
+ *
+ * The driver evaluates the ingress window closed, no frame received, recovery and additional
+ * filter mismatch counters of each stream-id against their thresholds with each diagnostic
+ * update. A breach is signaled through acm_wait_diag_alarm(), so applications do not need to
+ * poll the diagnostic data. All thresholds are disabled by default.
+ *
+ * @param module_id identifier of the module
+ * @param thresholds thresholds to be applied
+ *
+ * @return 0 will be returned in case of success. Negative values represent an error.
+ */
+int __must_check acm_write_diag_thresholds(enum acm_module_id module_id,
+        const struct acm_diag_thresholds *thresholds);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Read the diagnostic threshold breaches of a module
+ *
+ * Reading clears the breached stream-id bitmasks.
+ *
+ * @param module_id identifier of the module
+ * @param alarm returns the breaches
+ *
+ * @return 0 will be returned in case of success. Negative values represent an error.
+ */
+int __must_check acm_read_diag_alarm(enum acm_module_id module_id,
+        struct acm_diag_alarm *alarm);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Wait for a diagnostic threshold breach of a module
+ *
+ * The function returns as soon as a breach is pending, i.e. within one diagnostic poll
+ * interval after the respective counter exceeded its threshold. The breached stream-id
+ * bitmasks are cleared.
+ *
+ * @param module_id identifier of the module to wait for
+ * @param timeout_ms maximum time to wait in milliseconds, negative values wait without limit
+ * @param alarm address where the breaches are stored, may be NULL
+ *
+ * @return 0 if a breach is pending, -ETIMEDOUT if not. Other negative values represent an
+ * error.
+ */
+int __must_check acm_wait_diag_alarm(enum acm_module_id module_id, int timeout_ms,
+        struct acm_diag_alarm *alarm);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Read the failover policy of a module
+ *
+ * @param module_id identifier of the module
+ * @param policy returns the policy
+ *
+ * @return 0 will be returned in case of success. Negative values represent an error.
+ */
+int __must_check acm_read_failover_policy(enum acm_module_id module_id,
+        struct acm_failover_policy *policy);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Write the failover policy of a module
+ *
+ * The driver performs the actions of the policy synchronously when it is notified of a link
+ * change of the module's port, i.e. without a round trip to the application. All actions are
+ * disabled by default. Actions of link down are undone on link up only if the link up policy
+ * contains the respective action.
+ *
+ * @param module_id identifier of the module
+ * @param policy policy to be applied
+ *
+ * @return 0 will be returned in case of success. Negative values represent an error.
+ */
+int __must_check acm_write_failover_policy(enum acm_module_id module_id,
+        const struct acm_failover_policy *policy);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Read the last link event of a module
+ *
+ * @param module_id identifier of the module
+ * @param event returns the link event
+ *
+ * @return 0 will be returned in case of success. Negative values represent an error.
+ */
+int __must_check acm_read_link_event(enum acm_module_id module_id,
+        struct acm_link_event *event);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Wait for the next link event of a module
+ *
+ * Only link changes whose policy contains ACM_FAILOVER_NOTIFY are reported.
+ *
+ * @param module_id identifier of the module to wait for
+ * @param timeout_ms maximum time to wait in milliseconds, negative values wait without limit
+ * @param event address where the link event is stored, may be NULL
+ *
+ * @return 0 if a link event has been reported, -ETIMEDOUT if not. Other negative values
+ * represent an error.
+ */
+int __must_check acm_wait_link_event(enum acm_module_id module_id, int timeout_ms,
+        struct acm_link_event *event);
+
 /**
  * @ingroup acmcapability
  * @brief Read capabilities of the device
@@ -677,6 +876,26 @@ void acm_destroy_module(struct acm_module *module);
 int __must_check acm_set_module_schedule(struct acm_module *module,
 		uint32_t cycle_ns, struct timespec start);
 
+/**
+ * @ingroup acmschedule
+ * @brief Set the sub-nanoseconds of a module's schedule cycle
+ *
+ * The schedule cycle of the module lasts cycle_ns + cycle_subns / 2^24
+ * nano-seconds, e.g. to follow a PTP grandmaster running with a
+ * frequency offset. A start time the driver has to advance by whole cycles
+ * keeps the phase including the sub-nanoseconds, see struct
+ * acm_schedule_event.
+ *
+ * @param module module where to set the sub-nanoseconds
+ * @param cycle_subns sub-nanoseconds of the cycle in units of 2^-24 ns,
+ *          lower than ACM_CYCLE_SUBNS_MAX
+ *
+ * @return the function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check acm_set_module_cycle_subns(struct acm_module *module,
+		uint32_t cycle_subns);
+
 /**
  * @ingroup acmmodule
  * @brief Add a stream to a module
@@ -756,6 +975,25 @@ int __must_check acm_validate_module(struct acm_module *module);
 */
 int __must_check acm_validate_config(struct acm_config *config);
 
+/**
+ * @ingroup acmvalidate
+ * @brief Calculate the hardware resource usage of a module
+ *
+ * Reports how many lookup rules, DMA command slots, constant buffer bytes and redundancy table
+ * entries the streams of the module occupy. Equal constant data of several insert constant
+ * operations occupies the constant buffer once only. Ingress triggered streams whose lookup
+ * and filter equal the ones of another stream of the module are reported as conflicts, as
+ * they cannot share a lookup rule.
+ *
+ * @param module module to be examined
+ * @param usage returns the resource usage
+ *
+ * @return the function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check acm_get_module_usage(struct acm_module *module,
+        struct acm_module_usage *usage);
+
 /**
  * @ingroup acmconfig
  * @brief Apply a complete configuration
@@ -771,6 +1009,29 @@ int __must_check acm_validate_config(struct acm_config *config);
 int __must_check acm_apply_config(struct acm_config *config,
 		uint32_t identifier);
 
+/**
+ * @ingroup acmconfig
+ * @brief Apply the configuration of a single module
+ *
+ * Only the module module_id of the device is reprogrammed, the other module keeps forwarding.
+ * The configuration of the other module must be unchanged compared to the configuration
+ * identified by identifier_expected, which is actually applied to the device.
+ * Configurations with redundant streams and configurations in which the message buffers of
+ * the other module would change can only be applied by acm_apply_config().
+ *
+ * @param config ACM configuration containing the module to be applied to the device
+ * @param module_id identity of the module to be reprogrammed
+ * @param identifier configuration id for verification in case of schedule change
+ * @param identifier_expected expected configuration id of the device.
+ *
+ * @return the function will return 0 in case of success, -EBUSY if the module cannot be
+ * reprogrammed alone. Other negative values represent an error.
+*/
+int __must_check acm_apply_module_config(struct acm_config *config,
+		enum acm_module_id module_id,
+		uint32_t identifier,
+		uint32_t identifier_expected);
+
 /**
  * @ingroup acmschedule
  * @brief Apply a new schedule
@@ -787,6 +1048,54 @@ int __must_check acm_apply_config(struct acm_config *config,
 int __must_check acm_apply_schedule(struct acm_config *config,
 		uint32_t identifier, uint32_t identifier_expected);
 
+/**
+ * @ingroup acmconfig
+ * @brief Compile a configuration to a binary image
+ *
+ * The configuration is validated and compiled to the final hardware tables, which are stored in
+ * a versioned and checksummed image. The device is not changed. Applying the image with
+ * acm_apply_config_image() has the same effect as acm_apply_config() with the same identifier,
+ * but does not need to rebuild or recalculate the configuration. Images can be stored and compared
+ * byte by byte.
+ *
+ * @param config ACM configuration to be compiled
+ * @param identifier configuration id for verification in case of schedule change
+ * @param image address where the pointer to the image is stored. The image has to be released
+ *          with free().
+ * @param size address where the size of the image in bytes is stored
+ *
+ * @return the function will return 0 in case of success. Negative values represent
+ * an error.
+*/
+int __must_check acm_create_config_image(struct acm_config *config,
+		uint32_t identifier, void **image, size_t *size);
+
+/**
+ * @ingroup acmconfig
+ * @brief Apply a binary configuration image
+ *
+ * The old configuration of the device will be replaced by the configuration of the image created
+ * by acm_create_config_image(). The schedules of the image are written to a free schedule table.
+ *
+ * @param image configuration image
+ * @param size size of the image in bytes
+ *
+ * @return the function will return 0 in case of success, -EACMIMAGE if the image is invalid or
+ * corrupted. Other negative values represent an error.
+*/
+int __must_check acm_apply_config_image(const void *image, size_t size);
+
+/**
+ * @ingroup acmconfig
+ * @brief Read the configuration id of a binary configuration image
+ *
+ * @param image configuration image
+ * @param size size of the image in bytes
+ *
+ * @return configuration id of the image, -EACMIMAGE if the image is invalid or corrupted.
+*/
+int64_t __must_check acm_read_config_image_identifier(const void *image, size_t size);
+
 /**
  * @ingroup acmconfig
  * @brief Disable a configuration
@@ -142,6 +142,10 @@ extern "C"
  * @brief ACM local error - too many insert operations in stream
  */
 #define EACMNUMINSERT   164
+/**
+ * @brief ACM local error - invalid or corrupted configuration image
+ */
+#define EACMIMAGE       165
 
 /**
  * @brief MUST_CHECK
@@ -161,6 +165,16 @@ extern "C"
  */
 #define ACM_MODULES_COUNT	2U
 
+/**
+ * @brief upper limit (exclusive) of cycle time sub-nanoseconds (2^24)
+ */
+#define ACM_CYCLE_SUBNS_MAX	0x1000000U
+
+/**
+ * @brief Number of entries of the redundancy tables
+ */
+#define ACM_REDUNDANCY_ENTRY_COUNT	32U
+
 /**
  * @brief maximum filter data size in bytes
  */
@@ -320,6 +334,35 @@ enum acm_status_item {
     STATUS_ITEM_NUM, /**< not a status item, just for checking range */
 };
 
+/**
+ * @ingroup acmstatusarea
+ * @brief Selection of status items read at once
+ *
+ * The values can be combined to select the modules and the items to be read by
+ * acm_read_status().
+ */
+enum acm_status_select {
+    ACM_STATUS_SELECT_MODULE_0 = 1 << MODULE_0, /**< read the status items of module 0 */
+    ACM_STATUS_SELECT_MODULE_1 = 1 << MODULE_1, /**< read the status items of module 1 */
+    ACM_STATUS_SELECT_ERRORS = 1 << 8, /**< also read the error items STATUS_HALT_ERROR_OCCURED,
+     STATUS_IP_ERROR_FLAGS and STATUS_POLICING_ERROR_FLAGS */
+};
+
+/**
+ * @ingroup acmstatusarea
+ * @brief ACM status structure
+ *
+ * struct acm_status contains the status items of all modules read at once.
+ */
+struct acm_status {
+    struct timespec timestamp; /**< CLOCK_MONOTONIC time when reading the status items started */
+    uint32_t duration_ns; /**< Time needed to read all selected status items. All values were
+     read within this window after timestamp. */
+    uint32_t select; /**< Combination of enum acm_status_select the status was read with */
+    int64_t item[ACM_MODULES_COUNT][STATUS_ITEM_NUM]; /**< Values of the status items per module,
+     -ENODATA for items which were not selected */
+};
+
 /**
  * @ingroup acmdiagarea
  * @brief ACM diagnostic structure
@@ -354,6 +397,188 @@ struct acm_diagnostic {
      The counter will increase with each frame producing the mismatch of the additional filter information. */
 };
 
+/**
+ * @ingroup acmdiagarea
+ * @brief FRER statistics of a single redundancy table entry
+ *
+ * The driver samples the redundancy status table with each recovery tick. Recoveries,
+ * duplicates and errors are counted at most once per sample and thus are lower bounds.
+ */
+struct acm_redundancy_entry_stats {
+    uint64_t passed; /**< Advance of the sequence number, i.e. frames passed by the recovery */
+    uint32_t recoveries; /**< Samples with a replica received */
+    uint32_t duplicates; /**< Replicas discarded because the other replica was received first */
+    uint32_t errors; /**< Replicas discarded due to receive errors */
+    uint32_t out_of_order; /**< Sequence number moved backwards, e.g. after a receive timeout */
+    uint32_t resets; /**< Sequence number entry written by software */
+    uint32_t timeouts; /**< Base recovery receive timeouts */
+    uint32_t passed_rate; /**< Frames passed per second */
+    uint32_t duplicate_rate; /**< Duplicates per second */
+};
+
+/**
+ * @ingroup acmdiagarea
+ * @brief FRER statistics of the ACM
+ *
+ * struct acm_redundancy_stats contains the statistics of all redundancy table entries and
+ * the receive timeouts of the individual recovery.
+ */
+struct acm_redundancy_stats {
+    struct timespec timestamp; /**< PTP time of the last sample */
+    uint32_t samples; /**< Number of samples taken since the last reset */
+    uint32_t individual_timeouts[ACM_MODULES_COUNT][ACM_MAX_LOOKUP_SIZE]; /**< Individual
+     recovery receive timeouts per module and stream-id */
+    struct acm_redundancy_entry_stats entry[ACM_REDUNDANCY_ENTRY_COUNT]; /**< Statistics per
+     redundancy table entry */
+};
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Diagnostic counters supervised by thresholds
+ */
+enum acm_diag_counter {
+    ACM_DIAG_INGRESS_WINDOW_CLOSED, /**< acm_diagnostic::ingressWindowClosedCounter */
+    ACM_DIAG_NO_FRAME_RECEIVED, /**< acm_diagnostic::noFrameReceivedCounter */
+    ACM_DIAG_RECOVERY, /**< acm_diagnostic::recoveryCounter */
+    ACM_DIAG_ADDITIONAL_FILTER_MISMATCH, /**< acm_diagnostic::additionalFilterMismatchCounter */
+    ACM_DIAG_COUNTER_COUNT /**< Number of supervised counters */
+};
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Threshold of a diagnostic counter of a stream-id
+ *
+ * The driver evaluates the counters with each diagnostic update (see
+ * acm_set_diagnostics_poll_time()). A breach is raised if a counter increased by at least
+ * limit since the previous evaluation.
+ */
+struct acm_diag_threshold {
+    uint32_t limit; /**< Counter increase raising a breach, 0 disables the threshold */
+    uint32_t holdoff_ms; /**< Minimum time between two breaches in milliseconds */
+};
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Thresholds of the diagnostic counters of a module
+ */
+struct acm_diag_thresholds {
+    struct acm_diag_threshold rule[ACM_DIAG_COUNTER_COUNT][ACM_MAX_LOOKUP_SIZE]; /**<
+     Thresholds per counter and stream-id */
+};
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Threshold breaches of the diagnostic counters of a module
+ */
+struct acm_diag_alarm {
+    struct timespec timestamp; /**< Timestamp of the diagnostic data of the last breach */
+    uint32_t sequence; /**< Number of breach notifications so far */
+    uint32_t suppressed; /**< Number of breaches suppressed by holdoff */
+    uint32_t rules[ACM_DIAG_COUNTER_COUNT]; /**< Bitmask of the stream-ids per counter with a
+     breach since the last read */
+    uint32_t delta[ACM_DIAG_COUNTER_COUNT][ACM_MAX_LOOKUP_SIZE]; /**< Counter increase of the
+     last breach per counter and stream-id */
+};
+
+/**
+ * @ingroup acmstatusarea
+ * @brief ACM schedule switch event
+ *
+ * struct acm_schedule_event describes the last switch of a module's scheduler to a newly
+ * applied schedule table.
+ */
+struct acm_schedule_event {
+    uint32_t sequence; /**< Number of switches detected by the driver so far */
+    uint16_t table; /**< Index of the hardware schedule table which was started */
+    bool active; /**< Table is reported in use by the hardware */
+    bool last_cycle_reached; /**< Last cycle of the table has been reached */
+    struct timespec start; /**< Achieved start time of the table (PTP time) */
+    struct timespec detected; /**< PTP time when the switch had been detected */
+    struct timespec requested; /**< Requested start time of the table (PTP time) */
+    uint32_t start_subns; /**< Sub-nanoseconds of start in units of 2^-24 ns */
+    int64_t slip_ns; /**< Difference of achieved and requested start time in ns */
+};
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Callback function for acm_wait_schedule_active_async()
+ *
+ * @param module_id identifier of the module the event belongs to
+ * @param result 0 if the schedule became active, negative error code otherwise
+ * @param event the switch event, valid if result is 0 or -ETIMEDOUT
+ * @param arg argument passed to acm_wait_schedule_active_async()
+ */
+typedef void (*acm_schedule_event_cb)(enum acm_module_id module_id, int result,
+        const struct acm_schedule_event *event, void *arg);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Failover actions on link changes of a module's port
+ * @{
+ */
+#define ACM_FAILOVER_SCHEDULER	(1U << 0) /**< Emergency disable the module's scheduler on link
+ down, release it on link up */
+#define ACM_FAILOVER_RECOVERY	(1U << 1) /**< Reset the sequence recovery of the module's
+ streams, the next frame is accepted */
+#define ACM_FAILOVER_MSGBUF	(1U << 2) /**< Mark the module's message buffers invalid on
+ link down, valid again on link up */
+#define ACM_FAILOVER_NOTIFY	(1U << 3) /**< Report the link event, see acm_wait_link_event() */
+/** @} */
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Failover policy of a module
+ *
+ * Both members are bitmasks of ACM_FAILOVER_* actions performed by the driver as soon as the
+ * link of the module's port goes down or up respectively.
+ */
+struct acm_failover_policy {
+    uint32_t link_down; /**< Actions on link down */
+    uint32_t link_up; /**< Actions on link up */
+};
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Link event of a module reported by the failover
+ */
+struct acm_link_event {
+    uint32_t sequence; /**< Number of link events reported so far */
+    bool link_up; /**< New link state */
+    uint32_t actions; /**< Bitmask of the ACM_FAILOVER_* actions performed */
+    uint32_t msgbuf_invalid; /**< Bitmask of the message buffers marked invalid */
+    uint32_t duration_ns; /**< Time the driver spent performing the actions */
+    struct timespec timestamp; /**< PTP time of the link event */
+};
+
+/**
+ * @ingroup acmvalidate
+ * @brief Usage of a hardware resource of a module
+ */
+struct acm_resource_usage {
+    uint32_t used; /**< Number of items used, including items reserved by the library */
+    uint32_t capacity; /**< Number of items available */
+};
+
+/**
+ * @ingroup acmvalidate
+ * @brief Hardware resource usage of a module configuration
+ *
+ * The usage is calculated from the streams added to the module the same way the configuration
+ * is written to the hardware, thus it allows to judge how many further streams fit on the
+ * module before the configuration is applied.
+ */
+struct acm_module_usage {
+    struct acm_resource_usage lookup_rules; /**< Lookup rules for ingress triggered streams */
+    struct acm_resource_usage scatter_dma; /**< Scatter DMA commands (ingress operations) */
+    struct acm_resource_usage gather_dma; /**< Gather/prefetch DMA commands (egress
+     operations) */
+    struct acm_resource_usage const_buffer; /**< Bytes of the constant buffer */
+    struct acm_resource_usage redundancy; /**< Redundancy table entries */
+    uint32_t const_buffer_shared; /**< Bytes of constant data shared between operations */
+    uint32_t lookup_conflicts; /**< Ingress triggered streams with the same lookup and filter as
+     a stream added before; the hardware cannot tell their frames apart */
+};
+
 /**
  * @ingroup acmcapability
  * @brief ACM capability items
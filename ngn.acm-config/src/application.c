@@ -27,6 +27,9 @@
 #include "tracing.h"
 #include "hwconfig_def.h"
 #include "sysfs.h"
+#include "stream.h"
+#include "operation.h"
+#include "module.h"
 
 int __must_check apply_configuration(struct acm_config *config, uint32_t identifier) {
     int ret, i;
@@ -116,6 +119,140 @@ int __must_check apply_schedule(struct acm_config *config) {
     return 0;
 }
 
+/**
+ * @brief bit mask of the hardware message buffers used by a module
+ */
+static uint32_t module_msg_buff_mask(struct acm_module *module) {
+    struct acm_stream *stream;
+    struct operation *operation;
+    uint32_t mask = 0;
+
+    if (!module)
+        return 0;
+
+    ACMLIST_LOCK(&module->streams);
+    ACMLIST_FOREACH(stream, &module->streams, entry)
+    {
+        ACMLIST_LOCK(&stream->operations);
+        ACMLIST_FOREACH(operation, &stream->operations, entry)
+        {
+            if (operation->msg_buf)
+                mask |= 1U << operation->msg_buf->msg_buff_index;
+        }
+        ACMLIST_UNLOCK(&stream->operations);
+    }
+    ACMLIST_UNLOCK(&module->streams);
+
+    return mask;
+}
+
+/**
+ * @brief check if a module contains redundant streams
+ */
+static bool module_has_redundant_streams(struct acm_module *module) {
+    struct acm_stream *stream;
+    bool redundant = false;
+
+    if (!module)
+        return false;
+
+    ACMLIST_LOCK(&module->streams);
+    ACMLIST_FOREACH(stream, &module->streams, entry)
+    {
+        if ((stream->type == REDUNDANT_STREAM_TX) || (stream->type == REDUNDANT_STREAM_RX))
+            redundant = true;
+    }
+    ACMLIST_UNLOCK(&module->streams);
+
+    return redundant;
+}
+
+int __must_check apply_module_configuration(struct acm_config *config,
+        enum acm_module_id module_id,
+        uint32_t identifier) {
+    struct acm_module *module;
+    uint32_t module_buffs = 0, other_buffs = 0;
+    int ret, i;
+
+    TRACE2_ENTER();
+    module = config->bypass[module_id];
+    if (!module) {
+        LOGERR("Config: module %d not part of configuration", module_id);
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+    /* redundancy tables are shared among the modules */
+    for (i = 0; i < ACM_MODULES_COUNT; i++) {
+        if (module_has_redundant_streams(config->bypass[i])) {
+            LOGGING_INFO("Config: redundant streams require reprogramming both modules");
+            TRACE2_MSG("Fail");
+            return -EBUSY;
+        }
+    }
+    /* message buffers used by the other module stay untouched */
+    for (i = 0; i < ACM_MODULES_COUNT; i++) {
+        if (i == module_id)
+            module_buffs |= module_msg_buff_mask(config->bypass[i]);
+        else
+            other_buffs |= module_msg_buff_mask(config->bypass[i]);
+    }
+    module_buffs &= ~other_buffs;
+    ret = sysfs_check_msg_buff_on_HW(&config->msg_buffs, other_buffs);
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+
+    // start configuration session of the module only
+    ret = sysfs_write_config_modules(1U << module_id);
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    ret = sysfs_write_config_status_to_HW(ACMDRV_CONFIG_START_STATE);
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    /* flash the msg_buffers of the module - it is important to first write
+     * the file descriptors and then the message buffer aliases */
+    ret = sysfs_write_msg_buff_mask_to_HW(&config->msg_buffs, BUFF_DESC, module_buffs);
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    ret = sysfs_write_msg_buff_mask_to_HW(&config->msg_buffs, BUFF_ALIAS, module_buffs);
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    ret = write_module_data_to_HW(module);
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    ret = sysfs_write_configuration_id(identifier);
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    // finish configuration
+    ret = sysfs_write_config_status_to_HW(ACMDRV_CONFIG_END_STATE);
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    ret = write_module_schedule_to_HW(module);
+    if (ret < 0) {
+        LOGERR("Config: applying schedule to HW failed");
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+
+    TRACE2_EXIT();
+    return 0;
+}
+
 int __must_check remove_configuration(void) {
     int ret;
 
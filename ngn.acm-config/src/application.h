@@ -49,6 +49,26 @@ int __must_check apply_configuration(struct acm_config *config, uint32_t identif
  * an error.
 */
 int __must_check apply_schedule(struct acm_config *config);
+/**
+ * @ingroup acmconfig
+ * @brief Apply the configuration of a single module.
+ *
+ * Only the module module_id is reprogrammed, the other module of the configuration is assumed to
+ * be unchanged and keeps running. The message buffers used by the other module have to be
+ * configured identically on hardware, redundant streams are not supported, as they share tables
+ * among both modules.
+ *
+ * @param config ACM configuration to be applied to the device
+ * @param module_id identity of the module to be reprogrammed
+ * @param identifier configuration id for verification in case of schedule change
+ *
+ * @return the function will return 0 in case of success, -EBUSY if the module cannot be
+ * reprogrammed without reprogramming the other module. Other negative values represent
+ * an error.
+*/
+int __must_check apply_module_configuration(struct acm_config *config,
+        enum acm_module_id module_id,
+        uint32_t identifier);
 /**
  * @ingroup acmconfig
  * @brief Delete actually applied configuration from hardware.
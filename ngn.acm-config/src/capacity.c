@@ -0,0 +1,62 @@
+/*
+ * TTTech ACM Configuration Library (libacmconfig)
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * ALL RIGHTS RESERVED.
+ * Usage of this software, including source code, netlists, documentation,
+ * is subject to restrictions and conditions of the applicable license
+ * agreement with TTTech Industrial Automation AG or its affiliates.
+ *
+ * All trademarks used are the property of their respective owners.
+ *
+ * TTTech Industrial Automation AG and its affiliates do not assume any liability
+ * arising out of the application or use of any product described or shown
+ * herein. TTTech Industrial Automation AG and its affiliates reserve the right to
+ * make changes, at any time, in order to improve reliability, function or
+ * design.
+ *
+ * Contact: https://tttech.com * support@tttech.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+#include <string.h>
+#include <errno.h>
+
+#include "capacity.h"
+#include "tracing.h"
+
+int __must_check capacity_place_constant(uint8_t *buffer, uint16_t *used,
+        const uint8_t *data, uint16_t size) {
+    int offset, overlap;
+
+    TRACE3_ENTER();
+    if (!buffer || !used || !data || (size == 0) || (*used > ACM_MAX_CONST_BUFFER_SIZE)) {
+        TRACE3_MSG("Fail");
+        return -EINVAL;
+    }
+
+    /* share a copy within the used part */
+    for (offset = 0; offset + size <= *used; offset++) {
+        if (memcmp(&buffer[offset], data, size) == 0) {
+            TRACE3_MSG("shared at offset %d", offset);
+            TRACE3_EXIT();
+            return offset;
+        }
+    }
+
+    /* share the end of the used part with the beginning of data */
+    for (overlap = (size - 1 < *used) ? size - 1 : *used; overlap > 0; overlap--) {
+        if (memcmp(&buffer[*used - overlap], data, overlap) == 0)
+            break;
+    }
+
+    offset = *used - overlap;
+    if (offset + size > ACM_MAX_CONST_BUFFER_SIZE) {
+        TRACE3_MSG("Fail");
+        return -EACMCONSTBUFFER;
+    }
+    memcpy(&buffer[offset], data, size);
+    *used = offset + size;
+
+    TRACE3_EXIT();
+    return offset;
+}
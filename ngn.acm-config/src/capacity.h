@@ -0,0 +1,48 @@
+/*
+ * TTTech ACM Configuration Library (libacmconfig)
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * ALL RIGHTS RESERVED.
+ * Usage of this software, including source code, netlists, documentation,
+ * is subject to restrictions and conditions of the applicable license
+ * agreement with TTTech Industrial Automation AG or its affiliates.
+ *
+ * All trademarks used are the property of their respective owners.
+ *
+ * TTTech Industrial Automation AG and its affiliates do not assume any liability
+ * arising out of the application or use of any product described or shown
+ * herein. TTTech Industrial Automation AG and its affiliates reserve the right to
+ * make changes, at any time, in order to improve reliability, function or
+ * design.
+ *
+ * Contact: https://tttech.com * support@tttech.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+#ifndef CAPACITY_H_
+#define CAPACITY_H_
+
+#include <stdint.h>
+
+#include "libacmconfig_def.h"
+
+/**
+ * @ingroup acmvalidate
+ * @brief place constant data in the constant buffer of a module
+ *
+ * The constant buffer is filled from its start. Data already contained in the
+ * used part of the buffer is not stored again but shared, i.e. the offset of
+ * the existing copy is returned. Data whose beginning equals the end of the
+ * used part only is appended by its remainder. Thus for example streams
+ * inserting the same header constants need the constant buffer space once.
+ *
+ * @param buffer constant buffer of ACM_MAX_CONST_BUFFER_SIZE bytes
+ * @param used number of bytes used in buffer, updated by the function
+ * @param data constant data to be placed
+ * @param size number of bytes of data
+ *
+ * @return offset of the data within buffer. Negative values represent an error.
+ */
+int __must_check capacity_place_constant(uint8_t *buffer, uint16_t *used,
+        const uint8_t *data, uint16_t size);
+
+#endif /* CAPACITY_H_ */
@@ -212,6 +212,62 @@ int __must_check config_schedule(struct acm_config *config,
     return ret;
 }
 
+int __must_check config_enable_module(struct acm_config *config,
+        enum acm_module_id module_id,
+        uint32_t identifier,
+        uint32_t identifier_expected) {
+    int ret;
+
+    TRACE2_ENTER();
+    if (!config) {
+        LOGERR("Config: Configuration not defined");
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+    if ((module_id != MODULE_0) && (module_id != MODULE_1)) {
+        LOGERR("Config: invalid module id %d", module_id);
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+    // check if new configuration identifier is different to 0
+    if (identifier == 0) {
+        LOGERR("Config: Configuration identifier 0 not allowed");
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+    // the other module keeps running the configuration with identifier_expected
+    ret = sysfs_read_configuration_id();
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    if (ret != identifier_expected) {
+        LOGERR("Config: read identifier %d not equal expected identifier %d",
+                ret,
+                identifier_expected);
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+
+    ret = validate_config(config, true);
+    if (ret) {
+        LOGERR("Config: final validation before applying module to HW failed");
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    ret = apply_module_configuration(config, module_id, identifier);
+    if (ret != 0) {
+        LOGERR("Config: applying module %d to HW failed", module_id);
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+
+    config->config_applied = true;
+
+    TRACE2_EXIT();
+    return 0;
+}
+
 int __must_check config_disable(void) {
     return remove_configuration();
 }
@@ -124,6 +124,26 @@ int __must_check config_schedule(struct acm_config *config,
         uint32_t identifier,
         uint32_t identifier_expected);
 
+/**
+ * @ingroup acmconfig
+ * @brief Apply the configuration of a single module to hardware
+ *
+ * The function does the same checks as config_schedule. Then only the module module_id is
+ * reprogrammed, while the other module keeps running.
+ *
+ * @param config ACM configuration containing the module to be applied
+ * @param module_id identity of the module to be reprogrammed
+ * @param identifier new configuration id
+ * @param identifier_expected expected id of configuration actually applied to hardware
+ *
+ * @return The function will return 0 in case of success, -EBUSY if the module cannot be
+ * reprogrammed alone. Other negative values represent an error.
+*/
+int __must_check config_enable_module(struct acm_config *config,
+        enum acm_module_id module_id,
+        uint32_t identifier,
+        uint32_t identifier_expected);
+
 /**
  * @ingroup acmconfig
  * @brief Remove a configuration from hardware
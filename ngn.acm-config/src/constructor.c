@@ -26,6 +26,8 @@
 #include "tracing.h"
 #include "hwconfig_def.h"
 #include "sysfs.h"
+#include "status.h"
+#include "netdev.h"
 #include "constructor.h"
 
 CTOR void con(void) {
@@ -56,3 +58,7 @@ CTOR void con(void) {
 
 }
 
+DTOR void des(void) {
+    status_close_items();
+    netdev_close();
+}
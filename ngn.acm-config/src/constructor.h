@@ -34,8 +34,10 @@
  */
 #ifndef TEST
 #define CTOR __attribute__((constructor)) static
+#define DTOR __attribute__((destructor)) static
 #else
 #define CTOR
+#define DTOR
 #endif
 
 /**
@@ -50,5 +52,13 @@
  */
 CTOR void con(void);
 
+/**
+ * @brief release resources of acm lib
+ *
+ * The function closes the status files kept open for reading the status of the modules.
+ *
+ */
+DTOR void des(void);
+
 
 #endif /* CONSTRUCTOR_H_ */
@@ -0,0 +1,390 @@
+/*
+ * TTTech ACM Configuration Library (libacmconfig)
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * ALL RIGHTS RESERVED.
+ * Usage of this software, including source code, netlists, documentation,
+ * is subject to restrictions and conditions of the applicable license
+ * agreement with TTTech Industrial Automation AG or its affiliates.
+ *
+ * All trademarks used are the property of their respective owners.
+ *
+ * TTTech Industrial Automation AG and its affiliates do not assume any liability
+ * arising out of the application or use of any product described or shown
+ * herein. TTTech Industrial Automation AG and its affiliates reserve the right to
+ * make changes, at any time, in order to improve reliability, function or
+ * design.
+ *
+ * Contact: https://tttech.com * support@tttech.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "image.h"
+#include "logging.h"
+#include "tracing.h"
+#include "memory.h"
+#include "hwconfig_def.h"
+#include "sysfs.h"
+#include "application.h"
+#include "validate.h"
+
+/**
+ * @brief initial allocation of an image in bytes
+ */
+#define IMAGE_INITIAL_SIZE 4096U
+
+/**
+ * @brief image under construction
+ */
+struct image_builder {
+    uint8_t *data; /**< image data, starting with the header */
+    size_t length; /**< used bytes of data */
+    size_t capacity; /**< allocated bytes of data */
+    size_t last; /**< offset of the last record, 0 if there is none */
+    uint32_t records; /**< number of records */
+};
+
+/**
+ * @brief files which are written per schedule table
+ */
+static const struct image_table_file {
+    const char *file; /**< filename relative to the acm sysfs directory */
+    uint32_t element_size; /**< size of a single element */
+    uint32_t table_elements; /**< number of elements per schedule table */
+} image_table_files[] = {
+    {
+        __stringify(ACMDRV_SYSFS_CONFIG_GROUP) "/" __stringify(ACM_SYSFS_SCHED_TAB),
+        sizeof (struct acmdrv_sched_tbl_row),
+        ACMDRV_SCHED_TBL_ROW_COUNT
+    },
+    {
+        __stringify(ACMDRV_SYSFS_CONFIG_GROUP) "/" __stringify(ACM_SYSFS_SCHED_CYCLE),
+        sizeof (struct acmdrv_sched_cycle_time),
+        1
+    },
+    {
+        __stringify(ACMDRV_SYSFS_CONFIG_GROUP) "/" __stringify(ACM_SYSFS_SCHED_START),
+        sizeof (struct acmdrv_timespec64),
+        1
+    },
+};
+
+static inline size_t image_pad(size_t length) {
+    return (length + 3) & ~(size_t) 3;
+}
+
+STATIC uint32_t image_crc32(const uint8_t *data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFU;
+    size_t i;
+    int bit;
+
+    for (i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320U & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static int image_reserve(struct image_builder *builder, size_t length) {
+    size_t capacity;
+    uint8_t *data;
+
+    if (builder->length + length <= builder->capacity)
+        return 0;
+
+    capacity = builder->capacity ? builder->capacity : IMAGE_INITIAL_SIZE;
+    while (capacity < builder->length + length)
+        capacity *= 2;
+
+    /* memory is zeroed, so padding bytes are always 0 */
+    data = acm_zalloc(capacity);
+    if (!data) {
+        LOGERR("Image: Out of memory");
+        return -ENOMEM;
+    }
+    if (builder->data)
+        memcpy(data, builder->data, builder->length);
+    acm_free(builder->data);
+    builder->data = data;
+    builder->capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief determine if a write goes to a schedule table of a module
+ */
+static void image_table_relative(const char *file,
+        off_t offset,
+        uint32_t *module,
+        uint32_t *table_stride) {
+    int i;
+
+    *module = 0;
+    *table_stride = 0;
+    for (i = 0; i < sizeof (image_table_files) / sizeof (image_table_files[0]); i++) {
+        const struct image_table_file *table_file = &image_table_files[i];
+
+        if (strcmp(file, table_file->file) != 0)
+            continue;
+        *table_stride = table_file->element_size * table_file->table_elements;
+        *module = offset / (*table_stride * ACMDRV_SCHED_TBL_COUNT);
+        return;
+    }
+}
+
+/**
+ * @brief write hook appending a write to the image
+ */
+static int image_record_write(void *arg,
+        const char *path_name,
+        const void *buffer,
+        size_t buffer_length,
+        off_t offset) {
+    struct image_builder *builder = arg;
+    struct image_record *record;
+    uint32_t module, table_stride;
+    const char *file;
+    int ret;
+
+    if (strncmp(path_name, ACMDEV_BASE, strlen(ACMDEV_BASE)) != 0) {
+        LOGERR("Image: %s not part of acm filesystem", path_name);
+        return -EINVAL;
+    }
+    file = path_name + strlen(ACMDEV_BASE);
+    if (strlen(file) >= IMAGE_FILE_LENGTH) {
+        LOGERR("Image: filename %s too long", file);
+        return -ENAMETOOLONG;
+    }
+    if ((offset < 0) || (offset > UINT32_MAX) || (buffer_length > UINT32_MAX)) {
+        LOGERR("Image: write to %s out of range", file);
+        return -EINVAL;
+    }
+    image_table_relative(file, offset, &module, &table_stride);
+
+    /* contiguous writes to the same file are merged into one record */
+    if (builder->last) {
+        record = (struct image_record *) (builder->data + builder->last);
+        if ((strcmp(record->file, file) == 0) &&
+                (record->module == module) &&
+                (record->table_stride == table_stride) &&
+                (record->length % 4 == 0) &&
+                (record->offset + record->length == offset)) {
+            ret = image_reserve(builder, image_pad(buffer_length));
+            if (ret < 0)
+                return ret;
+            record = (struct image_record *) (builder->data + builder->last);
+            memcpy(builder->data + builder->length, buffer, buffer_length);
+            record->length += buffer_length;
+            builder->length += image_pad(buffer_length);
+            return 0;
+        }
+    }
+
+    ret = image_reserve(builder, sizeof (*record) + image_pad(buffer_length));
+    if (ret < 0)
+        return ret;
+    record = (struct image_record *) (builder->data + builder->length);
+    strcpy(record->file, file);
+    record->offset = offset;
+    record->length = buffer_length;
+    record->module = module;
+    record->table_stride = table_stride;
+    memcpy(record + 1, buffer, buffer_length);
+
+    builder->last = builder->length;
+    builder->length += sizeof (*record) + image_pad(buffer_length);
+    builder->records++;
+    return 0;
+}
+
+int __must_check image_create(struct acm_config *config,
+        uint32_t identifier,
+        void **image,
+        size_t *size) {
+    struct image_builder builder;
+    struct image_header *header;
+    int ret;
+
+    TRACE2_ENTER();
+    if (!config || !image || !size) {
+        LOGERR("Image: Invalid input");
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+    if (identifier == 0) {
+        LOGERR("Image: Configuration identifier 0 not allowed");
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+    ret = validate_config(config, true);
+    if (ret) {
+        LOGERR("Image: final validation of configuration failed");
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+
+    memset(&builder, 0, sizeof (builder));
+    ret = image_reserve(&builder, sizeof (*header));
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+    builder.length = sizeof (*header);
+
+    /* record the writes of the regular apply path */
+    sysfs_set_write_hook(image_record_write, &builder);
+    ret = apply_configuration(config, identifier);
+    sysfs_set_write_hook(NULL, NULL);
+    if (ret < 0) {
+        LOGERR("Image: recording configuration failed");
+        acm_free(builder.data);
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+
+    header = (struct image_header *) builder.data;
+    header->magic = IMAGE_MAGIC;
+    header->version = IMAGE_VERSION;
+    header->header_size = sizeof (*header);
+    header->identifier = identifier;
+    header->record_count = builder.records;
+    header->length = builder.length;
+    header->checksum = image_crc32(builder.data + sizeof (*header),
+            builder.length - sizeof (*header));
+
+    *image = builder.data;
+    *size = builder.length;
+    TRACE2_EXIT();
+    return 0;
+}
+
+int __must_check image_check(const void *image, size_t size) {
+    const struct image_header *header = image;
+    const struct image_record *record;
+    size_t pos;
+    uint32_t i;
+
+    TRACE2_ENTER();
+    if (!image || (size < sizeof (*header))) {
+        LOGERR("Image: image too short");
+        goto fail;
+    }
+    if ((header->magic != IMAGE_MAGIC) || (header->header_size != sizeof (*header))) {
+        LOGERR("Image: no configuration image");
+        goto fail;
+    }
+    if (header->version != IMAGE_VERSION) {
+        LOGERR("Image: version %u not supported", header->version);
+        goto fail;
+    }
+    if (header->length != size) {
+        LOGERR("Image: length %u does not match size %zu", header->length, size);
+        goto fail;
+    }
+    if (header->checksum != image_crc32((const uint8_t *) image + sizeof (*header),
+            size - sizeof (*header))) {
+        LOGERR("Image: checksum mismatch");
+        goto fail;
+    }
+
+    pos = sizeof (*header);
+    for (i = 0; i < header->record_count; i++) {
+        if (size - pos < sizeof (*record)) {
+            LOGERR("Image: record %u truncated", i);
+            goto fail;
+        }
+        record = (const struct image_record *) ((const uint8_t *) image + pos);
+        pos += sizeof (*record);
+        if ((memchr(record->file, 0, IMAGE_FILE_LENGTH) == NULL) ||
+                (record->length > size - pos) ||
+                (record->table_stride && (record->module >= ACM_MODULES_COUNT))) {
+            LOGERR("Image: record %u invalid", i);
+            goto fail;
+        }
+        pos += image_pad(record->length);
+    }
+    if (pos != size) {
+        LOGERR("Image: unexpected data after last record");
+        goto fail;
+    }
+
+    TRACE2_EXIT();
+    return 0;
+
+fail:
+    TRACE2_MSG("Fail");
+    return -EACMIMAGE;
+}
+
+int __must_check image_apply(const void *image, size_t size) {
+    const struct image_header *header = image;
+    const struct image_record *record;
+    char path_name[SYSFS_PATH_LENGTH];
+    int table[ACM_MODULES_COUNT];
+    size_t pos;
+    off_t offset;
+    uint32_t i;
+    int ret;
+
+    TRACE2_ENTER();
+    ret = image_check(image, size);
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+
+    for (i = 0; i < ACM_MODULES_COUNT; i++)
+        table[i] = -1;
+
+    pos = sizeof (*header);
+    for (i = 0; i < header->record_count; i++) {
+        record = (const struct image_record *) ((const uint8_t *) image + pos);
+        pos += sizeof (*record) + image_pad(record->length);
+
+        offset = record->offset;
+        if (record->table_stride) {
+            /* the configuration is complete, when the first schedule
+             * record of a module shows up */
+            if (table[record->module] < 0) {
+                ret = sysfs_read_free_schedule_table(record->module,
+                        &table[record->module]);
+                if (ret < 0) {
+                    TRACE2_MSG("Fail");
+                    return ret;
+                }
+            }
+            offset += (off_t) table[record->module] * record->table_stride;
+        }
+
+        ret = snprintf(path_name, sizeof (path_name), ACMDEV_BASE "%s", record->file);
+        if (ret >= sizeof (path_name)) {
+            LOGERR("Image: pathname of %s too long", record->file);
+            TRACE2_MSG("Fail");
+            return -ENOMEM;
+        }
+        ret = write_file_sysfs(path_name, (void *) (record + 1), record->length, offset);
+        if (ret < 0) {
+            LOGERR("Image: writing record %u to %s failed", i, record->file);
+            TRACE2_MSG("Fail");
+            return ret;
+        }
+    }
+
+    TRACE2_EXIT();
+    return 0;
+}
+
+int64_t __must_check image_identifier(const void *image, size_t size) {
+    const struct image_header *header = image;
+    int ret;
+
+    ret = image_check(image, size);
+    if (ret < 0)
+        return ret;
+
+    return header->identifier;
+}
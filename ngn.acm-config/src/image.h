@@ -0,0 +1,160 @@
+/*
+ * TTTech ACM Configuration Library (libacmconfig)
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * ALL RIGHTS RESERVED.
+ * Usage of this software, including source code, netlists, documentation,
+ * is subject to restrictions and conditions of the applicable license
+ * agreement with TTTech Industrial Automation AG or its affiliates.
+ *
+ * All trademarks used are the property of their respective owners.
+ *
+ * TTTech Industrial Automation AG and its affiliates do not assume any liability
+ * arising out of the application or use of any product described or shown
+ * herein. TTTech Industrial Automation AG and its affiliates reserve the right to
+ * make changes, at any time, in order to improve reliability, function or
+ * design.
+ *
+ * Contact: https://tttech.com * support@tttech.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+
+/**
+ * @file image.h
+ *
+ * Compiled configuration images
+ *
+ * An image holds the final hardware tables of a validated configuration (message buffer
+ * descriptors and aliases, lookup, scatter/prefetch/gather DMA, redundancy and schedule rows) as
+ * sequence of writes to the acm filesystem. It is recorded by running the regular apply path
+ * with all writes redirected, so applying an image does not need to rebuild and recalculate the
+ * configuration.
+ *
+ * Image layout (all values in host byte order):
+ *
+ *     struct image_header
+ *     struct image_record, data padded to 4 bytes
+ *     struct image_record, data padded to 4 bytes
+ *     ...
+ *
+ * Schedule table rows, cycle and start times are recorded for schedule table 0 of a module and
+ * moved to a free schedule table of the module when the image is applied.
+ */
+#ifndef IMAGE_H_
+#define IMAGE_H_
+
+#include "libacmconfig_def.h"
+#include "config.h"
+
+/**
+ * @brief magic number of configuration images ("ACMI")
+ */
+#define IMAGE_MAGIC 0x494D4341U
+
+/**
+ * @brief version of the image format, images of other versions are rejected
+ */
+#define IMAGE_VERSION 1U
+
+/**
+ * @brief maximum length of a filename relative to the acm sysfs directory
+ */
+#define IMAGE_FILE_LENGTH 48U
+
+/**
+ * @brief header of a configuration image
+ */
+struct image_header {
+    uint32_t magic; /**< IMAGE_MAGIC */
+    uint16_t version; /**< IMAGE_VERSION */
+    uint16_t header_size; /**< size of this header in bytes */
+    uint32_t identifier; /**< configuration id written by the image */
+    uint32_t record_count; /**< number of records following the header */
+    uint32_t length; /**< length of the whole image in bytes */
+    uint32_t checksum; /**< CRC-32 of all bytes following the header */
+};
+
+/**
+ * @brief single write recorded in a configuration image
+ */
+struct image_record {
+    char file[IMAGE_FILE_LENGTH]; /**< filename relative to the acm sysfs directory */
+    uint32_t offset; /**< offset to write the data to */
+    uint32_t length; /**< number of data bytes following the record */
+    uint32_t module; /**< module of a schedule table relative record */
+    uint32_t table_stride; /**< offset increment per schedule table, 0 if not table relative */
+};
+
+/**
+ * @brief For test purposes static functions are declared as non static
+ * @{
+ */
+#ifndef TEST
+#define STATIC static
+#else
+#define STATIC
+
+uint32_t image_crc32(const uint8_t *data, size_t length);
+#endif
+/** @} */
+
+/**
+ * @ingroup acmconfig
+ * @brief Compile a configuration to an image
+ *
+ * The configuration is validated and the writes of acm_apply_config() are recorded to an image
+ * instead of being written to hardware. The hardware is not changed.
+ *
+ * @param config ACM configuration to be compiled
+ * @param identifier configuration id written when the image is applied
+ * @param image address where the pointer to the image is stored; release it with free()
+ * @param size address where the size of the image in bytes is stored
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check image_create(struct acm_config *config,
+        uint32_t identifier,
+        void **image,
+        size_t *size);
+
+/**
+ * @ingroup acmconfig
+ * @brief Check a configuration image
+ *
+ * Magic, version, length and checksum of the image and the bounds of all records are checked.
+ *
+ * @param image configuration image
+ * @param size size of the image in bytes
+ *
+ * @return The function will return 0 if the image is valid, -EACMIMAGE otherwise.
+ */
+int __must_check image_check(const void *image, size_t size);
+
+/**
+ * @ingroup acmconfig
+ * @brief Apply a configuration image to hardware
+ *
+ * After checking the image, all recorded writes are replayed. Schedules are moved to a free
+ * schedule table of their module.
+ *
+ * @param image configuration image
+ * @param size size of the image in bytes
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check image_apply(const void *image, size_t size);
+
+/**
+ * @ingroup acmconfig
+ * @brief Read the configuration id of a configuration image
+ *
+ * @param image configuration image
+ * @param size size of the image in bytes
+ *
+ * @return configuration id of the image. Negative values represent an error.
+ */
+int64_t __must_check image_identifier(const void *image, size_t size);
+
+#endif /* IMAGE_H_ */
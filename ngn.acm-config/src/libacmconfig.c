@@ -34,6 +34,7 @@
 #include "validate.h"
 #include "sysfs.h"
 #include "hwconfig_def.h"
+#include "image.h"
 
 #define ACMAPI __attribute__((visibility("default")))
 
@@ -43,17 +44,92 @@ ACMAPI int64_t __must_check acm_read_status_item(enum acm_module_id module_id,
     return status_read_item(module_id, status_id);
 }
 
+ACMAPI int __must_check acm_read_status(uint32_t select, struct acm_status *status) {
+    TRACE1_MSG("Executing. select=0x%x", select);
+    return status_read_all(select, status);
+}
+
 ACMAPI int64_t __must_check acm_read_config_identifier() {
     TRACE1_MSG("Executing");
     return status_read_config_identifier();
 }
 
+ACMAPI int __must_check acm_wait_schedule_active(enum acm_module_id module_id,
+        int timeout_ms, struct acm_schedule_event *event) {
+    TRACE1_MSG("Executing. module_id=%d, timeout=%d", module_id, timeout_ms);
+    return status_wait_schedule_active(module_id, timeout_ms, event);
+}
+
+ACMAPI int __must_check acm_wait_schedule_active_async(enum acm_module_id module_id,
+        int timeout_ms, acm_schedule_event_cb cb, void *arg) {
+    TRACE1_MSG("Executing. module_id=%d, timeout=%d", module_id, timeout_ms);
+    return status_wait_schedule_active_async(module_id, timeout_ms, cb, arg);
+}
+
 ACMAPI struct acm_diagnostic* __must_check acm_read_diagnostics(enum acm_module_id module_id) {
     TRACE1_MSG("Executing. module_id=%d", module_id);
     return status_read_diagnostics(module_id);
 }
 
 
+ACMAPI int __must_check acm_read_redundancy_stats(struct acm_redundancy_stats *stats) {
+    TRACE1_MSG("Executing.");
+    return status_read_redundancy_stats(stats);
+}
+
+ACMAPI int __must_check acm_reset_redundancy_stats(void) {
+    TRACE1_MSG("Executing.");
+    return status_reset_redundancy_stats();
+}
+
+ACMAPI int __must_check acm_read_diag_thresholds(enum acm_module_id module_id,
+        struct acm_diag_thresholds *thresholds) {
+    TRACE1_MSG("Executing. module_id=%d", module_id);
+    return status_read_diag_thresholds(module_id, thresholds);
+}
+
+ACMAPI int __must_check acm_write_diag_thresholds(enum acm_module_id module_id,
+        const struct acm_diag_thresholds *thresholds) {
+    TRACE1_MSG("Executing. module_id=%d", module_id);
+    return status_write_diag_thresholds(module_id, thresholds);
+}
+
+ACMAPI int __must_check acm_read_diag_alarm(enum acm_module_id module_id,
+        struct acm_diag_alarm *alarm) {
+    TRACE1_MSG("Executing. module_id=%d", module_id);
+    return status_read_diag_alarm(module_id, alarm);
+}
+
+ACMAPI int __must_check acm_wait_diag_alarm(enum acm_module_id module_id, int timeout_ms,
+        struct acm_diag_alarm *alarm) {
+    TRACE1_MSG("Executing. module_id=%d, timeout=%d", module_id, timeout_ms);
+    return status_wait_diag_alarm(module_id, timeout_ms, alarm);
+}
+
+ACMAPI int __must_check acm_read_failover_policy(enum acm_module_id module_id,
+        struct acm_failover_policy *policy) {
+    TRACE1_MSG("Executing. module_id=%d", module_id);
+    return status_read_failover_policy(module_id, policy);
+}
+
+ACMAPI int __must_check acm_write_failover_policy(enum acm_module_id module_id,
+        const struct acm_failover_policy *policy) {
+    TRACE1_MSG("Executing. module_id=%d", module_id);
+    return status_write_failover_policy(module_id, policy);
+}
+
+ACMAPI int __must_check acm_read_link_event(enum acm_module_id module_id,
+        struct acm_link_event *event) {
+    TRACE1_MSG("Executing. module_id=%d", module_id);
+    return status_read_link_event(module_id, event);
+}
+
+ACMAPI int __must_check acm_wait_link_event(enum acm_module_id module_id, int timeout_ms,
+        struct acm_link_event *event) {
+    TRACE1_MSG("Executing. module_id=%d, timeout=%d", module_id, timeout_ms);
+    return status_wait_link_event(module_id, timeout_ms, event);
+}
+
 ACMAPI int __must_check acm_set_diagnostics_poll_time(enum acm_module_id module_id,
         uint16_t interval_ms) {
     TRACE1_MSG("Executing. module_id=%d, interval=%d", module_id, interval_ms);
@@ -552,6 +628,12 @@ ACMAPI int __must_check acm_set_module_schedule(struct acm_module *module,
     return module_set_schedule(module, cycle_ns, start);
 }
 
+ACMAPI int __must_check acm_set_module_cycle_subns(struct acm_module *module,
+        uint32_t cycle_subns) {
+    TRACE1_MSG("Executing.");
+    return module_set_cycle_subns(module, cycle_subns);
+}
+
 ACMAPI int __must_check acm_add_module_stream(struct acm_module *module, struct acm_stream *stream) {
     int ret;
 
@@ -629,11 +711,25 @@ ACMAPI int __must_check acm_validate_config(struct acm_config *config) {
     return validate_config(config, true);
 }
 
+ACMAPI int __must_check acm_get_module_usage(struct acm_module *module,
+        struct acm_module_usage *usage) {
+    TRACE1_MSG("Executing.");
+    return module_get_usage(module, usage);
+}
+
 ACMAPI int __must_check acm_apply_config(struct acm_config *config, uint32_t identifier) {
     TRACE1_MSG("Executing.");
     return config_enable(config, identifier);
 }
 
+ACMAPI int __must_check acm_apply_module_config(struct acm_config *config,
+        enum acm_module_id module_id,
+        uint32_t identifier,
+        uint32_t identifier_expected) {
+    TRACE1_MSG("Executing.");
+    return config_enable_module(config, module_id, identifier, identifier_expected);
+}
+
 ACMAPI int __must_check acm_apply_schedule(struct acm_config *config,
         uint32_t identifier,
         uint32_t identifier_expected) {
@@ -641,6 +737,24 @@ ACMAPI int __must_check acm_apply_schedule(struct acm_config *config,
     return config_schedule(config, identifier, identifier_expected);
 }
 
+ACMAPI int __must_check acm_create_config_image(struct acm_config *config,
+        uint32_t identifier,
+        void **image,
+        size_t *size) {
+    TRACE1_MSG("Executing.");
+    return image_create(config, identifier, image, size);
+}
+
+ACMAPI int __must_check acm_apply_config_image(const void *image, size_t size) {
+    TRACE1_MSG("Executing.");
+    return image_apply(image, size);
+}
+
+ACMAPI int64_t __must_check acm_read_config_image_identifier(const void *image, size_t size) {
+    TRACE1_MSG("Executing.");
+    return image_identifier(image, size);
+}
+
 ACMAPI int __must_check acm_disable_config(void) {
     TRACE1_MSG("Executing.");
     return config_disable();
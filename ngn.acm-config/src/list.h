@@ -62,8 +62,19 @@ struct {                             \
     (_entry)->tqe.tqe_prev = NULL;      \
 } while(0)
 
+/*
+ * Applications using the library from a single thread only can build it with
+ * ACM_SINGLE_THREADED defined, which drops locking of the lists.
+ */
+#ifdef ACM_SINGLE_THREADED
+#define ACMLIST_LOCK(head)      do { (void) (head); } while (0)
+#define ACMLIST_UNLOCK(head)    do { (void) (head); } while (0)
+#define ACMLIST_LOCK_INIT(head) do { (void) (head); } while (0)
+#else
 #define ACMLIST_LOCK(head)      pthread_mutex_lock(&((head)->lock))
 #define ACMLIST_UNLOCK(head)    pthread_mutex_unlock(&((head)->lock))
+#define ACMLIST_LOCK_INIT(head) pthread_mutex_init(&((head)->lock), NULL)
+#endif
 #define ACMLIST_COUNT(head)     ((head)->num)
 #define ACMLIST_REF(elm, field) ((elm)->field.tqh)
 
@@ -73,7 +84,7 @@ struct {                             \
 } while (0)
 
 #define ACMLIST_INIT(head) do {                \
-    pthread_mutex_init(&((head)->lock), NULL); \
+    ACMLIST_LOCK_INIT(head);                   \
     _ACMLIST_INIT(head);                       \
 } while (0)
 
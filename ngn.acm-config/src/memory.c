@@ -19,8 +19,100 @@
  * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
  */
 #include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
 #include <string.h>
+#include <pthread.h>
 #include "memory.h"
+#include "stream.h"
+#include "operation.h"
+#include "schedule.h"
+#include "sysfs.h"
+
+/* number of objects allocated at once when an arena runs empty */
+#define ARENA_CHUNK_OBJECTS 64
+
+#ifdef ACM_SINGLE_THREADED
+#define ARENA_LOCK(arena)   do { } while (0)
+#define ARENA_UNLOCK(arena) do { } while (0)
+#else
+#define ARENA_LOCK(arena)   pthread_mutex_lock(&(arena)->lock)
+#define ARENA_UNLOCK(arena) pthread_mutex_unlock(&(arena)->lock)
+#endif
+
+/* free objects are linked through their first bytes */
+struct arena_object {
+    struct arena_object *next;
+};
+
+struct arena_chunk {
+    struct arena_chunk *next;
+    max_align_t objects[];
+};
+
+struct arena {
+    pthread_mutex_t lock;
+    size_t object_size;
+    size_t used;
+    struct arena_object *free_objects;
+    struct arena_chunk *chunks;
+};
+
+#define ARENA_INITIALIZER(type) \
+{                                                   \
+    .lock = PTHREAD_MUTEX_INITIALIZER,              \
+    .object_size = sizeof (type),                   \
+    .used = 0,                                      \
+    .free_objects = NULL,                           \
+    .chunks = NULL                                  \
+}
+
+static struct arena arenas[ACM_ARENA_TYPE_NUM] = {
+    [ACM_ARENA_STREAM] = ARENA_INITIALIZER(struct acm_stream),
+    [ACM_ARENA_OPERATION] = ARENA_INITIALIZER(struct operation),
+    [ACM_ARENA_SCHEDULE] = ARENA_INITIALIZER(struct schedule_entry),
+    [ACM_ARENA_FSC_COMMAND] = ARENA_INITIALIZER(struct fsc_command),
+};
+
+static size_t arena_stride(const struct arena *arena) {
+    size_t align = sizeof (max_align_t);
+
+    return (arena->object_size + align - 1) / align * align;
+}
+
+static int arena_grow(struct arena *arena) {
+    struct arena_chunk *chunk;
+    size_t stride = arena_stride(arena);
+    uint8_t *object;
+    int i;
+
+    chunk = malloc(sizeof (*chunk) + ARENA_CHUNK_OBJECTS * stride);
+    if (!chunk)
+        return -ENOMEM;
+
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+
+    /* link objects in ascending order */
+    object = (uint8_t *) chunk->objects + (ARENA_CHUNK_OBJECTS - 1) * stride;
+    for (i = 0; i < ARENA_CHUNK_OBJECTS; i++, object -= stride) {
+        struct arena_object *free_object = (struct arena_object *) object;
+
+        free_object->next = arena->free_objects;
+        arena->free_objects = free_object;
+    }
+    return 0;
+}
+
+static void arena_release(struct arena *arena) {
+    while (arena->chunks) {
+        struct arena_chunk *chunk = arena->chunks;
+
+        arena->chunks = chunk->next;
+        free(chunk);
+    }
+    arena->free_objects = NULL;
+}
 
 void* acm_zalloc(size_t size) {
     return calloc(1, size);
@@ -33,3 +125,41 @@ void acm_free(void *mem) {
 char* acm_strdup(const char *s) {
     return strdup(s);
 }
+
+void* acm_arena_zalloc(enum acm_arena_type type) {
+    struct arena *arena;
+    struct arena_object *object = NULL;
+
+    if (type >= ACM_ARENA_TYPE_NUM)
+        return NULL;
+
+    arena = &arenas[type];
+    ARENA_LOCK(arena);
+    if (arena->free_objects || arena_grow(arena) == 0) {
+        object = arena->free_objects;
+        arena->free_objects = object->next;
+        arena->used++;
+    }
+    ARENA_UNLOCK(arena);
+
+    if (object)
+        memset(object, 0, arena->object_size);
+    return object;
+}
+
+void acm_arena_free(enum acm_arena_type type, void *mem) {
+    struct arena *arena;
+    struct arena_object *object = mem;
+
+    if (!mem || type >= ACM_ARENA_TYPE_NUM)
+        return;
+
+    arena = &arenas[type];
+    ARENA_LOCK(arena);
+    object->next = arena->free_objects;
+    arena->free_objects = object;
+    arena->used--;
+    if (arena->used == 0)
+        arena_release(arena);
+    ARENA_UNLOCK(arena);
+}
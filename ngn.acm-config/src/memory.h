@@ -66,4 +66,45 @@ void acm_free(void *mem);
  */
 char *acm_strdup(const char *s);
 
+/**
+ * @brief types of objects allocated from an arena
+ *
+ * Objects of which a configuration typically holds thousands (streams, operations, schedule
+ * entries and fsc commands) are not allocated individually, but carved out of larger chunks
+ * of an arena per object type.
+ */
+enum acm_arena_type {
+    ACM_ARENA_STREAM = 0,
+    ACM_ARENA_OPERATION,
+    ACM_ARENA_SCHEDULE,
+    ACM_ARENA_FSC_COMMAND,
+    ACM_ARENA_TYPE_NUM
+};
+
+/**
+ * @brief allocate an object from an arena
+ *
+ * The function takes an object of the arena's object type from the arena and initializes it
+ * with zero. If the arena has no free object left, a new chunk is added to the arena.
+ *
+ * @param type arena to allocate the object from
+ *
+ * @return The function returns a pointer to the allocated object. If no memory was allocated,
+ * the function returns NULL.
+ */
+void *acm_arena_zalloc(enum acm_arena_type type);
+
+/**
+ * @brief return an object to its arena
+ *
+ * The function returns the object where mem points to to the arena it was allocated from.
+ * When the last object of an arena is returned, i.e. when the last configuration has been
+ * destroyed, all chunks of the arena are released.
+ *
+ * @param type arena the object was allocated from
+ * @param mem pointer to object to be returned, NULL is ignored
+ *
+ */
+void acm_arena_free(enum acm_arena_type type, void *mem);
+
 #endif /* MEMORY_H_ */
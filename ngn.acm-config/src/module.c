@@ -60,6 +60,7 @@ struct acm_module __must_check* module_create(enum acm_connection_mode mode,
     module->speed = speed;
     // set init values are for module cycle and start time
     module->cycle_ns = 0;
+    module->cycle_subns = 0;
     module->start.tv_nsec = 0;
     module->start.tv_sec = 0;
 
@@ -158,6 +159,27 @@ int __must_check module_set_schedule(struct acm_module *module,
     return 0;
 }
 
+int __must_check module_set_cycle_subns(struct acm_module *module,
+        uint32_t cycle_subns) {
+    TRACE2_ENTER();
+    if (!module) {
+        LOGERR("Module: Invalid module input: %d", module);
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+    if (cycle_subns >= ACM_CYCLE_SUBNS_MAX) {
+        LOGERR("Module: Cycle Time sub-nanoseconds out of range: %u",
+                cycle_subns);
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+
+    module->cycle_subns = cycle_subns;
+
+    TRACE2_EXIT();
+    return 0;
+}
+
 int __must_check module_add_schedules(struct acm_stream *stream, struct schedule_entry *schedule) {
 
     struct stream_list *streamlist;
@@ -236,16 +258,17 @@ int __must_check module_add_schedules(struct acm_stream *stream, struct schedule
 void remove_schedule_sysfs_items_schedule(struct schedule_entry *schedule_item,
         struct acm_module *module) {
     struct fsc_command_list *fsc_list;
-    struct fsc_command *fsc_item;
+    struct fsc_command *fsc_item, *next_item;
 
     TRACE2_ENTER();
     fsc_list = &module->fsc_list;
     ACMLIST_LOCK(fsc_list);
-    ACMLIST_FOREACH(fsc_item, fsc_list, entry)
-    {
+    /* item is released while iterating, so keep track of the next one */
+    for (fsc_item = ACMLIST_FIRST(fsc_list); fsc_item; fsc_item = next_item) {
+        next_item = ACMLIST_NEXT(fsc_item, entry);
         if (fsc_item->schedule_reference == schedule_item) {
             _ACMLIST_REMOVE(fsc_list, fsc_item, entry);
-            acm_free(fsc_item);
+            acm_arena_free(ACM_ARENA_FSC_COMMAND, fsc_item);
         }
     }
     ACMLIST_UNLOCK(fsc_list);
@@ -294,7 +317,7 @@ void fsc_command_empty_list(struct fsc_command_list *fsc_list) {
         fsc_item = ACMLIST_FIRST(fsc_list);
         _ACMLIST_REMOVE(fsc_list, fsc_item, entry);
 
-        acm_free(fsc_item);
+        acm_arena_free(ACM_ARENA_FSC_COMMAND, fsc_item);
     }
 
     ACMLIST_UNLOCK(fsc_list);
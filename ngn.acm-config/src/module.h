@@ -46,6 +46,7 @@ struct acm_module {
     enum acm_linkspeed speed; /**< linkspeed of the module */
     enum acm_module_id module_id; /**< identity of the module, unique within a configuratin*/
     uint32_t cycle_ns; /**< length of the period of the module in nanoseconds */
+    uint32_t cycle_subns; /**< sub-nanoseconds of the period in units of 2^-24 ns */
     struct timespec start; /**< start start-time of the configuration */
     struct acm_config *config_reference; /**< pointer to configuration the module was added to */
     struct fsc_command_list fsc_list; /**< list of fsc_commands for the module, calculated from schedules of streams*/
@@ -62,6 +63,7 @@ struct acm_module {
     .speed = (_speed),                                           \
     .module_id = (_id),                                          \
     .cycle_ns = 0,                                               \
+    .cycle_subns = 0,                                            \
     .start = { 0, 0 },                                           \
     .config_reference = (_config),                               \
     .fsc_list = COMMANDLIST_INITIALIZER((_module).fsc_list),     \
@@ -150,6 +152,20 @@ int __must_check module_set_schedule(struct acm_module *module,
         uint32_t cycle,
         struct timespec start);
 
+/**
+ * @ingroup acmmodule
+ * @brief set the sub-nanoseconds of the cycle time of a module
+ *
+ * @param module module where to set the sub-nanoseconds
+ * @param cycle_subns sub-nanoseconds of the cycle in units of 2^-24 ns,
+ *          has to be lower than ACM_CYCLE_SUBNS_MAX
+ *
+ * @return the function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check module_set_cycle_subns(struct acm_module *module,
+        uint32_t cycle_subns);
+
 /**
  * @ingroup acmmodule
  * @brief create HW schedule items for a logical schedule entry
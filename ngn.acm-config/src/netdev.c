@@ -0,0 +1,293 @@
+/*
+ * TTTech ACM Configuration Library (libacmconfig)
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * ALL RIGHTS RESERVED.
+ * Usage of this software, including source code, netlists, documentation,
+ * is subject to restrictions and conditions of the applicable license
+ * agreement with TTTech Industrial Automation AG or its affiliates.
+ *
+ * All trademarks used are the property of their respective owners.
+ *
+ * TTTech Industrial Automation AG and its affiliates do not assume any liability
+ * arising out of the application or use of any product described or shown
+ * herein. TTTech Industrial Automation AG and its affiliates reserve the right to
+ * make changes, at any time, in order to improve reliability, function or
+ * design.
+ *
+ * Contact: https://tttech.com * support@tttech.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <net/ethernet.h>
+#include <linux/rtnetlink.h>
+
+#include "netdev.h"
+#include "sysfs.h"
+#include "hwconfig_def.h"
+#include "logging.h"
+#include "tracing.h"
+
+/* receive buffer for rtnetlink messages */
+#define NETDEV_BUFFER_SIZE 8192
+
+struct netdev_port {
+    const char *ifname;             /* name of the network device */
+    bool present;                   /* device reported by rtnetlink */
+    bool running;                   /* link is up */
+    bool mac_valid;                 /* mac holds the MAC address of the device */
+    bool mac_used;                  /* mac was used as source address of streams */
+    uint8_t mac[ETHER_ADDR_LEN];    /* MAC address */
+    int speed_mbps;                 /* link speed, 0 if not read yet, negative if unknown */
+};
+
+static struct {
+    pthread_mutex_t lock;
+    int fd;                         /* rtnetlink socket, -1 if not subscribed */
+    bool unavailable;               /* subscription not possible, read from kernel on access */
+    struct netdev_port port[ACM_MODULES_COUNT];
+} netdev_cache = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .fd = -1,
+    .unavailable = false,
+    .port = {
+        [MODULE_0] = { .ifname = PORT_MODULE_0 },
+        [MODULE_1] = { .ifname = PORT_MODULE_1 },
+    },
+};
+
+STATIC void netdev_process_message(const struct nlmsghdr *nlh) {
+    const struct ifinfomsg *ifi;
+    const struct rtattr *rta;
+    const char *ifname = NULL;
+    const uint8_t *mac = NULL;
+    struct netdev_port *port = NULL;
+    int length, i;
+
+    if ( (nlh->nlmsg_type != RTM_NEWLINK) && (nlh->nlmsg_type != RTM_DELLINK))
+        return;
+
+    ifi = NLMSG_DATA(nlh);
+    length = IFLA_PAYLOAD(nlh);
+    for (rta = IFLA_RTA(ifi); RTA_OK(rta, length); rta = RTA_NEXT(rta, length)) {
+        switch (rta->rta_type) {
+            case IFLA_IFNAME:
+                ifname = RTA_DATA(rta);
+                break;
+            case IFLA_ADDRESS:
+                if (RTA_PAYLOAD(rta) == ETHER_ADDR_LEN)
+                    mac = RTA_DATA(rta);
+                break;
+            default:
+                break;
+        }
+    }
+    if (!ifname)
+        return;
+
+    for (i = 0; i < ACM_MODULES_COUNT; i++)
+        if (strcmp(netdev_cache.port[i].ifname, ifname) == 0)
+            port = &netdev_cache.port[i];
+    if (!port)
+        return;
+
+    if (nlh->nlmsg_type == RTM_DELLINK) {
+        port->present = false;
+        return;
+    }
+
+    if (mac) {
+        if (port->mac_used && port->mac_valid && (memcmp(port->mac, mac, ETHER_ADDR_LEN) != 0))
+            LOGWARN("Netdev: MAC address of %s changed, source MAC of streams added before is stale",
+                    ifname);
+        memcpy(port->mac, mac, ETHER_ADDR_LEN);
+        port->mac_valid = true;
+    }
+    port->running = (ifi->ifi_flags & IFF_RUNNING) != 0;
+    /* link speed may have changed with any link event */
+    port->speed_mbps = 0;
+    port->present = true;
+}
+
+/* close the rtnetlink socket, lock held */
+static void netdev_close_socket(void) {
+    if (netdev_cache.fd >= 0)
+        close(netdev_cache.fd);
+    netdev_cache.fd = -1;
+}
+
+/* process messages of the rtnetlink socket, until end of dump or no more pending, lock held */
+static int netdev_receive(bool dump) {
+    char buffer[NETDEV_BUFFER_SIZE] __attribute__((aligned(NLMSG_ALIGNTO)));
+    const struct nlmsghdr *nlh;
+    ssize_t length;
+
+    for (;;) {
+        length = recv(netdev_cache.fd, buffer, sizeof (buffer), dump ? 0 : MSG_DONTWAIT);
+        if (length < 0) {
+            if (errno == EINTR)
+                continue;
+            if (!dump && ( (errno == EAGAIN) || (errno == EWOULDBLOCK)))
+                return 0;
+            return -errno;
+        }
+
+        for (nlh = (const struct nlmsghdr *) buffer; NLMSG_OK(nlh, length);
+                nlh = NLMSG_NEXT(nlh, length)) {
+            if (nlh->nlmsg_type == NLMSG_DONE)
+                return 0;
+            if (nlh->nlmsg_type == NLMSG_ERROR)
+                return -EIO;
+            netdev_process_message(nlh);
+        }
+    }
+}
+
+/* subscribe to link notifications and read the current state of all devices, lock held */
+static int netdev_open(void) {
+    struct sockaddr_nl addr = {
+        .nl_family = AF_NETLINK,
+        .nl_groups = RTMGRP_LINK,
+    };
+    struct {
+        struct nlmsghdr nlh;
+        struct ifinfomsg ifi;
+    } request = {
+        .nlh = {
+            .nlmsg_len = NLMSG_LENGTH(sizeof (struct ifinfomsg)),
+            .nlmsg_type = RTM_GETLINK,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+        },
+        .ifi = {
+            .ifi_family = AF_UNSPEC,
+        },
+    };
+    int ret;
+
+    netdev_cache.fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (netdev_cache.fd < 0)
+        return -errno;
+
+    if ( (bind(netdev_cache.fd, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+            || (send(netdev_cache.fd, &request, request.nlh.nlmsg_len, 0) < 0)) {
+        ret = -errno;
+        netdev_close_socket();
+        return ret;
+    }
+
+    ret = netdev_receive(true);
+    if (ret < 0)
+        netdev_close_socket();
+    return ret;
+}
+
+/* bring the cache up to date, returns false if the cache cannot be used, lock held */
+static bool netdev_update(void) {
+    int ret;
+
+    if (netdev_cache.unavailable)
+        return false;
+
+    if (netdev_cache.fd >= 0) {
+        ret = netdev_receive(false);
+        if (ret == 0)
+            return true;
+        /* notifications were lost (e.g. -ENOBUFS), resynchronize */
+        netdev_close_socket();
+    }
+
+    ret = netdev_open();
+    if (ret < 0) {
+        LOGWARN("Netdev: no link notifications (%d), reading network devices on each access",
+                ret);
+        netdev_cache.unavailable = true;
+        return false;
+    }
+    return true;
+}
+
+STATIC int netdev_cached_mac(enum acm_module_id module_id, uint8_t *mac) {
+    struct netdev_port *port = &netdev_cache.port[module_id];
+
+    if (!port->present || !port->mac_valid)
+        return -ENODATA;
+
+    memcpy(mac, port->mac, ETHER_ADDR_LEN);
+    port->mac_used = true;
+    return 0;
+}
+
+int __must_check netdev_get_mac(enum acm_module_id module_id, uint8_t *mac) {
+    int ret = -ENODATA;
+
+    TRACE3_ENTER();
+    if (module_id >= ACM_MODULES_COUNT) {
+        TRACE3_MSG("Fail");
+        return -EACMINTERNAL;
+    }
+
+    pthread_mutex_lock(&netdev_cache.lock);
+    if (netdev_update())
+        ret = netdev_cached_mac(module_id, mac);
+    pthread_mutex_unlock(&netdev_cache.lock);
+
+    /* device not known to the cache */
+    if (ret == -ENODATA)
+        ret = get_mac_address((char *) netdev_cache.port[module_id].ifname, mac);
+    TRACE3_EXIT();
+    return ret;
+}
+
+STATIC void netdev_check_cached_link(enum acm_module_id module_id, enum acm_linkspeed speed) {
+    static const int speed_mbps[] = {
+        [SPEED_100MBps] = 100,
+        [SPEED_1GBps] = 1000,
+    };
+    struct netdev_port *port = &netdev_cache.port[module_id];
+    char path_name[SYSFS_PATH_LENGTH];
+
+    if (!port->present)
+        return;
+
+    if (!port->running) {
+        LOGWARN("Netdev: link of %s is down", port->ifname);
+        return;
+    }
+
+    if (port->speed_mbps == 0) {
+        snprintf(path_name, sizeof (path_name), DELAY_BASE "%s/speed", port->ifname);
+        port->speed_mbps = read_uint64_sysfs_item(path_name);
+        if (port->speed_mbps == 0)
+            port->speed_mbps = -1;
+    }
+
+    if ( (port->speed_mbps > 0) && (speed <= SPEED_1GBps)
+            && (port->speed_mbps != speed_mbps[speed]))
+        LOGWARN("Netdev: %s runs at %d Mbps, module %d is configured for %d Mbps",
+                port->ifname, port->speed_mbps, module_id, speed_mbps[speed]);
+}
+
+void netdev_check_link(enum acm_module_id module_id, enum acm_linkspeed speed) {
+    TRACE3_ENTER();
+    if (module_id >= ACM_MODULES_COUNT)
+        return;
+
+    pthread_mutex_lock(&netdev_cache.lock);
+    if (netdev_update())
+        netdev_check_cached_link(module_id, speed);
+    pthread_mutex_unlock(&netdev_cache.lock);
+    TRACE3_EXIT();
+}
+
+void netdev_close(void) {
+    pthread_mutex_lock(&netdev_cache.lock);
+    netdev_close_socket();
+    netdev_cache.unavailable = false;
+    pthread_mutex_unlock(&netdev_cache.lock);
+}
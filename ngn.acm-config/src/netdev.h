@@ -0,0 +1,87 @@
+/*
+ * TTTech ACM Configuration Library (libacmconfig)
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * ALL RIGHTS RESERVED.
+ * Usage of this software, including source code, netlists, documentation,
+ * is subject to restrictions and conditions of the applicable license
+ * agreement with TTTech Industrial Automation AG or its affiliates.
+ *
+ * All trademarks used are the property of their respective owners.
+ *
+ * TTTech Industrial Automation AG and its affiliates do not assume any liability
+ * arising out of the application or use of any product described or shown
+ * herein. TTTech Industrial Automation AG and its affiliates reserve the right to
+ * make changes, at any time, in order to improve reliability, function or
+ * design.
+ *
+ * Contact: https://tttech.com * support@tttech.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+
+/**
+ * @file netdev.h
+ *
+ * Cache of the properties of the network devices of the modules
+ *
+ * MAC address, link state and link speed of the ports associated to the modules are cached
+ * and kept up to date by a subscription to the rtnetlink link notifications. Pending
+ * notifications are processed whenever the cache is accessed, so building a configuration does
+ * not query the kernel per stream. If the subscription is not possible, the properties are read
+ * from the kernel on each access.
+ */
+#ifndef NETDEV_H_
+#define NETDEV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <linux/netlink.h>
+
+#include "libacmconfig_def.h"
+
+/**
+ * @brief For test purposes static functions are declared as non static
+ * @{
+ */
+#ifndef TEST
+#define STATIC static
+#else
+#define STATIC
+
+void netdev_process_message(const struct nlmsghdr *nlh);
+int netdev_cached_mac(enum acm_module_id module_id, uint8_t *mac);
+void netdev_check_cached_link(enum acm_module_id module_id, enum acm_linkspeed speed);
+#endif
+/** @} */
+
+/**
+ * @brief Get MAC address of the port of a module
+ *
+ * The MAC address is taken from the cache. Later changes of the MAC address are reported,
+ * as source addresses of streams already added to the module become stale.
+ *
+ * @param module_id identifier of the module
+ * @param mac address where the MAC address (6 bytes) is stored
+ *
+ * @return 0 on success. Negative values represent an error.
+ */
+int __must_check netdev_get_mac(enum acm_module_id module_id, uint8_t *mac);
+
+/**
+ * @brief Check the link of the port of a module
+ *
+ * The function reports a warning if the link of the port is down or if the link speed does
+ * not match the speed the module is configured for. Both conditions do not prevent applying
+ * a configuration, as the link may come up later.
+ *
+ * @param module_id identifier of the module
+ * @param speed link speed the module is configured for
+ */
+void netdev_check_link(enum acm_module_id module_id, enum acm_linkspeed speed);
+
+/**
+ * @brief Release the rtnetlink subscription of the cache
+ */
+void netdev_close(void);
+
+#endif /* NETDEV_H_ */
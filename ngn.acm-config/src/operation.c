@@ -29,6 +29,7 @@
 #include "libacmconfig_def.h"
 #include "validate.h"
 #include "sysfs.h"
+#include "netdev.h"
 
 /**
  * @brief structure for checking the specified length values of operations
@@ -77,7 +78,7 @@ struct operation __must_check* operation_create_insert(uint16_t length, const ch
         return NULL;
     }
 
-    operation = acm_zalloc(sizeof (*operation));
+    operation = acm_arena_zalloc(ACM_ARENA_OPERATION);
 
     if (!operation) {
         LOGERR("Operation: Out of memory");
@@ -90,7 +91,7 @@ struct operation __must_check* operation_create_insert(uint16_t length, const ch
     operation->length = length;
     operation->buffer_name = acm_strdup(buffer_name);
     if (!operation->buffer_name) {
-        acm_free(operation);
+        acm_arena_free(ACM_ARENA_OPERATION, operation);
         LOGERR("Operation: Out of memory");
         TRACE2_MSG("Fail");
         return NULL;
@@ -117,7 +118,7 @@ struct operation __must_check* operation_create_insertconstant(const char *data,
         TRACE2_MSG("Fail");
         return NULL;
     }
-    operation = acm_zalloc(sizeof (*operation));
+    operation = acm_arena_zalloc(ACM_ARENA_OPERATION);
 
     if (!operation) {
         LOGERR("Operation: Out of memory");
@@ -129,7 +130,7 @@ struct operation __must_check* operation_create_insertconstant(const char *data,
     operation->length = data_size;
     operation->data = acm_zalloc(data_size);
     if (!operation->data) {
-        acm_free(operation);
+        acm_arena_free(ACM_ARENA_OPERATION, operation);
         LOGERR("Operation: Out of memory");
         TRACE2_MSG("Fail");
         return NULL;
@@ -159,7 +160,7 @@ struct operation __must_check* operation_create_pad(uint16_t length, char pad_va
         return NULL;
     }
 
-    operation = acm_zalloc(sizeof (*operation));
+    operation = acm_arena_zalloc(ACM_ARENA_OPERATION);
 
     if (!operation) {
         LOGERR("Operation: Out of memory");
@@ -172,7 +173,7 @@ struct operation __must_check* operation_create_pad(uint16_t length, char pad_va
 
     operation->data = acm_zalloc(1);
     if (!operation->data) {
-        acm_free(operation);
+        acm_arena_free(ACM_ARENA_OPERATION, operation);
         LOGERR("Operation: Out of memory");
         TRACE2_MSG("Fail");
         return NULL;
@@ -208,7 +209,7 @@ struct operation __must_check* operation_create_forward(uint16_t offset, uint16_
         return NULL;
     }
 
-    operation = acm_zalloc(sizeof (*operation));
+    operation = acm_arena_zalloc(ACM_ARENA_OPERATION);
 
     if (!operation) {
         LOGERR("Operation: Out of memory");
@@ -263,7 +264,7 @@ struct operation __must_check* operation_create_read(uint16_t offset,
         return NULL;
     }
 
-    operation = acm_zalloc(sizeof (*operation));
+    operation = acm_arena_zalloc(ACM_ARENA_OPERATION);
 
     if (!operation) {
         LOGERR("Operation: Out of memory");
@@ -277,7 +278,7 @@ struct operation __must_check* operation_create_read(uint16_t offset,
 
     operation->buffer_name = acm_strdup(buffer_name);
     if (!operation->buffer_name) {
-        acm_free(operation);
+        acm_arena_free(ACM_ARENA_OPERATION, operation);
         LOGERR("Operation: Out of memory");
         TRACE2_MSG("Fail");
         return NULL;
@@ -291,7 +292,7 @@ struct operation __must_check* operation_create_forwardall() {
     struct operation *operation;
 
     TRACE2_ENTER();
-    operation = acm_zalloc(sizeof (*operation));
+    operation = acm_arena_zalloc(ACM_ARENA_OPERATION);
 
     if (!operation) {
         LOGERR("Operation: Out of memory");
@@ -314,7 +315,7 @@ void operation_destroy(struct operation *operation) {
 
     acm_free(operation->data);
     acm_free(operation->buffer_name);
-    acm_free(operation);
+    acm_arena_free(ACM_ARENA_OPERATION, operation);
     TRACE2_EXIT();
 }
 
@@ -426,16 +427,7 @@ int __must_check operation_list_update_smac(struct operation_list *list, enum ac
 
     TRACE3_ENTER();
     /* read MAC address of module */
-    switch (id) {
-        case MODULE_0:
-            ret = get_mac_address(PORT_MODULE_0, mac);
-            break;
-        case MODULE_1:
-            ret = get_mac_address(PORT_MODULE_1, mac);
-            break;
-        default:
-            ret = -EACMINTERNAL;
-    }
+    ret = netdev_get_mac(id, mac);
     if (ret < 0) {
         LOGERR("Operation: problem reading MAC address of module");
         TRACE3_MSG("Fail");
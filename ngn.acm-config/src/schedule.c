@@ -101,7 +101,7 @@ struct schedule_entry *schedule_create(uint32_t time_start,
         return NULL;
     }
 
-    schedule = acm_zalloc(sizeof (*schedule));
+    schedule = acm_arena_zalloc(ACM_ARENA_SCHEDULE);
     if (!schedule) {
         LOGERR("%s: Out of memory", __func__);
         return NULL;
@@ -117,5 +117,5 @@ struct schedule_entry *schedule_create(uint32_t time_start,
 }
 
 void schedule_destroy(struct schedule_entry *schedule) {
-    acm_free(schedule);
+    acm_arena_free(ACM_ARENA_SCHEDULE, schedule);
 }
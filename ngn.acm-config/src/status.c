@@ -24,6 +24,10 @@
 #include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdbool.h>
 
 #include "status.h"
 
@@ -146,6 +150,155 @@ int64_t __must_check status_read_item(enum acm_module_id module_id, enum acm_sta
     return ret;
 }
 
+/* files of the status items kept open by status_read_all() */
+static struct {
+    pthread_mutex_t lock;
+    bool open[ACM_MODULES_COUNT][STATUS_ITEM_NUM];
+    int fd[ACM_MODULES_COUNT][STATUS_ITEM_NUM];
+} status_items = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static bool status_is_error_item(enum acm_status_item id) {
+    return strcmp(status_subpath[id].group, __stringify(ACMDRV_SYSFS_ERROR_GROUP)) == 0;
+}
+
+static int status_open_item(enum acm_module_id module_id, enum acm_status_item id) {
+    char path_name[SYSFS_PATH_LENGTH];
+    int ret;
+
+    ret = snprintf(path_name, sizeof (path_name), ACMDEV_BASE "%s/%s_M%d",
+            status_subpath[id].group, status_subpath[id].subpath, module_id);
+    if ( (ret < 0) || (ret >= (int) sizeof (path_name))) {
+        LOGERR("Status: path name of status item %d too long", id);
+        return -EINVAL;
+    }
+
+    ret = open(path_name, O_RDONLY | O_DSYNC);
+    if (ret < 0) {
+        LOGERR("Status: open file %s failed", path_name);
+        return -ENODEV;
+    }
+    return ret;
+}
+
+static int64_t status_pread_item(int fd) {
+    char buffer[80];
+    char *conversion_end_ptr;
+    ssize_t read_length;
+    int64_t value;
+
+    /* reading from offset 0 makes the driver provide the current value */
+    read_length = pread(fd, buffer, sizeof (buffer) - 1, 0);
+    if (read_length < 0)
+        return -errno;
+    if (read_length == 0)
+        return -EACMSYSFSNODATA;
+    buffer[read_length] = '\0';
+
+    errno = 0;
+    value = strtoull(buffer, &conversion_end_ptr, 0);
+    if (errno != 0)
+        return -errno;
+    if (conversion_end_ptr == buffer)
+        return -EINVAL;
+    return value;
+}
+
+/* read a status item from its kept file, lock held */
+static int64_t status_read_kept_item(enum acm_module_id module_id, enum acm_status_item id) {
+    int64_t value = -ENODEV;
+    int retry;
+
+    /* the file is reopened once, e.g. if the driver was reloaded in the meantime */
+    for (retry = 0; retry < 2; retry++) {
+        if (!status_items.open[module_id][id]) {
+            int fd = status_open_item(module_id, id);
+
+            if (fd < 0)
+                return fd;
+            status_items.fd[module_id][id] = fd;
+            status_items.open[module_id][id] = true;
+        }
+
+        value = status_pread_item(status_items.fd[module_id][id]);
+        if (value >= 0)
+            return value;
+
+        close(status_items.fd[module_id][id]);
+        status_items.open[module_id][id] = false;
+    }
+
+    LOGERR("Status: problem reading %s_M%d", status_subpath[id].subpath, module_id);
+    return value;
+}
+
+int __must_check status_read_all(uint32_t select, struct acm_status *status) {
+    const uint32_t modules = ACM_STATUS_SELECT_MODULE_0 | ACM_STATUS_SELECT_MODULE_1;
+    struct timespec end;
+    unsigned int module_id;
+    enum acm_status_item id;
+    int64_t value;
+    int ret = 0;
+
+    if (!status) {
+        LOGERR("Status: no status structure");
+        return -EINVAL;
+    }
+    if ( ( (select & modules) == 0) || (select & ~(modules | ACM_STATUS_SELECT_ERRORS))) {
+        LOGERR("Status: invalid status selection 0x%x", select);
+        return -EINVAL;
+    }
+
+    status->select = select;
+    status->duration_ns = 0;
+    for (module_id = 0; module_id < ACM_MODULES_COUNT; module_id++)
+        for (id = 0; id < STATUS_ITEM_NUM; id++)
+            status->item[module_id][id] = -ENODATA;
+
+    pthread_mutex_lock(&status_items.lock);
+    clock_gettime(CLOCK_MONOTONIC, &status->timestamp);
+    for (module_id = 0; module_id < ACM_MODULES_COUNT; module_id++) {
+        if ( (select & (1U << module_id)) == 0)
+            continue;
+
+        for (id = 0; id < STATUS_ITEM_NUM; id++) {
+            if (status_is_error_item(id) && ( (select & ACM_STATUS_SELECT_ERRORS) == 0))
+                continue;
+
+            value = status_read_kept_item(module_id, id);
+            if (value < 0) {
+                ret = value;
+                goto unlock;
+            }
+            status->item[module_id][id] = value;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    status->duration_ns = (end.tv_sec - status->timestamp.tv_sec) * 1000000000
+            + (end.tv_nsec - status->timestamp.tv_nsec);
+
+unlock:
+    pthread_mutex_unlock(&status_items.lock);
+    return ret;
+}
+
+void status_close_items(void) {
+    unsigned int module_id;
+    enum acm_status_item id;
+
+    pthread_mutex_lock(&status_items.lock);
+    for (module_id = 0; module_id < ACM_MODULES_COUNT; module_id++) {
+        for (id = 0; id < STATUS_ITEM_NUM; id++) {
+            if (!status_items.open[module_id][id])
+                continue;
+            close(status_items.fd[module_id][id]);
+            status_items.open[module_id][id] = false;
+        }
+    }
+    pthread_mutex_unlock(&status_items.lock);
+}
+
 struct acm_diagnostic *__must_check status_read_diagnostics(enum acm_module_id module_id) {
     struct acmdrv_diagnostics packed_diag_values;
     int ret;
@@ -182,6 +335,194 @@ struct acm_diagnostic *__must_check status_read_diagnostics(enum acm_module_id m
     return unpacked_diagnostics;
 }
 
+/**
+ * @brief copy FRER statistics from packed to unpacked structure
+ */
+static void convert_redun_stats2unpacked(const struct acmdrv_redun_stats *source,
+        struct acm_redundancy_stats *destination) {
+    unsigned int i, j;
+
+    destination->timestamp.tv_sec = source->timestamp.tv_sec;
+    destination->timestamp.tv_nsec = source->timestamp.tv_nsec;
+    destination->samples = source->samples;
+    for (i = 0; i < ACM_MODULES_COUNT; i++)
+        for (j = 0; j < ACM_MAX_LOOKUP_SIZE; j++)
+            destination->individual_timeouts[i][j] = source->individual_timeouts[i][j];
+    for (i = 0; i < ACM_REDUNDANCY_ENTRY_COUNT; i++) {
+        const struct acmdrv_redun_entry_stats *src = &source->entry[i];
+        struct acm_redundancy_entry_stats *dst = &destination->entry[i];
+
+        dst->passed = src->passed;
+        dst->recoveries = src->recoveries;
+        dst->duplicates = src->duplicates;
+        dst->errors = src->errors;
+        dst->out_of_order = src->out_of_order;
+        dst->resets = src->resets;
+        dst->timeouts = src->timeouts;
+        dst->passed_rate = src->passed_rate;
+        dst->duplicate_rate = src->duplicate_rate;
+    }
+}
+
+int __must_check status_read_redundancy_stats(struct acm_redundancy_stats *stats) {
+    struct acmdrv_redun_stats packed;
+    char path_name[SYSFS_PATH_LENGTH];
+    int ret;
+
+    if (!stats) {
+        LOGERR("Status: Invalid redundancy statistics input");
+        return -EINVAL;
+    }
+
+    ret = sysfs_construct_path_name(path_name,
+            SYSFS_PATH_LENGTH,
+            __stringify(ACMDRV_SYSFS_DIAG_GROUP),
+            __stringify(ACM_SYSFS_REDUND_STATS));
+    if (ret != 0)
+        return ret;
+
+    ret = read_buffer_sysfs_item(path_name, &packed, sizeof(packed), 0);
+    if (ret != 0) {
+        LOGERR("Status: problem reading data from file %s", path_name);
+        return ret;
+    }
+
+    convert_redun_stats2unpacked(&packed, stats);
+    return 0;
+}
+
+int __must_check status_reset_redundancy_stats(void) {
+    char path_name[SYSFS_PATH_LENGTH];
+    uint32_t value = 0;
+    int ret;
+
+    ret = sysfs_construct_path_name(path_name,
+            SYSFS_PATH_LENGTH,
+            __stringify(ACMDRV_SYSFS_DIAG_GROUP),
+            __stringify(ACM_SYSFS_REDUND_STATS));
+    if (ret != 0)
+        return ret;
+
+    return write_file_sysfs(path_name, &value, sizeof(value), 0);
+}
+
+/**
+ * @brief construct the path name of a per module file of the diagnostic section
+ */
+static int diag_module_path_name(char *path_name, enum acm_module_id module_id,
+        const char *file) {
+    char file_name[SYSFS_PATH_LENGTH];
+
+    if (module_id >= ACM_MODULES_COUNT) {
+        LOGERR("Status: module_id out of range: %d", module_id);
+        return -EINVAL;
+    }
+
+    snprintf(file_name, sizeof(file_name), "%s_M%d", file, module_id);
+    return sysfs_construct_path_name(path_name,
+            SYSFS_PATH_LENGTH,
+            __stringify(ACMDRV_SYSFS_DIAG_GROUP),
+            file_name);
+}
+
+int __must_check status_read_diag_thresholds(enum acm_module_id module_id,
+        struct acm_diag_thresholds *thresholds) {
+    struct acmdrv_diag_thresholds packed;
+    char path_name[SYSFS_PATH_LENGTH];
+    unsigned int i, j;
+    int ret;
+
+    if (!thresholds) {
+        LOGERR("Status: Invalid diagnostic thresholds input");
+        return -EINVAL;
+    }
+
+    ret = diag_module_path_name(path_name, module_id, __stringify(ACM_SYSFS_DIAG_THRESHOLDS));
+    if (ret != 0)
+        return ret;
+
+    ret = read_buffer_sysfs_item(path_name, &packed, sizeof(packed), 0);
+    if (ret != 0) {
+        LOGERR("Status: problem reading data from file %s", path_name);
+        return ret;
+    }
+
+    for (i = 0; i < ACM_DIAG_COUNTER_COUNT; i++)
+        for (j = 0; j < ACM_MAX_LOOKUP_SIZE; j++) {
+            thresholds->rule[i][j].limit = packed.rule[i][j].limit;
+            thresholds->rule[i][j].holdoff_ms = packed.rule[i][j].holdoff;
+        }
+    return 0;
+}
+
+int __must_check status_write_diag_thresholds(enum acm_module_id module_id,
+        const struct acm_diag_thresholds *thresholds) {
+    struct acmdrv_diag_thresholds packed;
+    char path_name[SYSFS_PATH_LENGTH];
+    unsigned int i, j;
+    int ret;
+
+    if (!thresholds) {
+        LOGERR("Status: Invalid diagnostic thresholds input");
+        return -EINVAL;
+    }
+
+    ret = diag_module_path_name(path_name, module_id, __stringify(ACM_SYSFS_DIAG_THRESHOLDS));
+    if (ret != 0)
+        return ret;
+
+    for (i = 0; i < ACM_DIAG_COUNTER_COUNT; i++)
+        for (j = 0; j < ACM_MAX_LOOKUP_SIZE; j++) {
+            packed.rule[i][j].limit = thresholds->rule[i][j].limit;
+            packed.rule[i][j].holdoff = thresholds->rule[i][j].holdoff_ms;
+        }
+
+    return write_file_sysfs(path_name, &packed, sizeof(packed), 0);
+}
+
+/**
+ * @brief copy diagnostic threshold breaches from packed to unpacked structure
+ */
+static void convert_diag_alarm2unpacked(const struct acmdrv_diag_alarm *source,
+        struct acm_diag_alarm *destination) {
+    unsigned int i, j;
+
+    destination->timestamp.tv_sec = source->timestamp.tv_sec;
+    destination->timestamp.tv_nsec = source->timestamp.tv_nsec;
+    destination->sequence = source->seq;
+    destination->suppressed = source->suppressed;
+    for (i = 0; i < ACM_DIAG_COUNTER_COUNT; i++) {
+        destination->rules[i] = source->rules[i];
+        for (j = 0; j < ACM_MAX_LOOKUP_SIZE; j++)
+            destination->delta[i][j] = source->delta[i][j];
+    }
+}
+
+int __must_check status_read_diag_alarm(enum acm_module_id module_id,
+        struct acm_diag_alarm *alarm) {
+    struct acmdrv_diag_alarm packed;
+    char path_name[SYSFS_PATH_LENGTH];
+    int ret;
+
+    if (!alarm) {
+        LOGERR("Status: Invalid diagnostic alarm input");
+        return -EINVAL;
+    }
+
+    ret = diag_module_path_name(path_name, module_id, __stringify(ACM_SYSFS_DIAG_ALARM));
+    if (ret != 0)
+        return ret;
+
+    ret = read_buffer_sysfs_item(path_name, &packed, sizeof(packed), 0);
+    if (ret != 0) {
+        LOGERR("Status: problem reading data from file %s", path_name);
+        return ret;
+    }
+
+    convert_diag_alarm2unpacked(&packed, alarm);
+    return 0;
+}
+
 int __must_check status_set_diagnostics_poll_time(enum acm_module_id module_id,
         uint16_t interval_ms) {
     int ret;
@@ -363,3 +704,429 @@ int32_t __must_check calc_tick_duration() {
     tick_duration = 1E9 / time_freq; // multiply with 1E9 to get nanoseconds
     return tick_duration;
 }
+
+/**
+ * @brief read the schedule switch event of a module from an open sysfs file
+ */
+static int read_sched_switch_event(int fd, enum acm_module_id module_id,
+        struct acmdrv_sched_switch_event *event) {
+    ssize_t ret;
+
+    ret = pread(fd, event, sizeof(*event), sizeof(*event) * module_id);
+    if (ret < 0)
+        return -errno;
+    if (ret != sizeof(*event))
+        return -EIO;
+    return 0;
+}
+
+/**
+ * @brief deadline of a wait, timeout_ms from now
+ */
+static void init_deadline(struct timespec *deadline, int timeout_ms) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (timeout_ms % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+/**
+ * @brief remaining milliseconds until deadline, negative deadline means no limit
+ */
+static int remaining_msecs(const struct timespec *deadline, int timeout_ms) {
+    struct timespec now;
+    int64_t remaining;
+
+    if (timeout_ms < 0)
+        return -1;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    remaining = (deadline->tv_sec - now.tv_sec) * 1000
+            + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+    return remaining > 0 ? remaining : 0;
+}
+
+int __must_check status_wait_schedule_active(enum acm_module_id module_id, int timeout_ms,
+        struct acm_schedule_event *event) {
+    char path_name[SYSFS_PATH_LENGTH];
+    struct acmdrv_sched_switch_event sw_event;
+    struct timespec deadline;
+    struct pollfd pfd;
+    int ret, fd;
+
+    if (module_id >= ACM_MODULES_COUNT) {
+        LOGERR("Status: module_id out of range: %d", module_id);
+        return -EINVAL;
+    }
+
+    ret = sysfs_construct_path_name(path_name,
+            SYSFS_PATH_LENGTH,
+            __stringify(ACMDRV_SYSFS_CONFIG_GROUP),
+            __stringify(ACM_SYSFS_SCHED_SWITCH));
+    if (ret != 0)
+        return ret;
+
+    fd = open(path_name, O_RDONLY);
+    if (fd < 0) {
+        ret = -errno;
+        LOGERR("Status: open file %s failed", path_name);
+        return ret;
+    }
+
+    init_deadline(&deadline, timeout_ms);
+
+    pfd.fd = fd;
+    pfd.events = POLLPRI | POLLERR;
+
+    /*
+     * The driver notifies the file when a detection finished. The file has
+     * to be read before polling, otherwise a pending notification is lost.
+     */
+    for (;;) {
+        ret = read_sched_switch_event(fd, module_id, &sw_event);
+        if (ret < 0) {
+            LOGERR("Status: problem reading %s", path_name);
+            goto out;
+        }
+        if (!sw_event.pending && (sw_event.seq != 0))
+            break;
+
+        ret = poll(&pfd, 1, remaining_msecs(&deadline, timeout_ms));
+        if (ret < 0) {
+            ret = -errno;
+            if (ret == -EINTR)
+                continue;
+            LOGERR("Status: poll on %s failed", path_name);
+            goto out;
+        }
+        if (ret == 0) {
+            ret = -ETIMEDOUT;
+            goto out;
+        }
+    }
+
+    ret = (sw_event.status & ACMDRV_SCHED_TBL_STATUS_IN_USE) ? 0 : -ETIMEDOUT;
+    if (event) {
+        event->sequence = sw_event.seq;
+        event->table = sw_event.table;
+        event->active = !!(sw_event.status & ACMDRV_SCHED_TBL_STATUS_IN_USE);
+        event->last_cycle_reached =
+                !!(sw_event.status & ACMDRV_SCHED_TBL_STATUS_LAST_CYC_REACHED);
+        event->start.tv_sec = sw_event.start.tv_sec;
+        event->start.tv_nsec = sw_event.start.tv_nsec;
+        event->detected.tv_sec = sw_event.detected.tv_sec;
+        event->detected.tv_nsec = sw_event.detected.tv_nsec;
+        event->requested.tv_sec = sw_event.requested.tv_sec;
+        event->requested.tv_nsec = sw_event.requested.tv_nsec;
+        event->start_subns = sw_event.start_subns;
+        event->slip_ns = sw_event.slip;
+    }
+out:
+    close(fd);
+    return ret;
+}
+
+/**
+ * @brief arguments of a schedule wait thread
+ */
+struct schedule_wait {
+    enum acm_module_id module_id; /**< module to wait for */
+    int timeout_ms; /**< timeout in milliseconds */
+    acm_schedule_event_cb cb; /**< callback function */
+    void *arg; /**< callback argument */
+};
+
+/**
+ * @brief thread function of status_wait_schedule_active_async()
+ */
+static void *schedule_wait_thread(void *data) {
+    struct schedule_wait *wait = data;
+    struct acm_schedule_event event = { 0 };
+    int ret;
+
+    ret = status_wait_schedule_active(wait->module_id, wait->timeout_ms, &event);
+    wait->cb(wait->module_id, ret, &event, wait->arg);
+    acm_free(wait);
+    return NULL;
+}
+
+int __must_check status_wait_schedule_active_async(enum acm_module_id module_id,
+        int timeout_ms, acm_schedule_event_cb cb, void *arg) {
+    struct schedule_wait *wait;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int ret;
+
+    if (!cb) {
+        LOGERR("Status: no callback function for schedule wait");
+        return -EINVAL;
+    }
+
+    wait = acm_zalloc(sizeof(*wait));
+    if (!wait) {
+        LOGERR("Status: out of memory");
+        return -ENOMEM;
+    }
+    wait->module_id = module_id;
+    wait->timeout_ms = timeout_ms;
+    wait->cb = cb;
+    wait->arg = arg;
+
+    ret = pthread_attr_init(&attr);
+    if (ret == 0) {
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        ret = pthread_create(&thread, &attr, schedule_wait_thread, wait);
+        pthread_attr_destroy(&attr);
+    }
+    if (ret != 0) {
+        LOGERR("Status: creating schedule wait thread failed");
+        acm_free(wait);
+        return -ret;
+    }
+    return 0;
+}
+
+/**
+ * @brief check if a diagnostic threshold breach is pending
+ */
+static bool diag_alarm_pending(const struct acmdrv_diag_alarm *alarm) {
+    unsigned int i;
+
+    for (i = 0; i < ACMDRV_DIAG_COUNTER_COUNT; i++)
+        if (alarm->rules[i])
+            return true;
+    return false;
+}
+
+int __must_check status_wait_diag_alarm(enum acm_module_id module_id, int timeout_ms,
+        struct acm_diag_alarm *alarm) {
+    char path_name[SYSFS_PATH_LENGTH];
+    struct acmdrv_diag_alarm packed;
+    struct timespec deadline;
+    struct pollfd pfd;
+    ssize_t len;
+    int ret, fd;
+
+    ret = diag_module_path_name(path_name, module_id, __stringify(ACM_SYSFS_DIAG_ALARM));
+    if (ret != 0)
+        return ret;
+
+    fd = open(path_name, O_RDONLY);
+    if (fd < 0) {
+        ret = -errno;
+        LOGERR("Status: open file %s failed", path_name);
+        return ret;
+    }
+
+    init_deadline(&deadline, timeout_ms);
+    pfd.fd = fd;
+    pfd.events = POLLPRI | POLLERR;
+
+    /*
+     * The driver notifies the file on new breaches. The file has to be read
+     * before polling, otherwise a pending notification is lost.
+     */
+    for (;;) {
+        len = pread(fd, &packed, sizeof(packed), 0);
+        if (len != sizeof(packed)) {
+            ret = len < 0 ? -errno : -EIO;
+            LOGERR("Status: problem reading %s", path_name);
+            goto out;
+        }
+        if (diag_alarm_pending(&packed))
+            break;
+
+        ret = poll(&pfd, 1, remaining_msecs(&deadline, timeout_ms));
+        if (ret < 0) {
+            ret = -errno;
+            if (ret == -EINTR)
+                continue;
+            LOGERR("Status: poll on %s failed", path_name);
+            goto out;
+        }
+        if (ret == 0) {
+            ret = -ETIMEDOUT;
+            goto out;
+        }
+    }
+
+    ret = 0;
+    if (alarm)
+        convert_diag_alarm2unpacked(&packed, alarm);
+out:
+    close(fd);
+    return ret;
+}
+
+/**
+ * @brief check module id and construct the path of a failover file of the config group
+ */
+static int failover_path_name(char *path_name, enum acm_module_id module_id,
+        const char *file) {
+    if (module_id >= ACM_MODULES_COUNT) {
+        LOGERR("Status: module_id out of range: %d", module_id);
+        return -EINVAL;
+    }
+
+    return sysfs_construct_path_name(path_name,
+            SYSFS_PATH_LENGTH,
+            __stringify(ACMDRV_SYSFS_CONFIG_GROUP),
+            file);
+}
+
+int __must_check status_read_failover_policy(enum acm_module_id module_id,
+        struct acm_failover_policy *policy) {
+    struct acmdrv_failover_policy packed;
+    char path_name[SYSFS_PATH_LENGTH];
+    int ret;
+
+    if (!policy) {
+        LOGERR("Status: Invalid failover policy input");
+        return -EINVAL;
+    }
+
+    ret = failover_path_name(path_name, module_id, __stringify(ACM_SYSFS_FAILOVER_POLICY));
+    if (ret != 0)
+        return ret;
+
+    ret = read_buffer_sysfs_item(path_name, &packed, sizeof(packed),
+            sizeof(packed) * module_id);
+    if (ret != 0) {
+        LOGERR("Status: problem reading data from file %s", path_name);
+        return ret;
+    }
+
+    policy->link_down = packed.link_down;
+    policy->link_up = packed.link_up;
+    return 0;
+}
+
+int __must_check status_write_failover_policy(enum acm_module_id module_id,
+        const struct acm_failover_policy *policy) {
+    struct acmdrv_failover_policy packed;
+    char path_name[SYSFS_PATH_LENGTH];
+    int ret;
+
+    if (!policy || ((policy->link_down | policy->link_up) & ~ACMDRV_FAILOVER_ALL)) {
+        LOGERR("Status: Invalid failover policy input");
+        return -EINVAL;
+    }
+
+    ret = failover_path_name(path_name, module_id, __stringify(ACM_SYSFS_FAILOVER_POLICY));
+    if (ret != 0)
+        return ret;
+
+    packed.link_down = policy->link_down;
+    packed.link_up = policy->link_up;
+    return write_file_sysfs(path_name, &packed, sizeof(packed), sizeof(packed) * module_id);
+}
+
+/**
+ * @brief copy a link event from packed to unpacked structure
+ */
+static void convert_link_event2unpacked(const struct acmdrv_link_event *source,
+        struct acm_link_event *destination) {
+    destination->sequence = source->seq;
+    destination->link_up = !!source->link_up;
+    destination->actions = source->actions;
+    destination->msgbuf_invalid = source->msgbuf_invalid;
+    destination->duration_ns = source->duration;
+    destination->timestamp.tv_sec = source->timestamp.tv_sec;
+    destination->timestamp.tv_nsec = source->timestamp.tv_nsec;
+}
+
+int __must_check status_read_link_event(enum acm_module_id module_id,
+        struct acm_link_event *event) {
+    struct acmdrv_link_event packed;
+    char path_name[SYSFS_PATH_LENGTH];
+    int ret;
+
+    if (!event) {
+        LOGERR("Status: Invalid link event input");
+        return -EINVAL;
+    }
+
+    ret = failover_path_name(path_name, module_id, __stringify(ACM_SYSFS_LINK_EVENT));
+    if (ret != 0)
+        return ret;
+
+    ret = read_buffer_sysfs_item(path_name, &packed, sizeof(packed),
+            sizeof(packed) * module_id);
+    if (ret != 0) {
+        LOGERR("Status: problem reading data from file %s", path_name);
+        return ret;
+    }
+
+    convert_link_event2unpacked(&packed, event);
+    return 0;
+}
+
+int __must_check status_wait_link_event(enum acm_module_id module_id, int timeout_ms,
+        struct acm_link_event *event) {
+    char path_name[SYSFS_PATH_LENGTH];
+    struct acmdrv_link_event packed;
+    struct timespec deadline;
+    struct pollfd pfd;
+    uint32_t sequence = 0;
+    bool first = true;
+    ssize_t len;
+    int ret, fd;
+
+    ret = failover_path_name(path_name, module_id, __stringify(ACM_SYSFS_LINK_EVENT));
+    if (ret != 0)
+        return ret;
+
+    fd = open(path_name, O_RDONLY);
+    if (fd < 0) {
+        ret = -errno;
+        LOGERR("Status: open file %s failed", path_name);
+        return ret;
+    }
+
+    init_deadline(&deadline, timeout_ms);
+    pfd.fd = fd;
+    pfd.events = POLLPRI | POLLERR;
+
+    /*
+     * The sequence number read first identifies the event already reported.
+     * The file has to be read before polling, otherwise a pending
+     * notification is lost.
+     */
+    for (;;) {
+        len = pread(fd, &packed, sizeof(packed), sizeof(packed) * module_id);
+        if (len != sizeof(packed)) {
+            ret = len < 0 ? -errno : -EIO;
+            LOGERR("Status: problem reading %s", path_name);
+            goto out;
+        }
+        if (first) {
+            sequence = packed.seq;
+            first = false;
+        } else if (packed.seq != sequence) {
+            break;
+        }
+
+        ret = poll(&pfd, 1, remaining_msecs(&deadline, timeout_ms));
+        if (ret < 0) {
+            ret = -errno;
+            if (ret == -EINTR)
+                continue;
+            LOGERR("Status: poll on %s failed", path_name);
+            goto out;
+        }
+        if (ret == 0) {
+            ret = -ETIMEDOUT;
+            goto out;
+        }
+    }
+
+    ret = 0;
+    if (event)
+        convert_link_event2unpacked(&packed, event);
+out:
+    close(fd);
+    return ret;
+}
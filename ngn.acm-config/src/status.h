@@ -161,6 +161,18 @@ static const struct sysfs_status_subpath status_subpath[] = {
  * @brief filename for accessing diagnostic poll time
  */
 #define ACM_SYSFS_DIAG_POLL_TIME diag_poll_time
+/**
+ * @brief filename for accessing FRER statistics
+ */
+#define ACM_SYSFS_REDUND_STATS redund_stats
+/**
+ * @brief filename for accessing diagnostic counter thresholds
+ */
+#define ACM_SYSFS_DIAG_THRESHOLDS diag_thresholds
+/**
+ * @brief filename for accessing diagnostic threshold breaches
+ */
+#define ACM_SYSFS_DIAG_ALARM diag_alarm
 
 
 /**
@@ -214,6 +226,28 @@ int64_t __must_check status_read_buffer_locking_vector();
  */
 int64_t __must_check status_read_item(enum acm_module_id module_id, enum acm_status_item id);
 
+/**
+ * @ingroup acmstatusarea
+ * @brief Read all status items of the selected modules
+ *
+ * The function reads the status items of the selected modules into status. The files of
+ * the status items are opened on first use and kept open, so subsequent reads need a single
+ * pread() per item only. If reading a kept file fails, e.g. because the driver was reloaded,
+ * the file is reopened once.
+ *
+ * @param select combination of enum acm_status_select
+ * @param status address where the status items are stored
+ *
+ * @return 0 on success. Negative values represent an error.
+ */
+int __must_check status_read_all(uint32_t select, struct acm_status *status);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Close the files kept open by status_read_all()
+ */
+void status_close_items(void);
+
 /**
  * @ingroup acmdiagarea
  * @brief Set diagnostic poll cycle
@@ -246,6 +280,143 @@ int __must_check status_set_diagnostics_poll_time(enum acm_module_id module_id,
  */
 struct acm_diagnostic* __must_check status_read_diagnostics(enum acm_module_id module_id);
 
+/**
+ * @ingroup acmdiagarea
+ * @brief Read the FRER statistics
+ *
+ * The function reads the statistics of all redundancy table entries from the acm
+ * filesystem and converts them from HW format to external format.
+ *
+ * @param stats returns the statistics
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check status_read_redundancy_stats(struct acm_redundancy_stats *stats);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Reset the FRER statistics
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check status_reset_redundancy_stats(void);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Read the diagnostic counter thresholds of a module
+ *
+ * @param module_id identifier of the module
+ * @param thresholds returns the thresholds
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check status_read_diag_thresholds(enum acm_module_id module_id,
+        struct acm_diag_thresholds *thresholds);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Write the diagnostic counter thresholds of a module
+ *
+ * @param module_id identifier of the module
+ * @param thresholds thresholds to be written
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check status_write_diag_thresholds(enum acm_module_id module_id,
+        const struct acm_diag_thresholds *thresholds);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Read the diagnostic threshold breaches of a module
+ *
+ * Reading clears the breached stream-id bitmasks in the driver.
+ *
+ * @param module_id identifier of the module
+ * @param alarm returns the breaches
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check status_read_diag_alarm(enum acm_module_id module_id,
+        struct acm_diag_alarm *alarm);
+
+/**
+ * @ingroup acmdiagarea
+ * @brief Wait for a diagnostic threshold breach of a module
+ *
+ * The function reads the threshold breaches of the module from acm filesystem. As long as
+ * no breach is pending, it polls the file for the next notification of the driver.
+ *
+ * @param module_id identifier of the module to wait for
+ * @param timeout_ms maximum time to wait in milliseconds, negative values wait without limit
+ * @param alarm address where the breaches are stored, may be NULL
+ *
+ * @return 0 if a breach is pending, -ETIMEDOUT if not. Other negative values represent an
+ * error.
+ */
+int __must_check status_wait_diag_alarm(enum acm_module_id module_id, int timeout_ms,
+        struct acm_diag_alarm *alarm);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Read the failover policy of a module
+ *
+ * @param module_id identifier of the module
+ * @param policy returns the policy
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check status_read_failover_policy(enum acm_module_id module_id,
+        struct acm_failover_policy *policy);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Write the failover policy of a module
+ *
+ * @param module_id identifier of the module
+ * @param policy policy to be written
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check status_write_failover_policy(enum acm_module_id module_id,
+        const struct acm_failover_policy *policy);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Read the last link event of a module
+ *
+ * @param module_id identifier of the module
+ * @param event returns the link event
+ *
+ * @return The function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check status_read_link_event(enum acm_module_id module_id,
+        struct acm_link_event *event);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Wait for the next link event of a module
+ *
+ * The function reads the link event of the module from acm filesystem and polls the file
+ * until the driver reports an event with a new sequence number.
+ *
+ * @param module_id identifier of the module to wait for
+ * @param timeout_ms maximum time to wait in milliseconds, negative values wait without limit
+ * @param event address where the link event is stored, may be NULL
+ *
+ * @return 0 if a link event has been reported, -ETIMEDOUT if not. Other negative values
+ * represent an error.
+ */
+int __must_check status_wait_link_event(enum acm_module_id module_id, int timeout_ms,
+        struct acm_link_event *event);
+
 /**
  * @ingroup acmstatusarea
  * @brief Read a specific capability item of the system
@@ -270,6 +441,37 @@ int32_t __must_check status_read_capability_item(enum acm_capability_item id);
  */
 int64_t __must_check status_read_time_freq(void);
 
+/**
+ * @ingroup acmstatusarea
+ * @brief Wait until the last applied schedule is active
+ *
+ * The function reads the schedule switch event of the module from acm filesystem. As long as
+ * the driver did not finish the switch detection, it polls the file for the next event.
+ *
+ * @param module_id identifier of the module to wait for
+ * @param timeout_ms maximum time to wait in milliseconds, negative values wait without limit
+ * @param event address where the switch event is stored, may be NULL
+ *
+ * @return 0 if the schedule is active, -ETIMEDOUT if not. Other negative values represent an
+ * error.
+ */
+int __must_check status_wait_schedule_active(enum acm_module_id module_id, int timeout_ms,
+        struct acm_schedule_event *event);
+
+/**
+ * @ingroup acmstatusarea
+ * @brief Wait until the last applied schedule is active in a separate thread
+ *
+ * @param module_id identifier of the module to wait for
+ * @param timeout_ms maximum time to wait in milliseconds, negative values wait without limit
+ * @param cb callback function called with the result of status_wait_schedule_active()
+ * @param arg argument passed to the callback function
+ *
+ * @return 0 if the thread has been started. Negative values represent an error.
+ */
+int __must_check status_wait_schedule_active_async(enum acm_module_id module_id,
+        int timeout_ms, acm_schedule_event_cb cb, void *arg);
+
 /**
  * @ingroup acmstatusarea
  * @brief Read status item of type int32
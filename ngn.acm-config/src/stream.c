@@ -47,7 +47,7 @@ struct acm_stream __must_check* stream_create(enum stream_type type) {
         return NULL;
     }
 
-    stream = acm_zalloc(sizeof (*stream));
+    stream = acm_arena_zalloc(ACM_ARENA_STREAM);
 
     if (!stream) {
         LOGERR("Stream: Out of memory");
@@ -61,7 +61,7 @@ struct acm_stream __must_check* stream_create(enum stream_type type) {
     ret = operation_list_init(&stream->operations);
     if (ret != 0) {
         LOGERR("Stream: Could not initialize operation list");
-        acm_free(stream);
+        acm_arena_free(ACM_ARENA_STREAM, stream);
         return NULL;
     }
 
@@ -69,7 +69,7 @@ struct acm_stream __must_check* stream_create(enum stream_type type) {
     if (ret != 0) {
         LOGERR("Stream: Could not initialize schedule list");
         operation_list_flush(&stream->operations);
-        acm_free(stream);
+        acm_arena_free(ACM_ARENA_STREAM, stream);
         return NULL;
     }
     TRACE2_EXIT();
@@ -118,7 +118,7 @@ void stream_destroy(struct acm_stream *stream) {
     schedule_list_flush(&stream->windows);
     lookup_destroy(stream->lookup);
 
-    acm_free(stream);
+    acm_arena_free(ACM_ARENA_STREAM, stream);
     TRACE3_EXIT();
 }
 
@@ -373,7 +373,7 @@ int __must_check stream_set_egress_header(struct acm_stream *stream,
         ETHER_ADDR_LEN);
     ret = stream_add_operation(stream, operation_dmac);
     if (ret < 0) {
-        acm_free(operation_dmac);
+        operation_destroy(operation_dmac);
         return ret;
     }
 
@@ -401,8 +401,8 @@ int __must_check stream_set_egress_header(struct acm_stream *stream,
     if (ret < 0) {
         /* take out operations of operation_list and release memory */
         operation_list_remove_operation(&stream->operations, operation_dmac);
-        acm_free(operation_dmac);
-        acm_free(operation_smac);
+        operation_destroy(operation_dmac);
+        operation_destroy(operation_smac);
         return ret;
     }
 
@@ -417,8 +417,8 @@ int __must_check stream_set_egress_header(struct acm_stream *stream,
             /* take out operations of operation_list and release memory */
             operation_list_remove_operation(&stream->operations, operation_dmac);
             operation_list_remove_operation(&stream->operations, operation_smac);
-            acm_free(operation_dmac);
-            acm_free(operation_smac);
+            operation_destroy(operation_dmac);
+            operation_destroy(operation_smac);
             return -EINVAL;
         }
     } else
@@ -428,9 +428,9 @@ int __must_check stream_set_egress_header(struct acm_stream *stream,
         /* take out operations of operation_list and release memory */
         operation_list_remove_operation(&stream->operations, operation_dmac);
         operation_list_remove_operation(&stream->operations, operation_smac);
-        acm_free(operation_dmac);
-        acm_free(operation_smac);
-        acm_free(operation_vlan);
+        operation_destroy(operation_dmac);
+        operation_destroy(operation_smac);
+        operation_destroy(operation_vlan);
         return ret;
     }
 
@@ -37,6 +37,76 @@
 #include "memory.h"
 #include "buffer.h"
 #include "status.h"
+#include "capacity.h"
+
+/**
+ * @brief first file descriptor value handed out while writes are hooked
+ */
+#define SYSFS_HOOK_FD_BASE 0x40000000
+/**
+ * @brief number of files which can be opened at the same time while writes are hooked
+ */
+#define SYSFS_HOOK_FILES 4
+
+/**
+ * @brief redirection of configuration writes of the calling thread
+ * @{
+ */
+static __thread sysfs_write_hook write_hook;
+static __thread void *write_hook_arg;
+static __thread const char *write_hook_files[SYSFS_HOOK_FILES];
+/** @} */
+
+void sysfs_set_write_hook(sysfs_write_hook hook, void *arg) {
+    write_hook = hook;
+    write_hook_arg = arg;
+    memset(write_hook_files, 0, sizeof (write_hook_files));
+}
+
+static bool sysfs_hook_fd(int fd) {
+    return write_hook && (fd >= SYSFS_HOOK_FD_BASE) &&
+            (fd < SYSFS_HOOK_FD_BASE + SYSFS_HOOK_FILES);
+}
+
+static int sysfs_open_write(const char *path_name) {
+    int i;
+
+    if (!write_hook)
+        return open(path_name, O_WRONLY | O_DSYNC);
+
+    /* path_name stays valid until the file is closed again */
+    for (i = 0; i < SYSFS_HOOK_FILES; i++) {
+        if (!write_hook_files[i]) {
+            write_hook_files[i] = path_name;
+            return SYSFS_HOOK_FD_BASE + i;
+        }
+    }
+    errno = EMFILE;
+    return -1;
+}
+
+static ssize_t sysfs_pwrite(int fd, const void *buffer, size_t length, off_t offset) {
+    int ret;
+
+    if (!sysfs_hook_fd(fd))
+        return pwrite(fd, buffer, length, offset);
+
+    ret = write_hook(write_hook_arg, write_hook_files[fd - SYSFS_HOOK_FD_BASE], buffer,
+            length, offset);
+    if (ret < 0) {
+        errno = -ret;
+        return -1;
+    }
+    return length;
+}
+
+static void sysfs_close(int fd) {
+    if (sysfs_hook_fd(fd)) {
+        write_hook_files[fd - SYSFS_HOOK_FD_BASE] = NULL;
+        return;
+    }
+    close(fd);
+}
 
 int __must_check read_buffer_sysfs_item(const char *path_name,
         void *buffer,
@@ -110,16 +180,16 @@ int __must_check write_file_sysfs(const char *path_name,
 
     TRACE2_ENTER();
     /* open file */
-    fd = open(path_name, O_WRONLY | O_DSYNC);
+    fd = sysfs_open_write(path_name);
     if (fd < 0) {
         LOGERR("Sysfs: open file %s failed", path_name);
         TRACE2_MSG("Fail");
         return -errno;
     }
     /* write file */
-    ret = pwrite(fd, buffer, buffer_length, offset);
+    ret = sysfs_pwrite(fd, buffer, buffer_length, offset);
     /* close file */
-    close(fd);
+    sysfs_close(fd);
 
     /* check success of write data */
     if (ret < 0) {
@@ -206,7 +276,7 @@ int __must_check create_event_sysfs_items(struct schedule_entry *schedule_item,
         }
 
         /* request memory */
-        fsc_schedule = acm_zalloc(sizeof (*fsc_schedule));
+        fsc_schedule = acm_arena_zalloc(ACM_ARENA_FSC_COMMAND);
         if (!fsc_schedule) {
             LOGERR("Sysfs: Out of memory");
             TRACE2_MSG("Fail");
@@ -253,7 +323,7 @@ int __must_check create_window_sysfs_items(struct schedule_entry *schedule_item,
 
         //create start window item
         /* request memory */
-        fsc_schedule = acm_zalloc(sizeof (*fsc_schedule));
+        fsc_schedule = acm_arena_zalloc(ACM_ARENA_FSC_COMMAND);
         if (!fsc_schedule) {
             LOGERR("Sysfs: Out of memory");
             TRACE2_MSG("Fail");
@@ -276,7 +346,7 @@ int __must_check create_window_sysfs_items(struct schedule_entry *schedule_item,
                         + module->module_delays[speed].ser_switch) / tick_duration;
                 break;
             default:
-                acm_free(fsc_schedule);
+                acm_arena_free(ACM_ARENA_FSC_COMMAND, fsc_schedule);
                 LOGERR("Sysfs: connection mode has undefined value: %d", module->mode);
                 TRACE2_MSG("Fail");
                 return -EACMINTERNAL;
@@ -300,7 +370,7 @@ int __must_check create_window_sysfs_items(struct schedule_entry *schedule_item,
 
         // create end window item
         /* request memory */
-        fsc_schedule = acm_zalloc(sizeof (*fsc_schedule));
+        fsc_schedule = acm_arena_zalloc(ACM_ARENA_FSC_COMMAND);
         if (!fsc_schedule) {
             LOGERR("Sysfs: Out of memory");
             TRACE2_MSG("Fail");
@@ -388,7 +458,7 @@ STATIC int write_fsc_nop_command(int fd,
     false, false, false, false);
     local_fsc.delta_cycle = delta_cycle;
     local_fsc.padding = 0;
-    ret = pwrite(fd,
+    ret = sysfs_pwrite(fd,
             &local_fsc,
             sizeof (local_fsc),
             (ACMDRV_SCHED_TBL_ROW_COUNT * module_index * ACMDRV_SCHED_TBL_COUNT +
@@ -509,7 +579,7 @@ int __must_check write_fsc_schedules_to_HW(struct acm_module *module, int table_
     }
 
     // open file
-    fd = open(path_name, O_WRONLY | O_DSYNC);
+    fd = sysfs_open_write(path_name);
     if (fd < 0) {
         LOGERR("Sysfs: open file %s failed", path_name);
         TRACE2_MSG("Fail");
@@ -584,7 +654,7 @@ int __must_check write_fsc_schedules_to_HW(struct acm_module *module, int table_
             }
             local_fsc.cmd = previous_item->hw_schedule_item.cmd;
             local_fsc.padding = 0;
-            ret = pwrite(fd,
+            ret = sysfs_pwrite(fd,
                     (char*) &local_fsc,
                     sizeof (local_fsc),
                     (ACMDRV_SCHED_TBL_ROW_COUNT * module->module_id * ACMDRV_SCHED_TBL_COUNT +
@@ -632,7 +702,7 @@ int __must_check write_fsc_schedules_to_HW(struct acm_module *module, int table_
         }
         local_fsc.cmd = previous_item->hw_schedule_item.cmd;
         local_fsc.delta_cycle = ANZ_MIN_TICKS;
-        ret = pwrite(fd,
+        ret = sysfs_pwrite(fd,
                 (char*) &local_fsc,
                 sizeof (local_fsc),
                 (ACMDRV_SCHED_TBL_ROW_COUNT * module->module_id * ACMDRV_SCHED_TBL_COUNT +
@@ -647,7 +717,7 @@ int __must_check write_fsc_schedules_to_HW(struct acm_module *module, int table_
     end:
     ACMLIST_UNLOCK(fsc_list);
     // close file
-    close(fd);
+    sysfs_close(fd);
     TRACE2_EXIT();
     return ret;
 }
@@ -669,7 +739,7 @@ int __must_check write_module_schedules_to_HW(struct acm_module *module, int tab
         goto out;
 
     // open file
-    fd = open(path_name, O_WRONLY | O_DSYNC);
+    fd = sysfs_open_write(path_name);
     if (fd < 0) {
         LOGERR("Sysfs: open file %s failed", path_name);
         TRACE2_MSG("Fail");
@@ -678,8 +748,8 @@ int __must_check write_module_schedules_to_HW(struct acm_module *module, int tab
     }
     // write cycle time
     cycle_time.ns = module->cycle_ns;
-    cycle_time.subns = 0;
-    ret = pwrite(fd,
+    cycle_time.subns = module->cycle_subns;
+    ret = sysfs_pwrite(fd,
             (char *) &cycle_time,
             sizeof (cycle_time),
             (module->module_id * ACMDRV_SCHED_TBL_COUNT + table_index) * sizeof (cycle_time));
@@ -690,7 +760,7 @@ int __must_check write_module_schedules_to_HW(struct acm_module *module, int tab
         goto out_close;
     }
     // close file
-    close(fd);
+    sysfs_close(fd);
 
     // WRITE MODULE START TIME
     /* construct path name */
@@ -702,7 +772,7 @@ int __must_check write_module_schedules_to_HW(struct acm_module *module, int tab
         goto out;
 
     // open file
-    fd = open(path_name, O_WRONLY | O_DSYNC);
+    fd = sysfs_open_write(path_name);
     if (fd < 0) {
         LOGERR("Sysfs: open file %s failed", path_name);
         TRACE2_MSG("Fail");
@@ -712,7 +782,7 @@ int __must_check write_module_schedules_to_HW(struct acm_module *module, int tab
     // write schedule start time
     start_time.tv_nsec = module->start.tv_nsec;
     start_time.tv_sec = module->start.tv_sec;
-    ret = pwrite(fd,
+    ret = sysfs_pwrite(fd,
             (char *) &start_time,
             sizeof (start_time),
             (module->module_id * ACMDRV_SCHED_TBL_COUNT + table_index) * sizeof (start_time));
@@ -723,18 +793,28 @@ int __must_check write_module_schedules_to_HW(struct acm_module *module, int tab
 
     // close file
 out_close:
-    close(fd);
+    sysfs_close(fd);
 out:
     TRACE2_EXIT();
     return ret;
 }
 
 int __must_check sysfs_read_schedule_status(struct acm_module *module, int *free_table) {
+    return sysfs_read_free_schedule_table(module->module_id, free_table);
+}
+
+int __must_check sysfs_read_free_schedule_table(enum acm_module_id module_id, int *free_table) {
     char path_name[SYSFS_PATH_LENGTH];
     struct acmdrv_sched_tbl_status sched_status[ACMDRV_SCHED_TBL_COUNT];
     int ret, fd, i, can_be_used, status_in_use;
 
     TRACE2_ENTER();
+    /* recorded schedules are moved to a free table when they are replayed */
+    if (write_hook) {
+        *free_table = 0;
+        TRACE2_EXIT();
+        return 0;
+    }
     /* construct path name */
     ret = sysfs_construct_path_name(path_name,
             SYSFS_PATH_LENGTH,
@@ -755,7 +835,7 @@ int __must_check sysfs_read_schedule_status(struct acm_module *module, int *free
     ret = pread(fd,
             (char *) &sched_status,
             sizeof (sched_status),
-            sizeof (sched_status) * module->module_id);
+            sizeof (sched_status) * module_id);
     close(fd);
 
     if (ret < 0) {
@@ -882,6 +962,15 @@ int __must_check sysfs_write_config_status_to_HW(enum acmdrv_status status) {
             0);
 }
 
+int __must_check sysfs_write_config_modules(uint32_t modules) {
+
+    TRACE2_MSG("Executing");
+    return write_buffer_config_sysfs_item(__stringify(ACM_SYSFS_CONFIG_MODULES),
+            (char*) &modules,
+            sizeof (modules),
+            0);
+}
+
 int __must_check sysfs_write_module_enable(struct acm_module *module, bool enable) {
     uint32_t enable_value;
 
@@ -897,10 +986,11 @@ int __must_check sysfs_write_data_constant_buffer(struct acm_module *module) {
     struct acmdrv_bypass_const_buffer constant_buffer;
     struct acm_stream *stream;
     struct operation *operation;
-    unsigned int offset = 0;
+    uint16_t used = 0;
+    int offset = 0;
 
     TRACE2_ENTER();
-    memset(&constant_buffer.data[offset], 0, sizeof (constant_buffer.data));
+    memset(&constant_buffer.data[0], 0, sizeof (constant_buffer.data));
     // iterate through all streams of the module
     ACMLIST_LOCK(&module->streams);
     ACMLIST_FOREACH(stream, &module->streams, entry)
@@ -911,16 +1001,26 @@ int __must_check sysfs_write_data_constant_buffer(struct acm_module *module) {
         ACMLIST_FOREACH(operation, oplist, entry)
         {
             if (operation->opcode == INSERT_CONSTANT) {
-                /* in case of operation insert_constant: write data from operation to
-                 * constant Buffer and write offset in constant buffer to operation */
-                memcpy(&constant_buffer.data[offset], operation->data, operation->data_size);
+                /* in case of operation insert_constant: place data from operation in
+                 * constant Buffer, sharing equal data of other operations, and write
+                 * offset in constant buffer to operation */
+                offset = capacity_place_constant(constant_buffer.data, &used,
+                        (uint8_t*) operation->data, operation->data_size);
+                if (offset < 0)
+                    break;
                 operation->const_buff_offset = offset;
-                offset = offset + operation->data_size;
             }
         }
         ACMLIST_UNLOCK(oplist);
+        if (offset < 0)
+            break;
     }
     ACMLIST_UNLOCK(&module->streams);
+    if (offset < 0) {
+        LOGERR("Sysfs: constant data does not fit into constant buffer");
+        TRACE2_MSG("Fail");
+        return offset;
+    }
 
     TRACE2_EXIT();
     return write_buffer_config_sysfs_item(__stringify(ACM_SYSFS_CONST_BUFFER),
@@ -1650,6 +1750,12 @@ exit:
 
 int __must_check sysfs_write_msg_buff_to_HW(struct buffer_list *bufferlist,
         enum buff_table_type buff_table) {
+    return sysfs_write_msg_buff_mask_to_HW(bufferlist, buff_table, UINT32_MAX);
+}
+
+int __must_check sysfs_write_msg_buff_mask_to_HW(struct buffer_list *bufferlist,
+        enum buff_table_type buff_table,
+        uint32_t mask) {
     char path_name[SYSFS_PATH_LENGTH];
     struct sysfs_buffer *buffer;
     uint32_t descriptor;
@@ -1677,7 +1783,7 @@ int __must_check sysfs_write_msg_buff_to_HW(struct buffer_list *bufferlist,
     }
 
     // open file
-    fd = open(path_name, O_WRONLY | O_DSYNC);
+    fd = sysfs_open_write(path_name);
     if (fd < 0) {
         LOGERR("Sysfs: open file %s failed", path_name);
         TRACE2_MSG("Fail");
@@ -1688,6 +1794,8 @@ int __must_check sysfs_write_msg_buff_to_HW(struct buffer_list *bufferlist,
     ACMLIST_LOCK(bufferlist);
     ACMLIST_FOREACH(buffer, bufferlist, entry)
     {
+        if (!(mask & (1U << buffer->msg_buff_index)))
+            continue;
         if (buff_table == BUFF_DESC) {
             descriptor = acmdrv_buff_desc_create(buffer->msg_buff_offset,
                     buffer->reset,
@@ -1708,7 +1816,7 @@ int __must_check sysfs_write_msg_buff_to_HW(struct buffer_list *bufferlist,
             hw_item = (char*) &alias;
             item_size = sizeof (alias);
         }
-        ret = pwrite(fd, hw_item, item_size, buffer->msg_buff_index * item_size);
+        ret = sysfs_pwrite(fd, hw_item, item_size, buffer->msg_buff_index * item_size);
         if (ret < 0) {
             LOGERR("Sysfs: problem writing to %s ", path_name);
             ret = -errno;
@@ -1720,7 +1828,70 @@ int __must_check sysfs_write_msg_buff_to_HW(struct buffer_list *bufferlist,
 
     ACMLIST_UNLOCK(bufferlist);
     // close file
-    close(fd);
+    sysfs_close(fd);
+
+    TRACE2_EXIT();
+    return ret;
+}
+
+int __must_check sysfs_check_msg_buff_on_HW(struct buffer_list *bufferlist, uint32_t mask) {
+    char desc_path[SYSFS_PATH_LENGTH];
+    char alias_path[SYSFS_PATH_LENGTH];
+    struct sysfs_buffer *buffer;
+    uint32_t descriptor, hw_descriptor;
+    struct acmdrv_buff_alias hw_alias;
+    int ret;
+
+    TRACE2_ENTER();
+    ret = sysfs_construct_path_name(desc_path,
+            SYSFS_PATH_LENGTH,
+            __stringify(ACMDRV_SYSFS_CONFIG_GROUP),
+            __stringify(ACM_SYSFS_MSGBUFF_DESC));
+    if (ret == 0)
+        ret = sysfs_construct_path_name(alias_path,
+                SYSFS_PATH_LENGTH,
+                __stringify(ACMDRV_SYSFS_CONFIG_GROUP),
+                __stringify(ACM_SYSFS_MSGBUFF_ALIAS));
+    if (ret < 0) {
+        TRACE2_MSG("Fail");
+        return ret;
+    }
+
+    ACMLIST_LOCK(bufferlist);
+    ACMLIST_FOREACH(buffer, bufferlist, entry)
+    {
+        if (!(mask & (1U << buffer->msg_buff_index)))
+            continue;
+
+        descriptor = acmdrv_buff_desc_create(buffer->msg_buff_offset,
+                buffer->reset,
+                buffer->stream_direction,
+                buffer->buff_size,
+                buffer->timestamp,
+                buffer->valid);
+        hw_descriptor = 0;
+        ret = read_buffer_sysfs_item(desc_path, &hw_descriptor, sizeof (hw_descriptor),
+                buffer->msg_buff_index * sizeof (hw_descriptor));
+        if (ret < 0)
+            break;
+        /* inactive message buffers read an empty alias */
+        memset(&hw_alias, 0, sizeof (hw_alias));
+        ret = read_buffer_sysfs_item(alias_path, &hw_alias, sizeof (hw_alias),
+                buffer->msg_buff_index * sizeof (hw_alias));
+        if (ret < 0)
+            break;
+
+        if ((descriptor != hw_descriptor)
+                || (hw_alias.idx != buffer->msg_buff_index)
+                || (strncmp(hw_alias.alias, buffer->msg_buff_name,
+                        sizeof (hw_alias.alias)) != 0)) {
+            LOGGING_INFO("Sysfs: message buffer %s differs from hardware",
+                    buffer->msg_buff_name);
+            ret = -EBUSY;
+            break;
+        }
+    }
+    ACMLIST_UNLOCK(bufferlist);
 
     TRACE2_EXIT();
     return ret;
@@ -63,9 +63,13 @@ int __must_check write_fsc_nop_command(int fd, uint32_t delta_cycle, enum acm_mo
 #define ACM_SYSFS_SCHED_CYCLE sched_cycle_time
 #define ACM_SYSFS_SCHED_START sched_start_table
 #define ACM_SYSFS_SCHED_STATUS table_status
+#define ACM_SYSFS_SCHED_SWITCH sched_switch_event
 #define ACM_SYSFS_EMERGENCY emergency_disable
+#define ACM_SYSFS_FAILOVER_POLICY failover_policy
+#define ACM_SYSFS_LINK_EVENT link_event
 #define ACM_SYSFS_CONN_MODE cntl_connection_mode
 #define ACM_SYSFS_CONFIG_STATE config_state
+#define ACM_SYSFS_CONFIG_MODULES config_modules
 #define ACM_SYSFS_MODULE_ENABLE cntl_ngn_enable
 #define ACM_SYSFS_CLEAR_ALL_FPGA clear_all_fpga
 
@@ -222,6 +226,34 @@ int __must_check write_file_sysfs(const char *path_name,
         size_t buffer_length,
         off_t offset);
 
+/**
+ * @brief Function receiving redirected configuration writes
+ *
+ * @param arg argument given to sysfs_set_write_hook()
+ * @param path_name path and filename the data would have been written to
+ * @param buffer data to be written
+ * @param buffer_length number of bytes to be written
+ * @param offset offset where to start to write
+ *
+ * @return 0 in case of success. Negative values represent an error.
+ */
+typedef int (*sysfs_write_hook)(void *arg,
+        const char *path_name,
+        const void *buffer,
+        size_t buffer_length,
+        off_t offset);
+
+/** @brief Redirect writes to the acm filesystem
+ *
+ * While a hook is set, all writes of the calling thread to the acm filesystem are passed to the
+ * hook instead of the hardware. Schedules are written to schedule table 0 of a module, as
+ * the status of the schedule tables is not read. This is used to record a configuration image.
+ *
+ * @param hook function receiving the writes, NULL to write to hardware again
+ * @param arg argument passed to the hook
+ */
+void sysfs_set_write_hook(sysfs_write_hook hook, void *arg);
+
 /** @brief Delete content of a file in  acm filesystem
  *
  * The function deletes the content of the file specified in parameter path_name. Afterwards the
@@ -370,6 +402,20 @@ int __must_check write_module_schedules_to_HW(struct acm_module *module, int tab
  */
 int __must_check sysfs_read_schedule_status(struct acm_module *module, int *free_table);
 
+/**
+ * @brief Find free schedule table of a module
+ *
+ * Same as sysfs_read_schedule_status(), but the module is given by its identity.
+ *
+ * @param module_id identity of the module
+ * @param free_table in case of success index of the HW schedule table which is free and can be
+ *          used for a new schedule.
+ *
+ * @return the function will return 0 in case of success. Negative values represent
+ * an error.
+ */
+int __must_check sysfs_read_free_schedule_table(enum acm_module_id module_id, int *free_table);
+
 /**
  * @brief Read configuration id from hardware
  *
@@ -407,6 +453,20 @@ int __must_check sysfs_write_configuration_id(int32_t identifier);
  */
 int __must_check sysfs_write_config_status_to_HW(enum acmdrv_status status);
 
+/**
+ * @brief Write modules of the next configuration session to hardware
+ *
+ * The function writes the bit mask of the modules, which are affected by the next
+ * configuration session, to the provided file in acm filesystem. If not all modules are
+ * selected, the driver only cleans up the selected modules at start of the configuration
+ * session while the other module keeps running.
+ *
+ * @param modules bit mask of modules (bit n for module n)
+ *
+ * @return The function will return 0 in case of success. Negative values represent an error.
+ */
+int __must_check sysfs_write_config_modules(uint32_t modules);
+
 /**
  * @brief Write emergency disable value to hardware
  *
@@ -453,7 +513,8 @@ int __must_check sysfs_write_module_enable(struct acm_module *module, bool enabl
  * with operation code INSERT_CONSTANT it writes the constant data from the operation to the
  * provided file in acm filesystem.
  * The function also determines the offset of the constant operation data in the constant buffer
- * on hardware and stores the offset in the operation data.
+ * on hardware and stores the offset in the operation data. Equal constant data of several
+ * operations is stored once only (see capacity_place_constant()).
  *
  * @param module address of the module which constant data shall be written
  *
@@ -646,6 +707,38 @@ int __must_check check_buff_name_against_sys_devices(const char *buffer_name);
 int __must_check sysfs_write_msg_buff_to_HW(struct buffer_list *bufferlist,
         enum buff_table_type buff_table);
 
+/**
+ * @brief Write message buffer data of selected message buffers to hardware
+ *
+ * Same as sysfs_write_msg_buff_to_HW, but only the message buffers whose index is set in
+ * mask are written.
+ *
+ * @param bufferlist pointer to the list of message buffers for which data shall be written to HW
+ * @param buff_table specifies which of the buffer tables shall be written: buffer descriptors
+ *          table or buffer aliases table
+ * @param mask bit mask of message buffer indexes to be written
+ *
+ * @return The function will return 0 in case of success. Negative values indicate an error.
+ */
+int __must_check sysfs_write_msg_buff_mask_to_HW(struct buffer_list *bufferlist,
+        enum buff_table_type buff_table,
+        uint32_t mask);
+
+/**
+ * @brief Check message buffers against hardware
+ *
+ * The function reads the buffer descriptors and buffer aliases of the message buffers whose
+ * index is set in mask from the hardware and compares them with the data of the respective
+ * message buffers in bufferlist.
+ *
+ * @param bufferlist pointer to the list of message buffers
+ * @param mask bit mask of message buffer indexes to be checked
+ *
+ * @return The function will return 0 if all checked message buffers are configured identically
+ *      on the hardware, -EBUSY if not. Other negative values indicate an error.
+ */
+int __must_check sysfs_check_msg_buff_on_HW(struct buffer_list *bufferlist, uint32_t mask);
+
 /**
  * @brief Write buffer locking mask to hardware
  *
@@ -27,6 +27,8 @@
 #include "hwconfig_def.h"
 #include "sysfs.h"
 #include "status.h"
+#include "netdev.h"
+#include "capacity.h"
 
 int __must_check validate_stream(struct acm_stream *stream, bool final_validate) {
     int ret;
@@ -189,17 +191,15 @@ int __must_check validate_module(struct acm_module *module, bool final_validate)
             TRACE2_MSG("Fail");
             return ret;
         }
+        /* port state does not prevent applying the configuration, only warn */
+        netdev_check_link(module->module_id, module->speed);
     }
 
     // following checks have to be done for final and non final validation
     streamlist = &module->streams;
 
     // Total constant message buffer size per module <= 4096
-    sum_const_buffer = 0;
-    ACMLIST_LOCK(streamlist);
-    ACMLIST_FOREACH(stream, streamlist, entry)
-        sum_const_buffer = sum_const_buffer + stream_sum_const_buffer(stream);
-    ACMLIST_UNLOCK(streamlist);
+    sum_const_buffer = module_sum_const_buffer(module);
     if (sum_const_buffer > ACM_MAX_CONST_BUFFER_SIZE) {
         LOGERR("Validate: constant message buffer %d too long", sum_const_buffer);
         TRACE2_MSG("Fail");
@@ -487,6 +487,125 @@ int __must_check stream_sum_const_buffer(struct acm_stream *stream) {
     return sum_constant_buffer_size;
 }
 
+int __must_check module_sum_const_buffer(struct acm_module *module) {
+    uint8_t buffer[ACM_MAX_CONST_BUFFER_SIZE];
+    struct acm_stream *stream;
+    struct operation *operation;
+    uint16_t used = 0;
+    int unplaced = 0;
+
+    TRACE3_ENTER();
+    if (!module) {
+        TRACE3_EXIT();
+        return 0;
+    }
+    ACMLIST_LOCK(&module->streams);
+    ACMLIST_FOREACH(stream, &module->streams, entry)
+    {
+        struct operation_list *oplist = &stream->operations;
+
+        ACMLIST_LOCK(oplist);
+        ACMLIST_FOREACH(operation, oplist, entry)
+        {
+            if (operation->opcode != INSERT_CONSTANT)
+                continue;
+            /* data not fitting anymore is counted unshared */
+            if (operation->data && (operation->data_size == operation->length)
+                    && (capacity_place_constant(buffer, &used, (uint8_t*) operation->data,
+                            operation->data_size) >= 0))
+                continue;
+            unplaced = unplaced + operation->length;
+        }
+        ACMLIST_UNLOCK(oplist);
+    }
+    ACMLIST_UNLOCK(&module->streams);
+    TRACE3_MSG("calculated buffer-size is %d", used + unplaced);
+    TRACE3_EXIT();
+    return used + unplaced;
+}
+
+/**
+ * @brief check if two lookups match the same frames
+ */
+static bool lookup_conflict(const struct lookup *a, const struct lookup *b) {
+    size_t i;
+
+    if (!a || !b || (a->filter_size != b->filter_size))
+        return false;
+    for (i = 0; i < ACM_MAX_LOOKUP_SIZE; i++) {
+        if ( (a->header_mask[i] != b->header_mask[i])
+                || ( (a->header[i] & a->header_mask[i]) != (b->header[i] & b->header_mask[i])))
+            return false;
+    }
+    for (i = 0; i < a->filter_size; i++) {
+        if ( (a->filter_mask[i] != b->filter_mask[i])
+                || ( (a->filter_pattern[i] & a->filter_mask[i])
+                        != (b->filter_pattern[i] & b->filter_mask[i])))
+            return false;
+    }
+    return true;
+}
+
+int __must_check module_get_usage(struct acm_module *module, struct acm_module_usage *usage) {
+    struct acm_stream *stream, *other;
+    int sum_const_buffer;
+
+    TRACE2_ENTER();
+    if (!module || !usage) {
+        LOGERR("Validate: Invalid module usage input");
+        TRACE2_MSG("Fail");
+        return -EINVAL;
+    }
+
+    memset(usage, 0, sizeof (*usage));
+    usage->lookup_rules.used = LOOKUP_START_IDX;
+    usage->lookup_rules.capacity = ACM_MAX_LOOKUP_ITEMS;
+    usage->scatter_dma.used = SCATTER_START_IDX;
+    usage->scatter_dma.capacity = ACM_MAX_INGRESS_OPERATIONS;
+    usage->gather_dma.used = GATHER_START_IDX;
+    usage->gather_dma.capacity = ACM_MAX_EGRESS_OPERATIONS;
+    usage->const_buffer.capacity = ACM_MAX_CONST_BUFFER_SIZE;
+    usage->redundancy.used = REDUNDANCY_START_IDX;
+    usage->redundancy.capacity = ACM_MAX_REDUNDANT_STREAMS;
+
+    sum_const_buffer = 0;
+    ACMLIST_LOCK(&module->streams);
+    ACMLIST_FOREACH(stream, &module->streams, entry)
+    {
+        int prefetch_ops, gather_ops;
+
+        /* counted like in validate_module */
+        prefetch_ops = stream_num_prefetch_ops(stream);
+        gather_ops = stream_num_gather_ops(stream);
+        usage->gather_dma.used += (gather_ops >= prefetch_ops) ? gather_ops : prefetch_ops;
+        usage->scatter_dma.used += stream_num_scatter_ops(stream);
+        sum_const_buffer = sum_const_buffer + stream_sum_const_buffer(stream);
+
+        if ( (stream->type == REDUNDANT_STREAM_TX) || (stream->type == REDUNDANT_STREAM_RX))
+            usage->redundancy.used++;
+        if ( (stream->type != INGRESS_TRIGGERED_STREAM) && (stream->type != REDUNDANT_STREAM_RX))
+            continue;
+        usage->lookup_rules.used++;
+        for (other = ACMLIST_FIRST(&module->streams); other != stream;
+                other = ACMLIST_NEXT(other, entry)) {
+            if ( ( (other->type == INGRESS_TRIGGERED_STREAM)
+                    || (other->type == REDUNDANT_STREAM_RX))
+                    && lookup_conflict(other->lookup, stream->lookup)) {
+                usage->lookup_conflicts++;
+                break;
+            }
+        }
+    }
+    ACMLIST_UNLOCK(&module->streams);
+
+    usage->const_buffer.used = module_sum_const_buffer(module);
+    if (sum_const_buffer > (int) usage->const_buffer.used)
+        usage->const_buffer_shared = sum_const_buffer - usage->const_buffer.used;
+
+    TRACE2_EXIT();
+    return 0;
+}
+
 int __must_check stream_check_periods(struct acm_stream *stream, uint32_t module_cycle_ns
 		, bool final_validate) {
     struct schedule_list *window_list;
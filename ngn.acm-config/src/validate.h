@@ -177,6 +177,37 @@ bool __must_check check_module_op_exists(struct acm_module *module);
  */
 int __must_check stream_sum_const_buffer(struct acm_stream *stream);
 
+/**
+ * @ingroup acmvalidate
+ * @brief calculates the constant buffer space needed by a module
+ *
+ * The function places the data of all operations of type INSERT_CONSTANT of
+ * the module's streams like it is done when the constant buffer is written,
+ * i.e. equal constant data is counted once only.
+ *
+ * @param module pointer to the module
+ *
+ * @return number of bytes of the constant buffer needed by the module
+ */
+int __must_check module_sum_const_buffer(struct acm_module *module);
+
+/**
+ * @ingroup acmvalidate
+ * @brief calculates the hardware resource usage of a module
+ *
+ * The function counts lookup rules, scatter and gather DMA commands, constant
+ * buffer space and redundancy table entries like validate_module() checks
+ * them. It additionally reports the constant buffer space saved by sharing
+ * and the ingress streams whose lookup conflicts with another stream.
+ *
+ * @param module pointer to the module
+ * @param usage pointer where the usage is stored
+ *
+ * @return the function will return 0 in case of success. Negative values
+ * represent an error.
+ */
+int __must_check module_get_usage(struct acm_module *module, struct acm_module_usage *usage);
+
 /**
  * @ingroup acmvalidate
  * @brief check all periods of a stream
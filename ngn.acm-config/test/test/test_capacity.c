@@ -0,0 +1,95 @@
+#include "unity.h"
+
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "capacity.h"
+#include "tracing.h"
+
+#include "mock_logging.h"
+
+void __attribute__((weak)) suite_setup(void)
+{
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_capacity_place_constant_append(void) {
+    uint8_t buffer[ACM_MAX_CONST_BUFFER_SIZE];
+    uint16_t used = 0;
+    int result;
+
+    result = capacity_place_constant(buffer, &used, (const uint8_t*) "abc", 3);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(3, used);
+    result = capacity_place_constant(buffer, &used, (const uint8_t*) "xyz", 3);
+    TEST_ASSERT_EQUAL(3, result);
+    TEST_ASSERT_EQUAL(6, used);
+    TEST_ASSERT_EQUAL_MEMORY("abcxyz", buffer, 6);
+}
+
+void test_capacity_place_constant_shared(void) {
+    uint8_t buffer[ACM_MAX_CONST_BUFFER_SIZE];
+    uint16_t used = 0;
+    int result;
+
+    result = capacity_place_constant(buffer, &used, (const uint8_t*) "header", 6);
+    TEST_ASSERT_EQUAL(0, result);
+    result = capacity_place_constant(buffer, &used, (const uint8_t*) "header", 6);
+    TEST_ASSERT_EQUAL(0, result);
+    result = capacity_place_constant(buffer, &used, (const uint8_t*) "ade", 3);
+    TEST_ASSERT_EQUAL(2, result);
+    TEST_ASSERT_EQUAL(6, used);
+}
+
+void test_capacity_place_constant_overlap(void) {
+    uint8_t buffer[ACM_MAX_CONST_BUFFER_SIZE];
+    uint16_t used = 0;
+    int result;
+
+    result = capacity_place_constant(buffer, &used, (const uint8_t*) "abcd", 4);
+    TEST_ASSERT_EQUAL(0, result);
+    result = capacity_place_constant(buffer, &used, (const uint8_t*) "cdef", 4);
+    TEST_ASSERT_EQUAL(2, result);
+    TEST_ASSERT_EQUAL(6, used);
+    TEST_ASSERT_EQUAL_MEMORY("abcdef", buffer, 6);
+}
+
+void test_capacity_place_constant_full(void) {
+    uint8_t buffer[ACM_MAX_CONST_BUFFER_SIZE];
+    uint8_t data[8];
+    uint16_t used = ACM_MAX_CONST_BUFFER_SIZE - 4;
+    int result;
+
+    memset(buffer, 0, sizeof (buffer));
+    memset(data, 0x55, sizeof (data));
+    result = capacity_place_constant(buffer, &used, data, sizeof (data));
+    TEST_ASSERT_EQUAL(-EACMCONSTBUFFER, result);
+    TEST_ASSERT_EQUAL(ACM_MAX_CONST_BUFFER_SIZE - 4, used);
+
+    /* fits only by sharing the end of the used part */
+    memset(&buffer[used], 0x55, 4);
+    used = ACM_MAX_CONST_BUFFER_SIZE;
+    result = capacity_place_constant(buffer, &used, data, 4);
+    TEST_ASSERT_EQUAL(ACM_MAX_CONST_BUFFER_SIZE - 4, result);
+}
+
+void test_capacity_place_constant_invalid(void) {
+    uint8_t buffer[ACM_MAX_CONST_BUFFER_SIZE];
+    uint16_t used = 0;
+    int result;
+
+    result = capacity_place_constant(buffer, &used, NULL, 3);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+    result = capacity_place_constant(buffer, &used, (const uint8_t*) "abc", 0);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+    result = capacity_place_constant(NULL, &used, (const uint8_t*) "abc", 3);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+}
@@ -3,6 +3,7 @@
 #include "constructor.h"
 #include "memory.h"
 #include "sysfs.h"
+#include "capacity.h"
 #include "logging.h"
 #include "tracing.h"
 
@@ -11,6 +12,7 @@
 #include "setup_helper.h"
 #include "mock_stream.h"
 #include "mock_status.h"
+#include "mock_netdev.h"
 
 void __attribute__((weak)) suite_setup(void)
 {
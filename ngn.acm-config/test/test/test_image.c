@@ -0,0 +1,200 @@
+#include "unity.h"
+
+#include "image.h"
+#include "tracing.h"
+#include "memory.h"
+
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include "mock_sysfs.h"
+#include "mock_application.h"
+#include "mock_validate.h"
+#include "mock_logging.h"
+
+#define SCHED_ROW_STRIDE (sizeof (struct acmdrv_sched_tbl_row) * ACMDRV_SCHED_TBL_ROW_COUNT)
+
+static sysfs_write_hook hook;
+static void *hook_arg;
+
+static struct {
+    char path_name[SYSFS_PATH_LENGTH];
+    uint8_t data[64];
+    size_t length;
+    off_t offset;
+} writes[8];
+static int write_count;
+
+void __attribute__((weak)) suite_setup(void)
+{
+}
+
+void setUp(void)
+{
+    logging_Ignore();
+    hook = NULL;
+    hook_arg = NULL;
+    write_count = 0;
+    memset(writes, 0, sizeof (writes));
+}
+
+void tearDown(void)
+{
+}
+
+static void stub_set_write_hook(sysfs_write_hook write_hook, void *arg, int num_calls) {
+    hook = write_hook;
+    hook_arg = arg;
+}
+
+static int stub_apply_configuration(struct acm_config *config, uint32_t identifier,
+        int num_calls) {
+    uint32_t state = ACMDRV_CONFIG_START_STATE;
+    uint32_t lookup[2] = { 0x11111111, 0x22222222 };
+    struct acmdrv_sched_tbl_row rows[2];
+    off_t row_offset = SCHED_ROW_STRIDE * ACMDRV_SCHED_TBL_COUNT * MODULE_1;
+
+    memset(rows, 0x5A, sizeof (rows));
+    TEST_ASSERT_NOT_NULL(hook);
+    TEST_ASSERT_EQUAL(0, hook(hook_arg, ACMDEV_BASE "config_bin/config_state", &state,
+            sizeof (state), 0));
+    /* contiguous writes are merged */
+    TEST_ASSERT_EQUAL(0, hook(hook_arg, ACMDEV_BASE "config_bin/lookup_pattern", &lookup[0],
+            sizeof (lookup[0]), 8));
+    TEST_ASSERT_EQUAL(0, hook(hook_arg, ACMDEV_BASE "config_bin/lookup_pattern", &lookup[1],
+            sizeof (lookup[1]), 12));
+    TEST_ASSERT_EQUAL(0, hook(hook_arg, ACMDEV_BASE "config_bin/sched_tab_row", &rows[0],
+            sizeof (rows[0]), row_offset));
+    TEST_ASSERT_EQUAL(0, hook(hook_arg, ACMDEV_BASE "config_bin/sched_tab_row", &rows[1],
+            sizeof (rows[1]), row_offset + sizeof (rows[0])));
+    return 0;
+}
+
+static int stub_write_file_sysfs(const char *path_name, void *buffer, size_t buffer_length,
+        off_t offset, int num_calls) {
+    TEST_ASSERT_LESS_THAN(8, write_count);
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof (writes[0].data), buffer_length);
+    strcpy(writes[write_count].path_name, path_name);
+    memcpy(writes[write_count].data, buffer, buffer_length);
+    writes[write_count].length = buffer_length;
+    writes[write_count].offset = offset;
+    write_count++;
+    return 0;
+}
+
+static int stub_read_free_schedule_table(enum acm_module_id module_id, int *free_table,
+        int num_calls) {
+    TEST_ASSERT_EQUAL(MODULE_1, module_id);
+    *free_table = 1;
+    return 0;
+}
+
+static void create_image(void **image, size_t *size) {
+    struct acm_config configuration;
+
+    memset(&configuration, 0, sizeof (configuration));
+    validate_config_ExpectAndReturn(&configuration, true, 0);
+    sysfs_set_write_hook_StubWithCallback(stub_set_write_hook);
+    apply_configuration_StubWithCallback(stub_apply_configuration);
+    TEST_ASSERT_EQUAL(0, image_create(&configuration, 4711, image, size));
+    TEST_ASSERT_NULL(hook);
+}
+
+void test_image_crc32(void) {
+    const char check[] = "123456789";
+
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, image_crc32((const uint8_t *) check, strlen(check)));
+}
+
+void test_image_create_neg_identifier(void) {
+    struct acm_config configuration;
+    void *image;
+    size_t size;
+
+    memset(&configuration, 0, sizeof (configuration));
+    TEST_ASSERT_EQUAL(-EINVAL, image_create(&configuration, 0, &image, &size));
+}
+
+void test_image_create_neg_validation(void) {
+    struct acm_config configuration;
+    void *image;
+    size_t size;
+
+    memset(&configuration, 0, sizeof (configuration));
+    validate_config_ExpectAndReturn(&configuration, true, -EACMSCHEDTIME);
+    TEST_ASSERT_EQUAL(-EACMSCHEDTIME, image_create(&configuration, 4711, &image, &size));
+}
+
+void test_image_create(void) {
+    struct image_header *header;
+    void *image;
+    size_t size;
+
+    create_image(&image, &size);
+    header = image;
+    TEST_ASSERT_EQUAL_HEX32(IMAGE_MAGIC, header->magic);
+    TEST_ASSERT_EQUAL(IMAGE_VERSION, header->version);
+    TEST_ASSERT_EQUAL(4711, header->identifier);
+    TEST_ASSERT_EQUAL(3, header->record_count);
+    TEST_ASSERT_EQUAL(size, header->length);
+    TEST_ASSERT_EQUAL(0, image_check(image, size));
+    TEST_ASSERT_EQUAL(4711, image_identifier(image, size));
+    free(image);
+}
+
+void test_image_apply(void) {
+    void *image;
+    size_t size;
+    off_t row_offset = SCHED_ROW_STRIDE * ACMDRV_SCHED_TBL_COUNT * MODULE_1;
+
+    create_image(&image, &size);
+    write_file_sysfs_StubWithCallback(stub_write_file_sysfs);
+    sysfs_read_free_schedule_table_StubWithCallback(stub_read_free_schedule_table);
+    TEST_ASSERT_EQUAL(0, image_apply(image, size));
+
+    TEST_ASSERT_EQUAL(3, write_count);
+    TEST_ASSERT_EQUAL_STRING(ACMDEV_BASE "config_bin/config_state", writes[0].path_name);
+    TEST_ASSERT_EQUAL(0, writes[0].offset);
+    TEST_ASSERT_EQUAL_STRING(ACMDEV_BASE "config_bin/lookup_pattern", writes[1].path_name);
+    TEST_ASSERT_EQUAL(8, writes[1].offset);
+    TEST_ASSERT_EQUAL(8, writes[1].length);
+    TEST_ASSERT_EQUAL_HEX32(0x22222222, *(uint32_t *) &writes[1].data[4]);
+    /* schedule moved to the free table */
+    TEST_ASSERT_EQUAL_STRING(ACMDEV_BASE "config_bin/sched_tab_row", writes[2].path_name);
+    TEST_ASSERT_EQUAL(row_offset + SCHED_ROW_STRIDE, writes[2].offset);
+    TEST_ASSERT_EQUAL(2 * sizeof (struct acmdrv_sched_tbl_row), writes[2].length);
+    free(image);
+}
+
+void test_image_apply_neg_corrupted(void) {
+    void *image;
+    size_t size;
+
+    create_image(&image, &size);
+    ((uint8_t *) image)[size - 1] ^= 0xFF;
+    TEST_ASSERT_EQUAL(-EACMIMAGE, image_apply(image, size));
+    TEST_ASSERT_EQUAL(-EACMIMAGE, image_identifier(image, size));
+    free(image);
+}
+
+void test_image_apply_neg_truncated(void) {
+    void *image;
+    size_t size;
+
+    create_image(&image, &size);
+    TEST_ASSERT_EQUAL(-EACMIMAGE, image_apply(image, size - 4));
+    TEST_ASSERT_EQUAL(-EACMIMAGE, image_apply(image, sizeof (struct image_header) - 1));
+    free(image);
+}
+
+void test_image_apply_neg_version(void) {
+    struct image_header *header;
+    void *image;
+    size_t size;
+
+    create_image(&image, &size);
+    header = image;
+    header->version = IMAGE_VERSION + 1;
+    TEST_ASSERT_EQUAL(-EACMIMAGE, image_apply(image, size));
+    free(image);
+}
@@ -23,6 +23,7 @@
 #include "mock_logging.h"
 #include "mock_sysfs.h"
 #include "mock_tracing.h"
+#include "mock_image.h"
 
 void __attribute__((weak)) suite_setup(void)
 {
@@ -46,6 +47,15 @@ void test_acm_read_status_item(void) {
     TEST_ASSERT_EQUAL_INT64(25, result);
 }
 
+void test_acm_read_status(void) {
+    struct acm_status status;
+
+    status_read_all_ExpectAndReturn(ACM_STATUS_SELECT_MODULE_0 | ACM_STATUS_SELECT_ERRORS,
+            &status, 0);
+    TEST_ASSERT_EQUAL(0, acm_read_status(ACM_STATUS_SELECT_MODULE_0 | ACM_STATUS_SELECT_ERRORS,
+            &status));
+}
+
 void test_acm_read_config_identifier(void) {
     int64_t result;
 
@@ -80,6 +90,95 @@ void test_acm_read_diagnostics(void) {
     TEST_ASSERT_EQUAL_MEMORY(&diagnostic_values, result, sizeof(struct acm_diagnostic));
 }
 
+void test_acm_read_redundancy_stats(void) {
+    struct acm_redundancy_stats stats;
+    int result;
+
+    status_read_redundancy_stats_ExpectAndReturn(&stats, 0);
+    result = acm_read_redundancy_stats(&stats);
+    TEST_ASSERT_EQUAL_INT(0, result);
+}
+
+void test_acm_reset_redundancy_stats(void) {
+    int result;
+
+    status_reset_redundancy_stats_ExpectAndReturn(-EACCES);
+    result = acm_reset_redundancy_stats();
+    TEST_ASSERT_EQUAL_INT(-EACCES, result);
+}
+
+void test_acm_read_diag_thresholds(void) {
+    struct acm_diag_thresholds thresholds;
+    int result;
+
+    status_read_diag_thresholds_ExpectAndReturn(MODULE_1, &thresholds, 0);
+    result = acm_read_diag_thresholds(MODULE_1, &thresholds);
+    TEST_ASSERT_EQUAL_INT(0, result);
+}
+
+void test_acm_write_diag_thresholds(void) {
+    struct acm_diag_thresholds thresholds;
+    int result;
+
+    status_write_diag_thresholds_ExpectAndReturn(MODULE_0, &thresholds, -EACCES);
+    result = acm_write_diag_thresholds(MODULE_0, &thresholds);
+    TEST_ASSERT_EQUAL_INT(-EACCES, result);
+}
+
+void test_acm_read_diag_alarm(void) {
+    struct acm_diag_alarm alarm;
+    int result;
+
+    status_read_diag_alarm_ExpectAndReturn(MODULE_0, &alarm, 0);
+    result = acm_read_diag_alarm(MODULE_0, &alarm);
+    TEST_ASSERT_EQUAL_INT(0, result);
+}
+
+void test_acm_wait_diag_alarm(void) {
+    struct acm_diag_alarm alarm;
+    int result;
+
+    status_wait_diag_alarm_ExpectAndReturn(MODULE_1, 100, &alarm, -ETIMEDOUT);
+    result = acm_wait_diag_alarm(MODULE_1, 100, &alarm);
+    TEST_ASSERT_EQUAL_INT(-ETIMEDOUT, result);
+}
+
+void test_acm_read_failover_policy(void) {
+    struct acm_failover_policy policy;
+    int result;
+
+    status_read_failover_policy_ExpectAndReturn(MODULE_1, &policy, 0);
+    result = acm_read_failover_policy(MODULE_1, &policy);
+    TEST_ASSERT_EQUAL_INT(0, result);
+}
+
+void test_acm_write_failover_policy(void) {
+    struct acm_failover_policy policy;
+    int result;
+
+    status_write_failover_policy_ExpectAndReturn(MODULE_0, &policy, -EINVAL);
+    result = acm_write_failover_policy(MODULE_0, &policy);
+    TEST_ASSERT_EQUAL_INT(-EINVAL, result);
+}
+
+void test_acm_read_link_event(void) {
+    struct acm_link_event event;
+    int result;
+
+    status_read_link_event_ExpectAndReturn(MODULE_0, &event, 0);
+    result = acm_read_link_event(MODULE_0, &event);
+    TEST_ASSERT_EQUAL_INT(0, result);
+}
+
+void test_acm_wait_link_event(void) {
+    struct acm_link_event event;
+    int result;
+
+    status_wait_link_event_ExpectAndReturn(MODULE_1, -1, &event, 0);
+    result = acm_wait_link_event(MODULE_1, -1, &event);
+    TEST_ASSERT_EQUAL_INT(0, result);
+}
+
 void test_acm_set_diagnostics_poll_time(void) {
     int return_value;
 
@@ -1196,6 +1295,16 @@ void test_acm_set_module_schedule(void) {
     TEST_ASSERT_EQUAL_INT(0, result);
 }
 
+void test_acm_set_module_cycle_subns(void) {
+    struct acm_module module;
+    memset(&module, 0, sizeof (module));
+    int result;
+
+    module_set_cycle_subns_ExpectAndReturn(&module, 0x800000, 0);
+    result = acm_set_module_cycle_subns(&module, 0x800000);
+    TEST_ASSERT_EQUAL_INT(0, result);
+}
+
 void test_acm_add_module_stream(void) {
     struct acm_module module;
     memset(&module, 0, sizeof (module));
@@ -1437,6 +1546,16 @@ void test_acm_validate_config(void) {
     TEST_ASSERT_EQUAL_INT(0, result);
 }
 
+void test_acm_get_module_usage(void) {
+    struct acm_module module;
+    struct acm_module_usage usage;
+    int result;
+
+    module_get_usage_ExpectAndReturn(&module, &usage, 0);
+    result = acm_get_module_usage(&module, &usage);
+    TEST_ASSERT_EQUAL_INT(0, result);
+}
+
 void test_acm_apply_config(void) {
     struct acm_config configuration;
     memset(&configuration, 0, sizeof (configuration));
@@ -1447,6 +1566,36 @@ void test_acm_apply_config(void) {
     TEST_ASSERT_EQUAL_INT(0, result);
 }
 
+void test_acm_create_config_image(void) {
+    struct acm_config configuration;
+    memset(&configuration, 0, sizeof (configuration));
+    void *image;
+    size_t size;
+    int result;
+
+    image_create_ExpectAndReturn(&configuration, 27, &image, &size, 0);
+    result = acm_create_config_image(&configuration, 27, &image, &size);
+    TEST_ASSERT_EQUAL_INT(0, result);
+}
+
+void test_acm_apply_config_image(void) {
+    uint8_t image[32];
+    int result;
+
+    image_apply_ExpectAndReturn(image, sizeof (image), -EACMIMAGE);
+    result = acm_apply_config_image(image, sizeof (image));
+    TEST_ASSERT_EQUAL_INT(-EACMIMAGE, result);
+}
+
+void test_acm_read_config_image_identifier(void) {
+    uint8_t image[32];
+    int64_t result;
+
+    image_identifier_ExpectAndReturn(image, sizeof (image), 27);
+    result = acm_read_config_image_identifier(image, sizeof (image));
+    TEST_ASSERT_EQUAL_INT64(27, result);
+}
+
 void test_acm_apply_schedule(void) {
     struct acm_config configuration;
     memset(&configuration, 0, sizeof (configuration));
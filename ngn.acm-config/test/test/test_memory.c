@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 /* Unity Test Framework */
 #include "unity.h"
@@ -52,3 +53,49 @@ void test_acm_strdup(void) {
     free(result);
     TEST_PASS();
 }
+
+void test_acm_arena_zalloc_reuse(void) {
+    uint32_t *schedule, *schedule_keep, *schedule_reused;
+
+    schedule = acm_arena_zalloc(ACM_ARENA_SCHEDULE);
+    TEST_ASSERT_NOT_NULL(schedule);
+    schedule_keep = acm_arena_zalloc(ACM_ARENA_SCHEDULE);
+    TEST_ASSERT_NOT_NULL(schedule_keep);
+    TEST_ASSERT_NOT_EQUAL(schedule, schedule_keep);
+
+    *schedule = 4711;
+    acm_arena_free(ACM_ARENA_SCHEDULE, schedule);
+    schedule_reused = acm_arena_zalloc(ACM_ARENA_SCHEDULE);
+    TEST_ASSERT_EQUAL_PTR(schedule, schedule_reused);
+    TEST_ASSERT_EQUAL(0, *schedule_reused);
+
+    acm_arena_free(ACM_ARENA_SCHEDULE, schedule_reused);
+    acm_arena_free(ACM_ARENA_SCHEDULE, schedule_keep);
+}
+
+void test_acm_arena_zalloc_many(void) {
+    uint32_t *schedule[200];
+    int i, j;
+
+    for (i = 0; i < 200; i++) {
+        schedule[i] = acm_arena_zalloc(ACM_ARENA_SCHEDULE);
+        TEST_ASSERT_NOT_NULL(schedule[i]);
+        *schedule[i] = i;
+    }
+    for (i = 0; i < 200; i++) {
+        TEST_ASSERT_EQUAL(i, *schedule[i]);
+        for (j = 0; j < i; j++)
+            TEST_ASSERT_NOT_EQUAL(schedule[j], schedule[i]);
+    }
+    for (i = 0; i < 200; i++)
+        acm_arena_free(ACM_ARENA_SCHEDULE, schedule[i]);
+}
+
+void test_acm_arena_zalloc_neg_type(void) {
+    TEST_ASSERT_NULL(acm_arena_zalloc(ACM_ARENA_TYPE_NUM));
+}
+
+void test_acm_arena_free_null(void) {
+    acm_arena_free(ACM_ARENA_STREAM, NULL);
+    TEST_PASS();
+}
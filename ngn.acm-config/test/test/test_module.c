@@ -406,6 +406,36 @@ void test_module_set_schedule_cycle_zero(void) {
     TEST_ASSERT_EQUAL(-EINVAL, result);
 }
 
+void test_module_set_cycle_subns(void) {
+    int result;
+    struct acm_module module =
+    MODULE_INITIALIZER(module, CONN_MODE_SERIAL, SPEED_100MBps, MODULE_0, NULL);
+
+    result = module_set_cycle_subns(&module, ACM_CYCLE_SUBNS_MAX - 1);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(ACM_CYCLE_SUBNS_MAX - 1, module.cycle_subns);
+}
+
+void test_module_set_cycle_subns_module_null(void) {
+    int ret;
+
+    logging_Expect(0, "Module: Invalid module input: %d");
+
+    ret = module_set_cycle_subns(NULL, 1);
+    TEST_ASSERT_EQUAL(-EINVAL, ret);
+}
+
+void test_module_set_cycle_subns_out_of_range(void) {
+    int result;
+    struct acm_module module =
+    MODULE_INITIALIZER(module, CONN_MODE_SERIAL, SPEED_100MBps, MODULE_0, NULL);
+
+    logging_Expect(0, "Module: Cycle Time sub-nanoseconds out of range: %u");
+    result = module_set_cycle_subns(&module, ACM_CYCLE_SUBNS_MAX);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+    TEST_ASSERT_EQUAL(0, module.cycle_subns);
+}
+
 void test_module_add_schedules_time_triggered_stream(void) {
     int result;
     struct schedule_entry window_mem = SCHEDULE_ENTRY_INITIALIZER;
@@ -639,11 +669,11 @@ void test_remove_schedule_sysfs_items_schedule(void) {
     ACMLIST_INSERT_TAIL(&module.fsc_list, &fsc_schedule_mem8, entry);
 
     // execute test
-    acm_free_Expect(&fsc_schedule_mem1);
-    acm_free_Expect(&fsc_schedule_mem3);
-    acm_free_Expect(&fsc_schedule_mem4);
-    acm_free_Expect(&fsc_schedule_mem6);
-    acm_free_Expect(&fsc_schedule_mem8);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem3);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem4);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem6);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem8);
     remove_schedule_sysfs_items_schedule(&schedule_item1, &module);
     TEST_ASSERT_EQUAL(3, ACMLIST_COUNT(&module.fsc_list));
 }
@@ -702,12 +732,12 @@ void test_remove_schedule_sysfs_items_stream(void) {
     ACMLIST_INSERT_TAIL(&module.fsc_list, &fsc_schedule_mem8, entry);
 
     // execute test
-    acm_free_Expect(&fsc_schedule_mem3);
-    acm_free_Expect(&fsc_schedule_mem6);
-    acm_free_Expect(&fsc_schedule_mem8);
-    acm_free_Expect(&fsc_schedule_mem2);
-    acm_free_Expect(&fsc_schedule_mem5);
-    acm_free_Expect(&fsc_schedule_mem7);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem3);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem6);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem8);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem2);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem5);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem7);
 
     remove_schedule_sysfs_items_stream(&stream1, &module);
     TEST_ASSERT_EQUAL(2, ACMLIST_COUNT(&module.fsc_list));
@@ -763,16 +793,16 @@ void test_fsc_command_empty_list(void) {
     ACMLIST_INSERT_TAIL(&fsc_list, &fsc_schedule_mem10, entry);
 
     // execute test
-    acm_free_Expect(&fsc_schedule_mem1);
-    acm_free_Expect(&fsc_schedule_mem2);
-    acm_free_Expect(&fsc_schedule_mem3);
-    acm_free_Expect(&fsc_schedule_mem4);
-    acm_free_Expect(&fsc_schedule_mem5);
-    acm_free_Expect(&fsc_schedule_mem6);
-    acm_free_Expect(&fsc_schedule_mem7);
-    acm_free_Expect(&fsc_schedule_mem8);
-    acm_free_Expect(&fsc_schedule_mem9);
-    acm_free_Expect(&fsc_schedule_mem10);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem2);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem3);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem4);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem5);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem6);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem7);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem8);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem9);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem10);
 
     fsc_command_empty_list(&fsc_list);
     TEST_ASSERT_EQUAL(0, ACMLIST_COUNT(&fsc_list));
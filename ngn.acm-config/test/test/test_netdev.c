@@ -0,0 +1,137 @@
+#include "unity.h"
+
+#include "netdev.h"
+#include "hwconfig_def.h"
+#include "tracing.h"
+
+#include <string.h>
+#include <errno.h>
+#include <net/if.h>
+#include <linux/rtnetlink.h>
+#include "mock_sysfs.h"
+#include "mock_logging.h"
+
+static const uint8_t mac_a[ETHER_ADDR_LEN] = { 0x00, 0x60, 0x65, 0x11, 0x22, 0x33 };
+static const uint8_t mac_b[ETHER_ADDR_LEN] = { 0x00, 0x60, 0x65, 0x44, 0x55, 0x66 };
+
+static union {
+    struct nlmsghdr nlh;
+    char buffer[256];
+} message;
+
+static void add_attribute(unsigned short type, const void *data, size_t length) {
+    struct rtattr *rta;
+
+    rta = (struct rtattr *) (message.buffer + NLMSG_ALIGN(message.nlh.nlmsg_len));
+    rta->rta_type = type;
+    rta->rta_len = RTA_LENGTH(length);
+    memcpy(RTA_DATA(rta), data, length);
+    message.nlh.nlmsg_len = NLMSG_ALIGN(message.nlh.nlmsg_len) + RTA_ALIGN(rta->rta_len);
+}
+
+static void send_link(uint16_t type, const char *ifname, const uint8_t *mac, unsigned int flags) {
+    struct ifinfomsg *ifi;
+
+    memset(&message, 0, sizeof (message));
+    message.nlh.nlmsg_type = type;
+    message.nlh.nlmsg_len = NLMSG_LENGTH(sizeof (struct ifinfomsg));
+    ifi = NLMSG_DATA(&message.nlh);
+    ifi->ifi_flags = flags;
+    add_attribute(IFLA_IFNAME, ifname, strlen(ifname) + 1);
+    if (mac)
+        add_attribute(IFLA_ADDRESS, mac, ETHER_ADDR_LEN);
+    netdev_process_message(&message.nlh);
+}
+
+void __attribute__((weak)) suite_setup(void)
+{
+}
+
+void setUp(void)
+{
+    send_link(RTM_DELLINK, PORT_MODULE_0, NULL, 0);
+    send_link(RTM_DELLINK, PORT_MODULE_1, NULL, 0);
+}
+
+void tearDown(void)
+{
+}
+
+void test_netdev_cached_mac(void) {
+    uint8_t mac[ETHER_ADDR_LEN];
+
+    TEST_ASSERT_EQUAL(-ENODATA, netdev_cached_mac(MODULE_0, mac));
+    send_link(RTM_NEWLINK, PORT_MODULE_0, mac_a, IFF_UP | IFF_RUNNING);
+    TEST_ASSERT_EQUAL(0, netdev_cached_mac(MODULE_0, mac));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(mac_a, mac, ETHER_ADDR_LEN);
+    TEST_ASSERT_EQUAL(-ENODATA, netdev_cached_mac(MODULE_1, mac));
+}
+
+void test_netdev_cached_mac_other_device(void) {
+    uint8_t mac[ETHER_ADDR_LEN];
+
+    send_link(RTM_NEWLINK, "eth0", mac_b, IFF_UP | IFF_RUNNING);
+    TEST_ASSERT_EQUAL(-ENODATA, netdev_cached_mac(MODULE_0, mac));
+    TEST_ASSERT_EQUAL(-ENODATA, netdev_cached_mac(MODULE_1, mac));
+}
+
+void test_netdev_cached_mac_dellink(void) {
+    uint8_t mac[ETHER_ADDR_LEN];
+
+    send_link(RTM_NEWLINK, PORT_MODULE_0, mac_a, IFF_UP | IFF_RUNNING);
+    send_link(RTM_DELLINK, PORT_MODULE_0, NULL, 0);
+    TEST_ASSERT_EQUAL(-ENODATA, netdev_cached_mac(MODULE_0, mac));
+}
+
+void test_netdev_mac_changed_after_use(void) {
+    uint8_t mac[ETHER_ADDR_LEN];
+
+    send_link(RTM_NEWLINK, PORT_MODULE_1, mac_a, IFF_UP | IFF_RUNNING);
+    /* change before use is not reported */
+    send_link(RTM_NEWLINK, PORT_MODULE_1, mac_b, IFF_UP | IFF_RUNNING);
+    TEST_ASSERT_EQUAL(0, netdev_cached_mac(MODULE_1, mac));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(mac_b, mac, ETHER_ADDR_LEN);
+    /* notification without change is not reported */
+    send_link(RTM_NEWLINK, PORT_MODULE_1, mac_b, IFF_UP);
+    logging_Expect(LOGLEVEL_WARN,
+            "Netdev: MAC address of %s changed, source MAC of streams added before is stale");
+    send_link(RTM_NEWLINK, PORT_MODULE_1, mac_a, IFF_UP | IFF_RUNNING);
+    TEST_ASSERT_EQUAL(0, netdev_cached_mac(MODULE_1, mac));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(mac_a, mac, ETHER_ADDR_LEN);
+}
+
+void test_netdev_check_link_not_present(void) {
+    netdev_check_cached_link(MODULE_0, SPEED_1GBps);
+}
+
+void test_netdev_check_link_down(void) {
+    send_link(RTM_NEWLINK, PORT_MODULE_0, mac_a, IFF_UP);
+    logging_Expect(LOGLEVEL_WARN, "Netdev: link of %s is down");
+    netdev_check_cached_link(MODULE_0, SPEED_1GBps);
+}
+
+void test_netdev_check_link_speed(void) {
+    send_link(RTM_NEWLINK, PORT_MODULE_0, mac_a, IFF_UP | IFF_RUNNING);
+    read_uint64_sysfs_item_ExpectAndReturn(DELAY_BASE PORT_MODULE_0 "/speed", 1000);
+    netdev_check_cached_link(MODULE_0, SPEED_1GBps);
+    /* speed is read once per link event */
+    logging_Expect(LOGLEVEL_WARN, "Netdev: %s runs at %d Mbps, module %d is configured for %d Mbps");
+    netdev_check_cached_link(MODULE_0, SPEED_100MBps);
+
+    send_link(RTM_NEWLINK, PORT_MODULE_0, mac_a, IFF_UP | IFF_RUNNING);
+    read_uint64_sysfs_item_ExpectAndReturn(DELAY_BASE PORT_MODULE_0 "/speed", 100);
+    netdev_check_cached_link(MODULE_0, SPEED_100MBps);
+}
+
+void test_netdev_check_link_speed_unknown(void) {
+    send_link(RTM_NEWLINK, PORT_MODULE_0, mac_a, IFF_UP | IFF_RUNNING);
+    read_uint64_sysfs_item_ExpectAndReturn(DELAY_BASE PORT_MODULE_0 "/speed", -EINVAL);
+    netdev_check_cached_link(MODULE_0, SPEED_1GBps);
+    netdev_check_cached_link(MODULE_0, SPEED_100MBps);
+}
+
+void test_netdev_get_mac_neg_module(void) {
+    uint8_t mac[ETHER_ADDR_LEN];
+
+    TEST_ASSERT_EQUAL(-EACMINTERNAL, netdev_get_mac(ACM_MODULES_COUNT, mac));
+}
@@ -10,6 +10,7 @@
 #include "mock_memory.h"
 #include "mock_validate.h"
 #include "mock_sysfs.h"
+#include "mock_netdev.h"
 #include "mock_logging.h"
 
 void __attribute__((weak)) suite_setup(void)
@@ -31,7 +32,7 @@ void test_operation_create_insert(void) {
     char *bufname = "buffer";
 
     check_buff_name_against_sys_devices_ExpectAndReturn(bufname, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (operation), &operation);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &operation);
     acm_strdup_ExpectAndReturn("buffer", bufname);
 
     result = operation_create_insert(200, "buffer");
@@ -97,7 +98,7 @@ void test_operation_create_insert_no_mem(void) {
     struct operation *result;
 
     check_buff_name_against_sys_devices_ExpectAndReturn("buffer", 0);
-    acm_zalloc_ExpectAndReturn(sizeof (struct operation), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, NULL);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_insert(250, "buffer");
@@ -111,9 +112,9 @@ void test_operation_create_insert_strdup_fail(void) {
     const char *bufname = "buffer";
 
     check_buff_name_against_sys_devices_ExpectAndReturn("buffer", 0);
-    acm_zalloc_ExpectAndReturn(sizeof (opmem), &opmem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &opmem);
     acm_strdup_ExpectAndReturn(bufname, NULL);
-    acm_free_Expect(&opmem);
+    acm_arena_free_Expect(ACM_ARENA_OPERATION, &opmem);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_insert(250, bufname);
@@ -138,7 +139,7 @@ void test_operation_create_insertconstant(void) {
     char data_mem[40];
     memset(&data_mem, 0, sizeof(data_mem));
 
-    acm_zalloc_ExpectAndReturn(sizeof (opmem), &opmem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &opmem);
     acm_zalloc_ExpectAndReturn(26, &data_mem);
 
     result = operation_create_insertconstant(const_data, 26);
@@ -173,7 +174,7 @@ void test_operation_create_insertconstant_no_mem(void) {
     struct operation *result;
     const char *const_data = "abcdefghijklmnopqrstuvwxyz";
 
-    acm_zalloc_ExpectAndReturn(sizeof (struct operation), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, NULL);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_insertconstant(const_data, 26);
@@ -186,9 +187,9 @@ void test_operation_create_insertconstant_alloc_data_fail(void) {
     struct operation *result;
     const char *const_data = "abcdefghijklmnopqrstuvwxyz";
 
-    acm_zalloc_ExpectAndReturn(sizeof (opmem), &opmem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &opmem);
     acm_zalloc_ExpectAndReturn(26, NULL);
-    acm_free_Expect(&opmem);
+    acm_arena_free_Expect(ACM_ARENA_OPERATION, &opmem);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_insertconstant(const_data, 26);
@@ -202,7 +203,7 @@ void test_operation_create_pad(void) {
     char data_mem;
     memset(&opmem, 0, sizeof(opmem));
 
-    acm_zalloc_ExpectAndReturn(sizeof (opmem), &opmem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &opmem);
     acm_zalloc_ExpectAndReturn(1, &data_mem);
 
     result = operation_create_pad(200, 0xab);
@@ -234,7 +235,7 @@ void test_operation_create_pad_max_size(void) {
 void test_operation_create_pad_no_mem(void) {
     struct operation *result;
 
-    acm_zalloc_ExpectAndReturn(sizeof (struct operation), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, NULL);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_pad(200, 0xab);
@@ -246,9 +247,9 @@ void test_operation_create_pad_alloc_data_fail(void) {
     memset(&opmem, 0, sizeof(opmem));
     struct operation *result;
 
-    acm_zalloc_ExpectAndReturn(sizeof (opmem), &opmem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &opmem);
     acm_zalloc_ExpectAndReturn(1, NULL);
-    acm_free_Expect(&opmem);
+    acm_arena_free_Expect(ACM_ARENA_OPERATION, &opmem);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_pad(200, 0xab);
@@ -260,7 +261,7 @@ void test_operation_create_forward(void) {
     memset(&opmem, 0, sizeof(opmem));
     struct operation *result;
 
-    acm_zalloc_ExpectAndReturn(sizeof (opmem), &opmem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &opmem);
 
     result = operation_create_forward(100, 200);
     TEST_ASSERT_EQUAL(FORWARD, result->opcode);
@@ -299,7 +300,7 @@ void test_operation_create_forward_exceeding_framesize(void) {
 void test_operation_create_forward_no_mem(void) {
     struct operation *result;
 
-    acm_zalloc_ExpectAndReturn(sizeof(struct operation), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, NULL);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_forward(100, 200);
@@ -313,7 +314,7 @@ void test_operation_create_read(void) {
     char *bufname = "buffer";
 
     check_buff_name_against_sys_devices_ExpectAndReturn(bufname, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (opmem), &opmem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &opmem);
     acm_strdup_ExpectAndReturn("buffer", bufname);
 
     result = operation_create_read(100, 200, "buffer");
@@ -389,7 +390,7 @@ void test_operation_create_read_no_mem(void) {
     struct operation *result;
 
     check_buff_name_against_sys_devices_ExpectAndReturn("buffer", 0);
-    acm_zalloc_ExpectAndReturn(sizeof (struct operation), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, NULL);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_read(100, 200, "buffer");
@@ -403,9 +404,9 @@ void test_operation_create_read_strdup_fails(void) {
     const char *bufname = "buffer";
 
     check_buff_name_against_sys_devices_ExpectAndReturn(bufname, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (opmem), &opmem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &opmem);
     acm_strdup_ExpectAndReturn(bufname, NULL);
-    acm_free_Expect(&opmem);
+    acm_arena_free_Expect(ACM_ARENA_OPERATION, &opmem);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_read(100, 200, bufname);
@@ -427,7 +428,7 @@ void test_operation_create_forward_all(void) {
     memset(&opmem, 0, sizeof(opmem));
     struct operation *result;
 
-    acm_zalloc_ExpectAndReturn(sizeof (opmem), &opmem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, &opmem);
 
     result = operation_create_forwardall();
     TEST_ASSERT_EQUAL(FORWARD_ALL, result->opcode);
@@ -442,7 +443,7 @@ void test_operation_create_forward_all(void) {
 void test_operation_create_forward_all_no_mem(void) {
     struct operation *result;
 
-    acm_zalloc_ExpectAndReturn(sizeof (struct operation), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_OPERATION, NULL);
     logging_Expect(LOGLEVEL_ERR, "Operation: Out of memory");
 
     result = operation_create_forwardall();
@@ -454,7 +455,7 @@ void test_operation_destroy(void) {
 
     acm_free_Expect(operation.buffer_name);
     acm_free_Expect(operation.data);
-    acm_free_Expect(&operation);
+    acm_arena_free_Expect(ACM_ARENA_OPERATION, &operation);
 
     operation_destroy(&operation);
 }
@@ -647,7 +648,7 @@ void test_operation_empty_list(void) {
     for (i = 0; i < max_ops; i++) {
         acm_free_Expect(operation[i].data);
         acm_free_Expect(operation[i].buffer_name);
-        acm_free_Expect(&operation[i]);
+        acm_arena_free_Expect(ACM_ARENA_OPERATION, &operation[i]);
     }
     operation_list_flush(&stream.operations);
     TEST_ASSERT_EQUAL(0, ACMLIST_COUNT(&stream.operations));
@@ -682,7 +683,7 @@ void test_operation_empty_user_list_stream_with_useroperations(void) {
     for (i = 0; i < 4; i++) {
         acm_free_Expect(&data[i]);
         acm_free_Expect(NULL);
-        acm_free_Expect(&op_pad[i]);
+        acm_arena_free_Expect(ACM_ARENA_OPERATION, &op_pad[i]);
     }
     operation_list_flush_user(&stream.operations);
     TEST_ASSERT_EQUAL(3, ACMLIST_COUNT(&stream.operations));
@@ -692,7 +693,7 @@ void test_operation_empty_user_list_stream_with_useroperations(void) {
     for (i = 0; i < 3; i++) {
         acm_free_Expect(NULL);
         acm_free_Expect(NULL);
-        acm_free_Expect(&opforward[i]);
+        acm_arena_free_Expect(ACM_ARENA_OPERATION, &opforward[i]);
     }
     operation_list_flush(&stream.operations);
     TEST_ASSERT_EQUAL(0, ACMLIST_COUNT(&stream.operations));
@@ -722,7 +723,7 @@ void test_operation_empty_user_list_without_useroperations(void) {
     for (i = 0; i < 3; i++) {
         acm_free_Expect(NULL);
         acm_free_Expect(NULL);
-        acm_free_Expect(&opforward[i]);
+        acm_arena_free_Expect(ACM_ARENA_OPERATION, &opforward[i]);
     }
     operation_list_flush(&stream.operations);
     TEST_ASSERT_EQUAL(0, ACMLIST_COUNT(&stream.operations));
@@ -752,9 +753,9 @@ void test_operation_list_update_smac_module_0(void) {
     TEST_ASSERT_EQUAL(max_ops, ACMLIST_COUNT(&stream.operations));
 
     /* execute test case */
-    get_mac_address_ExpectAndReturn(PORT_MODULE_0, (uint8_t*)mac_data, 0);
-    get_mac_address_IgnoreArg_mac();
-    get_mac_address_ReturnMemThruPtr_mac(mac_data, sizeof(mac_data)+1);
+    netdev_get_mac_ExpectAndReturn(MODULE_0, (uint8_t*)mac_data, 0);
+    netdev_get_mac_IgnoreArg_mac();
+    netdev_get_mac_ReturnMemThruPtr_mac(mac_data, sizeof(mac_data)+1);
     ret = operation_list_update_smac(&stream.operations, MODULE_0);
     TEST_ASSERT_EQUAL(0,ret);
     /* was the smac updated? */
@@ -785,9 +786,9 @@ void test_operation_list_update_smac_module_1(void) {
 
 
     /* execute test case */
-    get_mac_address_ExpectAndReturn(PORT_MODULE_1, (uint8_t*)mac_data, 0);
-    get_mac_address_IgnoreArg_mac();
-    get_mac_address_ReturnMemThruPtr_mac(mac_data, sizeof(mac_data)+1);
+    netdev_get_mac_ExpectAndReturn(MODULE_1, (uint8_t*)mac_data, 0);
+    netdev_get_mac_IgnoreArg_mac();
+    netdev_get_mac_ReturnMemThruPtr_mac(mac_data, sizeof(mac_data)+1);
     ret = operation_list_update_smac(&stream.operations, MODULE_1);
     TEST_ASSERT_EQUAL(0,ret);
     /* was the smac opmem[3] updated? */
@@ -799,6 +800,8 @@ void test_operation_list_update_smac_module_1(void) {
 void test_operation_list_update_smac_invalid_module(void) {
     int ret;
     struct acm_stream stream = STREAM_INITIALIZER(stream, TIME_TRIGGERED_STREAM);
+    netdev_get_mac_ExpectAndReturn(50, NULL, -EACMINTERNAL);
+    netdev_get_mac_IgnoreArg_mac();
     logging_Expect(LOGLEVEL_ERR, "Operation: problem reading MAC address of module");
     ret = operation_list_update_smac(&stream.operations, 50);
     TEST_ASSERT_EQUAL(-EACMINTERNAL, ret);
@@ -86,7 +86,7 @@ void test_schedule_create(void) {
     struct schedule_entry schedule = SCHEDULE_ENTRY_INITIALIZER;
     struct schedule_entry *result;
 
-    acm_zalloc_ExpectAndReturn(sizeof(schedule), &schedule);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_SCHEDULE, &schedule);
     result = schedule_create(10, 30, 20, 300);
     TEST_ASSERT_EQUAL_PTR(&schedule, result);
     TEST_ASSERT_EQUAL(10, result->time_start_ns);
@@ -107,7 +107,7 @@ void test_schedule_create_period_fail(void) {
 void test_schedule_create_neg_mem_alloc(void) {
     struct schedule_entry *result;
 
-    acm_zalloc_ExpectAndReturn(sizeof(struct schedule_entry), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_SCHEDULE, NULL);
     logging_Expect(LOGLEVEL_ERR, "%s: Out of memory");
 
     result = schedule_create(10, 30, 20, 500);
@@ -117,7 +117,7 @@ void test_schedule_create_neg_mem_alloc(void) {
 void test_schedule_destroy(void) {
     struct schedule_entry schedule = SCHEDULE_ENTRY_INITIALIZER;
 
-    acm_free_Expect(&schedule);
+    acm_arena_free_Expect(ACM_ARENA_SCHEDULE, &schedule);
     schedule_destroy(&schedule);
 }
 
@@ -143,7 +143,7 @@ void test_schedule_list_flush(void) {
     TEST_ASSERT_EQUAL(10, ACMLIST_COUNT(&list));
 
     for (i = 0; i < 10; ++i)
-        acm_free_Expect(&schedule[i]);
+        acm_arena_free_Expect(ACM_ARENA_SCHEDULE, &schedule[i]);
 
     schedule_list_flush(&list);
     TEST_ASSERT_EQUAL(0, ACMLIST_COUNT(&list));
@@ -178,12 +178,12 @@ void test_schedule_list_remove_schedule(void) {
     TEST_ASSERT_EQUAL_PTR(&schedule[9], schedule[8].entry.tqe.tqe_next);
 
     /* execute test case*/
-    acm_free_Expect(&schedule[4]);
+    acm_arena_free_Expect(ACM_ARENA_SCHEDULE, &schedule[4]);
     schedule_list_remove_schedule(&list, &schedule[4]);
     TEST_ASSERT_EQUAL(9, ACMLIST_COUNT(&list));
     TEST_ASSERT_EQUAL_PTR(&schedule[5], schedule[3].entry.tqe.tqe_next);
 
-    acm_free_Expect(&schedule[9]);
+    acm_arena_free_Expect(ACM_ARENA_SCHEDULE, &schedule[9]);
     schedule_list_remove_schedule(&list, &schedule[9]);
     TEST_ASSERT_EQUAL(8, ACMLIST_COUNT(&list));
     TEST_ASSERT_EQUAL_PTR(NULL, schedule[8].entry.tqe.tqe_next);
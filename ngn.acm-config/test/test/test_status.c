@@ -1,4 +1,7 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -27,9 +30,30 @@ void setUp(void)
 
 void tearDown(void)
 {
+    status_close_items();
     teardown_sysfs();
 }
 
+static void write_status_items(int module_id, bool errors, int64_t base) {
+    enum acm_status_item id;
+    char path_name[SYSFS_PATH_LENGTH];
+    FILE *file;
+
+    for (id = 0; id < STATUS_ITEM_NUM; id++) {
+        bool error_item = strcmp(status_subpath[id].group, "error") == 0;
+
+        if (error_item && !errors)
+            continue;
+        snprintf(path_name, sizeof (path_name), ACMDEV_BASE "%s/%s_M%d",
+                status_subpath[id].group, status_subpath[id].subpath, module_id);
+        file = fopen(path_name, "w");
+        TEST_ASSERT_NOT_NULL(file);
+        /* error items are provided as hex values by the driver */
+        fprintf(file, error_item ? "0X%llX\n" : "%lld\n", (long long) (base + id));
+        fclose(file);
+    }
+}
+
 void test_status_read_item(void) {
     int64_t status_value;
     char path[] = ACMDEV_BASE "/status/disable_overrun_prev_M0";
@@ -335,6 +359,335 @@ void test_status_read_capability_invalid_input(void) {
     TEST_ASSERT_EQUAL(-EINVAL, result);
 }
 
+void test_status_read_redundancy_stats_null(void) {
+    int result;
+
+    logging_Expect(0, "Status: Invalid redundancy statistics input");
+    result = status_read_redundancy_stats(NULL);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+}
+
+void test_status_read_redundancy_stats_problem_read(void) {
+    int result;
+    struct acm_redundancy_stats stats;
+
+    sysfs_construct_path_name_IgnoreAndReturn(0);
+    read_buffer_sysfs_item_ExpectAndReturn(NULL, NULL,
+            sizeof (struct acmdrv_redun_stats), 0, -EACCES);
+    read_buffer_sysfs_item_IgnoreArg_path_name();
+    read_buffer_sysfs_item_IgnoreArg_buffer();
+    logging_Expect(0, "Status: problem reading data from file %s");
+    result = status_read_redundancy_stats(&stats);
+    TEST_ASSERT_EQUAL(-EACCES, result);
+}
+
+void test_status_read_redundancy_stats(void) {
+    int result;
+    struct acm_redundancy_stats stats;
+    struct acmdrv_redun_stats packed;
+
+    memset(&stats, 0, sizeof(stats));
+    memset(&packed, 0, sizeof(packed));
+    packed.timestamp.tv_sec = 1000;
+    packed.timestamp.tv_nsec = 500;
+    packed.samples = 100;
+    packed.individual_timeouts[1][15] = 3;
+    packed.entry[31].passed = 0x100000000ULL;
+    packed.entry[31].recoveries = 1;
+    packed.entry[31].duplicates = 2;
+    packed.entry[31].errors = 3;
+    packed.entry[31].out_of_order = 4;
+    packed.entry[31].resets = 5;
+    packed.entry[31].timeouts = 6;
+    packed.entry[31].passed_rate = 7;
+    packed.entry[31].duplicate_rate = 8;
+
+    sysfs_construct_path_name_IgnoreAndReturn(0);
+    read_buffer_sysfs_item_ExpectAndReturn(NULL, NULL, sizeof (packed), 0, 0);
+    read_buffer_sysfs_item_IgnoreArg_path_name();
+    read_buffer_sysfs_item_IgnoreArg_buffer();
+    read_buffer_sysfs_item_ReturnMemThruPtr_buffer(&packed, sizeof(packed));
+    result = status_read_redundancy_stats(&stats);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_INT64(1000, stats.timestamp.tv_sec);
+    TEST_ASSERT_EQUAL_INT64(500, stats.timestamp.tv_nsec);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.samples);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.individual_timeouts[1][15]);
+    TEST_ASSERT_EQUAL_UINT64(0x100000000ULL, stats.entry[31].passed);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.entry[31].recoveries);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.entry[31].duplicates);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.entry[31].errors);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.entry[31].out_of_order);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.entry[31].resets);
+    TEST_ASSERT_EQUAL_UINT32(6, stats.entry[31].timeouts);
+    TEST_ASSERT_EQUAL_UINT32(7, stats.entry[31].passed_rate);
+    TEST_ASSERT_EQUAL_UINT32(8, stats.entry[31].duplicate_rate);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.entry[0].passed);
+}
+
+void test_status_reset_redundancy_stats(void) {
+    int result;
+
+    sysfs_construct_path_name_IgnoreAndReturn(0);
+    write_file_sysfs_ExpectAndReturn(NULL, NULL, sizeof (uint32_t), 0, 0);
+    write_file_sysfs_IgnoreArg_path_name();
+    write_file_sysfs_IgnoreArg_buffer();
+    result = status_reset_redundancy_stats();
+    TEST_ASSERT_EQUAL(0, result);
+}
+
+void test_status_read_diag_thresholds_null(void) {
+    int result;
+
+    logging_Expect(0, "Status: Invalid diagnostic thresholds input");
+    result = status_read_diag_thresholds(MODULE_0, NULL);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+}
+
+void test_status_read_diag_thresholds_wrong_module(void) {
+    int result;
+    struct acm_diag_thresholds thresholds;
+
+    logging_Expect(0, "Status: module_id out of range: %d");
+    result = status_read_diag_thresholds(ACM_MODULES_COUNT, &thresholds);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+}
+
+void test_status_read_diag_thresholds(void) {
+    int result;
+    struct acm_diag_thresholds thresholds;
+    struct acmdrv_diag_thresholds packed;
+    char path[] = ACMDEV_BASE "diag/diag_thresholds_M1";
+
+    memset(&thresholds, 0, sizeof(thresholds));
+    memset(&packed, 0, sizeof(packed));
+    packed.rule[ACMDRV_DIAG_RECOVERY][15].limit = 10;
+    packed.rule[ACMDRV_DIAG_RECOVERY][15].holdoff = 1000;
+
+    sysfs_construct_path_name_ExpectAndReturn(NULL, SYSFS_PATH_LENGTH, "diag",
+            "diag_thresholds_M1", 0);
+    sysfs_construct_path_name_IgnoreArg_path_name();
+    sysfs_construct_path_name_ReturnMemThruPtr_path_name(path, strlen(path) + 1);
+    read_buffer_sysfs_item_ExpectAndReturn(path, NULL, sizeof (packed), 0, 0);
+    read_buffer_sysfs_item_IgnoreArg_buffer();
+    read_buffer_sysfs_item_ReturnMemThruPtr_buffer(&packed, sizeof(packed));
+    result = status_read_diag_thresholds(MODULE_1, &thresholds);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_UINT32(10, thresholds.rule[ACM_DIAG_RECOVERY][15].limit);
+    TEST_ASSERT_EQUAL_UINT32(1000, thresholds.rule[ACM_DIAG_RECOVERY][15].holdoff_ms);
+    TEST_ASSERT_EQUAL_UINT32(0, thresholds.rule[ACM_DIAG_INGRESS_WINDOW_CLOSED][0].limit);
+}
+
+static struct acmdrv_diag_thresholds written_thresholds;
+
+static int stub_write_diag_thresholds(const char *path_name, void *buffer,
+        size_t buffer_length, off_t offset, int num_calls) {
+    TEST_ASSERT_EQUAL(0, num_calls);
+    TEST_ASSERT_EQUAL(sizeof (written_thresholds), buffer_length);
+    TEST_ASSERT_EQUAL(0, offset);
+    memcpy(&written_thresholds, buffer, buffer_length);
+    return 0;
+}
+
+void test_status_write_diag_thresholds(void) {
+    int result;
+    struct acm_diag_thresholds thresholds;
+    struct acmdrv_diag_thresholds packed;
+
+    memset(&thresholds, 0, sizeof(thresholds));
+    memset(&packed, 0, sizeof(packed));
+    thresholds.rule[ACM_DIAG_NO_FRAME_RECEIVED][3].limit = 1;
+    thresholds.rule[ACM_DIAG_NO_FRAME_RECEIVED][3].holdoff_ms = 500;
+    packed.rule[ACMDRV_DIAG_NO_FRAME_RECEIVED][3].limit = 1;
+    packed.rule[ACMDRV_DIAG_NO_FRAME_RECEIVED][3].holdoff = 500;
+
+    sysfs_construct_path_name_IgnoreAndReturn(0);
+    write_file_sysfs_StubWithCallback(stub_write_diag_thresholds);
+    result = status_write_diag_thresholds(MODULE_0, &thresholds);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_MEMORY(&packed, &written_thresholds, sizeof(packed));
+}
+
+void test_status_read_diag_alarm_problem_read(void) {
+    int result;
+    struct acm_diag_alarm alarm;
+
+    sysfs_construct_path_name_IgnoreAndReturn(0);
+    read_buffer_sysfs_item_ExpectAndReturn(NULL, NULL,
+            sizeof (struct acmdrv_diag_alarm), 0, -EACCES);
+    read_buffer_sysfs_item_IgnoreArg_path_name();
+    read_buffer_sysfs_item_IgnoreArg_buffer();
+    logging_Expect(0, "Status: problem reading data from file %s");
+    result = status_read_diag_alarm(MODULE_0, &alarm);
+    TEST_ASSERT_EQUAL(-EACCES, result);
+}
+
+void test_status_read_diag_alarm(void) {
+    int result;
+    struct acm_diag_alarm alarm;
+    struct acmdrv_diag_alarm packed;
+
+    memset(&alarm, 0, sizeof(alarm));
+    memset(&packed, 0, sizeof(packed));
+    packed.timestamp.tv_sec = 1000;
+    packed.timestamp.tv_nsec = 500;
+    packed.seq = 2;
+    packed.suppressed = 5;
+    packed.rules[ACMDRV_DIAG_ADDITIONAL_FILTER_MISMATCH] = 0x8001;
+    packed.delta[ACMDRV_DIAG_ADDITIONAL_FILTER_MISMATCH][15] = 7;
+
+    sysfs_construct_path_name_IgnoreAndReturn(0);
+    read_buffer_sysfs_item_ExpectAndReturn(NULL, NULL, sizeof (packed), 0, 0);
+    read_buffer_sysfs_item_IgnoreArg_path_name();
+    read_buffer_sysfs_item_IgnoreArg_buffer();
+    read_buffer_sysfs_item_ReturnMemThruPtr_buffer(&packed, sizeof(packed));
+    result = status_read_diag_alarm(MODULE_1, &alarm);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_INT64(1000, alarm.timestamp.tv_sec);
+    TEST_ASSERT_EQUAL_INT64(500, alarm.timestamp.tv_nsec);
+    TEST_ASSERT_EQUAL_UINT32(2, alarm.sequence);
+    TEST_ASSERT_EQUAL_UINT32(5, alarm.suppressed);
+    TEST_ASSERT_EQUAL_HEX32(0x8001, alarm.rules[ACM_DIAG_ADDITIONAL_FILTER_MISMATCH]);
+    TEST_ASSERT_EQUAL_UINT32(7, alarm.delta[ACM_DIAG_ADDITIONAL_FILTER_MISMATCH][15]);
+    TEST_ASSERT_EQUAL_HEX32(0, alarm.rules[ACM_DIAG_RECOVERY]);
+}
+
+void test_status_wait_diag_alarm_open_fail(void) {
+    int result;
+    char path[] = "/nonexistent/diag/diag_alarm_M0";
+
+    sysfs_construct_path_name_ExpectAndReturn(NULL, SYSFS_PATH_LENGTH, "diag",
+            "diag_alarm_M0", 0);
+    sysfs_construct_path_name_IgnoreArg_path_name();
+    sysfs_construct_path_name_ReturnMemThruPtr_path_name(path, strlen(path) + 1);
+    logging_Expect(0, "Status: open file %s failed");
+    result = status_wait_diag_alarm(MODULE_0, 10, NULL);
+    TEST_ASSERT_EQUAL(-ENOENT, result);
+}
+
+void test_status_read_failover_policy_wrong_module(void) {
+    int result;
+    struct acm_failover_policy policy;
+
+    logging_Expect(0, "Status: module_id out of range: %d");
+    result = status_read_failover_policy(ACM_MODULES_COUNT, &policy);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+}
+
+void test_status_read_failover_policy(void) {
+    int result;
+    struct acm_failover_policy policy;
+    struct acmdrv_failover_policy packed;
+    char path[] = ACMDEV_BASE "config_bin/failover_policy";
+
+    memset(&policy, 0, sizeof(policy));
+    packed.link_down = ACMDRV_FAILOVER_SCHEDULER | ACMDRV_FAILOVER_NOTIFY;
+    packed.link_up = ACMDRV_FAILOVER_SCHEDULER;
+
+    sysfs_construct_path_name_ExpectAndReturn(NULL, SYSFS_PATH_LENGTH, "config_bin",
+            "failover_policy", 0);
+    sysfs_construct_path_name_IgnoreArg_path_name();
+    sysfs_construct_path_name_ReturnMemThruPtr_path_name(path, strlen(path) + 1);
+    read_buffer_sysfs_item_ExpectAndReturn(path, NULL, sizeof (packed), sizeof (packed), 0);
+    read_buffer_sysfs_item_IgnoreArg_buffer();
+    read_buffer_sysfs_item_ReturnMemThruPtr_buffer(&packed, sizeof(packed));
+    result = status_read_failover_policy(MODULE_1, &policy);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_HEX32(ACM_FAILOVER_SCHEDULER | ACM_FAILOVER_NOTIFY, policy.link_down);
+    TEST_ASSERT_EQUAL_HEX32(ACM_FAILOVER_SCHEDULER, policy.link_up);
+}
+
+void test_status_write_failover_policy_invalid(void) {
+    int result;
+    struct acm_failover_policy policy;
+
+    policy.link_down = ACM_FAILOVER_MSGBUF;
+    policy.link_up = 0x100;
+    logging_Expect(0, "Status: Invalid failover policy input");
+    result = status_write_failover_policy(MODULE_0, &policy);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+}
+
+static struct acmdrv_failover_policy written_policy;
+
+static int stub_write_failover_policy(const char *path_name, void *buffer,
+        size_t buffer_length, off_t offset, int num_calls) {
+    TEST_ASSERT_EQUAL(0, num_calls);
+    TEST_ASSERT_EQUAL(sizeof (written_policy), buffer_length);
+    TEST_ASSERT_EQUAL(sizeof (written_policy), offset);
+    memcpy(&written_policy, buffer, buffer_length);
+    return 0;
+}
+
+void test_status_write_failover_policy(void) {
+    int result;
+    struct acm_failover_policy policy;
+
+    policy.link_down = ACM_FAILOVER_RECOVERY | ACM_FAILOVER_MSGBUF;
+    policy.link_up = ACM_FAILOVER_MSGBUF | ACM_FAILOVER_NOTIFY;
+
+    sysfs_construct_path_name_IgnoreAndReturn(0);
+    write_file_sysfs_StubWithCallback(stub_write_failover_policy);
+    result = status_write_failover_policy(MODULE_1, &policy);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_HEX32(ACMDRV_FAILOVER_RECOVERY | ACMDRV_FAILOVER_MSGBUF,
+            written_policy.link_down);
+    TEST_ASSERT_EQUAL_HEX32(ACMDRV_FAILOVER_MSGBUF | ACMDRV_FAILOVER_NOTIFY,
+            written_policy.link_up);
+}
+
+void test_status_read_link_event_null(void) {
+    int result;
+
+    logging_Expect(0, "Status: Invalid link event input");
+    result = status_read_link_event(MODULE_0, NULL);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+}
+
+void test_status_read_link_event(void) {
+    int result;
+    struct acm_link_event event;
+    struct acmdrv_link_event packed;
+
+    memset(&event, 0, sizeof(event));
+    memset(&packed, 0, sizeof(packed));
+    packed.seq = 3;
+    packed.link_up = 1;
+    packed.actions = ACMDRV_FAILOVER_MSGBUF | ACMDRV_FAILOVER_NOTIFY;
+    packed.msgbuf_invalid = 0x5;
+    packed.duration = 12000;
+    packed.timestamp.tv_sec = 1000;
+    packed.timestamp.tv_nsec = 500;
+
+    sysfs_construct_path_name_IgnoreAndReturn(0);
+    read_buffer_sysfs_item_ExpectAndReturn(NULL, NULL, sizeof (packed), 0, 0);
+    read_buffer_sysfs_item_IgnoreArg_path_name();
+    read_buffer_sysfs_item_IgnoreArg_buffer();
+    read_buffer_sysfs_item_ReturnMemThruPtr_buffer(&packed, sizeof(packed));
+    result = status_read_link_event(MODULE_0, &event);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL_UINT32(3, event.sequence);
+    TEST_ASSERT_TRUE(event.link_up);
+    TEST_ASSERT_EQUAL_HEX32(ACM_FAILOVER_MSGBUF | ACM_FAILOVER_NOTIFY, event.actions);
+    TEST_ASSERT_EQUAL_HEX32(0x5, event.msgbuf_invalid);
+    TEST_ASSERT_EQUAL_UINT32(12000, event.duration_ns);
+    TEST_ASSERT_EQUAL_INT64(1000, event.timestamp.tv_sec);
+    TEST_ASSERT_EQUAL_INT64(500, event.timestamp.tv_nsec);
+}
+
+void test_status_wait_link_event_open_fail(void) {
+    int result;
+    char path[] = "/nonexistent/config_bin/link_event";
+
+    sysfs_construct_path_name_ExpectAndReturn(NULL, SYSFS_PATH_LENGTH, "config_bin",
+            "link_event", 0);
+    sysfs_construct_path_name_IgnoreArg_path_name();
+    sysfs_construct_path_name_ReturnMemThruPtr_path_name(path, strlen(path) + 1);
+    logging_Expect(0, "Status: open file %s failed");
+    result = status_wait_link_event(MODULE_1, 10, NULL);
+    TEST_ASSERT_EQUAL(-ENOENT, result);
+}
+
 void test_status_set_diagnostics_poll_time(void) {
     int result;
     char path[] = ACMDEV_BASE "diag/diag_poll_time_M0";
@@ -797,3 +1150,65 @@ void test_status_get_ip_version_neg_read3(void) {
     result = status_get_ip_version();
     TEST_ASSERT_EQUAL_STRING(NULL, result);
 }
+
+void test_status_read_all(void) {
+    struct acm_status status;
+    enum acm_status_item id;
+
+    write_status_items(1, false, 100);
+    TEST_ASSERT_EQUAL(0, status_read_all(ACM_STATUS_SELECT_MODULE_1, &status));
+    TEST_ASSERT_EQUAL(ACM_STATUS_SELECT_MODULE_1, status.select);
+    for (id = 0; id < STATUS_ITEM_NUM; id++) {
+        TEST_ASSERT_EQUAL_INT64(-ENODATA, status.item[0][id]);
+        if (strcmp(status_subpath[id].group, "error") == 0)
+            TEST_ASSERT_EQUAL_INT64(-ENODATA, status.item[1][id]);
+        else
+            TEST_ASSERT_EQUAL_INT64(100 + id, status.item[1][id]);
+    }
+}
+
+void test_status_read_all_errors(void) {
+    struct acm_status status;
+    enum acm_status_item id;
+
+    write_status_items(0, true, 200);
+    write_status_items(1, true, 300);
+    TEST_ASSERT_EQUAL(0, status_read_all(ACM_STATUS_SELECT_MODULE_0 | ACM_STATUS_SELECT_MODULE_1
+            | ACM_STATUS_SELECT_ERRORS, &status));
+    for (id = 0; id < STATUS_ITEM_NUM; id++) {
+        TEST_ASSERT_EQUAL_INT64(200 + id, status.item[0][id]);
+        TEST_ASSERT_EQUAL_INT64(300 + id, status.item[1][id]);
+    }
+}
+
+void test_status_read_all_reread(void) {
+    struct acm_status status;
+
+    write_status_items(0, false, 10);
+    TEST_ASSERT_EQUAL(0, status_read_all(ACM_STATUS_SELECT_MODULE_0, &status));
+    TEST_ASSERT_EQUAL_INT64(10 + STATUS_RX_FRAMES_PREV_CYCLE,
+            status.item[0][STATUS_RX_FRAMES_PREV_CYCLE]);
+
+    /* kept files provide the current value */
+    write_status_items(0, false, 1000);
+    TEST_ASSERT_EQUAL(0, status_read_all(ACM_STATUS_SELECT_MODULE_0, &status));
+    TEST_ASSERT_EQUAL_INT64(1000 + STATUS_RX_FRAMES_PREV_CYCLE,
+            status.item[0][STATUS_RX_FRAMES_PREV_CYCLE]);
+}
+
+void test_status_read_all_neg_select(void) {
+    struct acm_status status;
+
+    logging_Ignore();
+    TEST_ASSERT_EQUAL(-EINVAL, status_read_all(0, &status));
+    TEST_ASSERT_EQUAL(-EINVAL, status_read_all(ACM_STATUS_SELECT_ERRORS, &status));
+    TEST_ASSERT_EQUAL(-EINVAL, status_read_all(ACM_STATUS_SELECT_MODULE_0 | 0x80, &status));
+    TEST_ASSERT_EQUAL(-EINVAL, status_read_all(ACM_STATUS_SELECT_MODULE_0, NULL));
+}
+
+void test_status_read_all_neg_no_file(void) {
+    struct acm_status status;
+
+    logging_Ignore();
+    TEST_ASSERT_EQUAL(-ENODEV, status_read_all(ACM_STATUS_SELECT_MODULE_0, &status));
+}
@@ -33,7 +33,7 @@ void test_stream_create(void) {
     struct acm_stream stream_mem = STREAM_INITIALIZER(stream_mem, INGRESS_TRIGGERED_STREAM);
 
     for (stream_type = 0; stream_type < MAX_STREAM_TYPE; stream_type++) {
-        acm_zalloc_ExpectAndReturn(sizeof (*stream), &stream_mem);
+        acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem);
         operation_list_init_ExpectAndReturn(&stream_mem.operations, 0);
         schedule_list_init_ExpectAndReturn(&stream_mem.windows, 0);
 
@@ -62,7 +62,7 @@ void test_stream_create_invalid_type2(void) {
 void test_stream_create_no_mem(void) {
     struct acm_stream *stream;
 
-    acm_zalloc_ExpectAndReturn(sizeof (*stream), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, NULL);
     logging_Expect(0, "Stream: Out of memory");
     stream = stream_create(INGRESS_TRIGGERED_STREAM);
     TEST_ASSERT_EQUAL_PTR(NULL, stream);
@@ -73,10 +73,10 @@ void test_stream_create_operations_fail(void) {
     struct acm_stream stream_mem;
     memset(&stream_mem, 0, sizeof (stream_mem));
 
-    acm_zalloc_ExpectAndReturn(sizeof (*stream), &stream_mem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem);
     operation_list_init_ExpectAndReturn(&stream_mem.operations, -EINVAL);
     logging_Expect(0, "Stream: Could not initialize operation list");
-    acm_free_Expect(&stream_mem);
+    acm_arena_free_Expect(ACM_ARENA_STREAM, &stream_mem);
 
     stream = stream_create(INGRESS_TRIGGERED_STREAM);
     TEST_ASSERT_EQUAL_PTR(NULL, stream);
@@ -87,12 +87,12 @@ void test_stream_create_windows_fail(void) {
     struct acm_stream stream_mem;
     memset(&stream_mem, 0, sizeof (stream_mem));
 
-    acm_zalloc_ExpectAndReturn(sizeof (*stream), &stream_mem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem);
     operation_list_init_ExpectAndReturn(&stream_mem.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem.windows, -EINVAL);
     logging_Expect(0, "Stream: Could not initialize schedule list");
     operation_list_flush_Expect(&stream_mem.operations);
-    acm_free_Expect(&stream_mem);
+    acm_arena_free_Expect(ACM_ARENA_STREAM, &stream_mem);
 
     stream = stream_create(INGRESS_TRIGGERED_STREAM);
     TEST_ASSERT_EQUAL_PTR(NULL, stream);
@@ -104,7 +104,7 @@ void test_stream_destroy(void) {
     operation_list_flush_Expect(&stream_mem.operations);
     schedule_list_flush_Expect(&stream_mem.windows);
     lookup_destroy_Expect(stream_mem.lookup);
-    acm_free_Expect(&stream_mem);
+    acm_arena_free_Expect(ACM_ARENA_STREAM, &stream_mem);
 
     stream_destroy(&stream_mem);
 }
@@ -155,14 +155,14 @@ void test_stream_delete_reference_redundant_changes_to_time_triggered(void) {
     memset(&stream_mem, 0, sizeof (stream_mem));
 
     /* prepare test case */
-    acm_zalloc_ExpectAndReturn(sizeof (*stream_ref), &stream_mem_ref);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem_ref);
     operation_list_init_ExpectAndReturn(&stream_mem_ref.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem_ref.windows, 0);
     stream_ref = stream_create(TIME_TRIGGERED_STREAM);
     TEST_ASSERT_EQUAL_PTR(&stream_mem_ref, stream_ref);
     TEST_ASSERT_EQUAL(TIME_TRIGGERED_STREAM, stream_ref->type);
 
-    acm_zalloc_ExpectAndReturn(sizeof (*stream), &stream_mem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem);
     operation_list_init_ExpectAndReturn(&stream_mem.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem.windows, 0);
     stream = stream_create(TIME_TRIGGERED_STREAM);
@@ -180,7 +180,7 @@ void test_stream_delete_reference_redundant_changes_to_time_triggered(void) {
     operation_list_flush_Expect(&stream_mem.operations);
     schedule_list_flush_Expect(&stream_mem.windows);
     lookup_destroy_Expect(stream_mem.lookup);
-    acm_free_Expect(&stream_mem);
+    acm_arena_free_Expect(ACM_ARENA_STREAM, &stream_mem);
 
     stream_delete(stream);
 
@@ -197,12 +197,12 @@ void test_stream_delete_event_has_parent(void) {
     memset(&stream_mem, 0, sizeof (stream_mem));
 
     /* prepare test case */
-    acm_zalloc_ExpectAndReturn(sizeof (*stream_ref), &stream_mem_ref);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem_ref);
     operation_list_init_ExpectAndReturn(&stream_mem_ref.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem_ref.windows, 0);
     stream_ref = stream_create(EVENT_STREAM);
 
-    acm_zalloc_ExpectAndReturn(sizeof (*stream), &stream_mem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem);
     operation_list_init_ExpectAndReturn(&stream_mem.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem.windows, 0);
     stream = stream_create(INGRESS_TRIGGERED_STREAM);
@@ -232,12 +232,12 @@ void test_stream_delete_reference_event_also_destroyed(void) {
     memset(&stream_mem, 0, sizeof (stream_mem));
 
     /* execute test case */
-    acm_zalloc_ExpectAndReturn(sizeof (*stream_ref), &stream_mem_ref);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem_ref);
     operation_list_init_ExpectAndReturn(&stream_mem_ref.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem_ref.windows, 0);
     stream_ref = stream_create(EVENT_STREAM);
 
-    acm_zalloc_ExpectAndReturn(sizeof (*stream), &stream_mem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem);
     operation_list_init_ExpectAndReturn(&stream_mem.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem.windows, 0);
     stream = stream_create(INGRESS_TRIGGERED_STREAM);
@@ -255,11 +255,11 @@ void test_stream_delete_reference_event_also_destroyed(void) {
     operation_list_flush_Expect(&stream_mem_ref.operations);
     schedule_list_flush_Expect(&stream_mem_ref.windows);
     lookup_destroy_Expect(stream_mem_ref.lookup);
-    acm_free_Expect(&stream_mem_ref);
+    acm_arena_free_Expect(ACM_ARENA_STREAM, &stream_mem_ref);
     operation_list_flush_Expect(&stream_mem.operations);
     schedule_list_flush_Expect(&stream_mem.windows);
     lookup_destroy_Expect(stream_mem.lookup);
-    acm_free_Expect(&stream_mem);
+    acm_arena_free_Expect(ACM_ARENA_STREAM, &stream_mem);
 
     stream_delete(stream);
 }
@@ -276,17 +276,17 @@ void test_stream_delete_reference_event_recovery_also_destroyed(void) {
     memset(&stream_mem, 0, sizeof (stream_mem));
 
     /* prepare test case */
-    acm_zalloc_ExpectAndReturn(sizeof (*stream_ref_ref), &stream_mem_ref_ref);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem_ref_ref);
     operation_list_init_ExpectAndReturn(&stream_mem_ref_ref.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem_ref_ref.windows, 0);
     stream_ref_ref = stream_create(RECOVERY_STREAM);
 
-    acm_zalloc_ExpectAndReturn(sizeof (*stream_ref), &stream_mem_ref);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem_ref);
     operation_list_init_ExpectAndReturn(&stream_mem_ref.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem_ref.windows, 0);
     stream_ref = stream_create(EVENT_STREAM);
 
-    acm_zalloc_ExpectAndReturn(sizeof (*stream), &stream_mem);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_STREAM, &stream_mem);
     operation_list_init_ExpectAndReturn(&stream_mem.operations, 0);
     schedule_list_init_ExpectAndReturn(&stream_mem.windows, 0);
     stream = stream_create(INGRESS_TRIGGERED_STREAM);
@@ -309,15 +309,15 @@ void test_stream_delete_reference_event_recovery_also_destroyed(void) {
     operation_list_flush_Expect(&stream_mem_ref_ref.operations);
     schedule_list_flush_Expect(&stream_mem_ref_ref.windows);
     lookup_destroy_Expect(stream_mem_ref_ref.lookup);
-    acm_free_Expect(&stream_mem_ref_ref);
+    acm_arena_free_Expect(ACM_ARENA_STREAM, &stream_mem_ref_ref);
     operation_list_flush_Expect(&stream_mem_ref.operations);
     schedule_list_flush_Expect(&stream_mem_ref.windows);
     lookup_destroy_Expect(stream_mem_ref.lookup);
-    acm_free_Expect(&stream_mem_ref);
+    acm_arena_free_Expect(ACM_ARENA_STREAM, &stream_mem_ref);
     operation_list_flush_Expect(&stream_mem.operations);
     schedule_list_flush_Expect(&stream_mem.windows);
     lookup_destroy_Expect(stream_mem.lookup);
-    acm_free_Expect(&stream_mem);
+    acm_arena_free_Expect(ACM_ARENA_STREAM, &stream_mem);
 
     stream_delete(stream);
 }
@@ -1025,7 +1025,7 @@ void test_stream_set_egress_header_event_stream_empty_smac(void) {
 
     operation_create_forward_ExpectAndReturn(OFFSET_DEST_MAC_IN_FRAME, 6, &op_dmac);
     operation_list_add_operation_ExpectAndReturn(&stream_mem.operations, &op_dmac, -EINVAL);
-    acm_free_Expect(&op_dmac);
+    operation_destroy_Expect(&op_dmac);
     TEST_ASSERT_EQUAL(-EINVAL,
             stream_set_egress_header(&stream_mem, dmac, smac, ACM_VLAN_ID_MAX, 6));
 }
@@ -1047,8 +1047,8 @@ void test_stream_set_egress_header_no_event_stream_empty_smac(void) {
     operation_create_insertconstant_ExpectAndReturn(LOCAL_SMAC_CONST, 6, &op_smac);
     operation_list_add_operation_ExpectAndReturn(&stream_mem.operations, &op_smac, -EINVAL);
     operation_list_remove_operation_Expect(&stream_mem.operations, &op_dmac);
-    acm_free_Expect(&op_dmac);
-    acm_free_Expect(&op_smac);
+    operation_destroy_Expect(&op_dmac);
+    operation_destroy_Expect(&op_smac);
     TEST_ASSERT_EQUAL(-EINVAL, stream_set_egress_header(&stream_mem, dmac, smac, 200, 6));
 }
 
@@ -1074,9 +1074,9 @@ void test_stream_set_egress_header_neg_add_operation(void) {
     operation_list_remove_operation_Expect(&stream_mem.operations, &op_dmac);
     operation_list_remove_operation_Expect(&stream_mem.operations, &op_smac);
     //operation_list_add_operation_ExpectAndReturn(&stream_mem.operations, &operation_mem, 0);
-    acm_free_Expect(&op_dmac);
-    acm_free_Expect(&op_smac);
-    acm_free_Expect(&op_vlan);
+    operation_destroy_Expect(&op_dmac);
+    operation_destroy_Expect(&op_smac);
+    operation_destroy_Expect(&op_vlan);
     TEST_ASSERT_EQUAL(-EINVAL, stream_set_egress_header(&stream_mem, dmac, smac, 200, 6));
 }
 
@@ -1099,8 +1099,8 @@ void test_stream_set_egress_header_neg_no_vlan(void) {
     logging_Expect(0, "Stream: No VLAN-ID defined");
     operation_list_remove_operation_Expect(&stream_mem.operations, &op_dmac);
     operation_list_remove_operation_Expect(&stream_mem.operations, &op_smac);
-    acm_free_Expect(&op_dmac);
-    acm_free_Expect(&op_smac);
+    operation_destroy_Expect(&op_dmac);
+    operation_destroy_Expect(&op_smac);
     TEST_ASSERT_EQUAL(-EINVAL,
             stream_set_egress_header(&stream_mem, dmac, smac, ACM_VLAN_ID_MAX, 6));
 }
@@ -1217,7 +1217,7 @@ void test_stream_empty_list(void) {
         operation_list_flush_Expect(&streams[i].operations);
         schedule_list_flush_Expect(&streams[i].windows);
         lookup_destroy_Expect(streams[i].lookup);
-        acm_free_Expect(&streams[i]);
+        acm_arena_free_Expect(ACM_ARENA_STREAM, &streams[i]);
     }
     stream_empty_list(&module.streams);
     TEST_ASSERT_EQUAL(0, ACMLIST_COUNT(&module.streams));
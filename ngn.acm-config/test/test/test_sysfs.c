@@ -9,6 +9,7 @@
 
 /* Module under test */
 #include "sysfs.h"
+#include "capacity.h"
 #include "list.h"
 
 /* directly added modules */
@@ -376,34 +377,34 @@ void test_create_event_sysfs_items(void) {
     log_schedule.period_ns = 500;
     log_schedule.send_time_ns = 70;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), &fsc_schedule_mem1);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem2), &fsc_schedule_mem2);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem2);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem3), &fsc_schedule_mem3);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem3);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem4), &fsc_schedule_mem4);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem4);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem5), &fsc_schedule_mem5);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem5);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem6), &fsc_schedule_mem6);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem6);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem7), &fsc_schedule_mem7);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem7);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem8), &fsc_schedule_mem8);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem8);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem9), &fsc_schedule_mem9);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem9);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem10), &fsc_schedule_mem10);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem10);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
 
@@ -480,13 +481,13 @@ void test_create_event_sysfs_items_small_gap(void) {
     log_schedule2.period_ns = 1000000;
     log_schedule2.send_time_ns = 100004;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), &fsc_schedule_mem1);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
 
     result = create_event_sysfs_items(&log_schedule1, &module, 80, 20, 5);
     TEST_ASSERT_EQUAL(0, result);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem2), &fsc_schedule_mem2);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem2);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
     result = create_event_sysfs_items(&log_schedule2, &module, 80, 20, 5);
@@ -516,7 +517,7 @@ void test_create_event_sysfs_items_null(void) {
     log_schedule.period_ns = 500;
     log_schedule.send_time_ns = 70;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, NULL);
     logging_Expect(0, "Sysfs: Out of memory");
 
     result = create_event_sysfs_items(&log_schedule, &module, 80, 20, 5);
@@ -556,34 +557,34 @@ void test_create_window_sysfs_items(void) {
     log_schedule.time_start_ns = 1500;
     log_schedule.time_end_ns = 1900;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), &fsc_schedule_mem1);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem2), &fsc_schedule_mem2);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem2);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem3), &fsc_schedule_mem3);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem3);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem4), &fsc_schedule_mem4);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem4);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem5), &fsc_schedule_mem5);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem5);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem6), &fsc_schedule_mem6);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem6);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem7), &fsc_schedule_mem7);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem7);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem8), &fsc_schedule_mem8);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem8);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem9), &fsc_schedule_mem9);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem9);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem10), &fsc_schedule_mem10);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem10);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
 
@@ -650,16 +651,16 @@ void test_create_window_sysfs_items_recovery(void) {
     log_schedule.time_start_ns = 1200;
     log_schedule.time_end_ns = 3800;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), &fsc_schedule_mem1);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem2), &fsc_schedule_mem2);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem2);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem3), &fsc_schedule_mem3);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem3);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem4), &fsc_schedule_mem4);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem4);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
 
@@ -706,10 +707,10 @@ void test_create_window_sysfs_items_start_next_period(void) {
     log_schedule.time_start_ns = 4700;
     log_schedule.time_end_ns = 4900;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), &fsc_schedule_mem1);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem2), &fsc_schedule_mem2);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem2);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
 
@@ -751,10 +752,10 @@ void test_create_window_sysfs_items_tiny_gap_start_end(void) {
     log_schedule.time_start_ns = 199388;
     log_schedule.time_end_ns = 199308;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), &fsc_schedule_mem1);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem2), &fsc_schedule_mem2);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem2);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
 
@@ -787,8 +788,8 @@ void test_create_window_sysfs_items_neg_conn_mode_default(void) {
     log_schedule.time_start_ns = 1500;
     log_schedule.time_end_ns = 1900;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), &fsc_schedule_mem1);
-    acm_free_Expect(&fsc_schedule_mem1);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
+    acm_arena_free_Expect(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
     logging_Expect(0, "Sysfs: connection mode has undefined value: %d");
 
     result = create_window_sysfs_items(&log_schedule, &module, 80, 111, 12, false);
@@ -812,7 +813,7 @@ void test_create_window_sysfs_items_null_start(void) {
     log_schedule.time_start_ns = 1500;
     log_schedule.time_end_ns = 1900;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, NULL);
     logging_Expect(0, "Sysfs: Out of memory");
 
     result = create_window_sysfs_items(&log_schedule, &module, 80, 111, 12, false);
@@ -844,10 +845,10 @@ void test_create_window_sysfs_items_null_end(void) {
     log_schedule.time_start_ns = 1500;
     log_schedule.time_end_ns = 1900;
 
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), &fsc_schedule_mem1);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, &fsc_schedule_mem1);
     pthread_mutex_lock_ExpectAndReturn(&module.fsc_list.lock, 0);
     pthread_mutex_unlock_ExpectAndReturn(&module.fsc_list.lock, 0);
-    acm_zalloc_ExpectAndReturn(sizeof (fsc_schedule_mem1), NULL);
+    acm_arena_zalloc_ExpectAndReturn(ACM_ARENA_FSC_COMMAND, NULL);
     logging_Expect(0, "Sysfs: Out of memory");
 
     result = create_window_sysfs_items(&log_schedule, &module, 80, 111, 12, false);
@@ -2416,6 +2417,46 @@ void test_sysfs_write_data_constant_buffer(void) {
     close(fd);
 }
 
+void test_sysfs_write_data_constant_buffer_shared(void) {
+    int result;
+    char insert_const1[] = "abcdef";
+    char insert_const2[] = "cde";
+    char insert_const3[] = "efgh";
+    struct acm_module module =
+            MODULE_INITIALIZER(module, CONN_MODE_SERIAL, SPEED_100MBps, MODULE_0, NULL);
+    struct acm_stream stream1 = STREAM_INITIALIZER(stream1, TIME_TRIGGERED_STREAM);
+    struct acm_stream stream2 = STREAM_INITIALIZER(stream2, TIME_TRIGGERED_STREAM);
+    struct operation operation1 = INSERT_CONSTANT_OPERATION_INITIALIZER(insert_const1, 6);
+    struct operation operation2 = INSERT_CONSTANT_OPERATION_INITIALIZER(insert_const2, 3);
+    struct operation operation3 = INSERT_CONSTANT_OPERATION_INITIALIZER(insert_const3, 4);
+    uint8_t expect[] = "abcdefgh";
+    uint8_t read_buffer[sizeof (expect)];
+    int fd;
+
+    _ACMLIST_INSERT_HEAD(&module.streams, &stream1, entry);
+    _ACMLIST_INSERT_TAIL(&module.streams, &stream2, entry);
+    _ACMLIST_INSERT_TAIL(&stream1.operations, &operation1, entry);
+    _ACMLIST_INSERT_TAIL(&stream2.operations, &operation2, entry);
+    _ACMLIST_INSERT_TAIL(&stream2.operations, &operation3, entry);
+
+    pthread_mutex_lock_ExpectAndReturn(&module.streams.lock, 0);
+    pthread_mutex_lock_ExpectAndReturn(&stream1.operations.lock, 0);
+    pthread_mutex_unlock_ExpectAndReturn(&stream1.operations.lock, 0);
+    pthread_mutex_lock_ExpectAndReturn(&stream2.operations.lock, 0);
+    pthread_mutex_unlock_ExpectAndReturn(&stream2.operations.lock, 0);
+    pthread_mutex_unlock_ExpectAndReturn(&module.streams.lock, 0);
+    result = sysfs_write_data_constant_buffer(&module);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(0, operation1.const_buff_offset);
+    TEST_ASSERT_EQUAL(2, operation2.const_buff_offset);
+    TEST_ASSERT_EQUAL(4, operation3.const_buff_offset);
+    fd = open(ACMDEV_BASE "config_bin/const_buffer", O_RDONLY);
+    result = pread(fd, read_buffer, sizeof (read_buffer), 0);
+    close(fd);
+    TEST_ASSERT_EQUAL(sizeof (read_buffer), result);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expect, read_buffer, sizeof (read_buffer));
+}
+
 void test_write_clear_all_fpga(void) {
     int result, fd;
     int32_t read_value;
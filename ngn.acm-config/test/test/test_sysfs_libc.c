@@ -26,6 +26,7 @@
 
 /* Module under test */
 #include "sysfs.h"
+#include "capacity.h"
 
 /* directly added modules */
 #include "libc_helper.h" // <-- used to link in libc helper functions
@@ -1,6 +1,7 @@
 #include "unity.h"
 
 #include "validate.h"
+#include "capacity.h"
 #include "hwconfig_def.h"
 #include "tracing.h"
 
@@ -15,6 +16,7 @@
 #include "mock_module.h"
 #include "mock_stream.h"
 #include "mock_status.h"
+#include "mock_netdev.h"
 
 void __attribute__((weak)) suite_setup(void)
 {
@@ -22,6 +24,7 @@ void __attribute__((weak)) suite_setup(void)
 
 void setUp(void)
 {
+    netdev_check_link_Ignore();
 }
 
 void tearDown(void)
@@ -1236,3 +1239,94 @@ void test_check_stream_payload_neg_max_payload(void) {
     result = check_stream_payload(&stream);
     TEST_ASSERT_EQUAL(-EACMPAYLOAD, result);
 }
+
+void test_module_sum_const_buffer_shared(void) {
+    struct acm_module module =
+            MODULE_INITIALIZER(module, CONN_MODE_SERIAL, SPEED_1GBps, MODULE_0, NULL);
+    struct acm_stream stream1 = STREAM_INITIALIZER(stream1, TIME_TRIGGERED_STREAM);
+    struct acm_stream stream2 = STREAM_INITIALIZER(stream2, TIME_TRIGGERED_STREAM);
+    char data1[] = "abcdef";
+    char data2[] = "bcd";
+    char data3[] = "efgh";
+    struct operation operation1 = INSERT_CONSTANT_OPERATION_INITIALIZER(data1, 6);
+    struct operation operation2 = INSERT_CONSTANT_OPERATION_INITIALIZER(data2, 3);
+    struct operation operation3 = INSERT_CONSTANT_OPERATION_INITIALIZER(data3, 4);
+    struct operation operation4 = INSERT_CONSTANT_OPERATION_INITIALIZER(NULL, 0);
+    int result;
+
+    operation4.length = 5;
+    ACMLIST_INSERT_TAIL(&module.streams, &stream1, entry);
+    ACMLIST_INSERT_TAIL(&module.streams, &stream2, entry);
+    ACMLIST_INSERT_TAIL(&stream1.operations, &operation1, entry);
+    ACMLIST_INSERT_TAIL(&stream2.operations, &operation2, entry);
+    ACMLIST_INSERT_TAIL(&stream2.operations, &operation3, entry);
+    ACMLIST_INSERT_TAIL(&stream2.operations, &operation4, entry);
+
+    result = module_sum_const_buffer(&module);
+    TEST_ASSERT_EQUAL(13, result);
+    result = module_sum_const_buffer(NULL);
+    TEST_ASSERT_EQUAL(0, result);
+}
+
+void test_module_get_usage_invalid_input(void) {
+    struct acm_module module =
+            MODULE_INITIALIZER(module, CONN_MODE_SERIAL, SPEED_1GBps, MODULE_0, NULL);
+    struct acm_module_usage usage;
+    int result;
+
+    logging_Expect(0, "Validate: Invalid module usage input");
+    result = module_get_usage(NULL, &usage);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+    logging_Expect(0, "Validate: Invalid module usage input");
+    result = module_get_usage(&module, NULL);
+    TEST_ASSERT_EQUAL(-EINVAL, result);
+}
+
+void test_module_get_usage(void) {
+    struct acm_module module =
+            MODULE_INITIALIZER(module, CONN_MODE_SERIAL, SPEED_1GBps, MODULE_0, NULL);
+    struct acm_stream stream1 = STREAM_INITIALIZER(stream1, INGRESS_TRIGGERED_STREAM);
+    struct acm_stream stream2 = STREAM_INITIALIZER(stream2, REDUNDANT_STREAM_RX);
+    struct acm_stream stream3 = STREAM_INITIALIZER(stream3, TIME_TRIGGERED_STREAM);
+    struct lookup lookup1, lookup2;
+    char data[] = "constant";
+    struct operation operation1 = INSERT_CONSTANT_OPERATION_INITIALIZER(data, 8);
+    struct operation operation2 = INSERT_CONSTANT_OPERATION_INITIALIZER(data, 8);
+    struct acm_module_usage usage;
+    int result;
+
+    memset(&lookup1, 0, sizeof (lookup1));
+    memset(lookup1.header_mask, 0xFF, 6);
+    memset(lookup1.header, 0x11, 6);
+    /* bytes outside of the mask do not make a difference */
+    memcpy(&lookup2, &lookup1, sizeof (lookup2));
+    lookup2.header[10] = 0x22;
+    stream1.lookup = &lookup1;
+    stream2.lookup = &lookup2;
+    ACMLIST_INSERT_TAIL(&module.streams, &stream1, entry);
+    ACMLIST_INSERT_TAIL(&module.streams, &stream2, entry);
+    ACMLIST_INSERT_TAIL(&module.streams, &stream3, entry);
+    ACMLIST_INSERT_TAIL(&stream3.operations, &operation1, entry);
+    ACMLIST_INSERT_TAIL(&stream3.operations, &operation2, entry);
+
+    stream_num_prefetch_ops_ExpectAndReturn(&stream1, 0);
+    stream_num_gather_ops_ExpectAndReturn(&stream1, 0);
+    stream_num_scatter_ops_ExpectAndReturn(&stream1, 2);
+    stream_num_prefetch_ops_ExpectAndReturn(&stream2, 0);
+    stream_num_gather_ops_ExpectAndReturn(&stream2, 0);
+    stream_num_scatter_ops_ExpectAndReturn(&stream2, 1);
+    stream_num_prefetch_ops_ExpectAndReturn(&stream3, 3);
+    stream_num_gather_ops_ExpectAndReturn(&stream3, 4);
+    stream_num_scatter_ops_ExpectAndReturn(&stream3, 0);
+    result = module_get_usage(&module, &usage);
+    TEST_ASSERT_EQUAL(0, result);
+    TEST_ASSERT_EQUAL(LOOKUP_START_IDX + 2, usage.lookup_rules.used);
+    TEST_ASSERT_EQUAL(ACM_MAX_LOOKUP_ITEMS, usage.lookup_rules.capacity);
+    TEST_ASSERT_EQUAL(SCATTER_START_IDX + 3, usage.scatter_dma.used);
+    TEST_ASSERT_EQUAL(GATHER_START_IDX + 4, usage.gather_dma.used);
+    TEST_ASSERT_EQUAL(REDUNDANCY_START_IDX + 1, usage.redundancy.used);
+    TEST_ASSERT_EQUAL(8, usage.const_buffer.used);
+    TEST_ASSERT_EQUAL(ACM_MAX_CONST_BUFFER_SIZE, usage.const_buffer.capacity);
+    TEST_ASSERT_EQUAL(8, usage.const_buffer_shared);
+    TEST_ASSERT_EQUAL(1, usage.lookup_conflicts);
+}
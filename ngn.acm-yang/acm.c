@@ -26,6 +26,8 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <time.h>
 /* common includes */
 #include "common_defines.h"
 #include "common.h"
@@ -66,6 +68,44 @@ typedef struct TTStream {
 
 static LIST_HEAD( ListOfTTStreams, TTStream ) tt_streams;
 
+/**
+ * @ingroup acminternal
+ * @brief Classes of configuration changes, ordered by the extent of the
+ * device reconfiguration they require.
+ */
+typedef enum {
+    ACM_CHANGE_NONE = 0,    /**< nothing relevant for the device changed */
+    ACM_CHANGE_SCHEDULE,    /**< only schedule parameters changed */
+    ACM_CHANGE_CONFIG,      /**< streams, operations or module parameters changed */
+} acm_change_class_t;
+
+/* Datastore changes committed since the last configuration applied by this plugin.
+ * The device content is unknown until the plugin applied a configuration itself,
+ * so everything is considered changed initially. */
+static acm_change_class_t pending_change = ACM_CHANGE_CONFIG;
+
+/* Request which applied the last configuration, its own changes are not pending. */
+static uint32_t applied_request_id = 0;
+static bool applied_request_valid = false;
+
+/**
+ * @ingroup acminternal
+ * @brief Configuration built and validated in the change phase of a request.
+ */
+typedef struct {
+    bool valid;                     /**< a configuration is prepared */
+    uint32_t request_id;            /**< request the configuration belongs to */
+    struct acm_config *acm;         /**< configuration to be applied */
+    uint32_t config_id;             /**< configuration identifier */
+    bool schedule_only;             /**< apply schedule only */
+    acm_change_class_t change;      /**< changes covered by the configuration */
+} acm_prepared_t;
+
+static acm_prepared_t prepared = {0};
+
+/* Snapshot of the acm configuration while it is processed, see acm_config_tree_load(). */
+static struct lyd_node *acm_config_tree = NULL;
+
 /**
  * @ingroup acminternal
  * @brief Initialize a list of streams.
@@ -133,6 +173,102 @@ void tt_stream_list_clear(void) {
     }
 }
 
+/**
+ * @ingroup acminternal
+ * @brief Fetch the acm configuration from the datastore.
+ *
+ * The configuration is fetched once as data tree, so parsing it does not need a datastore
+ * request per stream, operation or schedule entry. If fetching fails, acm_get_items() falls
+ * back to request the items from the datastore.
+ *
+ * @param[in]   session     Sysrepo session of the current event.
+ */
+static void acm_config_tree_load(sr_session_ctx_t *session)
+{
+    int rc;
+
+    rc = sr_get_subtree(session, ACM_XPATH, 0, &acm_config_tree);
+    if (SR_ERR_OK != rc) {
+        SRP_LOG_WRN("Error by sr_get_subtree: %s", sr_strerror(rc));
+        acm_config_tree = NULL;
+    }
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Release the configuration fetched by acm_config_tree_load().
+ */
+static void acm_config_tree_free(void)
+{
+    lyd_free_withsiblings(acm_config_tree);
+    acm_config_tree = NULL;
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Get the items matching xpath from the acm configuration.
+ *
+ * Same as sr_get_items(), but the items are taken from the configuration fetched by
+ * acm_config_tree_load() if available. The values have to be released with sr_free_values().
+ *
+ * @param[in]   session     Sysrepo session of the current event.
+ * @param[in]   xpath       XPath of the items.
+ * @param[out]  values      Array of the items found.
+ * @param[out]  count       Number of items found.
+ *
+ * @return SR_ERR_OK or error code
+ */
+static int acm_get_items(sr_session_ctx_t *session, const char *xpath, sr_val_t **values, size_t *count)
+{
+    struct ly_set *set = NULL;
+    sr_val_t *val = NULL;
+    unsigned int i;
+    int rc = SR_ERR_OK;
+
+    if (NULL == acm_config_tree) {
+        return sr_get_items(session, xpath, 0, 0, values, count);
+    }
+
+    *values = NULL;
+    *count = 0;
+
+    set = lyd_find_path(acm_config_tree, xpath);
+    if (NULL == set) {
+        SRP_LOG_ERR("Invalid xpath %s.", xpath);
+        return SR_ERR_INVAL_ARG;
+    }
+    if (0 == set->number) {
+        ly_set_free(set);
+        return SR_ERR_OK;
+    }
+
+    *values = calloc(set->number, sizeof(**values));
+    if (NULL == *values) {
+        ly_set_free(set);
+        return SR_ERR_NOMEM;
+    }
+
+    for (i = 0; i < set->number; i++) {
+        rc = sr_tree_to_val(set->set.d[i], ".", &val);
+        if (SR_ERR_OK != rc) {
+            break;
+        }
+        /* move the value into the array, its content is released by sr_free_values */
+        (*values)[i] = *val;
+        free(val);
+        (*count)++;
+    }
+    ly_set_free(set);
+
+    if (SR_ERR_OK != rc) {
+        sr_free_values(*values, *count);
+        *values = NULL;
+        *count = 0;
+    }
+
+    return rc;
+}
+
 /**
  * @brief Callback to be called by the event of changing any running datastore content within the module.
  *
@@ -269,6 +405,166 @@ acm_fill_startup_datastore(sr_session_ctx_t *session)
     return EXIT_SUCCESS;
 }
 
+/**
+ * @ingroup acminternal
+ * @brief Cached operational state of the ACM.
+ *
+ * The status items of a module are read from the device at most once per
+ * freshness window, all operational requests within the window are served
+ * from the cache regardless of the session they originate from.
+ */
+typedef struct {
+    pthread_mutex_t lock;                                           /**< serializes cache refresh and access */
+    uint32_t freshness_ms;                                          /**< freshness window, 0 disables caching */
+    char *ip_version;                                               /**< IP version, constant at runtime */
+    int64_t status[ACM_MODULES_COUNT][STATUS_ITEM_NUM];            /**< status items per module */
+    struct timespec timestamp[ACM_MODULES_COUNT];                   /**< time of last refresh per module */
+    bool valid[ACM_MODULES_COUNT];                                  /**< status of module was read */
+} acm_state_cache_t;
+
+static acm_state_cache_t state_cache = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .freshness_ms = ACM_STATE_CACHE_DEFAULT_MS,
+};
+
+/**
+ * @ingroup acminternal
+ * @brief Initialize the operational state cache.
+ *
+ * The freshness window is taken from the environment variable ACM_STATE_CACHE_MS
+ * if set, otherwise ACM_STATE_CACHE_DEFAULT_MS applies.
+ */
+static void acm_state_cache_init(void)
+{
+    const char *value = getenv(ACM_STATE_CACHE_ENV_STR);
+    char *end = NULL;
+    unsigned long freshness_ms;
+
+    if ((NULL != value) && ('\0' != *value)) {
+        freshness_ms = strtoul(value, &end, 10);
+        if (('\0' == *end) && (freshness_ms <= UINT32_MAX)) {
+            state_cache.freshness_ms = (uint32_t)freshness_ms;
+        } else {
+            SRP_LOG_ERR("%s(): invalid value %s=%s ignored.", __func__, ACM_STATE_CACHE_ENV_STR, value);
+        }
+    }
+    SRP_LOG_DBG("%s(): state freshness window %u ms.", __func__, state_cache.freshness_ms);
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Release resources of the operational state cache.
+ */
+static void acm_state_cache_cleanup(void)
+{
+    pthread_mutex_lock(&state_cache.lock);
+    free(state_cache.ip_version);
+    state_cache.ip_version = NULL;
+    pthread_mutex_unlock(&state_cache.lock);
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Invalidate the cached status items of all modules.
+ *
+ * Called whenever the device configuration changed, as status items of the
+ * old configuration must not be reported for the new one.
+ */
+static void acm_state_cache_invalidate(void)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&state_cache.lock);
+    for (i = 0; i < ACM_MODULES_COUNT; i++) {
+        state_cache.valid[i] = false;
+    }
+    pthread_mutex_unlock(&state_cache.lock);
+}
+
+/* Check if the cached status of a module is within the freshness window (lock held). */
+static bool acm_state_cache_fresh(int index, const struct timespec *now)
+{
+    int64_t age_ms;
+
+    if (!state_cache.valid[index] || (0 == state_cache.freshness_ms)) {
+        return false;
+    }
+
+    age_ms = (int64_t)(now->tv_sec - state_cache.timestamp[index].tv_sec) * 1000 +
+             (now->tv_nsec - state_cache.timestamp[index].tv_nsec) / 1000000;
+
+    return (age_ms >= 0) && (age_ms < (int64_t)state_cache.freshness_ms);
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Get the status items of a module.
+ *
+ * If the cached values are outdated, the status items of all modules are
+ * refreshed from the device with a single acm_read_status() call, as both
+ * modules are usually requested together. Concurrent requests wait for a
+ * running refresh and share its result.
+ *
+ * @param[in]   index   Index of the module of ACM to read the status from.
+ * @param[out]  status  Array of STATUS_ITEM_NUM status items.
+ *
+ * @return SR_ERR_OK or SR_ERR_OPERATION_FAILED if the status cannot be read
+ */
+static int acm_state_cache_get(int index, int64_t *status)
+{
+    struct timespec now;
+    struct acm_status acm_status;
+    unsigned int i;
+    int ret;
+    int rc = SR_ERR_OK;
+
+    pthread_mutex_lock(&state_cache.lock);
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (!acm_state_cache_fresh(index, &now)) {
+        state_cache.valid[index] = false;
+        ret = acm_read_status(ACM_STATUS_SELECT_MODULE_0 | ACM_STATUS_SELECT_MODULE_1 |
+                              ACM_STATUS_SELECT_ERRORS, &acm_status);
+        if (ret < 0) {
+            SRP_LOG_ERR(ERR_ACM_STATUS_STR, ret);
+            rc = SR_ERR_OPERATION_FAILED;
+            goto unlock;
+        }
+        for (i = 0; i < ACM_MODULES_COUNT; i++) {
+            memcpy(state_cache.status[i], acm_status.item[i], sizeof(state_cache.status[i]));
+            state_cache.timestamp[i] = acm_status.timestamp;
+            state_cache.valid[i] = true;
+        }
+    }
+
+    memcpy(status, state_cache.status[index], sizeof(state_cache.status[index]));
+
+unlock:
+    pthread_mutex_unlock(&state_cache.lock);
+
+    return rc;
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Get the IP version string, it is read from the device only once.
+ *
+ * @return IP version string owned by the cache or NULL if it cannot be read
+ */
+static const char *acm_state_cache_ip_version(void)
+{
+    const char *ip_version;
+
+    pthread_mutex_lock(&state_cache.lock);
+    if (NULL == state_cache.ip_version) {
+        state_cache.ip_version = acm_read_ip_version();
+    }
+    ip_version = state_cache.ip_version;
+    pthread_mutex_unlock(&state_cache.lock);
+
+    return ip_version;
+}
+
 /**
  * @brief Creates a new container bypass1 or bypass2 inside container acm inside acm yang module.
  * This function is for state data from container 'acm'.
@@ -282,18 +578,18 @@ static int new_acm_state(struct lyd_node **parent, int index, char *container_na
 {
     char path[MAX_STR_LEN] = {0};
     char tmp[MAX_STR_LEN] = {0};
+    int64_t status[STATUS_ITEM_NUM];
     int64_t acm_status;
     enum acm_status_item i;
 
     SRP_LOG_DBG(DBG_MSG_FUN_CALLED_STR, __func__);
 
-    for (i = STATUS_HALT_ERROR_OCCURED; i < STATUS_ITEM_NUM; i++) {
-        acm_status = acm_read_status_item(index, i);
+    if (SR_ERR_OK != acm_state_cache_get(index, status)) {
+        return SR_ERR_OPERATION_FAILED;
+    }
 
-        if (acm_status < 0) {
-            SRP_LOG_ERR(ERR_ACM_STATUS_MODULE_STR, index, i, acm_status);
-            return SR_ERR_OPERATION_FAILED;
-        }
+    for (i = STATUS_HALT_ERROR_OCCURED; i < STATUS_ITEM_NUM; i++) {
+        acm_status = status[i];
 
         switch (i) {
         case STATUS_HALT_ERROR_OCCURED:
@@ -440,7 +736,7 @@ static int acm_state_cb(sr_session_ctx_t *session, const char *module_name, cons
     SRP_LOG_DBG(DBG_MSG_FUN_CALLED_STR, __func__);
 
     lib_version = acm_read_lib_version();
-    ip_version = acm_read_ip_version();
+    ip_version = acm_state_cache_ip_version();
 
     /* container acm, leaf acm-lib-version */
     /* this need to be done like this because *parent is NULL inside this callback
@@ -493,7 +789,7 @@ int new_base_time(sr_session_ctx_t *session, struct timespec *time, char* contai
 
     fill_xpath(path, ACM_BASE_TIME_XPATH, container_name);
 
-    if (SR_ERR_OK == sr_get_items(session, path, 0, 0, &base_time, &counter)) {
+    if (SR_ERR_OK == acm_get_items(session, path, &base_time, &counter)) {
         /* iterate trough bypass1 or bypass2 container */
         for (i=0; i<(int)counter; i++) {
             /* if leaf seconds inside container base-time is found */
@@ -632,7 +928,7 @@ int new_stream_ops(sr_session_ctx_t *session, char *container_name, char *stream
 
     /* get stream-operations list entry */
     fill_xpath(path, ACM_LIST_STREAM_OPERATION_XPATH, container_name, stream_key, sub_container_name, operation_key);
-    if (SR_ERR_OK == sr_get_items(session, path, 0, 0, &stream_operations_entry, &counter)) {
+    if (SR_ERR_OK == acm_get_items(session, path, &stream_operations_entry, &counter)) {
         for (i=0; i<(int)counter; i++) {
             parse_stream_ops_opcode(stream_operations_entry[i], &opcode, OPC_READ);
             parse_stream_ops_offset(stream_operations_entry[i], &offset);
@@ -1208,7 +1504,7 @@ int new_shedule_window(sr_session_ctx_t *session, char *container_name,char *str
 
     /* get schedule-events list entry */
     fill_xpath(path, ACM_LIST_SCHEDULE_EVENTS_XPATH, container_name, stream_key, schedule_key);
-    if (SR_ERR_OK == sr_get_items(session, path, 0, 0, &schedule_events_entry, &counter)) {
+    if (SR_ERR_OK == acm_get_items(session, path, &schedule_events_entry, &counter)) {
         for (i=0; i<(int)counter; i++) {
             /* if leaf period is found */
             if (true == sr_xpath_node_name_eq(schedule_events_entry[i].xpath, ACM_PERIOD_STR)) {
@@ -1351,7 +1647,7 @@ int new_stream_node(sr_session_ctx_t *session, struct acm_module *module, char *
 
     /* get stream entry who has stream-key=stream_key */
     fill_xpath(path, ACM_LIST_STREAM_XPATH, container_name, stream_key);
-    if (SR_ERR_OK == sr_get_items(session, path, 0, 0, &stream_entry, &counter)) {
+    if (SR_ERR_OK == acm_get_items(session, path, &stream_entry, &counter)) {
         for (i=0; i<(int)counter; i++) {
             /* find stream-key in stream list */
             if (true == sr_xpath_node_name_eq(stream_entry[i].xpath, ACM_STREAM_KEY_STR)) {
@@ -1383,7 +1679,7 @@ int new_stream_node(sr_session_ctx_t *session, struct acm_module *module, char *
         if (true == sr_xpath_node_name_eq(stream_entry[i].xpath, ACM_INGRESS_STREAM_STR)) {
             /* now get every leaf and list instance inside stream list entry inside ingress-stream container */
             fill_xpath(path, ACM_LIST_STREAM_INGRESS_STREAM_CON_XPATH, container_name, stream_key);
-            if (SR_ERR_OK == sr_get_items(session, path, 0, 0, &ingress_stream, &ingress_stream_counter)) {
+            if (SR_ERR_OK == acm_get_items(session, path, &ingress_stream, &ingress_stream_counter)) {
                 if ((int)ingress_stream_counter) {
                     ret = new_ingress_stream(session, module, ingress_stream, ingress_stream_counter, &it_stream, stream_key, container_name);
                     if (EXIT_SUCCESS != ret) {
@@ -1419,7 +1715,7 @@ int new_stream_node(sr_session_ctx_t *session, struct acm_module *module, char *
         if (true == sr_xpath_node_name_eq(stream_entry[i].xpath, ACM_EGRESS_STREAM_STR)) {
             /* now get every leaf and list instance inside stream list entry inside time-triggered-stream container */
             fill_xpath(path, ACM_LIST_STREAM_TIME_TRIGGERED_ST_XPATH, container_name, stream_key);
-            if (SR_ERR_OK == sr_get_items(session, path, 0, 0, &egress_stream, &egress_stream_counter)) {
+            if (SR_ERR_OK == acm_get_items(session, path, &egress_stream, &egress_stream_counter)) {
                 if ((int)egress_stream_counter) {
                     ret = new_egress_stream(session, module, egress_stream, egress_stream_counter, &tt_stream, stream_key, container_name);
                     if (EXIT_SUCCESS != ret) {
@@ -1455,7 +1751,7 @@ int new_stream_node(sr_session_ctx_t *session, struct acm_module *module, char *
         if (true == sr_xpath_node_name_eq(stream_entry[i].xpath, ACM_EVENT_STREAM_STR)) {
             /* now get every leaf and list instance inside stream list entry inside event-stream container */
             fill_xpath(path, ACM_LIST_STREAM_EVENT_STREAM_XPATH, container_name, stream_key);
-            if (SR_ERR_OK == sr_get_items(session, path, 0, 0, &event_stream, &event_stream_counter)) {
+            if (SR_ERR_OK == acm_get_items(session, path, &event_stream, &event_stream_counter)) {
                 if ((int)event_stream_counter) {
                     /* go event-stream container */
                     ret =  new_event_stream(session, module, event_stream, event_stream_counter, it_stream, &e_stream, stream_key, container_name);
@@ -1478,7 +1774,7 @@ int new_stream_node(sr_session_ctx_t *session, struct acm_module *module, char *
         if (true == sr_xpath_node_name_eq(stream_entry[i].xpath, ACM_EGRESS_STREAM_RECOVERY_STR)) {
             /* now get every leaf and list instance inside stream list entry inside egress-stream-recovery container */
             fill_xpath(path, ACM_LIST_STREAM_EGGRESS_STREAM_REC_XPATH, container_name, stream_key);
-            if (SR_ERR_OK == sr_get_items(session, path, 0, 0, &egress_stream_recovery, &egress_stream_recovery_counter)) {
+            if (SR_ERR_OK == acm_get_items(session, path, &egress_stream_recovery, &egress_stream_recovery_counter)) {
                 if ((int)egress_stream_recovery_counter) {
                     ret =  new_egress_stream_recovery(session, module, egress_stream_recovery, egress_stream_recovery_counter, e_stream, stream_key, container_name);
                     if (EXIT_SUCCESS != ret) {
@@ -1513,7 +1809,7 @@ int new_stream_node(sr_session_ctx_t *session, struct acm_module *module, char *
         if (true == sr_xpath_node_name_eq(stream_entry[i].xpath, ACM_STREAM_SCHEDULE_STR)) {
             /* now get every leaf and list instance inside stream list entry inside stream-schedule container */
             fill_xpath(path, ACM_LIST_STREAM_STREAM_SCHEDULE_XPATH, container_name, stream_key);
-            if (SR_ERR_OK == sr_get_items(session, path, 0, 0, &stream_schedule, &stream_schedule_counter)) {
+            if (SR_ERR_OK == acm_get_items(session, path, &stream_schedule, &stream_schedule_counter)) {
                 if ((int)stream_schedule_counter) {
                     ret = new_stream_schedule(session, stream_schedule, stream_schedule_counter, my_stream, is_ingress, stream_key, container_name);
                     if (EXIT_SUCCESS != ret) {
@@ -1646,18 +1942,21 @@ int new_acm_module(sr_session_ctx_t *session, int index, sr_val_t* container, si
 }
 
 /**
- * @brief Function to create and apply configuration.
+ * @brief Function to create and validate configuration.
  *
- * If parameter schedule_change is set to true, only schedule of the running configuration will be
- * updated.
+ * The configuration is built from the datastore content, but not applied to the device.
+ * If parameter schedule_change is set to true, the configuration is used for a schedule
+ * update only and is therefore not validated as a whole.
  *
  * @param[in]   session         Implicit session (do not stop) with information about the changed data (retrieved by sr_get_changes_iter) the event originator session IDs.
  * @param[in]   node            Current sr_val_t node.
  * @param[in]   schedule_change Indication for schedule-only change in configuration.
+ * @param[out]  p_acm           Created configuration, to be released with acm_destroy().
+ * @param[out]  p_config_id     Configuration identifier.
  *
  * @return EXIT_SUCCESS or EXIT_FAILURE
  */
-int process_acm_config(sr_session_ctx_t *session, sr_val_t* node, bool schedule_change)
+static int build_acm_config(sr_session_ctx_t *session, sr_val_t* node, bool schedule_change, struct acm_config **p_acm, uint32_t *p_config_id)
 {
     struct acm_config* acm = NULL;
     int bypass1_index = 0;
@@ -1684,7 +1983,7 @@ int process_acm_config(sr_session_ctx_t *session, sr_val_t* node, bool schedule_
     tt_stream_list_init();
 
     /* get container bypass1 */
-    if (SR_ERR_OK == sr_get_items(session, ACM_BYPASS1_XPATH, 0, 0, &bypass1, &bypass1_counter)) {
+    if (SR_ERR_OK == acm_get_items(session, ACM_BYPASS1_XPATH, &bypass1, &bypass1_counter)) {
         /* This condition is here because sr_get_items will always find container bypass one inside configuration
          * so we need to check if that container is empty. Container will be empty if his counter is 1.
          * If counter is different that 1, that means that container is not empty, there are leafs and list entries
@@ -1704,7 +2003,7 @@ int process_acm_config(sr_session_ctx_t *session, sr_val_t* node, bool schedule_
     }
 
     /* get container bypass2 */
-    if (SR_ERR_OK == sr_get_items(session, ACM_BYPASS2_XPATH, 0, 0, &bypass2, &bypass2_counter)) {
+    if (SR_ERR_OK == acm_get_items(session, ACM_BYPASS2_XPATH, &bypass2, &bypass2_counter)) {
         if (1 != bypass2_counter) {
             ret = new_acm_module(session, bypass2_index, bypass2, bypass2_counter, acm);
             if (EXIT_SUCCESS != ret) {
@@ -1725,19 +2024,7 @@ int process_acm_config(sr_session_ctx_t *session, sr_val_t* node, bool schedule_
         SRP_LOG_DBG("config ID found: %d.", config_id);
     }
 
-    if (schedule_change) {
-        SRP_LOG_DBGMSG("Applying ACM schedule.");
-        ret = acm_apply_schedule(acm, config_id, config_id);
-        if (ret) {
-            snprintf(error_msg, 2*MAX_STR_LEN, ERR_MSG_FORMAT_STR, ret, ERR_APPLICATION_SCHEDULE_FAILED_STR);
-            sr_set_error(session, node->xpath, error_msg);
-            SRP_LOG_ERR(ERROR_MSG_FUN_AND_MSG, __func__, error_msg);
-            tt_stream_list_clear();
-            acm_destroy(acm);
-            return EXIT_FAILURE;
-        }
-        SRP_LOG_DBGMSG("ACM schedule applied.");
-    } else {
+    if (!schedule_change) {
         SRP_LOG_DBGMSG("Validating ACM configuration");
         ret = acm_validate_config(acm);
         if (ret) {
@@ -1749,21 +2036,242 @@ int process_acm_config(sr_session_ctx_t *session, sr_val_t* node, bool schedule_
             return EXIT_FAILURE;
         }
         SRP_LOG_DBGMSG("ACM configuration is valid.");
+    }
+    tt_stream_list_clear();
+
+    *p_acm = acm;
+    *p_config_id = config_id;
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Function to apply a configuration created by build_acm_config().
+ *
+ * If parameter schedule_change is set to true, only schedule of the running configuration will be
+ * updated.
+ *
+ * @param[in]   acm             Configuration to be applied.
+ * @param[in]   config_id       Configuration identifier.
+ * @param[in]   schedule_change Indication for schedule-only change in configuration.
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+static int apply_acm_config(struct acm_config *acm, uint32_t config_id, bool schedule_change)
+{
+    char error_msg[2*MAX_STR_LEN] = {0};
+    int ret;
 
+    if (schedule_change) {
+        SRP_LOG_DBGMSG("Applying ACM schedule.");
+        ret = acm_apply_schedule(acm, config_id, config_id);
+        if (ret) {
+            snprintf(error_msg, 2*MAX_STR_LEN, ERR_MSG_FORMAT_STR, ret, ERR_APPLICATION_SCHEDULE_FAILED_STR);
+            SRP_LOG_ERR(ERROR_MSG_FUN_AND_MSG, __func__, error_msg);
+            return EXIT_FAILURE;
+        }
+        SRP_LOG_DBGMSG("ACM schedule applied.");
+    } else {
         SRP_LOG_DBGMSG("Applying ACM configuration");
         ret = acm_apply_config(acm, config_id);
         if (ret) {
             snprintf(error_msg, 2*MAX_STR_LEN, ERR_MSG_FORMAT_STR, ret, ERR_APPLICATION_CONFIGURATION_FAILED_STR);
-            sr_set_error(session, node->xpath, error_msg);
             SRP_LOG_ERR(ERROR_MSG_FUN_AND_MSG, __func__, error_msg);
-            tt_stream_list_clear();
-            acm_destroy(acm);
             return EXIT_FAILURE;
         }
         SRP_LOG_DBGMSG("ACM configuration applied.");
     }
-    acm_destroy(acm);
-    tt_stream_list_clear();
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Classify a changed node of the acm configuration.
+ *
+ * Stream schedules, cycle-time and base-time of a module are covered by a
+ * schedule-only update (acm_apply_schedule). Any other node, including the
+ * configuration-id, requires the complete configuration to be applied.
+ *
+ * @param[in]   xpath   XPath of the changed node.
+ *
+ * @return class of the change
+ */
+static acm_change_class_t acm_classify_node(const char *xpath)
+{
+    if ((true == sr_xpath_node_name_eq(xpath, ACM_CONFIG_CHANGE_STR)) ||
+        (true == sr_xpath_node_name_eq(xpath, ACM_SCHEDULE_CHANGE_STR))) {
+        return ACM_CHANGE_NONE;
+    }
+
+    if ((NULL != strstr(xpath, "/" ACM_STREAM_SCHEDULE_STR)) ||
+        (NULL != strstr(xpath, "/" ACM_BASE_TIME_STR)) ||
+        (true == sr_xpath_node_name_eq(xpath, ACM_CYCLE_TIME_STR))) {
+        return ACM_CHANGE_SCHEDULE;
+    }
+
+    return ACM_CHANGE_CONFIG;
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Classify all changes of the current request inside the acm module.
+ *
+ * @param[in]   session Implicit session of the change callback.
+ *
+ * @return class of the most extensive change, ACM_CHANGE_CONFIG if the changes cannot be retrieved
+ */
+static acm_change_class_t acm_classify_changes(sr_session_ctx_t *session)
+{
+    acm_change_class_t change = ACM_CHANGE_NONE;
+    acm_change_class_t node_change;
+    sr_change_oper_t op = {0};
+    sr_change_iter_t* iter = NULL;
+    sr_val_t* old_value = NULL;
+    sr_val_t* new_value = NULL;
+    sr_val_t* node = NULL;
+
+    if (SR_ERR_OK != sr_get_changes_iter(session, "/acm:*//.", &iter)) {
+        SRP_LOG_ERR(ERROR_MSG_FUN_AND_MSG, __func__, ERR_FORMING_ITERATOR_FAILED_STR);
+        return ACM_CHANGE_CONFIG;
+    }
+
+    while (SR_ERR_OK == sr_get_change_next(session, iter, &op, &old_value, &new_value)) {
+        node = (op == SR_OP_DELETED) ? old_value : new_value;
+
+        node_change = acm_classify_node(node->xpath);
+        if (node_change > change) {
+            change = node_change;
+        }
+
+        sr_free_val(old_value);
+        sr_free_val(new_value);
+        old_value = NULL;
+        new_value = NULL;
+    }
+
+    sr_free_change_iter(iter);
+
+    return change;
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Discard the configuration prepared for a request.
+ */
+static void acm_prepared_discard(void)
+{
+    if (NULL != prepared.acm) {
+        acm_destroy(prepared.acm);
+    }
+    memset(&prepared, 0, sizeof(prepared));
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Prepare the pending configuration changes with the least invasive operation.
+ *
+ * Changes of earlier requests not yet applied are combined with the changes of
+ * the current request. A schedule-only change is applied by acm_apply_schedule,
+ * leaving streams and message buffers of the running configuration untouched.
+ * A config-change request without any pending change forces the complete configuration
+ * to be applied again.
+ *
+ * libacmconfig derives lookup, DMA and schedule tables of a module from all of its
+ * streams, so adding or removing a single stream requires the complete configuration
+ * to be applied.
+ *
+ * The configuration is built and validated in the change phase of the request, so an
+ * invalid configuration is rejected before the device is accessed. It is applied by
+ * acm_commit_prepared_changes() when the request is done.
+ *
+ * @param[in]   session         Implicit session of the change callback.
+ * @param[in]   node            Current sr_val_t node.
+ * @param[in]   schedule_change Schedule-only update was requested explicitly.
+ * @param[in]   request_id      Request ID of the change callback.
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+static int acm_prepare_pending_changes(sr_session_ctx_t *session, sr_val_t* node, bool schedule_change, uint32_t request_id)
+{
+    acm_change_class_t change = acm_classify_changes(session);
+    struct acm_config *acm = NULL;
+    uint32_t config_id = 0;
+    bool schedule_only;
+    int ret;
+
+    if (pending_change > change) {
+        change = pending_change;
+    }
+
+    /* an explicit config-change request without classified changes re-applies everything */
+    if (!schedule_change && (ACM_CHANGE_NONE == change)) {
+        SRP_LOG_DBG("%s(): no pending changes, re-applying complete configuration.", __func__);
+        change = ACM_CHANGE_CONFIG;
+    }
+
+    schedule_only = schedule_change || (ACM_CHANGE_SCHEDULE == change);
+
+    /* a complete configuration prepared for the request covers a schedule update */
+    if (prepared.valid && (prepared.request_id == request_id) && !prepared.schedule_only) {
+        return EXIT_SUCCESS;
+    }
+
+    SRP_LOG_DBG("%s(): preparing %s.", __func__, schedule_only ? "schedule only" : "complete configuration");
+
+    acm_config_tree_load(session);
+    ret = build_acm_config(session, node, schedule_only, &acm, &config_id);
+    acm_config_tree_free();
+    if (EXIT_SUCCESS != ret) {
+        return EXIT_FAILURE;
+    }
+
+    acm_prepared_discard();
+    prepared.valid = true;
+    prepared.request_id = request_id;
+    prepared.acm = acm;
+    prepared.config_id = config_id;
+    prepared.schedule_only = schedule_only;
+    prepared.change = change;
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @ingroup acminternal
+ * @brief Apply the configuration prepared for a request to the device.
+ *
+ * The request is already committed to the datastore at this point. If the application
+ * fails, the complete configuration is kept pending, so the next request applies it again.
+ *
+ * @param[in]   request_id      Request ID of the change callback.
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+static int acm_commit_prepared_changes(uint32_t request_id)
+{
+    int ret;
+
+    if (!prepared.valid || (prepared.request_id != request_id)) {
+        return EXIT_SUCCESS;
+    }
+
+    acm_state_cache_invalidate();
+    ret = apply_acm_config(prepared.acm, prepared.config_id, prepared.schedule_only);
+    if (EXIT_SUCCESS != ret) {
+        pending_change = ACM_CHANGE_CONFIG;
+        applied_request_valid = false;
+        acm_prepared_discard();
+        return EXIT_FAILURE;
+    }
+
+    /* an explicit schedule update leaves other changes pending */
+    if (!prepared.schedule_only || (ACM_CHANGE_CONFIG != prepared.change)) {
+        pending_change = ACM_CHANGE_NONE;
+    }
+    applied_request_id = request_id;
+    applied_request_valid = true;
+    acm_prepared_discard();
 
     return EXIT_SUCCESS;
 }
@@ -1785,7 +2293,6 @@ acm_config_change_cb(sr_session_ctx_t *session, const char *module_name, const c
 {
     (void)event;
     (void)module_name;
-    (void)request_id;
     (void)private_data;
     int rc = SR_ERR_OK;
     sr_change_oper_t op = {0};
@@ -1803,6 +2310,14 @@ acm_config_change_cb(sr_session_ctx_t *session, const char *module_name, const c
         return SR_ERR_OK;
     }
 
+    /* the device has not been touched for an aborted request */
+    if (event == SR_EV_ABORT) {
+        if (prepared.valid && (request_id == prepared.request_id)) {
+            acm_prepared_discard();
+        }
+        return SR_ERR_OK;
+    }
+
     rc = sr_get_changes_iter(session, xpath, &iter);
     if (SR_ERR_OK != rc) {
         return rc;
@@ -1821,13 +2336,16 @@ acm_config_change_cb(sr_session_ctx_t *session, const char *module_name, const c
         if (true == sr_xpath_node_name_eq(node->xpath, ACM_CONFIG_CHANGE_STR)) {
             /* If config-change is true */
             if ((true == node->data.bool_val) && (event == SR_EV_CHANGE)) {
-                if (EXIT_SUCCESS != process_acm_config(session, node, false)) {
+                if (EXIT_SUCCESS != acm_prepare_pending_changes(session, node, false, request_id)) {
                     return SR_ERR_OPERATION_FAILED;
                 }
             }
 
             if ((event == SR_EV_DONE) && (true == node->data.bool_val)) {
                 SRP_LOG_DBG(DEBUG_MSG_WITH_TWO_PARAM, DBG_APPLYING_CHANGES_MSG, __func__);
+                if (EXIT_SUCCESS != acm_commit_prepared_changes(request_id)) {
+                    SRP_LOG_ERR("%s(): applying the configuration of request %u failed.", __func__, request_id);
+                }
             }
         }
 
@@ -1835,13 +2353,16 @@ acm_config_change_cb(sr_session_ctx_t *session, const char *module_name, const c
         if (true == sr_xpath_node_name_eq(node->xpath, ACM_SCHEDULE_CHANGE_STR)) {
             /* If schedule-change is true */
             if ((true == node->data.bool_val) && (event == SR_EV_CHANGE)) {
-                if (EXIT_SUCCESS != process_acm_config(session, node, true)) {
+                if (EXIT_SUCCESS != acm_prepare_pending_changes(session, node, true, request_id)) {
                     return SR_ERR_OPERATION_FAILED;
                 }
             }
 
             if ((event == SR_EV_DONE) && (true == node->data.bool_val)) {
                 SRP_LOG_DBG(DEBUG_MSG_WITH_TWO_PARAM, DBG_APPLYING_CHANGES_MSG, __func__);
+                if (EXIT_SUCCESS != acm_commit_prepared_changes(request_id)) {
+                    SRP_LOG_ERR("%s(): applying the configuration of request %u failed.", __func__, request_id);
+                }
             }
         }
         /* SR_OP_DELETED is supported and nothing happens if node is deleted, also if entire configuration is deleted.
@@ -1882,7 +2403,6 @@ int acm_dummy_cb(sr_session_ctx_t *session, const char *module_name, const char
 {
     (void)module_name;
     (void)event;
-    (void)request_id;
     (void)private_data;
     (void)xpath;
     int rc;
@@ -1894,7 +2414,20 @@ int acm_dummy_cb(sr_session_ctx_t *session, const char *module_name, const char
 
     SRP_LOG_DBG(DBG_MSG_FUN_CALLED_STR, __func__);
 
-    if ((SR_EV_DONE == event) || (0 == plugin_init)) {
+    if (0 == plugin_init) {
+        SRP_LOG_DBG(DEBUG_MSG_WITH_TWO_PARAM, DBG_APPLYING_CHANGES_MSG, __func__);
+        return SR_ERR_OK;
+    }
+
+    if (SR_EV_DONE == event) {
+        /* remember committed changes not applied to the device by this request */
+        if (!applied_request_valid || (request_id != applied_request_id)) {
+            acm_change_class_t change = acm_classify_changes(session);
+
+            if (change > pending_change) {
+                pending_change = change;
+            }
+        }
         SRP_LOG_DBG(DEBUG_MSG_WITH_TWO_PARAM, DBG_APPLYING_CHANGES_MSG, __func__);
         return SR_ERR_OK;
     }
@@ -1937,6 +2470,8 @@ int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_data)
 
     SRP_LOG_DBG(DBG_MSG_FUN_CALLED_STR, __func__);
 
+    acm_state_cache_init();
+
     do {
         /* subscribe for /acm module changes */
         rc = sr_module_change_subscribe(session, ACM_MODULE_STR, NULL,
@@ -1996,5 +2531,7 @@ sr_plugin_cleanup_cb(sr_session_ctx_t *session, void *private_data)
     (void)session;
     /* nothing to cleanup except freeing the subscriptions */
     sr_unsubscribe(subscription);
+    acm_prepared_discard();
+    acm_state_cache_cleanup();
     SRP_LOG_INF(INF_MODULE_CLEANUP_STR, ACM_MODULE_STR);
 }
@@ -100,6 +100,7 @@
 #define ACM_SOF_ERRORS_STR                   "SofErrors"
 
 /* container acm */
+#define ACM_XPATH									"/acm:acm"
 #define ACM_SCHEDULE_CHANGE_XPATH					"/acm:acm/schedule-change"
 #define ACM_CONFIG_CHANGE_XPATH						"/acm:acm/config-change"
 #define ACM_CONFIGURATION_ID_XPATH 					"/acm:acm/configuration-id"
@@ -116,6 +117,10 @@
 #define ACM_LIST_SCHEDULE_EVENTS_XPATH 		    	"/acm:acm/%s/stream[stream-key='%s']/stream-schedule/schedule-events[schedule-key='%s']/*"
 #define ACM_TIME_TRIGGERED_STREAM_XPATH 		    "/acm:acm/%s/stream[stream-key='%s']/*"
 
+/* operational state cache */
+#define ACM_STATE_CACHE_ENV_STR                     "ACM_STATE_CACHE_MS"
+#define ACM_STATE_CACHE_DEFAULT_MS                  1000
+
 /* container acm-state XPATH */
 #define ACM_LIB_VERSION_XPATH 						"/acm:acm-state/acm-lib-version"
 #define ACM_IP_VERSION_XPATH 						"/acm:acm-state/acm-ip-version"
@@ -138,7 +143,7 @@
 #define ACM_SOF_ERRORS_XPATH			 			"/acm:acm-state/%s/SofErrors"
 
 
-#define ERR_ACM_STATUS_MODULE_STR	                "Cannot get ACM status module %d, status %d. Error: %d"
+#define ERR_ACM_STATUS_STR	                        "Cannot get ACM status. Error: %d"
 #define ERR_ACM_CONFIGURATION_STR					"ACM configuration cannot be created."
 #define ERR_APPLICATION_SCHEDULE_FAILED_STR			"Application of schedule failed."
 #define ERR_VALIDATION_FAILED_STR					"Validation of configuration failed."
@@ -60,6 +60,9 @@ enum acm_ip_if_variant {
  * @var acm::msgbuf
  * @brief redundancy module handler
  *
+ * @var acm::cyclic
+ * @brief cyclic I/O engine
+ *
  * @var acm::commreg
  * @brief common register block handling
  *
@@ -81,6 +84,9 @@ enum acm_ip_if_variant {
  * @var acm::if_id
  * @brief interface identifier
  *
+ * @var acm::latency
+ * @brief latency counters of driver operations
+ *
  */
 struct acm {
 	struct device		dev;
@@ -91,6 +97,7 @@ struct acm {
 	struct scheduler	*scheduler;
 	struct redundancy	*redundancy;
 	struct msgbuf		*msgbuf;
+	struct cyclic		*cyclic;
 	struct commreg		*commreg;
 	struct reset		*reset;
 
@@ -102,6 +109,8 @@ struct acm {
 	struct acm_dev		*devices;
 
 	enum acm_ip_if_variant	if_id;
+
+	struct acm_latency	*latency;
 };
 
 /**
@@ -19,6 +19,30 @@
 
 #include <linux/io.h>
 
+#include "emu.h"
+#include "iorecord.h"
+
+#if defined(CONFIG_ACM_EMU) && !defined(ACM_EMU_IMPL)
+/*
+ * Route all register accesses through the emulation, which passes accesses
+ * to real hardware on unchanged.
+ */
+#undef readw
+#define readw(addr)		emu_readw(addr)
+#undef readl
+#define readl(addr)		emu_readl(addr)
+#undef writew
+#define writew(value, addr)	emu_writew(value, addr)
+#undef writel
+#define writel(value, addr)	emu_writel(value, addr)
+#undef __ioread32_copy
+#define __ioread32_copy(to, from, count)	\
+	emu_ioread32_copy(to, from, count)
+#undef __iowrite32_copy
+#define __iowrite32_copy(to, from, count)	\
+	emu_iowrite32_copy(to, from, count)
+#endif
+
 /**
  * @brief check if @p to, @p from and @p size are word aligned
  */
@@ -35,13 +59,17 @@ static inline bool is_aligned32(void *to, const void *from, size_t size)
 static inline void acm_iowrite32_copy(void __iomem *to, const void *from,
 				      size_t size)
 {
+	u64 start;
+
 //	pr_debug("%s(0x%p, 0x%p, %zu)", __func__, to, from, size);
 	if (!is_aligned32(to, from, size)) {
 		pr_err("%s: wrong alignment: to=%p, from=%p, count=%zu\n",
 		       __func__, to, from, size);
 		return;
 	}
+	start = iorecord_start();
 	__iowrite32_copy(to, from, size / sizeof(u32));
+	iorecord_add_block(to, IORECORD_WRITE, from, size / sizeof(u32), start);
 }
 
 /**
@@ -50,13 +78,17 @@ static inline void acm_iowrite32_copy(void __iomem *to, const void *from,
 static inline void acm_ioread32_copy(void *to, const void __iomem *from,
 				     size_t size)
 {
+	u64 start;
+
 //	pr_debug("%s(0x%p, 0x%p, %zu)", __func__, to, from, size);
 	if (!is_aligned32(to, from, size)) {
 		pr_err("%s: wrong alignment: to=%p, from=%p, count=%zu\n",
 		       __func__, to, from, size);
 		return;
 	}
+	start = iorecord_start();
 	__ioread32_copy(to, from, size / sizeof(u32));
+	iorecord_add_block(from, IORECORD_READ, to, size / sizeof(u32), start);
 }
 
 /**
@@ -76,4 +108,60 @@ static inline void acm_iowrite32_set(void __iomem *to, u32 val, size_t size)
 		*at++ = val;
 }
 
+/**
+ * @brief write 32 bit register, recorded by the register access recorder
+ */
+static inline void acm_writel(u32 value, void __iomem *addr)
+{
+	u64 start = iorecord_start();
+
+	writel(value, addr);
+	iorecord_add(addr, IORECORD_WRITE, sizeof(u32), value, start);
+}
+
+/**
+ * @brief write 16 bit register, recorded by the register access recorder
+ */
+static inline void acm_writew(u16 value, void __iomem *addr)
+{
+	u64 start = iorecord_start();
+
+	writew(value, addr);
+	iorecord_add(addr, IORECORD_WRITE, sizeof(u16), value, start);
+}
+
+/**
+ * @brief read 16 bit register, recorded by the register access recorder
+ */
+static inline u16 acm_readw(const void __iomem *addr)
+{
+	u64 start = iorecord_start();
+	u16 value = readw(addr);
+
+	iorecord_add(addr, IORECORD_READ, sizeof(u16), value, start);
+	return value;
+}
+
+/**
+ * @brief map a memory region of the ACM IP
+ *
+ * The region is registered with the register access recorder by its
+ * resource name.
+ */
+static inline void __iomem *acm_ioremap_resource(struct device *dev,
+						 struct resource *res)
+{
+	void __iomem *base;
+
+	if (emu_is_emulated(dev))
+		base = emu_ioremap_resource(dev, res);
+	else
+		base = devm_ioremap_resource(dev, res);
+
+	if (!IS_ERR(base))
+		iorecord_register_area(res->name, base, resource_size(res));
+
+	return base;
+}
+
 #endif /* ACM_ACMIO_H_ */
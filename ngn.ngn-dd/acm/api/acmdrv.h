@@ -668,6 +668,14 @@ static inline struct acmdrv_bitarray *acmdrv_bitmask_genmask(size_t size,
  *
  *                  Remark: this counter array is not functional in early ACM IP
  *                  versions.
+ * - *cyclic_image*: process image of #ACMDRV_CYCLIC_IMAGE_SIZE bytes shared
+ *                   with the cyclic I/O engine, may be mapped with mmap()
+ * - *cyclic_jobs*: array of up to #ACMDRV_CYCLIC_JOBS_MAX
+ *                  acmdrv_cyclic_job copy jobs, writable while the cyclic
+ *                  I/O engine is disabled
+ * - *cyclic_control*: one acmdrv_cyclic_control to enable/disable the
+ *                     cyclic I/O engine
+ * - *cyclic_stats*: read-only acmdrv_cyclic_stats of the cyclic I/O engine
  *
  * @{
  */
@@ -783,6 +791,76 @@ struct acmdrv_msgbuf_overwritten {
 	uint32_t count;	/**< counter value */
 };
 
+/**
+ * @name Message Buffer Status
+ * @anchor acmdrv_msgbuf_status
+ * @brief Bits of the status word of message buffers in auto lock mode
+ *
+ * The status word is sampled while the message buffer is locked and is
+ * located at the offset of the message buffer size within the character
+ * device, so reading the message buffer size + 4 bytes returns data and
+ * status with a single call.
+ * @{
+ */
+#define ACMDRV_MSGBUF_STATUS_OVERWRITTEN	(1 << 2)
+#define ACMDRV_MSGBUF_STATUS_D_LOCKED		(1 << 20)
+#define ACMDRV_MSGBUF_STATUS_FRESH		(1 << 24)
+#define ACMDRV_MSGBUF_STATUS_EMPTY		(1 << 28)
+/** @} */
+
+/**
+ * @name Cyclic I/O Engine
+ * @brief Copy jobs executed by the driver in each cycle
+ *
+ * The cyclic I/O engine copies between the message buffers and the process
+ * image (*cyclic_image*) synchronized to the PTP time of the ACM: cycles
+ * start at multiples of acmdrv_cyclic_control::period_ns and each job is
+ * executed acmdrv_cyclic_job::phase_ns after cycle start. RX buffers are
+ * copied to the image, TX buffers from the image. User space only accesses
+ * the process image.
+ * @{
+ */
+/** @brief size of the process image in bytes */
+#define ACMDRV_CYCLIC_IMAGE_SIZE	0x10000
+/** @brief maximum number of copy jobs */
+#define ACMDRV_CYCLIC_JOBS_MAX		64
+/** @brief minimum cycle period in ns, the engine must sleep in each cycle */
+#define ACMDRV_CYCLIC_PERIOD_MIN_NS	100000
+
+/**
+ * @brief Copy job of the cyclic I/O engine
+ *
+ * Offsets and length must be multiples of 4 bytes.
+ */
+struct acmdrv_cyclic_job {
+	uint16_t msgbuf;	/**< message buffer index */
+	uint16_t length;	/**< number of bytes to copy */
+	uint32_t buffer_offset;	/**< offset within the message buffer */
+	uint32_t image_offset;	/**< offset within the process image */
+	uint32_t phase_ns;	/**< execution time relative to cycle start */
+} __packed;
+
+/**
+ * @brief Control of the cyclic I/O engine
+ *
+ * The period must be at least #ACMDRV_CYCLIC_PERIOD_MIN_NS.
+ */
+struct acmdrv_cyclic_control {
+	uint32_t period_ns;	/**< cycle period */
+	uint32_t jobs;		/**< number of jobs to run, 0 disables */
+} __packed;
+
+/**
+ * @brief Statistics of the cyclic I/O engine
+ */
+struct acmdrv_cyclic_stats {
+	uint64_t cycles;	/**< number of executed cycles */
+	uint64_t missed;	/**< number of cycles skipped due to overrun */
+	uint32_t max_lateness_ns; /**< maximum job start lateness */
+	uint32_t errors;	/**< number of failed copy jobs */
+} __packed;
+/** @} */
+
 /**@} acmsysfscontrol*/
 
 /******************************************************************************/
@@ -837,6 +915,17 @@ struct acmdrv_msgbuf_overwritten {
  * - *configuration_id*: user id to identify an IP configuration
  * - *config_state*: state of the ACM. Contains a value according to enum
  *                   #acmdrv_status
+ * - *config_modules*: 32bit bit mask of the bypass modules affected by the
+ *                     next configuration session (bit n for module n).
+ *                     Defaults to #ACMDRV_CONFIG_MODULES_ALL and is reset to
+ *                     it by #ACMDRV_CONFIG_END_STATE and #ACMDRV_INIT_STATE.
+ *                     If not all modules are selected,
+ *                     #ACMDRV_CONFIG_START_STATE only cleans up the selected
+ *                     modules, their schedulers, redundancy control tables
+ *                     and the message buffers used by them exclusively,
+ *                     while the other module keeps running and its message
+ *                     buffers stay accessible. The IP is not reset in this
+ *                     case.
  * - *msg_buff_desc*: ACM message buffer descriptor array of struct
  *                    acmdrv_buff_desc items, one for each message buffer
  * - *msg_buff_alias*: ACM message buffer alias array of
@@ -890,10 +979,21 @@ struct acmdrv_msgbuf_overwritten {
  *                   table status values (#ACMDRV_SCHED_TBL_COUNT tables
  *                    (readonly) for each of the #ACMDRV_SCHEDULER_COUNT
  *                    schedulers)
+ * - *sched_switch_event*: Array of struct acmdrv_sched_switch_event
+ *                         (readonly), the last table switch of each of the
+ *                         #ACMDRV_SCHEDULER_COUNT schedulers. The attribute
+ *                         is pollable, i.e. poll() reports POLLPRI when a
+ *                         switch has been detected.
  * - *sched_cycle_time*: Array of struct acmdrv_sched_cycle_time data of
  *                       scheduler table cycle times
  * - *sched_start_table*: Array of struct acmdrv_timespec64 data of
  *                        scheduler table start times
+ * - *failover_policy*: Array of struct acmdrv_failover_policy, the actions
+ *                      performed on link changes of each of the
+ *                      #ACMDRV_BYPASS_MODULES_COUNT modules' ports
+ * - *link_event*: Array of struct acmdrv_link_event (readonly), the last
+ *                 link event of each of the #ACMDRV_BYPASS_MODULES_COUNT
+ *                 modules. The attribute is pollable.
  * - *emergency_disable*: Access to both scheduler's struct
  *                        acmdrv_sched_emerg_disable emergency disable
  *                        registers
@@ -962,6 +1062,8 @@ struct acmdrv_buff_desc {
  */
 #define ACMDRV_BUFF_DESC_BUFF_OFFSET_BIT_L	0
 #define ACMDRV_BUFF_DESC_BUFF_OFFSET_BIT_H	15
+#define ACMDRV_BUFF_DESC_AUTO_LOCK_BIT_L	18
+#define ACMDRV_BUFF_DESC_AUTO_LOCK_BIT_H	18
 #define ACMDRV_BUFF_DESC_BUFF_RST_BIT_L		19
 #define ACMDRV_BUFF_DESC_BUFF_RST_BIT_H		19
 #define ACMDRV_BUFF_DESC_BUFF_TYPE_BIT_L	20
@@ -989,6 +1091,18 @@ struct acmdrv_buff_desc {
 #define ACMDRV_BUFF_DESC_BUFF_OFFSET	\
 	BITMASK(ACMDRV_BUFF_DESC_BUFF_OFFSET_BIT)
 
+/**
+ * @def ACMDRV_BUFF_DESC_AUTO_LOCK
+ * @brief Auto Lock Flag
+ *
+ * Driver only flag: the message buffer is locked by the driver during each
+ * access through its character device. The device then provides the
+ * message buffer status (see @ref acmdrv_msgbuf_status "Message Buffer
+ * Status") as 32-bit word following the message data.
+ */
+#define ACMDRV_BUFF_DESC_AUTO_LOCK	\
+	BITMASK(ACMDRV_BUFF_DESC_AUTO_LOCK_BIT)
+
 /**
  * @def ACMDRV_BUFF_DESC_BUFF_RST
  * @brief Buffer Reset
@@ -1128,6 +1242,18 @@ static inline bool acmdrv_buff_desc_timestamp_read(
 	return RVAL(ACMDRV_BUFF_DESC_HAS_TIMESTAMP_BIT, desc->desc);
 }
 
+/**
+ * @brief Helper to read auto lock flag from given buffer descriptor
+ *
+ * @param desc pointer to buffer descriptor
+ * @return auto lock flag
+ */
+static inline bool acmdrv_buff_desc_auto_lock_read(
+		const struct acmdrv_buff_desc *desc)
+{
+	return RVAL(ACMDRV_BUFF_DESC_AUTO_LOCK_BIT, desc->desc);
+}
+
 /**
  * @brief Helper to read valid flag from given buffer descriptor
  *
@@ -3010,6 +3136,87 @@ struct acmdrv_timespec64 {
 	int32_t tv_nsec;	/**< nanoseconds */
 } __packed;
 
+/**
+ * @brief data representation for sched_switch_event
+ *
+ * When the start time of a table is accepted, pending is set until the
+ * table is reported in use by the IP or the detection timed out (1s after
+ * the start time), also if the start time is written to the IP later. Then
+ * seq is incremented and status holds the table status word (see
+ * @ref acmdrv_sched_tbl_status_details "Details"): the
+ * ACMDRV_SCHED_TBL_STATUS_IN_USE bit is cleared on timeout.
+ *
+ * A requested start time in the past or too close to be programmed in time
+ * is advanced by whole cycles: start holds the achieved start time,
+ * start_subns its sub-nanoseconds (2^-24 ns units) resulting from a cycle
+ * time with sub-nanoseconds and slip the difference to the requested start
+ * time in nanoseconds.
+ */
+struct acmdrv_sched_switch_event {
+	uint32_t seq;		/**< number of completed switch detections */
+	uint16_t table;		/**< index of the table started last */
+	uint16_t status;	/**< table status word at detection */
+	uint32_t pending;	/**< 1 while the switch is not yet detected */
+	struct acmdrv_timespec64 start;	/**< achieved start time of the table */
+	struct acmdrv_timespec64 detected; /**< PTP time of detection */
+	struct acmdrv_timespec64 requested; /**< requested start time */
+	uint32_t start_subns;	/**< sub-nanoseconds of the start time */
+	int64_t slip;		/**< start minus requested start time in ns */
+} __packed;
+
+/**
+ * @name Failover actions on link events
+ * @anchor acmdrv_failover_actions
+ * @{
+ */
+/** emergency disable the module's scheduler on link down and release it on
+ *  link up (only if it has been set by the failover)
+ */
+#define ACMDRV_FAILOVER_SCHEDULER	(1U << 0)
+/** set TakeAny of the enabled individual recoveries of the module and of
+ *  the enabled base recoveries referenced by its redundancy control table
+ */
+#define ACMDRV_FAILOVER_RECOVERY	(1U << 1)
+/** mark the message buffers used by the module invalid on link down and
+ *  valid again on link up
+ */
+#define ACMDRV_FAILOVER_MSGBUF		(1U << 2)
+/** report the event at link_event and notify its pollers */
+#define ACMDRV_FAILOVER_NOTIFY		(1U << 3)
+/** mask of all failover actions */
+#define ACMDRV_FAILOVER_ALL		(ACMDRV_FAILOVER_SCHEDULER | \
+					 ACMDRV_FAILOVER_RECOVERY | \
+					 ACMDRV_FAILOVER_MSGBUF | \
+					 ACMDRV_FAILOVER_NOTIFY)
+/** @} acmdrv_failover_actions */
+
+/**
+ * @brief data representation for failover_policy
+ *
+ * Both members are masks of @ref acmdrv_failover_actions "failover actions"
+ * the driver performs when the link of the module's port changes. All
+ * actions are disabled by default.
+ */
+struct acmdrv_failover_policy {
+	uint32_t link_down;	/**< actions on link down */
+	uint32_t link_up;	/**< actions on link up */
+} __packed;
+
+/**
+ * @brief data representation for link_event
+ *
+ * Updated on every link change of the module's port for which the policy
+ * requests #ACMDRV_FAILOVER_NOTIFY.
+ */
+struct acmdrv_link_event {
+	uint32_t seq;		/**< number of reported link events */
+	uint32_t link_up;	/**< 1 for link up, 0 for link down */
+	uint32_t actions;	/**< failover actions performed */
+	uint32_t msgbuf_invalid; /**< message buffers marked invalid */
+	uint32_t duration;	/**< ns spent performing the actions */
+	struct acmdrv_timespec64 timestamp; /**< PTP time of the event */
+} __packed;
+
 /**
  * @struct acmdrv_sched_emerg_disable
  * @brief data structure for emergency_disable interface
@@ -3631,6 +3838,11 @@ static inline uint16_t acmdrv_bypass_ingress_policing_control_read(
  */
 #define ACMDRV_CLEAR_ALL_PATTERN	0x13F72288
 
+/**
+ * @brief config_modules value selecting all bypass modules
+ */
+#define ACMDRV_CONFIG_MODULES_ALL	GENMASK(ACMDRV_BYPASS_MODULES_COUNT - 1, 0)
+
 /** @} acmsysfsconfig */
 
 /******************************************************************************/
@@ -4299,6 +4511,16 @@ static inline uint16_t acmdrv_bypass_ingress_policing_control_read(
  * - *redund_frames_produced*: Count Redundancy Frames Produced by respective
  *                             Bypass 0. Counter do not wrap.
  *
+ * Independent of the ACM IP version the driver provides its own latency
+ * counters:
+ *
+ * - *latency*: One line per driver operation with the operation name, the
+ *              number of samples, the accumulated and the maximum latency in
+ *              nanoseconds. The operations are message buffer read and write,
+ *              contended waits for the message buffer and descriptor locks,
+ *              scheduler table row transfers, diagnostics updates and
+ *              recovery ticks. Writing any value resets all counters.
+ *
  * @{
  */
 
@@ -4324,6 +4546,18 @@ static inline uint16_t acmdrv_bypass_ingress_policing_control_read(
  *                     the respective bypass module. A value of 0 turns polling
  *                     off, the default is set to 50m to avoid the schedule
  *                     cycle counter overflows down to 200usec cycle time.
+ * - *redund_stats*: struct acmdrv_redun_stats with the FRER (IEEE802.1CB)
+ *                   statistics of all redundancy table entries. The
+ *                   statistics are sampled with each recovery tick, any
+ *                   write access resets them.
+ * - *diag_thresholds*: struct acmdrv_diag_thresholds with the per rule
+ *                      thresholds of the diagnostic counters of the
+ *                      respective bypass module. All thresholds are disabled
+ *                      by default.
+ * - *diag_alarm*: struct acmdrv_diag_alarm with the threshold breaches of the
+ *                 respective bypass module. The attribute is notified on
+ *                 each new breach, thus can be waited for with poll()/select()
+ *                 (POLLPRI). Reading clears the breached rule bitmasks.
  * @{
  */
 
@@ -4392,6 +4626,93 @@ struct acmdrv_diagnostics {
 	uint32_t additionalFilterMismatchCounter[ACMDRV_BYPASS_NR_RULES];
 } __packed;
 
+/**
+ * @brief FRER statistics of a single redundancy table entry
+ *
+ * The counters are derived from the redundancy status table (see
+ * @ref acmdrv_redun_status_details "Details of ACM Redundancy Status")
+ * sampled with each recovery tick. A status word differing from the
+ * previous sample indicates a newly processed frame; its flags are counted
+ * at most once per sample, so recoveries, duplicates and errors are lower
+ * bounds if several frames are processed within one tick.
+ */
+struct acmdrv_redun_entry_stats {
+	uint64_t passed;	/**< advance of IntSeqNum, i.e. frames passed */
+	uint32_t recoveries;	/**< samples with Replica Received (RR) set */
+	uint32_t duplicates;	/**< replicas discarded as already received */
+	uint32_t errors;	/**< replicas discarded due to receive errors */
+	uint32_t out_of_order;	/**< IntSeqNum moved backwards */
+	uint32_t resets;	/**< IntSeqNum entry written by software */
+	uint32_t timeouts;	/**< base recovery receive timeouts */
+	uint32_t passed_rate;	/**< frames passed per second */
+	uint32_t duplicate_rate; /**< duplicates per second */
+} __packed;
+
+/**
+ * @brief FRER statistics of the redundancy module
+ *
+ * Rates are updated once per second from the counter deltas.
+ */
+struct acmdrv_redun_stats {
+	struct acmdrv_timespec64 timestamp; /**< PTP time of last sample */
+	uint32_t samples;	/**< number of samples taken */
+	/** individual recovery receive timeouts per module and rule */
+	uint32_t individual_timeouts[ACMDRV_BYPASS_MODULES_COUNT]
+				    [ACMDRV_BYPASS_NR_RULES];
+	/** statistics per redundancy table entry */
+	struct acmdrv_redun_entry_stats entry[ACMDRV_REDUN_TABLE_ENTRY_COUNT];
+} __packed;
+
+/**
+ * @brief diagnostic counters supervised by thresholds
+ */
+enum acmdrv_diag_counter {
+	/** acmdrv_diagnostics::ingressWindowClosedCounter */
+	ACMDRV_DIAG_INGRESS_WIN_CLOSED,
+	/** acmdrv_diagnostics::noFrameReceivedCounter */
+	ACMDRV_DIAG_NO_FRAME_RECEIVED,
+	/** acmdrv_diagnostics::recoveryCounter */
+	ACMDRV_DIAG_RECOVERY,
+	/** acmdrv_diagnostics::additionalFilterMismatchCounter */
+	ACMDRV_DIAG_ADDITIONAL_FILTER_MISMATCH,
+
+	ACMDRV_DIAG_COUNTER_COUNT /**< number of supervised counters */
+};
+
+/**
+ * @brief threshold of a single diagnostic counter of a rule
+ *
+ * The counters are evaluated with each diagnostic update, i.e. each
+ * diag_poll_time and each read of diagnostics. A breach is raised if a
+ * counter increased by at least limit since the previous evaluation.
+ */
+struct acmdrv_diag_threshold {
+	uint32_t limit;		/**< counter increase raising a breach, 0: off */
+	uint32_t holdoff;	/**< minimum time between two breaches in ms */
+} __packed;
+
+/**
+ * @brief thresholds of the diagnostic counters of a bypass module
+ */
+struct acmdrv_diag_thresholds {
+	/** thresholds per counter and rule */
+	struct acmdrv_diag_threshold rule[ACMDRV_DIAG_COUNTER_COUNT]
+					 [ACMDRV_BYPASS_NR_RULES];
+} __packed;
+
+/**
+ * @brief threshold breaches of the diagnostic counters of a bypass module
+ */
+struct acmdrv_diag_alarm {
+	struct acmdrv_timespec64 timestamp; /**< diagnostics of last breach */
+	uint32_t seq;		/**< number of notifications so far */
+	uint32_t suppressed;	/**< breaches suppressed by holdoff */
+	/** bitmask of breached rules per counter since last read */
+	uint32_t rules[ACMDRV_DIAG_COUNTER_COUNT];
+	/** counter increase of the last breach per counter and rule */
+	uint32_t delta[ACMDRV_DIAG_COUNTER_COUNT][ACMDRV_BYPASS_NR_RULES];
+} __packed;
+
 /**@} acmsysfsdiag */
 
 /**@} acmsysfs */
@@ -4406,9 +4727,90 @@ struct acmdrv_diagnostics {
  * acmdrv_buff_alias.alias. It is a character device which can be read or
  * written depending on its configuration via msg_buff_desc SYSFS config
  * interface according to #ACMDRV_BUFF_DESC_BUFF_TYPE in acmdrv_msfbuf_desc.desc
+ *
+ * The devices support pread() and pwrite() at any offset. The IP is accessed
+ * in 32-bit words only, so the words covering the requested range are
+ * accessed and partially written words keep their remaining bytes.
  * @{
  *
  */
+
+/**
+ * @brief 32-bit word range covering a byte range of a message buffer
+ *
+ * Reduces size to the part inside the message buffer, offset must be within
+ * the message buffer.
+ *
+ * @param msize size of the message buffer in bytes
+ * @param offset byte offset of the access
+ * @param size number of bytes to access, returns the bytes accessible
+ * @param first returns the offset of the first word of the range
+ * @param last returns the offset behind the last word of the range
+ * @return false if nothing is left to access
+ */
+static inline bool acmdrv_msgbuf_word_range(size_t msize, size_t offset,
+	size_t *size, size_t *first, size_t *last)
+{
+	const size_t mask = sizeof(uint32_t) - 1;
+
+	if (*size > msize - offset)
+		*size = msize - offset;
+	if (*size == 0)
+		return false;
+
+	*first = offset & ~mask;
+	*last = (offset + *size + mask) & ~mask;
+
+	return true;
+}
+
+/**
+ * @brief partially written words of a message buffer write
+ *
+ * The words returned have to be read from the message buffer and merged
+ * with acmdrv_msgbuf_merge_word() before the range is written back.
+ *
+ * @param offset byte offset of the write
+ * @param size number of bytes written, see acmdrv_msgbuf_word_range()
+ * @param first offset of the first word of the range
+ * @param last offset behind the last word of the range
+ * @param word returns the offsets of the partially written words
+ * @return number of partially written words (0 to 2)
+ */
+static inline unsigned int acmdrv_msgbuf_partial_words(size_t offset,
+	size_t size, size_t first, size_t last, size_t word[2])
+{
+	unsigned int n = 0;
+
+	if (offset != first)
+		word[n++] = first;
+	/* a single word is read once only */
+	if (offset + size != last && (n == 0 || last - sizeof(uint32_t) != first))
+		word[n++] = last - sizeof(uint32_t);
+
+	return n;
+}
+
+/**
+ * @brief merge the current content of a partially written word
+ *
+ * Copies the bytes of the word outside the written range from cur to buf.
+ *
+ * @param buf buffer holding the written bytes at offset
+ * @param word offset of the word, see acmdrv_msgbuf_partial_words()
+ * @param cur current content of the word
+ * @param offset byte offset of the write
+ * @param size number of bytes written
+ */
+static inline void acmdrv_msgbuf_merge_word(uint8_t *buf, size_t word,
+	const uint8_t *cur, size_t offset, size_t size)
+{
+	size_t j;
+
+	for (j = 0; j < sizeof(uint32_t); j++)
+		if (word + j < offset || word + j >= offset + size)
+			buf[word + j] = cur[j];
+}
 /**@} acmmsgbuf */
 
 /******************************************************************************/
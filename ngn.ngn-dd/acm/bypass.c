@@ -33,6 +33,8 @@
 #include <linux/netdevice.h>
 #include <asm/unaligned.h>
 #include <linux/mutex.h>
+#include <linux/sysfs.h>
+#include <linux/jiffies.h>
 
 #include "acm-module.h"
 #include "bypass.h"
@@ -40,6 +42,10 @@
 #include "acmbitops.h"
 #include "edge.h"
 #include "scheduler.h"
+#include "msgbuf.h"
+#include "redundancy.h"
+#include "latency.h"
+#include "trace.h"
 
 /**@} hwaccbypass */
 
@@ -76,6 +82,34 @@ struct nfr_cache {
 	u32 flags; /**< accumulated register value */
 	struct mutex lock; /**< cache access lock */
 };
+
+/**
+ * @brief threshold supervision of the diagnostic counters
+ *
+ * Protected by the diag_lock of the bypass module.
+ */
+struct diag_alarm {
+	struct acmdrv_diag_thresholds thresholds; /**< configured thresholds */
+	struct acmdrv_diag_alarm alarm; /**< breaches reported to user space */
+	/** counter values at previous evaluation */
+	u32 last[ACMDRV_DIAG_COUNTER_COUNT][ACMDRV_BYPASS_NR_RULES];
+	/** end of holdoff after a breach (jiffies) */
+	unsigned long holdoff[ACMDRV_DIAG_COUNTER_COUNT]
+			     [ACMDRV_BYPASS_NR_RULES];
+};
+
+/**
+ * @brief reaction on link changes of the bypass module's port
+ */
+struct failover {
+	struct acmdrv_failover_policy policy; /**< configured actions */
+	struct acmdrv_link_event event; /**< last reported link event */
+	bool link_down;		/**< link state seen last */
+	bool sched_disabled;	/**< scheduler emergency disabled by failover */
+	u32 msgbuf_invalid;	/**< message buffers invalidated by failover */
+	struct mutex lock;	/**< failover data lock */
+};
+
 /**
  * @brief Bypass Module Handler
  */
@@ -90,6 +124,8 @@ struct bypass {
 	struct mutex		diag_lock;	/**< diag data access lock */
 	struct delayed_work	diag_work;	/**< diag data polling work */
 	unsigned int		diag_poll_time;	/**< diag data poll time (ms) */
+	struct diag_alarm	diag_alarm;	/**< threshold supervision */
+	struct failover		failover;	/**< link change reaction */
 	bool			active;	/**< denotes bypass module as active */
 
 	struct nfr_cache	no_frames_received; /**< recovery cache data */
@@ -132,7 +168,7 @@ void bypass_area_write(struct bypass *bypass, off_t area, off_t offset,
 //	dev_dbg(acm_dev(bypass->acm), "[BP%d]: 0x%08x -> %s(0x%08lx, 0x%08lx)\n",
 //		bypass->index, value, __func__, area, offset);
 
-	writel(value, bypass->base + area + offset);
+	acm_writel(value, bypass->base + area + offset);
 }
 
 /**
@@ -494,6 +530,84 @@ static const struct bypass_diag_access_helper bypass_diag_access[MAX_DIDX] = {
 	}
 };
 
+/**
+ * @brief diagnostic elements of the counters supervised by thresholds
+ */
+static const enum diag_index diag_alarm_didx[ACMDRV_DIAG_COUNTER_COUNT] = {
+	[ACMDRV_DIAG_INGRESS_WIN_CLOSED] = INGRESS_WIN_CLOSED_COUNTER_DIDX,
+	[ACMDRV_DIAG_NO_FRAME_RECEIVED] = NO_FRAME_RECEIVED_COUNTER_DIDX,
+	[ACMDRV_DIAG_RECOVERY] = RECOVERY_COUNTER_DIDX,
+	[ACMDRV_DIAG_ADDITIONAL_FILTER_MISMATCH] =
+		ADDITIONAL_FILTER_MISMATCH_COUNTER_DIDX,
+};
+
+/**
+ * @brief sysfs attributes notified on threshold breaches per bypass module
+ */
+static const char * const diag_alarm_attr[ACMDRV_BYPASS_MODULES_COUNT] = {
+	"diag_alarm_M0",
+	"diag_alarm_M1",
+};
+
+/**
+ * @brief evaluate the diagnostic counters against their thresholds
+ *
+ * Compares the increase of each supervised counter since the previous
+ * evaluation with its threshold and notifies the diag_alarm attribute of
+ * the bypass module on new breaches. A breach within the holdoff time of a
+ * previous breach of the same counter and rule is suppressed.
+ *
+ * The diag_lock must be held when calling this function
+ */
+static void bypass_diag_check_thresholds(struct bypass *bypass)
+{
+	int c, r;
+	bool notify = false;
+	struct diag_alarm *da = &bypass->diag_alarm;
+	u8 *diagdata = (u8 *)(&bypass->diag);
+
+	for (c = 0; c < ACMDRV_DIAG_COUNTER_COUNT; ++c) {
+		const struct bypass_diag_access_helper *acc;
+		const u32 *data;
+
+		acc = &bypass_diag_access[diag_alarm_didx[c]];
+		data = (const u32 *)(&diagdata[acc->dataoffs]);
+
+		for (r = 0; r < ACMDRV_BYPASS_NR_RULES; ++r) {
+			const struct acmdrv_diag_threshold *th;
+			u32 delta = data[r] - da->last[c][r];
+
+			th = &da->thresholds.rule[c][r];
+			da->last[c][r] = data[r];
+			if (th->limit == 0 || delta < th->limit)
+				continue;
+
+			/* a holdoff end of 0 denotes no pending holdoff */
+			if (da->holdoff[c][r] &&
+			    time_before(jiffies, da->holdoff[c][r])) {
+				da->alarm.suppressed++;
+				continue;
+			}
+
+			da->holdoff[c][r] = jiffies +
+					    msecs_to_jiffies(th->holdoff);
+			da->alarm.rules[c] |= BIT(r);
+			da->alarm.delta[c][r] = delta;
+			trace_acm_diag_alarm(bypass->index, c, r, delta);
+			notify = true;
+		}
+	}
+
+	if (!notify)
+		return;
+
+	da->alarm.seq++;
+	da->alarm.timestamp = bypass->diag.timestamp;
+	sysfs_notify(&bypass->acm->dev.kobj,
+		     __stringify(ACMDRV_SYSFS_DIAG_GROUP),
+		     diag_alarm_attr[bypass->index]);
+}
+
 /**
  * @brief update diagnostic data cache
  *
@@ -530,6 +644,12 @@ static int bypass_diag_update(struct bypass *bypass)
 	end = ktime_get_mono_fast_ns();
 	dev_dbg(acm_dev(bypass->acm), "%s[%d] took %llu ns with %d retries\n",
 		__func__, bypass->index, end - start, retry);
+	acm_latency_record(bypass->acm, ACM_LAT_DIAG_UPDATE, start);
+	trace_acm_diag_update(bypass->index, retry, end - start, ret);
+
+	/* an inconsistent snapshot is evaluated with the next update */
+	if (!ret)
+		bypass_diag_check_thresholds(bypass);
 
 	return ret;
 }
@@ -545,6 +665,7 @@ static void bypass_diag_reset(struct bypass *bypass)
 		return;
 
 	memset(&bypass->diag, 0, sizeof(bypass->diag));
+	memset(bypass->diag_alarm.last, 0, sizeof(bypass->diag_alarm.last));
 }
 
 /**
@@ -599,6 +720,64 @@ unlock:
 	return ret;
 }
 
+/**
+ * @brief provide the diagnostic counter thresholds
+ */
+int bypass_diag_read_thresholds(struct bypass *bypass,
+				struct acmdrv_diag_thresholds *thresholds)
+{
+	int ret;
+
+	ret = mutex_lock_interruptible(&bypass->diag_lock);
+	if (ret)
+		return ret;
+	*thresholds = bypass->diag_alarm.thresholds;
+	mutex_unlock(&bypass->diag_lock);
+
+	return 0;
+}
+
+/**
+ * @brief set the diagnostic counter thresholds
+ *
+ * Pending holdoff times are cancelled, so the new thresholds apply with the
+ * next diagnostic update.
+ */
+int bypass_diag_write_thresholds(struct bypass *bypass,
+	const struct acmdrv_diag_thresholds *thresholds)
+{
+	int ret;
+
+	ret = mutex_lock_interruptible(&bypass->diag_lock);
+	if (ret)
+		return ret;
+	bypass->diag_alarm.thresholds = *thresholds;
+	memset(bypass->diag_alarm.holdoff, 0,
+	       sizeof(bypass->diag_alarm.holdoff));
+	mutex_unlock(&bypass->diag_lock);
+
+	return 0;
+}
+
+/**
+ * @brief provide the threshold breaches and clear the breached rules
+ */
+int bypass_diag_read_alarm(struct bypass *bypass,
+			   struct acmdrv_diag_alarm *alarm)
+{
+	int ret;
+
+	ret = mutex_lock_interruptible(&bypass->diag_lock);
+	if (ret)
+		return ret;
+	*alarm = bypass->diag_alarm.alarm;
+	memset(bypass->diag_alarm.alarm.rules, 0,
+	       sizeof(bypass->diag_alarm.alarm.rules));
+	mutex_unlock(&bypass->diag_lock);
+
+	return 0;
+}
+
 /**
  * @brief Check and clear on read NoFrameReceived flag for respective rule index
  */
@@ -642,6 +821,46 @@ void bypass_recovery_take_any(struct bypass *bypass, int idx)
 
 	mutex_unlock(&bypass->take_any_lock);
 }
+/**
+ * @brief determine the message buffers referenced by the bypass module
+ *
+ * Scans the scatter DMA commands and the prefetch DMA commands moving data
+ * from message buffers for the message buffer IDs they refer to.
+ *
+ * @param bypass bypass module instance
+ * @return bit mask of the referenced message buffers
+ */
+u32 bypass_msgbuf_usage(struct bypass *bypass)
+{
+	int i;
+	u32 usage = 0;
+	const size_t elsize = sizeof(struct acmdrv_bypass_dma_command);
+
+	for (i = 0; i < ACMDRV_BYPASS_SCATTER_DMA_CMD_COUNT; ++i) {
+		u32 cmd = bypass_area_read(bypass, ACM_BYPASS_SCATTER_DMA,
+					   i * elsize);
+
+		if (RVAL(ACMDRV_BYPASS_DMA_CMD_S_COMMAND_BIT, cmd) ==
+		    ACMDRV_BYPASS_DMA_CMD_S_COMMAND_INVALID)
+			continue;
+		usage |= BIT(RVAL(ACMDRV_BYPASS_DMA_CMD_S_RX_MSGBUF_ID_BIT,
+				  cmd));
+	}
+
+	for (i = 0; i < ACMDRV_BYPASS_PREFETCH_DMA_CMD_COUNT; ++i) {
+		u32 cmd = bypass_area_read(bypass,
+					   ACM_BYPASS_GATHER_DMA_PREFETCH,
+					   i * elsize);
+
+		if (RVAL(ACMDRV_BYPASS_DMA_CMD_P_COMMAND_BIT, cmd) !=
+		    ACMDRV_BYPASS_DMA_CMD_P_COMMAND_MOV_MSG_BUFF)
+			continue;
+		usage |= BIT(RVAL(ACMDRV_BYPASS_DMA_CMD_P_MSGBUF_ID_BIT, cmd));
+	}
+
+	return usage;
+}
+
 /**
  * @brief cleanup/initialize bypass module IP
  */
@@ -709,6 +928,132 @@ static void bypass_output_enable(struct bypass *bypass, bool onoff)
 				  !onoff);
 }
 
+/**
+ * @brief provide the failover policy
+ */
+void bypass_failover_read_policy(struct bypass *bypass,
+				 struct acmdrv_failover_policy *policy)
+{
+	mutex_lock(&bypass->failover.lock);
+	*policy = bypass->failover.policy;
+	mutex_unlock(&bypass->failover.lock);
+}
+
+/**
+ * @brief set the failover policy
+ *
+ * The policy applies with the next link change, actions already performed
+ * on the last link down are undone according to the new link up actions.
+ */
+int bypass_failover_write_policy(struct bypass *bypass,
+				 const struct acmdrv_failover_policy *policy)
+{
+	if ((policy->link_down | policy->link_up) & ~ACMDRV_FAILOVER_ALL)
+		return -EINVAL;
+
+	mutex_lock(&bypass->failover.lock);
+	bypass->failover.policy = *policy;
+	mutex_unlock(&bypass->failover.lock);
+
+	return 0;
+}
+
+/**
+ * @brief provide the last reported link event
+ */
+void bypass_failover_read_event(struct bypass *bypass,
+				struct acmdrv_link_event *event)
+{
+	mutex_lock(&bypass->failover.lock);
+	*event = bypass->failover.event;
+	mutex_unlock(&bypass->failover.lock);
+}
+
+/**
+ * @brief perform the failover actions on a link change
+ *
+ * Called synchronously from the netdevice notifier, so the actions are
+ * completed before the link change is propagated any further. Repeated
+ * events without a change of the link state are ignored.
+ *
+ * @param bypass bypass module instance
+ * @param up new link state
+ */
+static void bypass_link_failover(struct bypass *bypass, bool up)
+{
+	struct failover *fo = &bypass->failover;
+	struct acm *acm = bypass->acm;
+	u64 start = ktime_get_ns();
+	u32 actions;
+	u32 performed = 0;
+
+	mutex_lock(&fo->lock);
+	if (fo->link_down == !up)
+		goto unlock;
+	fo->link_down = !up;
+
+	actions = up ? fo->policy.link_up : fo->policy.link_down;
+
+	if (actions & ACMDRV_FAILOVER_SCHEDULER) {
+		const u16 mux = ACMDRV_SCHED_EMERG_DIS_MUX;
+		u16 eme = scheduler_read_emergency_disable(acm->scheduler,
+							   bypass->index);
+
+		if (!up && !(eme & mux)) {
+			scheduler_write_emergency_disable(acm->scheduler,
+				bypass->index, eme | mux);
+			fo->sched_disabled = true;
+			performed |= ACMDRV_FAILOVER_SCHEDULER;
+		} else if (up && fo->sched_disabled) {
+			scheduler_write_emergency_disable(acm->scheduler,
+				bypass->index, eme & ~mux);
+			fo->sched_disabled = false;
+			performed |= ACMDRV_FAILOVER_SCHEDULER;
+		}
+	}
+
+	if (actions & ACMDRV_FAILOVER_RECOVERY) {
+		redundancy_recovery_reset_module(acm->redundancy,
+						 bypass->index);
+		performed |= ACMDRV_FAILOVER_RECOVERY;
+	}
+
+	if (actions & ACMDRV_FAILOVER_MSGBUF) {
+		u32 mask = up ? fo->msgbuf_invalid :
+				bypass_msgbuf_usage(bypass);
+
+		/* descriptors written meanwhile are valid again anyway */
+		fo->msgbuf_invalid = mask &
+			msgbuf_invalidate_mask(acm->msgbuf, mask, !up);
+		performed |= ACMDRV_FAILOVER_MSGBUF;
+	}
+
+	if (performed)
+		dev_dbg(acm_dev(acm), "[BP%d]: link %s, failover 0x%x\n",
+			bypass->index, up ? "up" : "down", performed);
+
+	if (actions & ACMDRV_FAILOVER_NOTIFY) {
+		struct timespec64 now = ktime_to_timespec64(
+			scheduler_ktime_get_ptp(acm->scheduler));
+
+		fo->event.seq++;
+		fo->event.link_up = up;
+		fo->event.actions = performed | ACMDRV_FAILOVER_NOTIFY;
+		fo->event.msgbuf_invalid = fo->msgbuf_invalid;
+		fo->event.duration = ktime_get_ns() - start;
+		fo->event.timestamp.tv_sec = now.tv_sec;
+		fo->event.timestamp.tv_nsec = now.tv_nsec;
+		sysfs_notify(&acm->dev.kobj,
+			     __stringify(ACMDRV_SYSFS_CONFIG_GROUP),
+			     "link_event");
+	}
+
+	trace_acm_link_failover(bypass->index, up, performed,
+				ktime_get_ns() - start);
+unlock:
+	mutex_unlock(&fo->lock);
+}
+
 /**
  * @brief callback for netdevice events
  *
@@ -717,6 +1062,7 @@ static void bypass_output_enable(struct bypass *bypass, bool onoff)
  * (like KSZ9031) might hang thus not being able to autonegotiate a new link.
  * Here network events of the respective bypass module's port (derived by the
  * associated phy given in devicetree) trigger the appropriate action.
+ * Additionally the configured failover actions are performed on link changes.
  */
 static int bypass_netdev_event(struct notifier_block *nb,
 			       unsigned long event, void *ptr)
@@ -753,16 +1099,22 @@ static int bypass_netdev_event(struct notifier_block *nb,
 		 */
 		switch (event) {
 		case NETDEV_UP:
-			if (netif_carrier_ok(ndev))
+			if (netif_carrier_ok(ndev)) {
 				bypass_output_enable(bypass, true);
+				bypass_link_failover(bypass, true);
+			}
 			break;
 		case NETDEV_DOWN:
 			bypass_output_enable(bypass, false);
+			bypass_link_failover(bypass, false);
 			break;
 		case NETDEV_CHANGE:
-			if (netif_running(ndev))
-				bypass_output_enable(bypass,
-						     netif_carrier_ok(ndev));
+			if (netif_running(ndev)) {
+				bool up = netif_carrier_ok(ndev);
+
+				bypass_output_enable(bypass, up);
+				bypass_link_failover(bypass, up);
+			}
 			break;
 		default:
 			break;
@@ -817,7 +1169,7 @@ int __must_check bypass_init(struct acm *acm)
 
 		res = platform_get_resource_byname(pdev, IORESOURCE_MEM,
 						   resname);
-		bypass[i].base = devm_ioremap_resource(dev, res);
+		bypass[i].base = acm_ioremap_resource(dev, res);
 		if (IS_ERR(bypass[i].base))
 			return PTR_ERR(bypass[i].base);
 
@@ -849,6 +1201,7 @@ int __must_check bypass_init(struct acm *acm)
 		bypass_set_diag_poll_time(diag_poll, &bypass[i]);
 
 		mutex_init(&bypass[i].take_any_lock);
+		mutex_init(&bypass[i].failover.lock);
 
 		dev_dbg(dev, "Probed Bypass[%d] %pr -> 0x%p\n", i, res,
 			bypass[i].base);
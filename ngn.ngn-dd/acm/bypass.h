@@ -216,13 +216,27 @@ void bypass_set_active(struct bypass *bypass, bool active);
 bool bypass_get_active(struct bypass *bypass);
 
 void bypass_cleanup(struct bypass *bypass);
+u32 bypass_msgbuf_usage(struct bypass *bypass);
 
 int bypass_diag_read(struct bypass *bypass, struct acmdrv_diagnostics *diag);
 int bypass_diag_init(struct bypass *bypass);
+int bypass_diag_read_thresholds(struct bypass *bypass,
+				struct acmdrv_diag_thresholds *thresholds);
+int bypass_diag_write_thresholds(struct bypass *bypass,
+	const struct acmdrv_diag_thresholds *thresholds);
+int bypass_diag_read_alarm(struct bypass *bypass,
+			   struct acmdrv_diag_alarm *alarm);
 
 unsigned int bypass_get_diag_poll_time(const struct bypass *bypass);
 void bypass_set_diag_poll_time(unsigned int poll, struct bypass *bypass);
 
+void bypass_failover_read_policy(struct bypass *bypass,
+				 struct acmdrv_failover_policy *policy);
+int bypass_failover_write_policy(struct bypass *bypass,
+				 const struct acmdrv_failover_policy *policy);
+void bypass_failover_read_event(struct bypass *bypass,
+				struct acmdrv_link_event *event);
+
 void bypass_recovery_take_any(struct bypass *bypass, int idx);
 bool bypass_recovery_no_frame_received(struct bypass *bypass, int idx);
 
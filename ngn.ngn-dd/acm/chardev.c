@@ -50,14 +50,20 @@ struct acm_dev {
 
 	bool active;			/**< state of ACM device */
 	bool timestamp;			/**< time stamp configuration */
+	bool auto_lock;			/**< lock message buffer on access */
 };
 
 /**
  * @brief read method for ACM message buffer devices
+ *
+ * Supports pread() at any offset, only the 32-bit words covering the
+ * requested range are read from the message buffer. In auto lock mode the
+ * message buffer status word follows the data.
+ *
  * @param file the file to read from
  * @param buf the buffer to read to
  * @param size the maximum number of bytes to read
- * @param ppos the current position in the file
+ * @param ppos the offset within the message buffer
  * @return number of bytes read or errno
  */
 static ssize_t acm_dev_read(struct file *file, char __user *buf, size_t size,
@@ -71,29 +77,15 @@ static ssize_t acm_dev_read(struct file *file, char __user *buf, size_t size,
 	if (ret)
 		return ret;
 
-	if (!acm_state_is_running(acm->status)) {
+	if (!acm_state_msgbuf_is_running(acm->status, adev->idx)) {
 		dev_dbg(adev->dev, "not running\n");
 		ret = -EIO;
 		goto unlock;
 	}
 
-	if (*ppos != 0) {
-		dev_dbg(adev->dev, "reading from offset %llu not allowed\n",
-			*ppos);
-		ret = -EINVAL;
-		goto unlock;
-	}
-
-	if (size  > adev->size) {
-		dev_dbg(adev->dev, "truncating message to %zu\n", adev->size);
-		size = adev->size;
-	}
-
-	ret = msgbuf_read_to_user(acm->msgbuf, adev->idx, buf, size);
-	if (ret)
-		goto unlock;
-
-	ret = size;
+	/* the position is not advanced, so read() always starts at 0 */
+	ret = msgbuf_read_to_user(acm->msgbuf, adev->idx, buf, size, *ppos,
+				  adev->auto_lock);
 
 unlock:
 	mutex_unlock(&adev->cdev_mutex);
@@ -102,6 +94,9 @@ unlock:
 
 /**
  * @brief write method for ACM message buffer devices
+ *
+ * Supports pwrite() at any offset, bytes outside the requested range keep
+ * their content.
  */
 static ssize_t acm_dev_write(struct file *file, const char __user *buf,
 			     size_t size, loff_t *ppos)
@@ -114,30 +109,15 @@ static ssize_t acm_dev_write(struct file *file, const char __user *buf,
 	if (ret)
 		return ret;
 
-	if (!acm_state_is_running(acm->status)) {
+	if (!acm_state_msgbuf_is_running(acm->status, adev->idx)) {
 		dev_dbg(adev->dev, "not running\n");
 		ret = -EIO;
 		goto unlock;
 	}
 
-	if (*ppos != 0) {
-		dev_dbg(adev->dev, "reading from offset %llu not allowed\n",
-			*ppos);
-		ret = -EINVAL;
-		goto unlock;
-	}
-
-	if (size  > adev->size) {
-		dev_dbg(adev->dev, "truncating message to %zu\n", adev->size);
-		size = adev->size;
-	}
-
-	if (msgbuf_write_from_user(acm->msgbuf, adev->idx, buf, size)) {
-		ret = -EFAULT;
-		goto unlock;
-	}
-
-	ret = size;
+	/* the position is not advanced, so write() always starts at 0 */
+	ret = msgbuf_write_from_user(acm->msgbuf, adev->idx, buf, size, *ppos,
+				     adev->auto_lock);
 unlock:
 	mutex_unlock(&adev->cdev_mutex);
 
@@ -280,6 +260,25 @@ void acm_dev_set_timestamping(struct acm_dev *adev, bool enable)
 	adev->timestamp = enable;
 }
 
+/**
+ * @brief check if ACM device locks its message buffer on access
+ */
+bool acm_dev_get_auto_lock(const struct acm_dev *adev)
+{
+	return adev->auto_lock;
+}
+
+/**
+ * @brief configure ACM device to lock its message buffer on access
+ *
+ * In auto lock mode the message buffer status is provided after the
+ * message data.
+ */
+void acm_dev_set_auto_lock(struct acm_dev *adev, bool enable)
+{
+	adev->auto_lock = enable;
+}
+
 /**
  * @brief get name of ACM device
  */
@@ -37,6 +37,8 @@ int __must_check acm_dev_activate(struct acm_dev *adev, const char *alias,
 void acm_dev_deactivate(struct acm_dev *adev);
 bool acm_dev_get_timestamping(const struct acm_dev *adev);
 void acm_dev_set_timestamping(struct acm_dev *adev, bool enable);
+bool acm_dev_get_auto_lock(const struct acm_dev *adev);
+void acm_dev_set_auto_lock(struct acm_dev *adev, bool enable);
 const char *acm_dev_get_name(const struct acm_dev *adev);
 bool acm_dev_is_active(const struct acm_dev *adev);
 u64 acm_dev_get_id(const struct acm_dev *adev);
@@ -23,6 +23,51 @@
  */
 
 #include <linux/kernel.h>
+
+/**
+ * @brief default number of message buffers
+ */
+#define ACM_COMMREG_MSGBUF_COUNT_DEFAULT	32
+
+/**
+ * @brief default message buffers data width
+ */
+#define ACM_COMMREG_MSGBUF_DATAWIDTH_DEFAULT	4
+
+/**
+ * @name Common Register Offsets
+ * @brief Register offsets and definitions of the common register block
+ */
+/**@{*/
+#define ACM_COMMREG_DEVICE_ID		0x00000000
+#define ACM_COMMREG_VERSION_ID		0x00000004
+#define ACM_COMMREG_REVISION_ID		0x00000008
+
+#define ACM_COMMREG_GENERIC_0		0x00000100
+#define GENERIC_0_EXT_STATUS		BIT(0)
+#define GENERIC_0_TEST_EN		BIT(1)
+#define GENERIC_0_CFG_READ_BACK		BIT(2)
+#define GENERIC_0_INDIV_RECOV_EN	BIT(3)
+#define GENERIC_0_REDUND_RX_EN		BIT(4)
+#define GENERIC_0_MSG_BUFF_NO_L		5
+#define GENERIC_0_MSG_BUFF_NO_H		11
+#define GENERIC_0_MSG_BUFF_NO	\
+	GENMASK(GENERIC_0_MSG_BUFF_NO_H, GENERIC_0_MSG_BUFF_NO_L)
+#define GENERIC_0_TIME_FREQ_L		16
+#define GENERIC_0_TIME_FREQ_H		31
+#define GENERIC_0_TIME_FREQ	\
+	GENMASK(GENERIC_0_TIME_FREQ_H, GENERIC_0_TIME_FREQ_L)
+
+#define ACM_COMMREG_GENERIC_1		0x00000104
+#define GENERIC_1_MSGBUF_ADDR_WIDTH	GENMASK(15, 0)
+
+#define ACM_COMMREG_RST_REQ		0x00000200
+#define RST_REQ_SW_RST_REQ		BIT(0)
+#define RST_REQ_RST_REQ			BIT(1)
+
+#define ACM_COMMREG_CONFIGURATION_ID	0x00000300
+/**@}*/
+
 struct acm;
 struct commreg;
 
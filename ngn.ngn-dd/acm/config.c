@@ -26,6 +26,7 @@
  * @{
  */
 
+#include <linux/bitops.h>
 #include <linux/delay.h>
 #include <linux/io.h>
 
@@ -115,37 +116,116 @@ int acm_config_remove(struct acm *acm, enum acmdrv_status *new_status)
 	return 0;
 }
 
+/**
+ * @brief Clean up the configuration of selected modules only.
+ *
+ * Scheduler i is assumed to serve bypass module i. Message buffers which are
+ * still referenced by a module not being reconfigured are kept, as are the
+ * shared base recovery and IntSeqNum tables. The IP is not reset, so the
+ * other module keeps running.
+ *
+ * @param acm ACM instance
+ * @param modules bit mask of the modules to clean up
+ * @param new_status Returns new ACM state
+ * @return Returns 0 on success, negative error code otherwise.
+ */
+static int acm_config_remove_modules(struct acm *acm, unsigned long modules,
+				     enum acmdrv_status *new_status)
+{
+	int i;
+	int ret;
+	u32 msgbufs = 0;
+	u32 keep = 0;
+
+	*new_status = ACMDRV_INIT_STATE;
+
+	/* determine the message buffers used by the selected modules only */
+	for (i = 0; i < ACMDRV_BYPASS_MODULES_COUNT; ++i) {
+		if (test_bit(i, &modules))
+			msgbufs |= bypass_msgbuf_usage(acm->bypass[i]);
+		else
+			keep |= bypass_msgbuf_usage(acm->bypass[i]);
+	}
+	msgbufs &= ~keep;
+
+	/* 1. Disable scheduler and module and remove recovery settings */
+	for_each_set_bit(i, &modules, ACMDRV_BYPASS_MODULES_COUNT) {
+		int j;
+
+		scheduler_write_emergency_disable(acm->scheduler, i, 1);
+		scheduler_set_active(acm->scheduler, i, false);
+
+		bypass_enable(acm->bypass[i], false);
+		bypass_set_active(acm->bypass[i], false);
+
+		for (j = 0; j < ACMDRV_BYPASS_NR_RULES; ++j)
+			/* ignore returned value */
+			ret = redundancy_set_individual_recovery_timeout(
+				acm->redundancy, i, j, 0);
+	}
+
+	/* 2. Clean up devices for the message buffers of the modules */
+	for (i = 0; i < commreg_read_msgbuf_count(acm->commreg); ++i) {
+		struct acm_dev *adev;
+
+		if (!(msgbufs & BIT(i)))
+			continue;
+
+		adev = acm_dev_get_device(acm->devices, i);
+		acm_dev_deactivate(adev);
+		msgbuf_read_status(acm->msgbuf, i);
+		msgbuf_read_clear_overwritten(acm->msgbuf, i);
+	}
+	msgbuf_cleanup_mask(acm->msgbuf, msgbufs);
+
+	/* 3. clean-up the modules */
+	for_each_set_bit(i, &modules, ACMDRV_BYPASS_MODULES_COUNT) {
+		bypass_cleanup(acm->bypass[i]);
+		scheduler_cleanup_sched(acm->scheduler, i);
+		redundancy_cleanup_module(acm->redundancy, i);
+	}
+
+	return 0;
+}
+
 /**
  * @brief start configuration phase of ACM
  *
  * @param acm ACM instance
+ * @param modules bit mask of the modules to be configured
  * @param new_status Returns new ACM state
  * @return Returns 0 on success, negative error code otherwise.
  */
-int acm_config_start(struct acm *acm, enum acmdrv_status *new_status)
+int acm_config_start(struct acm *acm, unsigned long modules,
+		     enum acmdrv_status *new_status)
 {
-	return acm_config_remove(acm, new_status);
+	if (modules == ACMDRV_CONFIG_MODULES_ALL)
+		return acm_config_remove(acm, new_status);
+
+	return acm_config_remove_modules(acm, modules, new_status);
 }
 
 /**
  * @brief end configuration phase of ACM
  *
  * @param acm ACM instance
+ * @param modules bit mask of the modules having been configured
  * @param new_status Returns new ACM state
  * @return Returns 0 on success, negative error code otherwise.
  */
-int acm_config_end(struct acm *acm, enum acmdrv_status *new_status)
+int acm_config_end(struct acm *acm, unsigned long modules,
+		   enum acmdrv_status *new_status)
 {
 	int i;
 
 	/* Store which modules are active */
-	for (i = 0; i < ACMDRV_SCHEDULER_COUNT; ++i)
+	for_each_set_bit(i, &modules, ACMDRV_SCHEDULER_COUNT)
 		if (scheduler_read_emergency_disable(acm->scheduler, i))
 			scheduler_set_active(acm->scheduler, i, false);
 		else
 			scheduler_set_active(acm->scheduler, i, true);
 
-	for (i = 0; i < ACMDRV_BYPASS_MODULES_COUNT; ++i)
+	for_each_set_bit(i, &modules, ACMDRV_BYPASS_MODULES_COUNT)
 		bypass_set_active(acm->bypass[i],
 				  bypass_is_enabled(acm->bypass[i]));
 
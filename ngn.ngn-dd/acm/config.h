@@ -21,8 +21,10 @@
 #include "acm-module.h"
 #include "state.h"
 
-int acm_config_start(struct acm *acm, enum acmdrv_status *new_status);
-int acm_config_end(struct acm *acm, enum acmdrv_status *new_status);
+int acm_config_start(struct acm *acm, unsigned long modules,
+		     enum acmdrv_status *new_status);
+int acm_config_end(struct acm *acm, unsigned long modules,
+		   enum acmdrv_status *new_status);
 int acm_config_stop_running(struct acm *acm, enum acmdrv_status *new_status);
 int acm_config_restart_running(struct acm *acm, enum acmdrv_status *new_status);
 int acm_config_remove(struct acm *acm, enum acmdrv_status *new_status);
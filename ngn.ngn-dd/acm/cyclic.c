@@ -0,0 +1,469 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * TTTech ACM Linux driver
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * Contact Information:
+ * support@tttech-industrial.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+/**
+ * @file cyclic.c
+ * @brief ACM Driver Cyclic I/O Engine
+ */
+
+/**
+ * @brief kernel pr_* format macro
+ */
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+/**
+ * @defgroup acmcyclic ACM Cyclic I/O Engine
+ * @brief Copies between message buffers and a shared process image
+ *
+ * A kernel thread with real-time priority executes the configured copy jobs
+ * at their phase within each cycle. Cycles are aligned to the PTP time of the
+ * ACM: the thread sleeps on an hrtimer of CLOCK_MONOTONIC, the offset to the
+ * PTP time is determined again before each sleep, so the thread follows
+ * PTP clock adjustments.
+ *
+ * Jobs are sorted by phase, jobs of the same phase are executed with a
+ * single wakeup.
+ *
+ * @{
+ */
+#include <linux/kernel.h>
+#include <linux/device.h>
+#include <linux/platform_device.h>
+#include <linux/kthread.h>
+#include <linux/hrtimer.h>
+#include <linux/sched.h>
+#include <linux/version.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 11, 0)
+#include <uapi/linux/sched/types.h>
+#endif
+#include <linux/sort.h>
+#include <linux/vmalloc.h>
+#include <linux/mm.h>
+
+#include "acm-module.h"
+#include "cyclic.h"
+#include "msgbuf.h"
+#include "chardev.h"
+#include "commreg.h"
+#include "scheduler.h"
+#include "state.h"
+#include "latency.h"
+
+/**
+ * @brief cyclic I/O engine instance
+ */
+struct cyclic {
+	struct acm *acm;		/**< associated ACM instance */
+	void *image;			/**< process image */
+
+	struct mutex lock;		/**< lock for configuration access */
+	struct acmdrv_cyclic_job jobs[ACMDRV_CYCLIC_JOBS_MAX]; /**< jobs */
+	struct acmdrv_cyclic_control control; /**< active configuration */
+
+	struct acmdrv_cyclic_job run[ACMDRV_CYCLIC_JOBS_MAX]; /**< sorted */
+	struct task_struct *task;	/**< thread executing the jobs */
+	bool disabled;			/**< engine shut down for removal */
+	struct acmdrv_cyclic_stats stats; /**< statistics */
+};
+
+/**
+ * @brief get the process image
+ */
+void *cyclic_image(struct cyclic *cyclic)
+{
+	return cyclic->image;
+}
+
+/**
+ * @brief map the process image to user space
+ */
+int __must_check cyclic_image_map(struct cyclic *cyclic,
+				  struct vm_area_struct *vma)
+{
+	return remap_vmalloc_range(vma, cyclic->image, vma->vm_pgoff);
+}
+
+/**
+ * @brief read copy jobs to a buffer of packed acmdrv_cyclic_job
+ */
+int __must_check cyclic_get_jobs(struct cyclic *cyclic, unsigned int first,
+				 unsigned int last, void *jobs)
+{
+	if (first > last || last >= ACMDRV_CYCLIC_JOBS_MAX)
+		return -EINVAL;
+
+	mutex_lock(&cyclic->lock);
+	memcpy(jobs, &cyclic->jobs[first],
+	       (last - first + 1) * sizeof(*cyclic->jobs));
+	mutex_unlock(&cyclic->lock);
+
+	return 0;
+}
+
+/**
+ * @brief check a copy job against the limits of the process image
+ *
+ * The message buffer limits are checked on execution, since message buffers
+ * may be reconfigured while the engine is running.
+ */
+static int cyclic_job_check(struct cyclic *cyclic,
+			    const struct acmdrv_cyclic_job *job)
+{
+	struct device *dev = acm_dev(cyclic->acm);
+
+	if (job->msgbuf >= commreg_read_msgbuf_count(cyclic->acm->commreg)) {
+		dev_err(dev, "%s: invalid message buffer %u\n", __func__,
+			job->msgbuf);
+		return -EINVAL;
+	}
+
+	if (!IS_ALIGNED(job->length | job->buffer_offset | job->image_offset,
+			sizeof(u32))) {
+		dev_err(dev, "%s: job of message buffer %u not aligned\n",
+			__func__, job->msgbuf);
+		return -EINVAL;
+	}
+
+	if ((u64)job->image_offset + job->length > ACMDRV_CYCLIC_IMAGE_SIZE) {
+		dev_err(dev, "%s: job of message buffer %u exceeds image\n",
+			__func__, job->msgbuf);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief write copy jobs from a buffer of packed acmdrv_cyclic_job
+ *
+ * Only possible while the engine is disabled.
+ */
+int __must_check cyclic_set_jobs(struct cyclic *cyclic, unsigned int first,
+				 unsigned int last, const void *jobs)
+{
+	int ret = 0;
+
+	if (first > last || last >= ACMDRV_CYCLIC_JOBS_MAX)
+		return -EINVAL;
+
+	mutex_lock(&cyclic->lock);
+	if (cyclic->task) {
+		ret = -EBUSY;
+		goto unlock;
+	}
+
+	memcpy(&cyclic->jobs[first], jobs,
+	       (last - first + 1) * sizeof(*cyclic->jobs));
+unlock:
+	mutex_unlock(&cyclic->lock);
+	return ret;
+}
+
+/**
+ * @brief read active configuration, jobs is 0 if disabled
+ */
+void cyclic_get_control(struct cyclic *cyclic,
+			struct acmdrv_cyclic_control *control)
+{
+	mutex_lock(&cyclic->lock);
+	*control = cyclic->control;
+	mutex_unlock(&cyclic->lock);
+}
+
+/**
+ * @brief read statistics
+ *
+ * The statistics are updated by the engine without locking, so they might be
+ * slightly inconsistent to each other.
+ */
+void cyclic_get_stats(struct cyclic *cyclic,
+		      struct acmdrv_cyclic_stats *stats)
+{
+	stats->cycles = READ_ONCE(cyclic->stats.cycles);
+	stats->missed = READ_ONCE(cyclic->stats.missed);
+	stats->max_lateness_ns = READ_ONCE(cyclic->stats.max_lateness_ns);
+	stats->errors = READ_ONCE(cyclic->stats.errors);
+}
+
+/**
+ * @brief current PTP time of the ACM in ns
+ */
+static u64 cyclic_ptp_ns(struct cyclic *cyclic)
+{
+	return ktime_to_ns(scheduler_ktime_get_ptp(cyclic->acm->scheduler));
+}
+
+/**
+ * @brief sleep until PTP time target
+ *
+ * @return lateness of the wakeup in ns
+ */
+static u64 cyclic_sleep_until(struct cyclic *cyclic, u64 target)
+{
+	u64 now = cyclic_ptp_ns(cyclic);
+	ktime_t expires;
+
+	if (now < target) {
+		expires = ktime_add_ns(ktime_get(), target - now);
+		set_current_state(TASK_INTERRUPTIBLE);
+		schedule_hrtimeout_range(&expires, 0, HRTIMER_MODE_ABS);
+		now = cyclic_ptp_ns(cyclic);
+	}
+
+	return now > target ? now - target : 0;
+}
+
+/**
+ * @brief execute a single copy job
+ */
+static void cyclic_run_job(struct cyclic *cyclic,
+			   const struct acmdrv_cyclic_job *job)
+{
+	int ret;
+	struct acm *acm = cyclic->acm;
+
+	ret = msgbuf_copy(acm->msgbuf, job->msgbuf,
+			  cyclic->image + job->image_offset,
+			  job->buffer_offset, job->length,
+			  acm_dev_get_auto_lock(ACM_DEVICE(acm, job->msgbuf)));
+
+	/* empty RX buffers keep the previous data in the image */
+	if (ret && ret != -ENODATA)
+		WRITE_ONCE(cyclic->stats.errors, cyclic->stats.errors + 1);
+}
+
+/**
+ * @brief thread executing the copy jobs cycle by cycle
+ */
+static int cyclic_thread(void *data)
+{
+	struct cyclic *cyclic = data;
+	struct acm *acm = cyclic->acm;
+	const u64 period = cyclic->control.period_ns;
+	const unsigned int count = cyclic->control.jobs;
+	u64 cycle, now, lateness, skipped;
+	unsigned int i;
+
+	cycle = (div64_u64(cyclic_ptp_ns(cyclic), period) + 1) * period;
+
+	while (!kthread_should_stop()) {
+		i = 0;
+		while (i < count && !kthread_should_stop()) {
+			const u32 phase = cyclic->run[i].phase_ns;
+			u64 start;
+
+			lateness = cyclic_sleep_until(cyclic, cycle + phase);
+			if (lateness > cyclic->stats.max_lateness_ns)
+				WRITE_ONCE(cyclic->stats.max_lateness_ns,
+					   min_t(u64, lateness, U32_MAX));
+
+			start = acm_latency_start();
+			for (; i < count && cyclic->run[i].phase_ns == phase;
+			     ++i)
+				if (acm_state_msgbuf_is_running(acm->status,
+						cyclic->run[i].msgbuf))
+					cyclic_run_job(cyclic, &cyclic->run[i]);
+			acm_latency_record(acm, ACM_LAT_CYCLIC_CYCLE, start);
+		}
+
+		WRITE_ONCE(cyclic->stats.cycles, cyclic->stats.cycles + 1);
+		cycle += period;
+
+		/* skip cycles whose first job is already due */
+		now = cyclic_ptp_ns(cyclic);
+		if (now > cycle + cyclic->run[0].phase_ns) {
+			skipped = now - cycle - cyclic->run[0].phase_ns;
+			skipped = div64_u64(skipped, period) + 1;
+			cycle += skipped * period;
+			WRITE_ONCE(cyclic->stats.missed,
+				   cyclic->stats.missed + skipped);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief compare copy jobs by phase for sorting
+ */
+static int cyclic_job_cmp(const void *a, const void *b)
+{
+	const struct acmdrv_cyclic_job *ja = a, *jb = b;
+
+	if (ja->phase_ns < jb->phase_ns)
+		return -1;
+	return ja->phase_ns > jb->phase_ns;
+}
+
+/**
+ * @brief run the engine thread with real-time FIFO priority
+ */
+static void cyclic_set_fifo(struct task_struct *task)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 9, 0)
+	sched_set_fifo(task);
+#else
+	/* same priority as sched_set_fifo() of newer kernels */
+	struct sched_param param = { .sched_priority = MAX_RT_PRIO / 2 };
+
+	sched_setscheduler_nocheck(task, SCHED_FIFO, &param);
+#endif
+}
+
+/**
+ * @brief start the engine with the first control->jobs jobs
+ */
+static int cyclic_start(struct cyclic *cyclic,
+			const struct acmdrv_cyclic_control *control)
+{
+	int ret;
+	unsigned int i;
+	struct task_struct *task;
+	struct device *dev = acm_dev(cyclic->acm);
+
+	if (control->jobs > ACMDRV_CYCLIC_JOBS_MAX)
+		return -EINVAL;
+
+	/* shorter periods would keep the FIFO thread from ever sleeping */
+	if (control->period_ns < ACMDRV_CYCLIC_PERIOD_MIN_NS) {
+		dev_err(dev, "%s: period %u ns below minimum %u ns\n", __func__,
+			control->period_ns, ACMDRV_CYCLIC_PERIOD_MIN_NS);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < control->jobs; ++i) {
+		ret = cyclic_job_check(cyclic, &cyclic->jobs[i]);
+		if (ret)
+			return ret;
+
+		if (cyclic->jobs[i].phase_ns >= control->period_ns) {
+			dev_err(dev, "%s: phase of job %u exceeds period\n",
+				__func__, i);
+			return -EINVAL;
+		}
+	}
+
+	memcpy(cyclic->run, cyclic->jobs,
+	       control->jobs * sizeof(*cyclic->jobs));
+	sort(cyclic->run, control->jobs, sizeof(*cyclic->run), cyclic_job_cmp,
+	     NULL);
+	memset(&cyclic->stats, 0, sizeof(cyclic->stats));
+	cyclic->control = *control;
+
+	task = kthread_create(cyclic_thread, cyclic, "%s-cyclic",
+			      dev_name(&cyclic->acm->dev));
+	if (IS_ERR(task)) {
+		cyclic->control.jobs = 0;
+		return PTR_ERR(task);
+	}
+
+	cyclic_set_fifo(task);
+	cyclic->task = task;
+	wake_up_process(task);
+
+	dev_dbg(dev, "%s: %u jobs, period %u ns\n", __func__, control->jobs,
+		control->period_ns);
+	return 0;
+}
+
+/**
+ * @brief stop the engine, lock held
+ */
+static void cyclic_stop(struct cyclic *cyclic)
+{
+	if (!cyclic->task)
+		return;
+
+	kthread_stop(cyclic->task);
+	cyclic->task = NULL;
+	cyclic->control.jobs = 0;
+}
+
+/**
+ * @brief enable (control->jobs > 0) or disable the engine
+ *
+ * A running engine is stopped first, so the engine is restarted with a
+ * changed configuration.
+ */
+int __must_check cyclic_set_control(struct cyclic *cyclic,
+				    const struct acmdrv_cyclic_control *control)
+{
+	int ret = 0;
+
+	mutex_lock(&cyclic->lock);
+	if (cyclic->disabled) {
+		ret = -ENODEV;
+		goto unlock;
+	}
+	cyclic_stop(cyclic);
+	if (control->jobs)
+		ret = cyclic_start(cyclic, control);
+unlock:
+	mutex_unlock(&cyclic->lock);
+
+	return ret;
+}
+
+/**
+ * @brief initialize cyclic I/O engine
+ */
+int __must_check cyclic_init(struct acm *acm)
+{
+	struct cyclic *cyclic;
+	struct device *dev = acm_dev(acm);
+
+	cyclic = devm_kzalloc(dev, sizeof(*cyclic), GFP_KERNEL);
+	if (!cyclic)
+		return -ENOMEM;
+
+	cyclic->image = vmalloc_user(ACMDRV_CYCLIC_IMAGE_SIZE);
+	if (!cyclic->image)
+		return -ENOMEM;
+
+	cyclic->acm = acm;
+	mutex_init(&cyclic->lock);
+
+	acm->cyclic = cyclic;
+	return 0;
+}
+
+/**
+ * @brief stop the engine for good before the device is removed
+ *
+ * The process image stays valid until cyclic_exit(), since the sysfs
+ * attributes accessing it are removed with the device only.
+ */
+void cyclic_disable(struct acm *acm)
+{
+	struct cyclic *cyclic = acm->cyclic;
+
+	if (!cyclic)
+		return;
+
+	mutex_lock(&cyclic->lock);
+	cyclic->disabled = true;
+	cyclic_stop(cyclic);
+	mutex_unlock(&cyclic->lock);
+}
+
+/**
+ * @brief exit cyclic I/O engine, the device must be unregistered already
+ */
+void cyclic_exit(struct acm *acm)
+{
+	struct cyclic *cyclic = acm->cyclic;
+
+	if (!cyclic)
+		return;
+
+	cyclic_disable(acm);
+	vfree(cyclic->image);
+	acm->cyclic = NULL;
+}
+/**@} acmcyclic */
@@ -0,0 +1,52 @@
+/* SPDX-License-Identifier: GPL-2.0
+ *
+ * TTTech ACM Linux driver
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * Contact Information:
+ * support@tttech-industrial.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+/**
+ * @file cyclic.h
+ * @brief ACM Driver Cyclic I/O Engine
+ */
+
+#ifndef ACM_CYCLIC_H_
+#define ACM_CYCLIC_H_
+
+/**
+ * @addtogroup acmcyclic
+ * @{
+ */
+
+#include <linux/kernel.h>
+
+#include "api/acmdrv.h"
+
+struct acm;
+struct cyclic;
+struct vm_area_struct;
+
+void *cyclic_image(struct cyclic *cyclic);
+int __must_check cyclic_image_map(struct cyclic *cyclic,
+				  struct vm_area_struct *vma);
+int __must_check cyclic_get_jobs(struct cyclic *cyclic, unsigned int first,
+				 unsigned int last, void *jobs);
+int __must_check cyclic_set_jobs(struct cyclic *cyclic, unsigned int first,
+				 unsigned int last, const void *jobs);
+void cyclic_get_control(struct cyclic *cyclic,
+			struct acmdrv_cyclic_control *control);
+int __must_check
+cyclic_set_control(struct cyclic *cyclic,
+		   const struct acmdrv_cyclic_control *control);
+void cyclic_get_stats(struct cyclic *cyclic,
+		      struct acmdrv_cyclic_stats *stats);
+
+int __must_check cyclic_init(struct acm *acm);
+void cyclic_disable(struct acm *acm);
+void cyclic_exit(struct acm *acm);
+
+/**@} acmcyclic */
+
+#endif /* ACM_CYCLIC_H_ */
@@ -0,0 +1,956 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * TTTech ACM Linux driver
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * Contact Information:
+ * support@tttech-industrial.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+/**
+ * @file emu.c
+ * @brief ACM Driver IP Register Emulation
+ */
+
+/**
+ * @brief kernel pr_* format macro
+ */
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+/**
+ * @brief access the hardware directly, see acmio.h
+ */
+#define ACM_EMU_IMPL
+
+/**
+ * @defgroup hwaccemu ACM IP Register Emulation
+ * @brief Software model of the ACM IP registers
+ *
+ * If the driver is built with <tt>CONFIG_ACM_EMU=y</tt>, a platform device
+ * is registered on module load whose memory regions are backed by kernel
+ * memory instead of ACM IP. All register accesses of the driver are routed
+ * through the emulation (see acmio.h), accesses outside of the emulated
+ * regions are passed on to the hardware.
+ *
+ * The model implements the behavior the driver relies on:
+ *   - a Common Register Block identifying an ACM IP 1.1.0 (ttt,acm-4.0) with
+ *     32 message buffers and register based reset
+ *   - the row transfer handshake of the scheduler tables and the switch to a
+ *     table once its start time has been reached
+ *   - message buffer status with empty, fresh, locked and overwritten
+ *     semantics
+ *   - clear on read diagnostic counters of the bypass modules
+ *
+ * Traffic is emulated by a cycle timer: as long as a bypass module is
+ * enabled, each emulated cycle every valid, unlocked RX message buffer
+ * receives a frame and the fresh data of every TX message buffer is sent.
+ * The data of RX message buffers is left unchanged. The scheduler uses
+ * CLOCK_TAI as PTP time of the emulated device.
+ *
+ * @{
+ */
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/platform_device.h>
+#include <linux/vmalloc.h>
+#include <linux/hrtimer.h>
+#include <linux/spinlock.h>
+#include <linux/sizes.h>
+#include <linux/timekeeping.h>
+
+#include "acm-module.h"
+#include "acmio.h"
+#include "acmbitops.h"
+#include "emu.h"
+#include "commreg.h"
+#include "bypass.h"
+#include "scheduler.h"
+#include "msgbuf.h"
+
+/**@} hwaccemu */
+
+/**
+ * @addtogroup acmmodparam
+ * @{
+ */
+/**
+ * @brief register the emulated ACM on module load
+ */
+static bool emulate = true;
+
+/**
+ * @brief emulated network cycle in us
+ */
+static unsigned int emu_cycle_us = 1000;
+
+/**@} acmmodparam */
+
+/**
+ * @addtogroup hwaccemu
+ * @{
+ */
+
+/**
+ * @brief emulated memory regions
+ */
+enum emu_region_id {
+	EMU_COMMREG,
+	EMU_BYPASS0,
+	EMU_BYPASS1,
+	EMU_REDUNDANCY,
+	EMU_MSGBUF,
+	EMU_SCHEDULER,
+
+	EMU_REGION_COUNT
+};
+
+/**
+ * @brief names and sizes of the emulated memory regions
+ */
+static const struct {
+	const char *name;		/**< resource name used by the driver */
+	resource_size_t size;		/**< region size */
+} emu_regions[EMU_REGION_COUNT] = {
+	[EMU_COMMREG]		= { "CommonRegister",	SZ_4K },
+	[EMU_BYPASS0]		= { "Bypass0",		SZ_64K },
+	[EMU_BYPASS1]		= { "Bypass1",		SZ_64K },
+	[EMU_REDUNDANCY]	= { "Redundancy",	SZ_64K },
+	[EMU_MSGBUF]		= { "Messagebuffer",	SZ_256K },
+	[EMU_SCHEDULER]		= { "Scheduler",	SZ_128K },
+};
+
+/**
+ * @name Emulated ACM IP
+ * @brief Properties reported by the emulated ACM IP
+ */
+/**@{*/
+#define EMU_VERSION_ID		0x01010000	/* 1.1.0 */
+#define EMU_MSGBUF_COUNT	ACM_COMMREG_MSGBUF_COUNT_DEFAULT
+#define EMU_MSGBUF_ADDR_WIDTH	16
+#define EMU_TIME_FREQ_MHZ	100
+#define EMU_CYCLE_MIN_US	10
+/**@}*/
+
+/**
+ * @brief number of 16 bit data registers of a scheduler table row
+ */
+#define EMU_SCHED_ROW_WORDS	\
+	((ACM_SCHEDULER_COMMON_ROW_ACCESS_DATA4 -	\
+	  ACM_SCHEDULER_COMMON_ROW_ACCESS_DATA0) / sizeof(u16) + 1)
+
+/**
+ * @brief state of an emulated message buffer
+ */
+struct emu_msgbuf {
+	bool empty;		/**< no frame received since reset */
+	bool fresh;		/**< RX: not read yet, TX: not sent yet */
+	bool overwritten;	/**< fresh data replaced, cleared on read */
+};
+
+/**
+ * @brief state of an emulated scheduler table
+ */
+struct emu_sched_table {
+	u16 rows[ACMDRV_SCHED_TBL_ROW_COUNT][EMU_SCHED_ROW_WORDS]; /**< rows */
+	ktime_t start;		/**< time the table is taken */
+};
+
+/**
+ * @brief emulated ACM IP
+ */
+struct emu {
+	struct platform_device *pdev;	/**< emulated platform device */
+	struct resource root;		/**< parent of the emulated regions */
+	void *mem[EMU_REGION_COUNT];	/**< register memory */
+
+	spinlock_t lock;		/**< register and model lock */
+	struct hrtimer timer;		/**< emulated network cycle */
+
+	struct emu_msgbuf msgbuf[EMU_MSGBUF_COUNT];	/**< msgbuf state */
+	struct emu_sched_table table[ACMDRV_SCHEDULER_COUNT]
+				    [ACMDRV_SCHED_TBL_COUNT]; /**< tables */
+};
+
+/**
+ * @brief the emulated ACM IP instance
+ */
+static struct emu *emu;
+
+/**
+ * @brief 16 bit register of an emulated region
+ */
+static u16 *emu_reg16(int r, off_t off)
+{
+	return emu->mem[r] + off;
+}
+
+/**
+ * @brief 32 bit register of an emulated region
+ */
+static u32 *emu_reg32(int r, off_t off)
+{
+	return emu->mem[r] + off;
+}
+
+/**
+ * @brief find the emulated region of an address
+ *
+ * @return region id or -1 if the address is not emulated
+ */
+static int emu_region(const volatile void __iomem *addr, size_t size,
+		      off_t *off)
+{
+	int i;
+	const void *p = (const void __force *)addr;
+
+	if (!emu)
+		return -1;
+
+	for (i = 0; i < EMU_REGION_COUNT; ++i) {
+		if (p < emu->mem[i] || p >= emu->mem[i] + emu_regions[i].size)
+			continue;
+
+		*off = p - emu->mem[i];
+		if (*off + size > emu_regions[i].size) {
+			pr_err("%s: access beyond %s: 0x%08lx\n", __func__,
+			       emu_regions[i].name, *off);
+			return -1;
+		}
+		return i;
+	}
+
+	return -1;
+}
+
+/**
+ * @brief set the identification and generic registers
+ */
+static void emu_init_registers(void)
+{
+	int i;
+	u32 generic_0 = GENERIC_0_EXT_STATUS | GENERIC_0_CFG_READ_BACK |
+			GENERIC_0_INDIV_RECOV_EN | GENERIC_0_REDUND_RX_EN;
+	const off_t generics = ACM_SCHEDULER_GENERICS;
+
+	write_bitmask(EMU_MSGBUF_COUNT, &generic_0, GENERIC_0_MSG_BUFF_NO);
+	write_bitmask(EMU_TIME_FREQ_MHZ, &generic_0, GENERIC_0_TIME_FREQ);
+
+	*emu_reg32(EMU_COMMREG, ACM_COMMREG_VERSION_ID) = EMU_VERSION_ID;
+	*emu_reg32(EMU_COMMREG, ACM_COMMREG_GENERIC_0) = generic_0;
+	*emu_reg32(EMU_COMMREG, ACM_COMMREG_GENERIC_1) = EMU_MSGBUF_ADDR_WIDTH;
+
+	*emu_reg16(EMU_SCHEDULER, generics +
+		   ACM_SCHEDULER_GENERICS_SCHEDULERS) = ACMDRV_SCHEDULER_COUNT;
+	*emu_reg16(EMU_SCHEDULER, generics +
+		   ACM_SCHEDULER_GENERICS_TABLE_ROWS) =
+		ACMDRV_SCHED_TBL_ROW_COUNT;
+	*emu_reg16(EMU_SCHEDULER, generics +
+		   ACM_SCHEDULER_GENERICS_CLK_FREQ) = EMU_TIME_FREQ_MHZ;
+
+	for (i = 0; i < EMU_MSGBUF_COUNT; ++i)
+		emu->msgbuf[i] = (struct emu_msgbuf){ .empty = true };
+}
+
+/**
+ * @brief reset the entire emulated IP, lock held
+ */
+static void emu_reset(void)
+{
+	int i;
+
+	for (i = 0; i < EMU_REGION_COUNT; ++i)
+		memset(emu->mem[i], 0, emu_regions[i].size);
+	memset(emu->table, 0, sizeof(emu->table));
+
+	emu_init_registers();
+}
+
+/**
+ * @brief descriptor of an emulated message buffer
+ */
+static const struct acmdrv_buff_desc *emu_msgbuf_desc(int i)
+{
+	return emu->mem[EMU_MSGBUF] + ACM_MSGBUF_DESC(i);
+}
+
+/**
+ * @brief check lock control bit of an emulated message buffer
+ */
+static bool emu_msgbuf_locked(int i)
+{
+	const u32 *lock = emu_reg32(EMU_MSGBUF, ACM_MSGBUF_LOCK_CTL +
+				    i / 32 * sizeof(u32));
+
+	return *lock & BIT(i % 32);
+}
+
+/**
+ * @brief read status of an emulated message buffer, overwritten is cleared
+ */
+static u32 emu_msgbuf_status(int i)
+{
+	u32 status = 0;
+	struct emu_msgbuf *mb = &emu->msgbuf[i];
+
+	if (mb->overwritten)
+		status |= ACM_MSGBUF_STATUS_OVERWRITTEN;
+	if (emu_msgbuf_locked(i))
+		status |= ACM_MSGBUF_STATUS_D_LOCKED;
+	if (mb->fresh)
+		status |= ACM_MSGBUF_STATUS_FRESH;
+	if (mb->empty)
+		status |= ACM_MSGBUF_STATUS_EMPTY;
+
+	mb->overwritten = false;
+	return status;
+}
+
+/**
+ * @brief data of an emulated message buffer has been accessed
+ */
+static void emu_msgbuf_data_access(off_t off, bool write)
+{
+	int i;
+	struct emu_msgbuf *mb;
+	bool tx;
+
+	if (off < ACM_MSGBUF_DATA(0) ||
+	    off >= ACM_MSGBUF_DATA(EMU_MSGBUF_COUNT))
+		return;
+
+	i = (off - ACM_MSGBUF_DATA(0)) / ACM_MSGBUF_DATA_SIZE;
+	mb = &emu->msgbuf[i];
+	tx = acmdrv_buff_desc_type_read(emu_msgbuf_desc(i)) ==
+		ACMDRV_BUFF_DESC_BUFF_TYPE_TX;
+
+	if (tx && write) {
+		mb->overwritten |= mb->fresh;
+		mb->fresh = true;
+		mb->empty = false;
+	} else if (!tx && !write) {
+		mb->fresh = false;
+	}
+}
+
+/**
+ * @brief locate a register of a scheduler table
+ *
+ * @return true if @p off is located within a scheduler table
+ */
+static bool emu_sched_table_reg(off_t off, int *sidx, int *tidx, off_t *reg)
+{
+	off_t rel;
+	const off_t sched_size = ACM_SCHEDULER_SCHED(1) -
+				 ACM_SCHEDULER_SCHED(0);
+	const off_t tab_size = ACM_SCHEDULER_SCHED_TAB(1) -
+			       ACM_SCHEDULER_SCHED_TAB(0);
+
+	if (off < ACM_SCHEDULER_SCHED(0) ||
+	    off >= ACM_SCHEDULER_SCHED(ACMDRV_SCHEDULER_COUNT))
+		return false;
+
+	*sidx = (off - ACM_SCHEDULER_SCHED(0)) / sched_size;
+	rel = off - ACM_SCHEDULER_SCHED(*sidx);
+	if (rel < ACM_SCHEDULER_SCHED_TAB(0) ||
+	    rel >= ACM_SCHEDULER_SCHED_TAB(ACMDRV_SCHED_TBL_COUNT))
+		return false;
+
+	*tidx = (rel - ACM_SCHEDULER_SCHED_TAB(0)) / tab_size;
+	*reg = rel - ACM_SCHEDULER_SCHED_TAB(*tidx);
+	return true;
+}
+
+/**
+ * @brief 16 bit register of a scheduler table
+ */
+static u16 *emu_sched_table_reg16(int sidx, int tidx, off_t reg)
+{
+	return emu_reg16(EMU_SCHEDULER, ACM_SCHEDULER_SCHED(sidx) +
+			 ACM_SCHEDULER_SCHED_TAB(tidx) + reg);
+}
+
+/**
+ * @brief execute a scheduler table row transfer
+ */
+static void emu_sched_row_transfer(u16 cmd0)
+{
+	u16 *data, *row;
+	const u16 cmd1 = *emu_reg16(EMU_SCHEDULER, ACM_SCHEDULER_COMMON +
+				    ACM_SCHEDULER_COMMON_ROW_ACCESS_CMD1);
+	const int sidx = read_bitmask16(&cmd0, CMD0_SCHEDULER);
+	const int tidx = read_bitmask16(&cmd0, CMD0_TABLE);
+	const int ridx = read_bitmask16(&cmd1, CMD1_ROW_NUMBER);
+
+	write_bitmask16(0, &cmd0, CMD0_TRANSFER);
+	write_bitmask16(0, &cmd0, CMD0_ACCESS_ERROR);
+
+	if (sidx >= ACMDRV_SCHEDULER_COUNT ||
+	    ridx >= ACMDRV_SCHED_TBL_ROW_COUNT) {
+		write_bitmask16(1, &cmd0, CMD0_ACCESS_ERROR);
+		goto out;
+	}
+
+	data = emu_reg16(EMU_SCHEDULER, ACM_SCHEDULER_COMMON +
+			 ACM_SCHEDULER_COMMON_ROW_ACCESS_DATA0);
+	row = emu->table[sidx][tidx].rows[ridx];
+	if (read_bitmask16(&cmd0, CMD0_WRITE))
+		memcpy(row, data, sizeof(emu->table[sidx][tidx].rows[ridx]));
+	else
+		memcpy(data, row, sizeof(emu->table[sidx][tidx].rows[ridx]));
+
+out:
+	*emu_reg16(EMU_SCHEDULER, ACM_SCHEDULER_COMMON +
+		   ACM_SCHEDULER_COMMON_ROW_ACCESS_CMD0) = cmd0;
+}
+
+/**
+ * @brief a scheduler table has been started, latch its start time
+ *
+ * Only the lower 8 bits of the seconds are written, the start time is
+ * expected within 128 s around the current time.
+ */
+static void emu_sched_table_start(int sidx, int tidx)
+{
+	struct timespec64 now = ktime_to_timespec64(ktime_get_clocktai());
+	time64_t sec;
+	u32 nsec;
+
+	sec = *emu_sched_table_reg16(sidx, tidx,
+				     ACM_SCHEDULER_SCHED_TAB_STARTTIME_SEC) &
+		GENMASK(7, 0);
+	nsec = *emu_sched_table_reg16(sidx, tidx,
+				      ACM_SCHEDULER_SCHED_TAB_STARTTIME_NS_LOW);
+	nsec |= (*emu_sched_table_reg16(sidx, tidx,
+				ACM_SCHEDULER_SCHED_TAB_STARTTIME_NS_HIGH) &
+		 GENMASK(13, 0)) << 16;
+
+	sec |= now.tv_sec & ~(time64_t)GENMASK(7, 0);
+	if (sec + 128 < now.tv_sec)
+		sec += 256;
+	else if (sec > now.tv_sec + 128)
+		sec -= 256;
+
+	emu->table[sidx][tidx].start = ktime_set(sec, nsec);
+}
+
+/**
+ * @brief update the status of a scheduler table before it is read
+ */
+static void emu_sched_table_update(int sidx, int tidx)
+{
+	const ktime_t now = ktime_get_clocktai();
+	struct emu_sched_table *table = &emu->table[sidx][tidx];
+	u16 *tbl_gen = emu_sched_table_reg16(sidx, tidx,
+					     ACM_SCHEDULER_SCHED_TAB_TBL_GEN);
+	u64 cycle, last;
+
+	if ((*tbl_gen & TBL_GEN_CAN_BE_TAKEN) &&
+	    ktime_compare(now, table->start) >= 0) {
+		/* take the table, the other one gets inactive */
+		*emu_sched_table_reg16(sidx, 1 - tidx,
+				       ACM_SCHEDULER_SCHED_TAB_TBL_GEN) &=
+			~TBL_GEN_IN_USE;
+		*tbl_gen &= ~(TBL_GEN_CAN_BE_TAKEN | TBL_GEN_LAST_CYC_REACHED);
+		*tbl_gen |= TBL_GEN_IN_USE;
+	}
+
+	if (!(*tbl_gen & TBL_GEN_IN_USE) ||
+	    !(*tbl_gen & TBL_GEN_LAST_CYC_NR_EN))
+		return;
+
+	cycle = *emu_sched_table_reg16(sidx, tidx,
+				ACM_SCHEDULER_SCHED_TAB_CYCLETIME_NS_LOW);
+	cycle |= (u64)(*emu_sched_table_reg16(sidx, tidx,
+				ACM_SCHEDULER_SCHED_TAB_CYCLETIME_NS_HIGH) &
+		       GENMASK(13, 0)) << 16;
+	last = *emu_sched_table_reg16(sidx, tidx,
+				      ACM_SCHEDULER_SCHED_TAB_LAST_CYCLE);
+
+	if (ktime_compare(now, ktime_add_ns(table->start, cycle * last)) >= 0)
+		*tbl_gen |= TBL_GEN_LAST_CYC_REACHED;
+}
+
+/**
+ * @brief check if a bypass status register is cleared on read
+ */
+static bool emu_bypass_clear_on_read(off_t off)
+{
+	switch (off - ACM_BYPASS_STATUS_AREA) {
+	case ACM_BYPASS_STATUS_AREA_RX_FRAMES_COUNTER:
+	case ACM_BYPASS_STATUS_AREA_TX_FRAMES_COUNTER:
+	case ACM_BYPASS_STATUS_AREA_SCHEDULE_CYCLE_COUNTER:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief check if a bypass module is enabled
+ */
+static bool emu_bypass_enabled(int r)
+{
+	return acmdrv_bypass_ctrl_enable_read(*emu_reg32(r,
+		ACM_BYPASS_CONTROL_AREA + ACM_BYPASS_CONTROL_AREA_NGN_ENABLE));
+}
+
+/**
+ * @brief add to a saturating diagnostic counter of a bypass module
+ */
+static void emu_bypass_count(int r, off_t reg, u32 mask, u32 count)
+{
+	u32 *counter = emu_reg32(r, ACM_BYPASS_STATUS_AREA + reg);
+
+	*counter = min(*counter + count, mask);
+}
+
+/**
+ * @brief update the diagnostics of an enabled bypass module for a cycle
+ */
+static void emu_bypass_cycle(int r, const struct timespec64 *now,
+			     u32 rx_frames, u32 tx_frames)
+{
+	if (!emu_bypass_enabled(r))
+		return;
+
+	emu_bypass_count(r, ACM_BYPASS_STATUS_AREA_SCHEDULE_CYCLE_COUNTER,
+			 SCHEDULE_CYCLE_COUNTER, 1);
+	emu_bypass_count(r, ACM_BYPASS_STATUS_AREA_RX_FRAMES_COUNTER,
+			 RX_FRAMES_COUNTER, rx_frames);
+	emu_bypass_count(r, ACM_BYPASS_STATUS_AREA_TX_FRAMES_COUNTER,
+			 TX_FRAMES_COUNTER, tx_frames);
+
+	*emu_reg32(r, ACM_BYPASS_STATUS_AREA +
+		   ACM_BYPASS_STATUS_AREA_UPDATE_TIMESTAMP_NS) =
+		now->tv_nsec & UPDATE_TIMESTAMP_NS;
+	*emu_reg32(r, ACM_BYPASS_STATUS_AREA +
+		   ACM_BYPASS_STATUS_AREA_UPDATE_TIMESTAMP_S) =
+		now->tv_sec & UPDATE_TIMESTAMP_S;
+}
+
+/**
+ * @brief read an emulated 32 bit register, lock held
+ */
+static u32 emu_read32(int r, off_t off)
+{
+	u32 *reg = emu_reg32(r, off);
+	u32 value = *reg;
+
+	switch (r) {
+	case EMU_BYPASS0:
+	case EMU_BYPASS1:
+		if (emu_bypass_clear_on_read(off))
+			*reg = 0;
+		break;
+	case EMU_MSGBUF:
+		if (off >= ACM_MSGBUF_STATUS(0) &&
+		    off < ACM_MSGBUF_STATUS(EMU_MSGBUF_COUNT))
+			value = emu_msgbuf_status((off - ACM_MSGBUF_STATUS(0)) /
+						  sizeof(u32));
+		break;
+	}
+
+	return value;
+}
+
+/**
+ * @brief write an emulated 32 bit register, lock held
+ */
+static void emu_write32(int r, off_t off, u32 value)
+{
+	int i;
+
+	*emu_reg32(r, off) = value;
+
+	switch (r) {
+	case EMU_COMMREG:
+		if (off == ACM_COMMREG_RST_REQ && (value & RST_REQ_SW_RST_REQ))
+			emu_reset();
+		break;
+	case EMU_MSGBUF:
+		if (off >= ACM_MSGBUF_DESC(EMU_MSGBUF_COUNT))
+			break;
+
+		i = off / sizeof(msgbuf_desc_t);
+		if (acmdrv_buff_desc_reset_read(emu_msgbuf_desc(i)))
+			emu->msgbuf[i] = (struct emu_msgbuf){ .empty = true };
+		break;
+	}
+}
+
+/**
+ * @brief read an emulated 16 bit register, lock held
+ */
+static u16 emu_read16(int r, off_t off)
+{
+	int sidx, tidx;
+	off_t reg;
+
+	if (r == EMU_SCHEDULER &&
+	    emu_sched_table_reg(off, &sidx, &tidx, &reg) &&
+	    reg == ACM_SCHEDULER_SCHED_TAB_TBL_GEN)
+		emu_sched_table_update(sidx, tidx);
+
+	return *emu_reg16(r, off);
+}
+
+/**
+ * @brief write an emulated 16 bit register, lock held
+ */
+static void emu_write16(int r, off_t off, u16 value)
+{
+	int sidx, tidx;
+	off_t reg;
+
+	*emu_reg16(r, off) = value;
+
+	if (r != EMU_SCHEDULER)
+		return;
+
+	if (off == ACM_SCHEDULER_COMMON +
+		   ACM_SCHEDULER_COMMON_ROW_ACCESS_CMD0) {
+		if (value & CMD0_TRANSFER)
+			emu_sched_row_transfer(value);
+		return;
+	}
+
+	if (emu_sched_table_reg(off, &sidx, &tidx, &reg) &&
+	    reg == ACM_SCHEDULER_SCHED_TAB_TBL_GEN &&
+	    (value & TBL_GEN_CAN_BE_TAKEN))
+		emu_sched_table_start(sidx, tidx);
+}
+
+/**
+ * @brief emulated readw()
+ */
+u16 emu_readw(const volatile void __iomem *addr)
+{
+	int r;
+	u16 value;
+	off_t off;
+	unsigned long flags;
+
+	r = emu_region(addr, sizeof(u16), &off);
+	if (r < 0)
+		return readw(addr);
+
+	spin_lock_irqsave(&emu->lock, flags);
+	value = emu_read16(r, off);
+	spin_unlock_irqrestore(&emu->lock, flags);
+
+	return value;
+}
+
+/**
+ * @brief emulated readl()
+ */
+u32 emu_readl(const volatile void __iomem *addr)
+{
+	int r;
+	u32 value;
+	off_t off;
+	unsigned long flags;
+
+	r = emu_region(addr, sizeof(u32), &off);
+	if (r < 0)
+		return readl(addr);
+
+	spin_lock_irqsave(&emu->lock, flags);
+	value = emu_read32(r, off);
+	spin_unlock_irqrestore(&emu->lock, flags);
+
+	return value;
+}
+
+/**
+ * @brief emulated writew()
+ */
+void emu_writew(u16 value, volatile void __iomem *addr)
+{
+	int r;
+	off_t off;
+	unsigned long flags;
+
+	r = emu_region(addr, sizeof(u16), &off);
+	if (r < 0) {
+		writew(value, addr);
+		return;
+	}
+
+	spin_lock_irqsave(&emu->lock, flags);
+	emu_write16(r, off, value);
+	spin_unlock_irqrestore(&emu->lock, flags);
+}
+
+/**
+ * @brief emulated writel()
+ */
+void emu_writel(u32 value, volatile void __iomem *addr)
+{
+	int r;
+	off_t off;
+	unsigned long flags;
+
+	r = emu_region(addr, sizeof(u32), &off);
+	if (r < 0) {
+		writel(value, addr);
+		return;
+	}
+
+	spin_lock_irqsave(&emu->lock, flags);
+	emu_write32(r, off, value);
+	spin_unlock_irqrestore(&emu->lock, flags);
+}
+
+/**
+ * @brief emulated __ioread32_copy(), @p count in 32 bit words
+ */
+void emu_ioread32_copy(void *to, const void __iomem *from, size_t count)
+{
+	int r;
+	size_t i;
+	off_t off;
+	unsigned long flags;
+	u32 *dst = to;
+
+	r = emu_region(from, count * sizeof(u32), &off);
+	if (r < 0) {
+		__ioread32_copy(to, from, count);
+		return;
+	}
+
+	spin_lock_irqsave(&emu->lock, flags);
+	for (i = 0; i < count; ++i)
+		dst[i] = emu_read32(r, off + i * sizeof(u32));
+	if (r == EMU_MSGBUF)
+		emu_msgbuf_data_access(off, false);
+	spin_unlock_irqrestore(&emu->lock, flags);
+}
+
+/**
+ * @brief emulated __iowrite32_copy(), @p count in 32 bit words
+ */
+void emu_iowrite32_copy(void __iomem *to, const void *from, size_t count)
+{
+	int r;
+	size_t i;
+	off_t off;
+	unsigned long flags;
+	const u32 *src = from;
+
+	r = emu_region(to, count * sizeof(u32), &off);
+	if (r < 0) {
+		__iowrite32_copy(to, from, count);
+		return;
+	}
+
+	spin_lock_irqsave(&emu->lock, flags);
+	for (i = 0; i < count; ++i)
+		emu_write32(r, off + i * sizeof(u32), src[i]);
+	if (r == EMU_MSGBUF)
+		emu_msgbuf_data_access(off, true);
+	spin_unlock_irqrestore(&emu->lock, flags);
+}
+
+/**
+ * @brief emulated network cycle
+ */
+static enum hrtimer_restart emu_cycle(struct hrtimer *timer)
+{
+	int i;
+	u32 rx_frames = 0, tx_frames = 0;
+	unsigned long flags;
+	struct timespec64 now = ktime_to_timespec64(ktime_get_clocktai());
+
+	spin_lock_irqsave(&emu->lock, flags);
+
+	if (!emu_bypass_enabled(EMU_BYPASS0) &&
+	    !emu_bypass_enabled(EMU_BYPASS1))
+		goto unlock;
+
+	for (i = 0; i < EMU_MSGBUF_COUNT; ++i) {
+		struct emu_msgbuf *mb = &emu->msgbuf[i];
+		const struct acmdrv_buff_desc *desc = emu_msgbuf_desc(i);
+
+		/* locked buffers are neither sent nor updated */
+		if (!acmdrv_buff_desc_valid_read(desc) || emu_msgbuf_locked(i))
+			continue;
+
+		if (acmdrv_buff_desc_type_read(desc) ==
+		    ACMDRV_BUFF_DESC_BUFF_TYPE_TX) {
+			if (mb->fresh)
+				++tx_frames;
+			mb->fresh = false;
+		} else {
+			mb->overwritten |= mb->fresh;
+			mb->fresh = true;
+			mb->empty = false;
+			++rx_frames;
+		}
+	}
+
+	emu_bypass_cycle(EMU_BYPASS0, &now, rx_frames, tx_frames);
+	emu_bypass_cycle(EMU_BYPASS1, &now, rx_frames, tx_frames);
+
+unlock:
+	spin_unlock_irqrestore(&emu->lock, flags);
+
+	hrtimer_forward_now(timer, us_to_ktime(emu_cycle_us));
+	return HRTIMER_RESTART;
+}
+
+/**
+ * @brief check if a device is the emulated ACM
+ */
+bool emu_is_emulated(const struct device *dev)
+{
+	return emu && dev == &emu->pdev->dev;
+}
+
+/**
+ * @brief map a memory region of the emulated ACM
+ */
+void __iomem *emu_ioremap_resource(struct device *dev, struct resource *res)
+{
+	int i;
+
+	if (!res)
+		return IOMEM_ERR_PTR(-EINVAL);
+
+	for (i = 0; i < EMU_REGION_COUNT; ++i)
+		if (strcmp(res->name, emu_regions[i].name) == 0)
+			return (void __iomem __force *)emu->mem[i];
+
+	dev_err(dev, "%s: unknown region %s\n", __func__, res->name);
+	return IOMEM_ERR_PTR(-ENODEV);
+}
+
+/**
+ * @brief free the emulated ACM
+ */
+static void emu_free(void)
+{
+	int i;
+
+	for (i = 0; i < EMU_REGION_COUNT; ++i)
+		vfree(emu->mem[i]);
+	vfree(emu);
+	emu = NULL;
+}
+
+/**
+ * @brief register the emulated ACM
+ */
+int __must_check emu_init(void)
+{
+	int i, ret;
+	resource_size_t start = 0;
+	struct resource res[EMU_REGION_COUNT] = {};
+	struct platform_device *pdev;
+
+	if (!emulate)
+		return 0;
+
+	emu = vzalloc(sizeof(*emu));
+	if (!emu)
+		return -ENOMEM;
+
+	/* the regions are not part of iomem_resource */
+	for (i = 0; i < EMU_REGION_COUNT; ++i) {
+		emu->mem[i] = vzalloc(emu_regions[i].size);
+		if (!emu->mem[i]) {
+			ret = -ENOMEM;
+			goto out_free;
+		}
+
+		res[i].name = emu_regions[i].name;
+		res[i].start = start;
+		res[i].end = start + emu_regions[i].size - 1;
+		res[i].flags = IORESOURCE_MEM;
+		res[i].parent = &emu->root;
+		start += emu_regions[i].size;
+	}
+
+	emu->root.name = "acm-emu";
+	emu->root.start = 0;
+	emu->root.end = start - 1;
+	emu->root.flags = IORESOURCE_MEM;
+
+	spin_lock_init(&emu->lock);
+	emu_init_registers();
+
+	pdev = platform_device_alloc(ACMDRV_NAME, PLATFORM_DEVID_NONE);
+	if (!pdev) {
+		ret = -ENOMEM;
+		goto out_free;
+	}
+
+	ret = platform_device_add_resources(pdev, res, EMU_REGION_COUNT);
+	if (ret)
+		goto out_put;
+
+	emu_cycle_us = max_t(unsigned int, emu_cycle_us, EMU_CYCLE_MIN_US);
+	hrtimer_init(&emu->timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	emu->timer.function = emu_cycle;
+	hrtimer_start(&emu->timer, us_to_ktime(emu_cycle_us),
+		      HRTIMER_MODE_REL);
+
+	/* the driver probes the device right away */
+	emu->pdev = pdev;
+	ret = platform_device_add(pdev);
+	if (ret)
+		goto out_cancel;
+
+	pr_info("Emulated ACM IP registered, cycle %u us\n", emu_cycle_us);
+	return 0;
+
+out_cancel:
+	hrtimer_cancel(&emu->timer);
+	emu->pdev = NULL;
+out_put:
+	platform_device_put(pdev);
+out_free:
+	emu_free();
+	return ret;
+}
+
+/**
+ * @brief unregister the emulated ACM
+ */
+void emu_exit(void)
+{
+	if (!emu)
+		return;
+
+	platform_device_unregister(emu->pdev);
+	hrtimer_cancel(&emu->timer);
+	emu_free();
+}
+
+/**@} hwaccemu */
+
+/**
+ * @addtogroup acmmodparam
+ * @{
+ */
+/**
+ * @brief Linux module parameter definition to register the emulated ACM
+ */
+module_param(emulate, bool, 0444);
+
+/**
+ * @brief Linux module parameter description
+ */
+MODULE_PARM_DESC(emulate, "Register an emulated ACM IP");
+
+/**
+ * @brief Linux module parameter definition for the emulated network cycle
+ */
+module_param(emu_cycle_us, uint, 0444);
+
+/**
+ * @brief Linux module parameter description
+ */
+MODULE_PARM_DESC(emu_cycle_us, "Emulated network cycle in us");
+
+/**@} acmmodparam */
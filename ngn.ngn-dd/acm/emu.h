@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: GPL-2.0
+ *
+ * TTTech ACM Linux driver
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * Contact Information:
+ * support@tttech-industrial.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+/**
+ * @file emu.h
+ * @brief ACM Driver IP Register Emulation
+ */
+
+#ifndef ACM_EMU_H_
+#define ACM_EMU_H_
+
+/**
+ * @addtogroup hwaccemu
+ * @{
+ */
+
+#include <linux/kernel.h>
+#include <linux/device.h>
+#include <linux/ioport.h>
+#include <linux/io.h>
+
+#ifdef CONFIG_ACM_EMU
+
+int __must_check emu_init(void);
+void emu_exit(void);
+
+bool emu_is_emulated(const struct device *dev);
+void __iomem *emu_ioremap_resource(struct device *dev, struct resource *res);
+
+u16 emu_readw(const volatile void __iomem *addr);
+u32 emu_readl(const volatile void __iomem *addr);
+void emu_writew(u16 value, volatile void __iomem *addr);
+void emu_writel(u32 value, volatile void __iomem *addr);
+void emu_ioread32_copy(void *to, const void __iomem *from, size_t count);
+void emu_iowrite32_copy(void __iomem *to, const void *from, size_t count);
+
+#else /* CONFIG_ACM_EMU */
+
+static inline int __must_check emu_init(void)
+{
+	return 0;
+}
+
+static inline void emu_exit(void)
+{
+}
+
+static inline bool emu_is_emulated(const struct device *dev)
+{
+	return false;
+}
+
+static inline void __iomem *emu_ioremap_resource(struct device *dev,
+						 struct resource *res)
+{
+	return IOMEM_ERR_PTR(-ENODEV);
+}
+
+#endif /* CONFIG_ACM_EMU */
+
+/**@} hwaccemu */
+
+#endif /* ACM_EMU_H_ */
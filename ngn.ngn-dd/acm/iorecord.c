@@ -0,0 +1,565 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * TTTech ACM Linux driver
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * Contact Information:
+ * support@tttech-industrial.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+/**
+ * @file iorecord.c
+ * @brief ACM Driver Register Access Recorder
+ */
+
+/**
+ * @brief kernel pr_* format macro
+ */
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+/**
+ * @defgroup acmiorecord ACM Register Access Recorder
+ * @brief Recording of the register accesses of configuration transactions
+ *
+ * The recorder captures the register writes of the bypass and redundancy
+ * modules, the block transfers of acm_iowrite32_copy()/acm_ioread32_copy()
+ * and the scheduler table row accesses into a ring buffer. Each record holds
+ * a sequence number, the timestamp and duration of the access, the accessed
+ * area (i.e. the name of the ACM IP memory region) with offset, the access
+ * width and the value. For block transfers each 32 bit word is recorded,
+ * the duration of the whole transfer is assigned to its first word.
+ *
+ * The recorder is controlled via debugfs below
+ * <b><tt>/sys/kernel/debug/acm/iorecord</tt></b>:
+ *   - <b><tt>enable</tt></b>: write 1/0 to start/stop recording
+ *   - <b><tt>records</tt></b>: read the records in text form, oldest first,
+ *     write anything to clear them
+ *
+ * The ring buffer holds the last @ref iorecord_entries accesses, recording
+ * starts on module load if @ref iorecord is set. While recording is stopped
+ * the access paths only cost a static branch.
+ *
+ * The records are evaluated by the <tt>acm-iorec</tt> tool.
+ *
+ * @{
+ */
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/spinlock.h>
+#include <linux/mutex.h>
+#include <linux/vmalloc.h>
+
+#include "acm-module.h"
+#include "iorecord.h"
+
+/**@} acmiorecord */
+
+/**
+ * @addtogroup acmmodparam
+ * @{
+ */
+/**
+ * @brief record register accesses from module load on
+ */
+static bool iorecord;
+
+/**
+ * @brief number of records held by the ring buffer
+ */
+static unsigned int iorecord_entries = 65536;
+
+/**@} acmmodparam */
+
+/**
+ * @addtogroup acmiorecord
+ * @{
+ */
+
+/**
+ * @brief maximum number of distinguished areas
+ */
+#define IORECORD_AREA_COUNT	8
+
+/**
+ * @brief maximum length of an area name
+ */
+#define IORECORD_AREA_NAME_LEN	24
+
+/**
+ * @brief a recorded register access
+ */
+struct iorecord_entry {
+	u64 seq;		/**< sequence number */
+	u64 timestamp;		/**< CLOCK_MONOTONIC at start of access in ns */
+	u32 duration;		/**< duration of access in ns */
+	u32 offset;		/**< offset within area */
+	u32 value;		/**< value read or written */
+	u8 area;		/**< area index, IORECORD_AREA_COUNT: unknown */
+	u8 op;			/**< enum iorecord_op */
+	u8 width;		/**< access width in bytes */
+};
+
+/**
+ * @brief ACM IP memory region known to the recorder
+ */
+struct iorecord_area {
+	char name[IORECORD_AREA_NAME_LEN];	/**< resource name */
+	const volatile void __iomem *base;	/**< mapped base address */
+	resource_size_t size;		/**< region size */
+};
+
+/**
+ * @brief recorder state
+ */
+static struct {
+	spinlock_t lock;		/**< protects ring and areas */
+	struct mutex enable_lock;	/**< serializes enable/disable */
+	struct iorecord_entry *ring;	/**< ring buffer */
+	unsigned int size;		/**< number of ring entries */
+	u64 seq;			/**< sequence number of next record */
+	struct iorecord_area area[IORECORD_AREA_COUNT]; /**< known areas */
+	struct dentry *debugfs;		/**< debugfs directory */
+} rec = {
+	.lock = __SPIN_LOCK_UNLOCKED(rec.lock),
+	.enable_lock = __MUTEX_INITIALIZER(rec.enable_lock),
+};
+
+/**
+ * @brief recording active, checked by the access paths
+ */
+DEFINE_STATIC_KEY_FALSE(iorecord_active);
+
+/**
+ * @brief find area of an address, lock held
+ */
+static u8 iorecord_find_area(const volatile void __iomem *addr, u32 *offset)
+{
+	u8 i;
+
+	for (i = 0; i < IORECORD_AREA_COUNT; ++i) {
+		const struct iorecord_area *area = &rec.area[i];
+
+		if (!area->name[0] || addr < area->base ||
+		    addr >= area->base + area->size)
+			continue;
+
+		*offset = addr - area->base;
+		return i;
+	}
+
+	*offset = (u32)(uintptr_t)addr;
+	return IORECORD_AREA_COUNT;
+}
+
+/**
+ * @brief ring buffer entry of a sequence number, lock held
+ */
+static struct iorecord_entry *iorecord_slot(u64 seq)
+{
+	u32 idx;
+
+	div_u64_rem(seq, rec.size, &idx);
+	return &rec.ring[idx];
+}
+
+/**
+ * @brief append a record to the ring buffer, lock held
+ */
+static void iorecord_append(u8 area, u32 offset, enum iorecord_op op,
+			    unsigned int width, u32 value, u64 start,
+			    u32 duration)
+{
+	struct iorecord_entry *entry;
+
+	entry = iorecord_slot(rec.seq);
+	entry->seq = rec.seq++;
+	entry->timestamp = start;
+	entry->duration = duration;
+	entry->offset = offset;
+	entry->value = value;
+	entry->area = area;
+	entry->op = op;
+	entry->width = width;
+}
+
+/**
+ * @brief record a single register access, see iorecord_add()
+ */
+void __iorecord_add(const volatile void __iomem *addr, enum iorecord_op op,
+		    unsigned int width, u32 value, u64 start)
+{
+	u8 area;
+	u32 offset;
+	unsigned long flags;
+	u32 duration = ktime_get_ns() - start;
+
+	spin_lock_irqsave(&rec.lock, flags);
+	if (rec.ring) {
+		area = iorecord_find_area(addr, &offset);
+		iorecord_append(area, offset, op, width, value, start,
+				duration);
+	}
+	spin_unlock_irqrestore(&rec.lock, flags);
+}
+
+/**
+ * @brief record a block of register accesses, see iorecord_add_block()
+ */
+void __iorecord_add_block(const volatile void __iomem *addr,
+			  enum iorecord_op op, const u32 *values, size_t count,
+			  u64 start)
+{
+	u8 area;
+	u32 offset;
+	size_t i;
+	unsigned long flags;
+	u32 duration = ktime_get_ns() - start;
+
+	spin_lock_irqsave(&rec.lock, flags);
+	if (rec.ring) {
+		area = iorecord_find_area(addr, &offset);
+		for (i = 0; i < count; ++i)
+			iorecord_append(area, offset + i * sizeof(u32), op,
+					sizeof(u32), values[i], start,
+					i == 0 ? duration : 0);
+	}
+	spin_unlock_irqrestore(&rec.lock, flags);
+}
+
+/**
+ * @brief make a mapped ACM IP memory region known to the recorder
+ *
+ * Regions are identified by name, so a region mapped again on a subsequent
+ * probe replaces the former mapping.
+ */
+void iorecord_register_area(const char *name,
+			    const volatile void __iomem *base,
+			    resource_size_t size)
+{
+	int i, free = -1;
+	unsigned long flags;
+
+	if (!name)
+		return;
+
+	spin_lock_irqsave(&rec.lock, flags);
+	for (i = 0; i < IORECORD_AREA_COUNT; ++i) {
+		if (!rec.area[i].name[0]) {
+			if (free < 0)
+				free = i;
+			continue;
+		}
+		if (strncmp(rec.area[i].name, name,
+			    IORECORD_AREA_NAME_LEN - 1) == 0)
+			break;
+	}
+	if (i == IORECORD_AREA_COUNT)
+		i = free;
+	if (i >= 0) {
+		strscpy(rec.area[i].name, name, IORECORD_AREA_NAME_LEN);
+		rec.area[i].base = base;
+		rec.area[i].size = size;
+	}
+	spin_unlock_irqrestore(&rec.lock, flags);
+
+	if (i < 0)
+		pr_warn("%s: no space for area %s\n", __func__, name);
+}
+
+/**
+ * @brief start recording, allocating the ring buffer if needed
+ */
+static int iorecord_enable(void)
+{
+	struct iorecord_entry *ring = NULL;
+	unsigned long flags;
+
+	mutex_lock(&rec.enable_lock);
+	if (!rec.ring) {
+		ring = vmalloc(array_size(iorecord_entries, sizeof(*ring)));
+		if (!ring) {
+			mutex_unlock(&rec.enable_lock);
+			return -ENOMEM;
+		}
+
+		spin_lock_irqsave(&rec.lock, flags);
+		rec.ring = ring;
+		rec.size = iorecord_entries;
+		rec.seq = 0;
+		spin_unlock_irqrestore(&rec.lock, flags);
+	}
+	static_branch_enable(&iorecord_active);
+	mutex_unlock(&rec.enable_lock);
+
+	return 0;
+}
+
+/**
+ * @brief stop recording, the records are kept
+ */
+static void iorecord_disable(void)
+{
+	mutex_lock(&rec.enable_lock);
+	static_branch_disable(&iorecord_active);
+	mutex_unlock(&rec.enable_lock);
+}
+
+/**
+ * @brief drop all records
+ */
+static void iorecord_clear(void)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&rec.lock, flags);
+	rec.seq = 0;
+	spin_unlock_irqrestore(&rec.lock, flags);
+}
+
+/**
+ * @brief debugfs getter of recording state
+ */
+static int iorecord_enable_get(void *data, u64 *val)
+{
+	*val = static_key_enabled(&iorecord_active);
+	return 0;
+}
+
+/**
+ * @brief debugfs setter of recording state
+ */
+static int iorecord_enable_set(void *data, u64 val)
+{
+	if (val)
+		return iorecord_enable();
+
+	iorecord_disable();
+	return 0;
+}
+
+DEFINE_DEBUGFS_ATTRIBUTE(iorecord_enable_fops, iorecord_enable_get,
+			 iorecord_enable_set, "%llu\n");
+
+/**
+ * @brief snapshot of the records taken when opening the records file
+ */
+struct iorecord_snapshot {
+	u64 dropped;			/**< records lost due to wrap around */
+	size_t count;			/**< number of records */
+	char area[IORECORD_AREA_COUNT][IORECORD_AREA_NAME_LEN]; /**< names */
+	struct iorecord_entry entry[];	/**< records, oldest first */
+};
+
+/**
+ * @brief seq_file start operation
+ */
+static void *iorecord_seq_start(struct seq_file *m, loff_t *pos)
+{
+	struct iorecord_snapshot *snap = m->private;
+
+	if (*pos == 0)
+		return SEQ_START_TOKEN;
+	if (*pos > snap->count)
+		return NULL;
+
+	return &snap->entry[*pos - 1];
+}
+
+/**
+ * @brief seq_file next operation
+ */
+static void *iorecord_seq_next(struct seq_file *m, void *v, loff_t *pos)
+{
+	++*pos;
+	return iorecord_seq_start(m, pos);
+}
+
+/**
+ * @brief seq_file stop operation
+ */
+static void iorecord_seq_stop(struct seq_file *m, void *v)
+{
+}
+
+/**
+ * @brief seq_file show operation
+ */
+static int iorecord_seq_show(struct seq_file *m, void *v)
+{
+	const struct iorecord_snapshot *snap = m->private;
+	const struct iorecord_entry *entry = v;
+	const char *area = "-";
+
+	if (v == SEQ_START_TOKEN) {
+		seq_printf(m, "# dropped %llu\n", snap->dropped);
+		seq_puts(m, "# seq timestamp_ns duration_ns area access offset value\n");
+		return 0;
+	}
+
+	if (entry->area < IORECORD_AREA_COUNT && snap->area[entry->area][0])
+		area = snap->area[entry->area];
+
+	seq_printf(m, "%llu %llu %u %s %c%u 0x%08x 0x%08x\n", entry->seq,
+		   entry->timestamp, entry->duration, area,
+		   entry->op == IORECORD_WRITE ? 'w' : 'r',
+		   entry->width * BITS_PER_BYTE, entry->offset, entry->value);
+	return 0;
+}
+
+/**
+ * @brief seq_file operations of the records file
+ */
+static const struct seq_operations iorecord_seq_ops = {
+	.start	= iorecord_seq_start,
+	.next	= iorecord_seq_next,
+	.stop	= iorecord_seq_stop,
+	.show	= iorecord_seq_show,
+};
+
+/**
+ * @brief open records file, taking a snapshot of the ring buffer
+ */
+static int iorecord_records_open(struct inode *inode, struct file *file)
+{
+	int i, ret;
+	u64 seq;
+	unsigned long flags;
+	struct iorecord_snapshot *snap;
+
+	mutex_lock(&rec.enable_lock);
+	snap = vzalloc(struct_size(snap, entry, rec.size));
+	if (!snap) {
+		mutex_unlock(&rec.enable_lock);
+		return -ENOMEM;
+	}
+
+	spin_lock_irqsave(&rec.lock, flags);
+	seq = rec.seq > rec.size ? rec.seq - rec.size : 0;
+	snap->dropped = seq;
+	for (; seq < rec.seq; ++seq)
+		snap->entry[snap->count++] = *iorecord_slot(seq);
+	for (i = 0; i < IORECORD_AREA_COUNT; ++i)
+		strscpy(snap->area[i], rec.area[i].name,
+			IORECORD_AREA_NAME_LEN);
+	spin_unlock_irqrestore(&rec.lock, flags);
+	mutex_unlock(&rec.enable_lock);
+
+	ret = seq_open(file, &iorecord_seq_ops);
+	if (ret) {
+		vfree(snap);
+		return ret;
+	}
+	((struct seq_file *)file->private_data)->private = snap;
+
+	return 0;
+}
+
+/**
+ * @brief release records file
+ */
+static int iorecord_records_release(struct inode *inode, struct file *file)
+{
+	struct seq_file *m = file->private_data;
+
+	vfree(m->private);
+	return seq_release(inode, file);
+}
+
+/**
+ * @brief write to records file clears the records
+ */
+static ssize_t iorecord_records_write(struct file *file,
+				      const char __user *buf, size_t count,
+				      loff_t *ppos)
+{
+	iorecord_clear();
+	return count;
+}
+
+/**
+ * @brief file operations of the records file
+ */
+static const struct file_operations iorecord_records_fops = {
+	.owner		= THIS_MODULE,
+	.open		= iorecord_records_open,
+	.read		= seq_read,
+	.write		= iorecord_records_write,
+	.llseek		= seq_lseek,
+	.release	= iorecord_records_release,
+};
+
+/**
+ * @brief initialize the register access recorder
+ *
+ * Failing to create the debugfs entries is not fatal.
+ */
+int __must_check iorecord_init(void)
+{
+	int ret;
+	struct dentry *dir;
+
+	if (iorecord_entries == 0)
+		return 0;
+
+	if (iorecord) {
+		ret = iorecord_enable();
+		if (ret)
+			return ret;
+	}
+
+	rec.debugfs = debugfs_create_dir(ACMDRV_NAME, NULL);
+	dir = debugfs_create_dir("iorecord", rec.debugfs);
+	debugfs_create_file_unsafe("enable", 0600, dir, NULL,
+				   &iorecord_enable_fops);
+	debugfs_create_file("records", 0600, dir, NULL,
+			    &iorecord_records_fops);
+
+	return 0;
+}
+
+/**
+ * @brief remove the register access recorder
+ */
+void iorecord_exit(void)
+{
+	debugfs_remove_recursive(rec.debugfs);
+	rec.debugfs = NULL;
+
+	iorecord_disable();
+	spin_lock_irq(&rec.lock);
+	memset(rec.area, 0, sizeof(rec.area));
+	spin_unlock_irq(&rec.lock);
+	vfree(rec.ring);
+	rec.ring = NULL;
+}
+
+/**@} acmiorecord */
+
+/**
+ * @addtogroup acmmodparam
+ * @{
+ */
+/**
+ * @brief Linux module parameter definition to record from module load on
+ */
+module_param(iorecord, bool, 0444);
+
+/**
+ * @brief Linux module parameter description
+ */
+MODULE_PARM_DESC(iorecord, "Record register accesses from module load on");
+
+/**
+ * @brief Linux module parameter definition for the number of records
+ */
+module_param(iorecord_entries, uint, 0444);
+
+/**
+ * @brief Linux module parameter description
+ */
+MODULE_PARM_DESC(iorecord_entries,
+		 "Number of register accesses kept, 0 disables the recorder");
+
+/**@} acmmodparam */
@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: GPL-2.0
+ *
+ * TTTech ACM Linux driver
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * Contact Information:
+ * support@tttech-industrial.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+/**
+ * @file iorecord.h
+ * @brief ACM Driver Register Access Recorder
+ */
+
+#ifndef ACM_IORECORD_H_
+#define ACM_IORECORD_H_
+
+/**
+ * @addtogroup acmiorecord
+ * @{
+ */
+
+#include <linux/kernel.h>
+#include <linux/jump_label.h>
+#include <linux/timekeeping.h>
+
+/**
+ * @brief kind of a recorded register access
+ */
+enum iorecord_op {
+	IORECORD_READ,	/**< register read */
+	IORECORD_WRITE,	/**< register write */
+};
+
+DECLARE_STATIC_KEY_FALSE(iorecord_active);
+
+void __iorecord_add(const volatile void __iomem *addr, enum iorecord_op op,
+		    unsigned int width, u32 value, u64 start);
+void __iorecord_add_block(const volatile void __iomem *addr,
+			  enum iorecord_op op, const u32 *values, size_t count,
+			  u64 start);
+
+/**
+ * @brief start timestamp of a register access to be recorded
+ *
+ * @return timestamp in ns, 0 if recording is inactive
+ */
+static inline u64 iorecord_start(void)
+{
+	if (static_branch_unlikely(&iorecord_active))
+		return ktime_get_ns();
+
+	return 0;
+}
+
+/**
+ * @brief record a single 16 or 32 bit register access
+ *
+ * @param addr accessed register
+ * @param op read or write
+ * @param width access width in bytes
+ * @param value value read or written
+ * @param start timestamp taken by iorecord_start() before the access
+ */
+static inline void iorecord_add(const volatile void __iomem *addr,
+				enum iorecord_op op, unsigned int width,
+				u32 value, u64 start)
+{
+	if (static_branch_unlikely(&iorecord_active))
+		__iorecord_add(addr, op, width, value, start);
+}
+
+/**
+ * @brief record a block of 32 bit register accesses
+ *
+ * @param addr first accessed register
+ * @param op read or write
+ * @param values values read or written
+ * @param count number of 32 bit words
+ * @param start timestamp taken by iorecord_start() before the access
+ */
+static inline void iorecord_add_block(const volatile void __iomem *addr,
+				      enum iorecord_op op, const u32 *values,
+				      size_t count, u64 start)
+{
+	if (static_branch_unlikely(&iorecord_active))
+		__iorecord_add_block(addr, op, values, count, start);
+}
+
+void iorecord_register_area(const char *name,
+			    const volatile void __iomem *base,
+			    resource_size_t size);
+
+int __must_check iorecord_init(void);
+void iorecord_exit(void);
+
+/**@} acmiorecord */
+
+#endif /* ACM_IORECORD_H_ */
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * TTTech ACM Linux driver
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * Contact Information:
+ * support@tttech-industrial.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+/**
+ * @file latency.c
+ * @brief ACM Driver Latency Counters
+ */
+
+/**
+ * @brief kernel pr_* format macro
+ */
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+/**
+ * @defgroup acmlatency ACM Latency Counters
+ * @brief Latency accounting of driver operations
+ *
+ * Each operation accumulates the number of samples, the total and the
+ * maximum latency. The counters are updated lock-free, so they might be
+ * slightly inconsistent to each other while being read.
+ *
+ * The tracepoints of the driver are instantiated here as well.
+ *
+ * @{
+ */
+#include <linux/kernel.h>
+#include <linux/atomic.h>
+#include <linux/device.h>
+#include <linux/platform_device.h>
+
+#include "acm-module.h"
+#include "latency.h"
+
+#define CREATE_TRACE_POINTS
+#include "trace.h"
+
+/**
+ * @brief latency counter of a single operation
+ */
+struct acm_latency_counter {
+	atomic64_t count;	/**< number of samples */
+	atomic64_t total;	/**< accumulated latency in ns */
+	atomic64_t max;		/**< maximum latency in ns */
+};
+
+/**
+ * @brief latency counters of an ACM instance
+ */
+struct acm_latency {
+	struct acm_latency_counter op[ACM_LAT_OP_COUNT]; /**< per operation */
+};
+
+/**
+ * @brief operation names as presented in sysfs and trace output
+ */
+static const char * const acm_latency_names[ACM_LAT_OP_COUNT] = {
+	[ACM_LAT_MSGBUF_READ]		= "msgbuf_read",
+	[ACM_LAT_MSGBUF_WRITE]		= "msgbuf_write",
+	[ACM_LAT_MSGBUF_LOCK]		= "msgbuf_lock",
+	[ACM_LAT_DESC_LOCK]		= "desc_lock",
+	[ACM_LAT_SCHED_ROW_XFER]	= "sched_row_transfer",
+	[ACM_LAT_DIAG_UPDATE]		= "diag_update",
+	[ACM_LAT_RECOVERY_TICK]		= "recovery_tick",
+	[ACM_LAT_CYCLIC_CYCLE]		= "cyclic_cycle",
+};
+
+/**
+ * @brief account a sample of an operation
+ */
+static void acm_latency_add(struct acm_latency *latency,
+			    enum acm_latency_op op, u64 ns)
+{
+	struct acm_latency_counter *cnt = &latency->op[op];
+	s64 max;
+
+	atomic64_inc(&cnt->count);
+	atomic64_add(ns, &cnt->total);
+
+	max = atomic64_read(&cnt->max);
+	while (ns > max) {
+		s64 old = atomic64_cmpxchg(&cnt->max, max, ns);
+
+		if (old == max)
+			break;
+		max = old;
+	}
+}
+
+/**
+ * @brief account the latency of an operation started at start
+ *
+ * @param acm ACM instance
+ * @param op operation
+ * @param start result of acm_latency_start() at begin of the operation
+ */
+void acm_latency_record(struct acm *acm, enum acm_latency_op op, u64 start)
+{
+	if (!acm->latency)
+		return;
+
+	acm_latency_add(acm->latency, op, acm_latency_start() - start);
+}
+
+/**
+ * @brief account and trace a contended lock wait started at start
+ *
+ * @param acm ACM instance
+ * @param op lock operation
+ * @param idx index of the object the lock has been taken for, -1 if none
+ * @param start result of acm_latency_start() before waiting for the lock
+ */
+void acm_lock_wait_record(struct acm *acm, enum acm_latency_op op, int idx,
+			  u64 start)
+{
+	u64 wait = acm_latency_start() - start;
+
+	if (acm->latency)
+		acm_latency_add(acm->latency, op, wait);
+	trace_acm_lock_contended(acm_latency_names[op], idx, wait);
+}
+
+/**
+ * @brief print latency counters, one line per operation
+ */
+ssize_t acm_latency_print(struct acm *acm, char *buf, size_t size)
+{
+	ssize_t len = 0;
+	int op;
+
+	if (!acm->latency)
+		return -ENODEV;
+
+	for (op = 0; op < ACM_LAT_OP_COUNT; ++op) {
+		struct acm_latency_counter *cnt = &acm->latency->op[op];
+
+		len += scnprintf(buf + len, size - len, "%s %lld %lld %lld\n",
+				 acm_latency_names[op],
+				 atomic64_read(&cnt->count),
+				 atomic64_read(&cnt->total),
+				 atomic64_read(&cnt->max));
+	}
+
+	return len;
+}
+
+/**
+ * @brief reset all latency counters
+ */
+void acm_latency_reset(struct acm *acm)
+{
+	int op;
+
+	if (!acm->latency)
+		return;
+
+	for (op = 0; op < ACM_LAT_OP_COUNT; ++op) {
+		struct acm_latency_counter *cnt = &acm->latency->op[op];
+
+		atomic64_set(&cnt->count, 0);
+		atomic64_set(&cnt->total, 0);
+		atomic64_set(&cnt->max, 0);
+	}
+}
+
+/**
+ * @brief initialize latency counters
+ */
+int __must_check acm_latency_init(struct acm *acm)
+{
+	struct acm_latency *latency;
+
+	latency = devm_kzalloc(acm_dev(acm), sizeof(*latency), GFP_KERNEL);
+	if (!latency)
+		return -ENOMEM;
+
+	acm->latency = latency;
+	acm_latency_reset(acm);
+
+	return 0;
+}
+
+/**
+ * @brief exit latency counters
+ */
+void acm_latency_exit(struct acm *acm)
+{
+	/* memory is device managed, just stop accounting */
+	acm->latency = NULL;
+}
+/**@} acmlatency */
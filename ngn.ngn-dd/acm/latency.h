@@ -0,0 +1,103 @@
+/* SPDX-License-Identifier: GPL-2.0
+ *
+ * TTTech ACM Linux driver
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * Contact Information:
+ * support@tttech-industrial.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+/**
+ * @file latency.h
+ * @brief ACM Driver Latency Counters
+ */
+
+#ifndef ACM_LATENCY_H_
+#define ACM_LATENCY_H_
+
+/**
+ * @addtogroup acmlatency
+ * @{
+ */
+
+#include <linux/kernel.h>
+#include <linux/mutex.h>
+#include <linux/timekeeping.h>
+
+struct acm;
+
+/**
+ * @brief driver operations with latency accounting
+ */
+enum acm_latency_op {
+	ACM_LAT_MSGBUF_READ,	/**< message buffer read to user space */
+	ACM_LAT_MSGBUF_WRITE,	/**< message buffer write from user space */
+	ACM_LAT_MSGBUF_LOCK,	/**< contended wait for msgbuf_lock */
+	ACM_LAT_DESC_LOCK,	/**< contended wait for desc_lock */
+	ACM_LAT_SCHED_ROW_XFER,	/**< scheduler table row transfer */
+	ACM_LAT_DIAG_UPDATE,	/**< diagnostics update incl. retries */
+	ACM_LAT_RECOVERY_TICK,	/**< processing of a recovery tick */
+	ACM_LAT_CYCLIC_CYCLE,	/**< copy jobs of a cyclic I/O engine cycle */
+
+	ACM_LAT_OP_COUNT
+};
+
+/**
+ * @brief timestamp for latency measurement
+ */
+static inline u64 acm_latency_start(void)
+{
+	return ktime_get_mono_fast_ns();
+}
+
+void acm_latency_record(struct acm *acm, enum acm_latency_op op, u64 start);
+void acm_lock_wait_record(struct acm *acm, enum acm_latency_op op, int idx,
+			  u64 start);
+
+/**
+ * @brief lock mutex, accounting the wait time if it is contended
+ *
+ * The uncontended case costs a single mutex_trylock().
+ */
+static inline void acm_mutex_lock(struct acm *acm, struct mutex *lock,
+				  enum acm_latency_op op, int idx)
+{
+	u64 start;
+
+	if (mutex_trylock(lock))
+		return;
+
+	start = acm_latency_start();
+	mutex_lock(lock);
+	acm_lock_wait_record(acm, op, idx, start);
+}
+
+/**
+ * @brief interruptibly lock mutex, accounting the wait time if it is
+ *        contended
+ */
+static inline int __must_check acm_mutex_lock_interruptible(struct acm *acm,
+	struct mutex *lock, enum acm_latency_op op, int idx)
+{
+	u64 start;
+	int ret;
+
+	if (mutex_trylock(lock))
+		return 0;
+
+	start = acm_latency_start();
+	ret = mutex_lock_interruptible(lock);
+	acm_lock_wait_record(acm, op, idx, start);
+
+	return ret;
+}
+
+ssize_t acm_latency_print(struct acm *acm, char *buf, size_t size);
+void acm_latency_reset(struct acm *acm);
+
+int __must_check acm_latency_init(struct acm *acm);
+void acm_latency_exit(struct acm *acm);
+
+/**@} acmlatency */
+
+#endif /* ACM_LATENCY_H_ */
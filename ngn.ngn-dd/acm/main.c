@@ -65,6 +65,16 @@
  *
  *   - @ref logicctrl "Logic Control": Handles state transitions and IP
  *     configuration.
+ *
+ *   - @ref acmcyclic "Cyclic I/O Engine": copies between message buffers and
+ *     a process image shared with user space synchronized to the PTP time.
+ *
+ *   - @ref hwaccemu "IP Register Emulation": software model of the ACM IP
+ *     registers to run the driver without hardware (build with
+ *     <tt>CONFIG_ACM_EMU=y</tt>).
+ *
+ *   - @ref acmiorecord "Register Access Recorder": records the register
+ *     accesses of configuration transactions, exported via debugfs.
  */
 
 /**
@@ -89,6 +99,10 @@
 #include "msgbuf.h"
 #include "reset.h"
 #include "commreg.h"
+#include "latency.h"
+#include "cyclic.h"
+#include "emu.h"
+#include "iorecord.h"
 
 #include <linux/delay.h>
 
@@ -155,7 +169,7 @@ static int acm_probe(struct platform_device *pdev)
 
 	dev_info(dev, "Version %s", __stringify(ACMDRV_VERSION));
 	/* check for existing DT node */
-	if (!np) {
+	if (!np && !emu_is_emulated(dev)) {
 		dev_err(dev, "device tree configuration required");
 		return -EINVAL;
 	}
@@ -169,9 +183,15 @@ static int acm_probe(struct platform_device *pdev)
 	acm->pdev = pdev;
 	platform_set_drvdata(pdev, acm);
 
+	ret = acm_latency_init(acm);
+	if (ret)
+		goto out;
+
 	of_id = of_match_device(acm_dt_ids, &pdev->dev);
 	if (of_id)
 		acm->if_id = (enum acm_ip_if_variant)of_id->data;
+	else if (emu_is_emulated(dev))
+		acm->if_id = ACM_IF_4_0;
 	else {
 		dev_err(dev, "Unmatched ACM IP variant");
 		ret = -ENODEV;
@@ -218,20 +238,24 @@ dev_info(dev, "msgbuf_init");
 	if (ret)
 		goto out_redundancy;
 
+	ret = cyclic_init(acm);
+	if (ret)
+		goto out_msgbuf;
+
 	/* create ACM device */
 	acm->dev.release = acm_release;
 dev_info(dev, "dev_set_name");
         udelay(500);
 
-	ret = dev_set_name(&acm->dev, np->name);
+	ret = dev_set_name(&acm->dev, np ? np->name : ACMDRV_NAME);
 	if (ret)
-		goto out_msgbuf;
+		goto out_cyclic;
 dev_info(dev, "device_register");
         udelay(500);
 
 	ret = device_register(&acm->dev);
 	if (ret)
-		goto out_msgbuf;
+		goto out_cyclic;
 
 	/*
 	 * reserve the respective character devices, one for each message
@@ -298,6 +322,8 @@ unregister_chrdev:
 	unregister_chrdev_region(acm->devt, buffers);
 out_unreg_device:
 	device_unregister(&acm->dev);
+out_cyclic:
+	cyclic_exit(acm);
 out_msgbuf:
 	msgbuf_exit(acm);
 out_redundancy:
@@ -323,11 +349,13 @@ static int acm_remove(struct platform_device *pdev)
 {
 	struct acm *acm = platform_get_drvdata(pdev);
 
+	cyclic_disable(acm);
 	acm_state_exit(acm);
 	acm_dev_destroy(acm);
 	unregister_chrdev_region(acm->devt,
 				 commreg_read_msgbuf_count(acm->commreg));
 	device_unregister(&acm->dev);
+	cyclic_exit(acm);
 	msgbuf_exit(acm);
 	redundancy_exit(acm);
 	scheduler_exit(acm);
@@ -335,6 +363,7 @@ static int acm_remove(struct platform_device *pdev)
 	reset_exit(acm);
 	commreg_exit(acm);
 	destroy_workqueue(acm->wq);
+	acm_latency_exit(acm);
 
 	return 0;
 }
@@ -365,13 +394,29 @@ static int __init acm_module_init(void)
 		goto out;
 	}
 
+	ret = iorecord_init();
+	if (ret) {
+		pr_err("iorecord_init() failed: %d\n", ret);
+		goto out_class_destroy;
+	}
+
 	ret = platform_driver_register(&acm_driver);
 	if (ret) {
 		pr_err("platform_driver_register() failed: %d\n", ret);
-		goto out_class_destroy;
+		goto out_iorecord_exit;
+	}
+
+	ret = emu_init();
+	if (ret) {
+		pr_err("emu_init() failed: %d\n", ret);
+		goto out_driver_unregister;
 	}
 	return ret;
 
+out_driver_unregister:
+	platform_driver_unregister(&acm_driver);
+out_iorecord_exit:
+	iorecord_exit();
 out_class_destroy:
 	class_destroy(acm_class);
 out:
@@ -383,7 +428,9 @@ out:
  */
 static void __exit acm_module_exit(void)
 {
+	emu_exit();
 	platform_driver_unregister(&acm_driver);
+	iorecord_exit();
 	class_destroy(acm_class);
 }
 
@@ -35,23 +35,8 @@
 #include "acmbitops.h"
 #include "commreg.h"
 #include "msgbuf.h"
-
-/**
- * @name Message buffer Subsection Offsets
- * @brief Register offsets of the respective Message buffer Subsections
- */
-/**@{*/
-#define ACM_MSGBUF_DESC(i)	(0x00000000 + (i) * sizeof(msgbuf_desc_t))
-#define ACM_MSGBUF_LOCK_CTL	0x00000200
-#define ACM_MSGBUF_LOCK_CTL_LO	ACM_MSGBUF_LOCK_CTL
-#define ACM_MSGBUF_LOCK_CTL_HI	(ACM_MSGBUF_LOCK_CTL + 4)
-#define ACM_MSGBUF_RESET_CTL	0x00000300
-#define ACM_MSGBUF_IRQ_CTL	0x00000400
-#define ACM_MSGBUF_STATUS(i)	(0x00000600 + (i) * sizeof(u32))
-#define ACM_MSGBUF_TIMESTAMP	0x00000800
-#define ACM_MSGBUF_DATA_SIZE	0x800
-#define ACM_MSGBUF_DATA(i)	(0x00010000 + (i) * ACM_MSGBUF_DATA_SIZE)
-/**@}*/
+#include "latency.h"
+#include "trace.h"
 
 /**
  * @name Message Buffer Descriptor
@@ -71,19 +56,6 @@
 #define ACM_MSGBUF_DESC_TYPE_TX		ACM_BUFF_DESC_BUFF_TYPE_TX
 /**@}*/
 
-/**
- * @name Message Buffer Status
- * @brief Bit-Structure of Message Buffer Status
- */
-/**@{*/
-#define ACM_MSGBUF_STATUS_FCS		BIT(0)
-#define ACM_MSGBUF_STATUS_DSCR_ERR	BIT(1)
-#define ACM_MSGBUF_STATUS_OVERWRITTEN	BIT(2)
-#define ACM_MSGBUF_STATUS_D_LOCKED	BIT(20)
-#define ACM_MSGBUF_STATUS_FRESH		BIT(24)
-#define ACM_MSGBUF_STATUS_EMPTY		BIT(28)
-/**@}*/
-
 /**
  * @brief message buffer handler instance
  */
@@ -94,6 +66,7 @@ struct msgbuf {
 
 	atomic_t *overwritten;		/**< overwritten counter array */
 	msgbuf_desc_t *desc_cache;	/**< cache for message buffer descs */
+	u32 invalid;			/**< buffers invalidated on failover */
 
 	struct mutex lock_ctl_lock;	/**< lock for lock_cnt access */
 	struct mutex desc_lock;		/**< lock for descriptor access */
@@ -190,7 +163,7 @@ static u32 _msgbuf_read_desc(struct msgbuf *msgbuf, int i)
 		return 0;
 	}
 
-	mutex_lock(&msgbuf->desc_lock);
+	acm_mutex_lock(msgbuf->acm, &msgbuf->desc_lock, ACM_LAT_DESC_LOCK, i);
 	msgbuf->desc_cache[i] = readl(msgbuf->base + ACM_MSGBUF_DESC(i));
 	mutex_unlock(&msgbuf->desc_lock);
 
@@ -208,8 +181,10 @@ static void _msgbuf_write_desc(struct msgbuf *msgbuf, int i, u32 value)
 		return;
 	}
 
-	mutex_lock(&msgbuf->desc_lock);
+	acm_mutex_lock(msgbuf->acm, &msgbuf->desc_lock, ACM_LAT_DESC_LOCK, i);
 	msgbuf->desc_cache[i] = value;
+	if (i < sizeof(msgbuf->invalid) * BITS_PER_BYTE)
+		WRITE_ONCE(msgbuf->invalid, msgbuf->invalid & ~BIT(i));
 	writel(value, msgbuf->base + ACM_MSGBUF_DESC(i));
 	mutex_unlock(&msgbuf->desc_lock);
 }
@@ -285,6 +260,34 @@ struct acmdrv_msgbuf_lock_ctrl *msgbuf_get_lock_ctrl_mask(struct msgbuf *msgbuf)
 	return &msgbuf->mask;
 }
 
+/**
+ * @brief lock or unlock a single message buffer
+ *
+ * Only the lock control word containing the message buffer is accessed.
+ *
+ * @return true if the lock state of the message buffer was changed
+ */
+static bool msgbuf_lock_one(struct msgbuf *msgbuf, int i, bool lock)
+{
+	bool changed;
+	u32 value;
+	const u32 bit = BIT(i % (sizeof(u32) * NBBY));
+	void __iomem *reg = msgbuf->base + ACM_MSGBUF_LOCK_CTL +
+		i / (sizeof(u32) * NBBY) * sizeof(u32);
+
+	mutex_lock(&msgbuf->lock_ctl_lock);
+	value = readl(reg);
+	rmb(); /* ensure read sequence on ACM IP */
+	changed = !!(value & bit) != lock;
+	if (changed) {
+		writel(lock ? value | bit : value & ~bit, reg);
+		wmb(); /* ensure write sequence on ACM IP */
+	}
+	mutex_unlock(&msgbuf->lock_ctl_lock);
+
+	return changed;
+}
+
 /**
  * @brief read message buffer decriptor
  */
@@ -366,9 +369,15 @@ bool msgbuf_is_empty(struct msgbuf *msgbuf, int i)
 
 /**
  * @brief check if message buffer is valid
+ *
+ * A message buffer invalidated by msgbuf_invalidate_mask() is not valid.
  */
 bool msgbuf_is_valid(const struct msgbuf *msgbuf, int i)
 {
+	if (i < sizeof(msgbuf->invalid) * BITS_PER_BYTE &&
+	    (READ_ONCE(msgbuf->invalid) & BIT(i)))
+		return false;
+
 	return ACM_MSGBUF_DESC_VALID ==
 		(msgbuf->desc_cache[i] & ACM_MSGBUF_DESC_VALID);
 }
@@ -376,11 +385,17 @@ bool msgbuf_is_valid(const struct msgbuf *msgbuf, int i)
 /**
  * @brief read message buffer data to user space
  */
-int __must_check msgbuf_read_to_user(struct msgbuf *msgbuf, int i,
-				     char __user *to, size_t size)
+static ssize_t _msgbuf_read_to_user(struct msgbuf *msgbuf, int i,
+				char __user *to, size_t size, loff_t offset,
+				bool lock)
 {
 	int ret;
+	u32 status;
+	bool locked = false;
+	size_t first, last;
 	const size_t msize = msgbuf_size(msgbuf, i);
+	/* in auto lock mode the status word follows the data */
+	const size_t fsize = lock ? msize + sizeof(status) : msize;
 	const enum acm_msgbuf_type type = msgbuf_type(msgbuf, i);
 	const unsigned int buffers =
 		commreg_read_msgbuf_count(msgbuf->acm->commreg);
@@ -388,43 +403,101 @@ int __must_check msgbuf_read_to_user(struct msgbuf *msgbuf, int i,
 	 * use u32 aligned bounce buffer to to ensure dword alignment
 	 * for acm_memcpy32;
 	 */
-	u8 bounce[msize] __aligned(sizeof(u32));
+	u8 bounce[msize + sizeof(status)] __aligned(sizeof(u32));
 
-	if (type != ACM_MSGBUF_TYPE_RX)
+	/* status of TX buffers may be read in auto lock mode */
+	if (type != ACM_MSGBUF_TYPE_RX && !(lock && offset >= msize))
 		return -EIO;
 
-	if (i >= buffers)
+	if (i >= buffers || offset < 0)
 		return -EINVAL;
 
-	if (size > msize)
-		size = msize;
+	if (offset >= fsize ||
+	    !acmdrv_msgbuf_word_range(fsize, offset, &size, &first, &last))
+		return 0;
 
-	ret = mutex_lock_interruptible(&msgbuf->msgbuf_lock);
+	ret = acm_mutex_lock_interruptible(msgbuf->acm, &msgbuf->msgbuf_lock,
+					   ACM_LAT_MSGBUF_LOCK, i);
 	if (ret)
 		return ret;
 
-	if (msgbuf_is_empty(msgbuf, i)) {
-		mutex_unlock(&msgbuf->msgbuf_lock);
-		return -ENODATA;
+	/* keep the hardware from updating the data while it is read */
+	if (lock && first < msize)
+		locked = msgbuf_lock_one(msgbuf, i, true);
+
+	status = msgbuf_read_status(msgbuf, i);
+	if (first < msize && (status & ACM_MSGBUF_STATUS_EMPTY)) {
+		ret = -ENODATA;
+		goto unlock;
 	}
 
-	acm_ioread32_copy(bounce, msgbuf->base + ACM_MSGBUF_DATA(i), msize);
+	/* only the words covering the requested range are read */
+	if (first < msize)
+		acm_ioread32_copy(bounce + first, msgbuf->base +
+				  ACM_MSGBUF_DATA(i) + first,
+				  min(last, msize) - first);
+	if (last > msize)
+		memcpy(bounce + msize, &status, sizeof(status));
+
+unlock:
+	if (locked)
+		msgbuf_lock_one(msgbuf, i, false);
 	mutex_unlock(&msgbuf->msgbuf_lock);
+	if (ret)
+		return ret;
+
+	if (copy_to_user(to, bounce + offset, size))
+		return -EFAULT;
 
-	return copy_to_user(to, bounce, size) ? -EFAULT : 0;
+	return size;
+}
+
+/**
+ * @brief read message buffer data to user space
+ *
+ * @param msgbuf message buffer handler
+ * @param i message buffer index
+ * @param to user space buffer
+ * @param size number of bytes to read
+ * @param offset byte offset within the message buffer
+ * @param lock lock the message buffer during the access and provide the
+ *        message buffer status after the data
+ * @return number of bytes read (0 at the end of the message buffer) or
+ *         negative error code
+ */
+ssize_t __must_check msgbuf_read_to_user(struct msgbuf *msgbuf, int i,
+					 char __user *to, size_t size,
+					 loff_t offset, bool lock)
+{
+	ssize_t ret;
+	u64 start = acm_latency_start();
+
+	ret = _msgbuf_read_to_user(msgbuf, i, to, size, offset, lock);
+
+	acm_latency_record(msgbuf->acm, ACM_LAT_MSGBUF_READ, start);
+	trace_acm_msgbuf_access(i, false, size, acm_latency_start() - start,
+				ret < 0 ? ret : 0);
+
+	return ret;
 }
 
 /**
  * @brief write message buffer data from user space
  */
-int __must_check msgbuf_write_from_user(struct msgbuf *msgbuf, int i,
-					const char __user *from, size_t size)
+static ssize_t _msgbuf_write_from_user(struct msgbuf *msgbuf, int i,
+				   const char __user *from, size_t size,
+				   loff_t offset, bool lock)
 {
 	int ret;
+	bool locked = false;
+	unsigned int n, k;
+	size_t first, last, word[2];
+	u8 cur[sizeof(u32)] __aligned(sizeof(u32));
 	const size_t msize = msgbuf_size(msgbuf, i);
 	const enum acm_msgbuf_type type = msgbuf_type(msgbuf, i);
 	const unsigned int buffers =
 		commreg_read_msgbuf_count(msgbuf->acm->commreg);
+	void __iomem *data = msgbuf->base + ACM_MSGBUF_DATA(i);
 	/*
 	 * use u32 aligned bounce buffer to to ensure dword alignment
 	 * for acm_memcpy32;
@@ -434,31 +507,135 @@ int __must_check msgbuf_write_from_user(struct msgbuf *msgbuf, int i,
 	if (type != ACM_MSGBUF_TYPE_TX)
 		return -EIO;
 
-	if (size > msize)
-		size = msize;
-
-	if (i >= buffers)
+	if (i >= buffers || offset < 0)
 		return -EINVAL;
 
-	memset(bounce + size, 0, msize - size);
+	if (offset >= msize)
+		return -ENOSPC;
 
-	if (copy_from_user(bounce, from, size))
+	if (!acmdrv_msgbuf_word_range(msize, offset, &size, &first, &last))
+		return 0;
+
+	/* user space may fault, copy before any lock is taken */
+	if (copy_from_user(bounce + offset, from, size))
 		return -EFAULT;
 
-	ret = mutex_lock_interruptible(&msgbuf->msgbuf_lock);
+	ret = acm_mutex_lock_interruptible(msgbuf->acm, &msgbuf->msgbuf_lock,
+					   ACM_LAT_MSGBUF_LOCK, i);
 	if (ret)
 		return ret;
 
-	acm_iowrite32_copy(msgbuf->base + ACM_MSGBUF_DATA(i), bounce, msize);
+	/* keep the hardware from sending partially written data */
+	if (lock)
+		locked = msgbuf_lock_one(msgbuf, i, true);
+
+	/* merge partially written words with the current content */
+	n = acmdrv_msgbuf_partial_words(offset, size, first, last, word);
+	for (k = 0; k < n; k++) {
+		acm_ioread32_copy(cur, data + word[k], sizeof(u32));
+		acmdrv_msgbuf_merge_word(bounce, word[k], cur, offset, size);
+	}
+
+	acm_iowrite32_copy(data + first, bounce + first, last - first);
 	/* update overwritten by reading status */
 	msgbuf_read_status(msgbuf, i);
 
+	if (locked)
+		msgbuf_lock_one(msgbuf, i, false);
 	mutex_unlock(&msgbuf->msgbuf_lock);
 
-	return 0;
+	return size;
+}
+
+/**
+ * @brief write message buffer data from user space
+ *
+ * Only the 32-bit words covering the requested range are written, partially
+ * covered words keep their remaining bytes.
+ *
+ * @param msgbuf message buffer handler
+ * @param i message buffer index
+ * @param from user space buffer
+ * @param size number of bytes to write
+ * @param offset byte offset within the message buffer
+ * @param lock lock the message buffer during the access
+ * @return number of bytes written or negative error code
+ */
+ssize_t __must_check msgbuf_write_from_user(struct msgbuf *msgbuf, int i,
+					    const char __user *from,
+					    size_t size, loff_t offset,
+					    bool lock)
+{
+	ssize_t ret;
+	u64 start = acm_latency_start();
+
+	ret = _msgbuf_write_from_user(msgbuf, i, from, size, offset, lock);
+
+	acm_latency_record(msgbuf->acm, ACM_LAT_MSGBUF_WRITE, start);
+	trace_acm_msgbuf_access(i, true, size, acm_latency_start() - start,
+				ret < 0 ? ret : 0);
+
+	return ret;
 }
 
 
+/**
+ * @brief copy message buffer data between ACM IP and kernel memory
+ *
+ * RX buffers are read to data, TX buffers are written from data. Used by the
+ * cyclic I/O engine, so no bounce buffer is used and offset, size and data
+ * must be 32-bit aligned.
+ *
+ * @param msgbuf message buffer handler
+ * @param i message buffer index
+ * @param data kernel buffer
+ * @param offset byte offset within the message buffer
+ * @param size number of bytes to copy
+ * @param lock lock the message buffer during the access
+ * @return 0 on success, -ENODATA if an RX buffer is empty or negative error
+ *         code
+ */
+int __must_check msgbuf_copy(struct msgbuf *msgbuf, int i, void *data,
+			     size_t offset, size_t size, bool lock)
+{
+	int ret = 0;
+	bool locked = false;
+	void __iomem *io;
+	const unsigned int buffers =
+		commreg_read_msgbuf_count(msgbuf->acm->commreg);
+
+	if (i >= buffers || !msgbuf_is_valid(msgbuf, i))
+		return -EINVAL;
+
+	if (!IS_ALIGNED(offset | size, sizeof(u32)) ||
+	    offset + size > msgbuf_size(msgbuf, i))
+		return -EINVAL;
+
+	io = msgbuf->base + ACM_MSGBUF_DATA(i) + offset;
+
+	acm_mutex_lock(msgbuf->acm, &msgbuf->msgbuf_lock, ACM_LAT_MSGBUF_LOCK,
+		       i);
+	if (lock)
+		locked = msgbuf_lock_one(msgbuf, i, true);
+
+	if (msgbuf_type(msgbuf, i) == ACM_MSGBUF_TYPE_RX) {
+		if (msgbuf_is_empty(msgbuf, i))
+			ret = -ENODATA;
+		else
+			acm_ioread32_copy(data, io, size);
+	} else {
+		acm_iowrite32_copy(io, data, size);
+		/* update overwritten by reading status */
+		msgbuf_read_status(msgbuf, i);
+	}
+
+	if (locked)
+		msgbuf_lock_one(msgbuf, i, false);
+	mutex_unlock(&msgbuf->msgbuf_lock);
+
+	return ret;
+}
+
 /**
  * @brief cleanup/initialize message buffer hardware
  */
@@ -472,6 +649,62 @@ void msgbuf_cleanup(struct msgbuf *msgbuf)
 		_msgbuf_write_desc(msgbuf, i, 0);
 }
 
+/**
+ * @brief cleanup of selected message buffers only
+ *
+ * @param msgbuf message buffer handler
+ * @param mask bit mask of the message buffers whose descriptors are cleared
+ */
+void msgbuf_cleanup_mask(struct msgbuf *msgbuf, u32 mask)
+{
+	int i;
+	unsigned int buffers = commreg_read_msgbuf_count(msgbuf->acm->commreg);
+
+	for (i = 0; i < buffers && i < sizeof(mask) * BITS_PER_BYTE; i++)
+		if (mask & BIT(i))
+			_msgbuf_write_desc(msgbuf, i, 0);
+}
+
+/**
+ * @brief temporarily invalidate/revalidate selected message buffers
+ *
+ * Invalidation clears the valid flag of the hardware descriptors only, the
+ * descriptor cache keeps the configured values, so revalidation restores
+ * them. Writing a descriptor ends its invalidation.
+ *
+ * @param msgbuf message buffer handler
+ * @param mask bit mask of the message buffers
+ * @param invalidate true to invalidate, false to restore
+ * @return bit mask of the message buffers invalidated afterwards
+ */
+u32 msgbuf_invalidate_mask(struct msgbuf *msgbuf, u32 mask, bool invalidate)
+{
+	int i;
+	unsigned int buffers = commreg_read_msgbuf_count(msgbuf->acm->commreg);
+
+	for (i = 0; i < buffers && i < sizeof(mask) * BITS_PER_BYTE; i++) {
+		u32 desc;
+
+		if (!(mask & BIT(i)))
+			continue;
+
+		acm_mutex_lock(msgbuf->acm, &msgbuf->desc_lock,
+			       ACM_LAT_DESC_LOCK, i);
+		desc = msgbuf->desc_cache[i];
+		if (invalidate && (desc & ACM_MSGBUF_DESC_VALID)) {
+			WRITE_ONCE(msgbuf->invalid, msgbuf->invalid | BIT(i));
+			writel(desc & ~ACM_MSGBUF_DESC_VALID,
+			       msgbuf->base + ACM_MSGBUF_DESC(i));
+		} else if (!invalidate && (msgbuf->invalid & BIT(i))) {
+			WRITE_ONCE(msgbuf->invalid, msgbuf->invalid & ~BIT(i));
+			writel(desc, msgbuf->base + ACM_MSGBUF_DESC(i));
+		}
+		mutex_unlock(&msgbuf->desc_lock);
+	}
+
+	return READ_ONCE(msgbuf->invalid);
+}
+
 /**
  * @brief initialize message buffer handler
  */
@@ -491,7 +724,7 @@ int __must_check msgbuf_init(struct acm *acm)
 
 	res = platform_get_resource_byname(pdev, IORESOURCE_MEM,
 					   "Messagebuffer");
-	msgbuf->base = devm_ioremap_resource(dev, res);
+	msgbuf->base = acm_ioremap_resource(dev, res);
 	if (IS_ERR(msgbuf->base))
 		return PTR_ERR(msgbuf->base);
 	msgbuf->size = resource_size(res);
@@ -30,6 +30,36 @@
  */
 typedef u32 msgbuf_desc_t;
 
+/**
+ * @name Message buffer Subsection Offsets
+ * @brief Register offsets of the respective Message buffer Subsections
+ */
+/**@{*/
+#define ACM_MSGBUF_DESC(i)	(0x00000000 + (i) * sizeof(msgbuf_desc_t))
+#define ACM_MSGBUF_LOCK_CTL	0x00000200
+#define ACM_MSGBUF_LOCK_CTL_LO	ACM_MSGBUF_LOCK_CTL
+#define ACM_MSGBUF_LOCK_CTL_HI	(ACM_MSGBUF_LOCK_CTL + 4)
+#define ACM_MSGBUF_RESET_CTL	0x00000300
+#define ACM_MSGBUF_IRQ_CTL	0x00000400
+#define ACM_MSGBUF_STATUS(i)	(0x00000600 + (i) * sizeof(u32))
+#define ACM_MSGBUF_TIMESTAMP	0x00000800
+#define ACM_MSGBUF_DATA_SIZE	0x800
+#define ACM_MSGBUF_DATA(i)	(0x00010000 + (i) * ACM_MSGBUF_DATA_SIZE)
+/**@}*/
+
+/**
+ * @name Message Buffer Status
+ * @brief Bit-Structure of Message Buffer Status
+ */
+/**@{*/
+#define ACM_MSGBUF_STATUS_FCS		BIT(0)
+#define ACM_MSGBUF_STATUS_DSCR_ERR	BIT(1)
+#define ACM_MSGBUF_STATUS_OVERWRITTEN	ACMDRV_MSGBUF_STATUS_OVERWRITTEN
+#define ACM_MSGBUF_STATUS_D_LOCKED	ACMDRV_MSGBUF_STATUS_D_LOCKED
+#define ACM_MSGBUF_STATUS_FRESH		ACMDRV_MSGBUF_STATUS_FRESH
+#define ACM_MSGBUF_STATUS_EMPTY		ACMDRV_MSGBUF_STATUS_EMPTY
+/**@}*/
+
 /**
  * @brief message buffer types
  */
@@ -61,12 +91,18 @@ int __must_check msgbuf_desc_write(struct msgbuf *msgbuf,
 				       msgbuf_desc_t *buf);
 bool msgbuf_is_empty(struct msgbuf *msgbuf, int i);
 bool msgbuf_is_valid(const struct msgbuf *msgbuf, int i);
-int __must_check msgbuf_read_to_user(struct msgbuf *msgbuf, int i,
-					 char __user *to, size_t size);
-int __must_check msgbuf_write_from_user(struct msgbuf *msgbuf, int i,
+ssize_t __must_check msgbuf_read_to_user(struct msgbuf *msgbuf, int i,
+					 char __user *to, size_t size,
+					 loff_t offset, bool lock);
+ssize_t __must_check msgbuf_write_from_user(struct msgbuf *msgbuf, int i,
 					    const char __user *from,
-					    size_t size);
+					    size_t size, loff_t offset,
+					    bool lock);
+int __must_check msgbuf_copy(struct msgbuf *msgbuf, int i, void *data,
+			     size_t offset, size_t size, bool lock);
 void msgbuf_cleanup(struct msgbuf *msgbuf);
+void msgbuf_cleanup_mask(struct msgbuf *msgbuf, u32 mask);
+u32 msgbuf_invalidate_mask(struct msgbuf *msgbuf, u32 mask, bool invalidate);
 
 int __must_check msgbuf_init(struct acm *acm);
 void msgbuf_exit(struct acm *acm);
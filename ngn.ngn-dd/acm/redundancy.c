@@ -25,12 +25,16 @@
 #include <linux/of.h>
 #include <linux/uaccess.h>
 #include <linux/time.h>
+#include <linux/bitmap.h>
 #include <asm/div64.h>
 
 #include "acm-module.h"
 #include "redundancy.h"
 #include "acmio.h"
 #include "bypass.h"
+#include "scheduler.h"
+#include "latency.h"
+#include "trace.h"
 
 /**
  * @addtogroup acmmodparam
@@ -125,6 +129,41 @@ struct recovery {
 	struct mutex lock;
 };
 
+/**
+ * @struct redun_stats
+ * @brief FRER statistics derived from the redundancy status table
+ *
+ * @var redun_stats::data
+ * @brief published statistics
+ *
+ * @var redun_stats::status
+ * @brief status table entries of the last sample
+ *
+ * @var redun_stats::rebase
+ * @brief entries whose last sample is no valid reference
+ *
+ * @var redun_stats::rate_stamp
+ * @brief monotonic time the current rate interval started
+ *
+ * @var redun_stats::rate_passed
+ * @brief passed counters at start of the rate interval
+ *
+ * @var redun_stats::rate_duplicates
+ * @brief duplicate counters at start of the rate interval
+ *
+ * @var redun_stats::lock
+ * @brief statistics lock
+ */
+struct redun_stats {
+	struct acmdrv_redun_stats data;
+	u32 status[ACMDRV_REDUN_TABLE_ENTRY_COUNT];
+	DECLARE_BITMAP(rebase, ACMDRV_REDUN_TABLE_ENTRY_COUNT);
+	ktime_t rate_stamp;
+	u64 rate_passed[ACMDRV_REDUN_TABLE_ENTRY_COUNT];
+	u32 rate_duplicates[ACMDRV_REDUN_TABLE_ENTRY_COUNT];
+	struct mutex lock;
+};
+
 /**
  * @brief redundancy module handler instance
  */
@@ -135,8 +174,12 @@ struct redundancy {
 	struct acm *acm;	/**< associated ACM instance */
 
 	struct recovery recovery; /**<  redundancy module recovery data */
+	struct redun_stats stats; /**< FRER statistics */
 };
 
+static void redun_stats_rebase(struct redundancy *redund, off_t offset,
+			       size_t size);
+
 /**
  * @brief helper to read register in redundancy section
  */
@@ -162,7 +205,8 @@ void redundancy_area_write(struct redundancy *redundancy, off_t area,
 			__func__, area + offset);
 		return;
 	}
-	writel(value, redundancy->base + area + offset);
+	acm_writel(value, redundancy->base + area + offset);
+	redun_stats_rebase(redundancy, area + offset, sizeof(value));
 }
 
 /**
@@ -198,6 +242,25 @@ void redundancy_block_write(struct redundancy *redundancy, const void *src,
 	}
 	memcpy(bounce, src, size);
 	acm_iowrite32_copy(redundancy->base + offset, bounce, size);
+	redun_stats_rebase(redundancy, offset, size);
+}
+
+/**
+ * @brief reset the redundancy control table of a single bypass module
+ *
+ * The IntSeqNum table is shared by both modules and thus left untouched.
+ */
+void redundancy_cleanup_module(struct redundancy *redundancy, int module)
+{
+	int j;
+
+	if (module < 0 || module >= ACMDRV_REDUN_CTRLTAB_COUNT)
+		return;
+
+	for (j = 0; j < ACMDRV_REDUN_TABLE_ENTRY_COUNT; ++j)
+		redundancy_area_write(redundancy, ACM_REDUN_CTRLTAB(module),
+				      j * sizeof(struct acmdrv_redun_ctrl_entry),
+				      0);
 }
 
 /**
@@ -205,16 +268,12 @@ void redundancy_block_write(struct redundancy *redundancy, const void *src,
  */
 void redundancy_cleanup(struct redundancy *redundancy)
 {
-	int i, j;
+	int i;
 	const u32 intseqnum[ACMDRV_REDUN_TABLE_ENTRY_COUNT] = { 0 };
 
 	/* reset all redundancy control table entries */
 	for (i = 0; i < ACMDRV_REDUN_CTRLTAB_COUNT; ++i)
-		for (j = 0; j < ACMDRV_REDUN_TABLE_ENTRY_COUNT; ++j)
-			redundancy_area_write(
-				redundancy, ACM_REDUN_CTRLTAB(i),
-				j * sizeof(struct acmdrv_redun_ctrl_entry),
-				0);
+		redundancy_cleanup_module(redundancy, i);
 	/* reset IntSeqNum table */
 	redundancy_block_write(redundancy, intseqnum,
 			       ACM_REDUN_INTSEQNNUMTAB, sizeof(intseqnum));
@@ -529,6 +588,63 @@ int __must_check redundancy_set_base_recovery_timeout(struct redundancy *redund,
 	return 0;
 }
 
+/**
+ * @brief Reset the sequence recovery of a bypass module
+ *
+ * Sets TakeAny of all enabled individual recoveries of the module and of all
+ * enabled base recoveries whose IntSeqNum entries are referenced by the
+ * module's redundancy control table, i.e. the next frame is accepted
+ * regardless of its sequence number. Used on link changes of the module's
+ * port instead of waiting for the receive timeouts.
+ *
+ * @param redund redundancy instance
+ * @param module module number
+ */
+void redundancy_recovery_reset_module(struct redundancy *redund,
+				      unsigned int module)
+{
+	unsigned int i;
+	u32 referenced = 0;
+
+	if (module >= ACMDRV_BYPASS_MODULES_COUNT)
+		return;
+
+	for (i = 0; i < ACMDRV_REDUN_TABLE_ENTRY_COUNT; ++i) {
+		struct acmdrv_redun_ctrl_entry entry;
+
+		entry.ctrl = redundancy_area_read(redund,
+			ACM_REDUN_CTRLTAB(module), i * sizeof(entry));
+		if (entry.ctrl)
+			referenced |=
+			    BIT(acmdrv_redun_ctrltab_entry_int_seq_idx_read(
+				&entry));
+	}
+
+	mutex_lock(&redund->recovery.lock);
+
+	for (i = 0; i < ACMDRV_BYPASS_NR_RULES; ++i) {
+		struct recovery_data *individual =
+			&redund->recovery.individual[i][module];
+
+		if (individual->frer_seq_rcvy_reset_msec == 0)
+			continue;
+		individual_recovery_receive_timeout(redund, module, i);
+		reset_remaining_ticks(individual);
+	}
+
+	for (i = 0; i < ACMDRV_REDUN_TABLE_ENTRY_COUNT; ++i) {
+		struct base_recovery_data *base = &redund->recovery.base[i];
+
+		if (!(referenced & BIT(i)) ||
+		    base->data.frer_seq_rcvy_reset_msec == 0)
+			continue;
+		base_recovery_receive_timeout(redund, i);
+		reset_remaining_ticks(&base->data);
+	}
+
+	mutex_unlock(&redund->recovery.lock);
+}
+
 /**
  * @brief Read REDUND_FRAMES_PRODUCED registers
  */
@@ -539,6 +655,183 @@ unsigned int redundancy_get_redund_frames_produced(struct redundancy *redund,
 		REDUND_FRAMES_PRODUCED(modidx));
 }
 
+/**
+ * @brief Invalidate the statistics reference of rewritten IntSeqNum entries
+ *
+ * Software writes to the IntSeqNum table reset the sequence recovery, so
+ * the affected entries are counted as reset and their next sample is not
+ * compared to the previous one.
+ *
+ * @param redund redundancy instance
+ * @param offset offset of the write access within the redundancy module
+ * @param size size of the write access
+ */
+static void redun_stats_rebase(struct redundancy *redund, off_t offset,
+			       size_t size)
+{
+	const off_t start = ACM_REDUN_INTSEQNNUMTAB;
+	const off_t end = start + ACMDRV_REDUN_TABLE_ENTRY_COUNT *
+		sizeof(struct acmdrv_redun_intseqnum);
+	struct redun_stats *stats = &redund->stats;
+	unsigned int idx, first, last;
+
+	if (offset + size <= start || offset >= end)
+		return;
+
+	first = (max(offset, start) - start) /
+		sizeof(struct acmdrv_redun_intseqnum);
+	last = (min_t(off_t, offset + size, end) - start - 1) /
+		sizeof(struct acmdrv_redun_intseqnum);
+
+	mutex_lock(&stats->lock);
+	for (idx = first; idx <= last; ++idx) {
+		stats->data.entry[idx].resets++;
+		set_bit(idx, stats->rebase);
+	}
+	mutex_unlock(&stats->lock);
+}
+
+/**
+ * @brief account the change of a redundancy status table entry
+ *
+ * @param entry statistics of the entry
+ * @param prev status word of the previous sample
+ * @param cur status word of the current sample
+ */
+static void redun_stats_account(struct acmdrv_redun_entry_stats *entry,
+				u32 prev, u32 cur)
+{
+	const struct acmdrv_redun_status p = { .status = prev };
+	const struct acmdrv_redun_status c = { .status = cur };
+	enum acmdrv_redun_status_old_status old[] = {
+		acmdrv_redun_status_old_status_0_read(&c),
+		acmdrv_redun_status_old_status_1_read(&c),
+	};
+	s16 delta;
+	int i;
+
+	delta = acmdrv_redun_status_int_seq_num_read(&c) -
+		acmdrv_redun_status_int_seq_num_read(&p);
+	if (delta > 0)
+		entry->passed += delta;
+	else if (delta < 0)
+		entry->out_of_order++;
+
+	if (acmdrv_redun_status_rr_read(&c))
+		entry->recoveries++;
+
+	for (i = 0; i < ARRAY_SIZE(old); ++i) {
+		if (old[i] == ACMDRV_REDUN_OSTAT_FRM_RCVD_SKIP)
+			entry->duplicates++;
+		else if (old[i] == ACMDRV_REDUN_OSTAT_FRM_RCVD_ERR)
+			entry->errors++;
+	}
+}
+
+/**
+ * @brief update the rates once per second
+ *
+ * Statistics lock must be held when calling this function.
+ *
+ * @param stats statistics instance
+ */
+static void redun_stats_rates(struct redun_stats *stats)
+{
+	ktime_t now = ktime_get();
+	u64 elapsed = ktime_to_ns(ktime_sub(now, stats->rate_stamp));
+	unsigned int idx;
+
+	if (stats->rate_stamp && elapsed < NSEC_PER_SEC)
+		return;
+
+	for (idx = 0; idx < ACMDRV_REDUN_TABLE_ENTRY_COUNT; ++idx) {
+		struct acmdrv_redun_entry_stats *entry;
+
+		entry = &stats->data.entry[idx];
+
+		if (stats->rate_stamp) {
+			entry->passed_rate = div64_u64((entry->passed -
+				stats->rate_passed[idx]) * NSEC_PER_SEC,
+				elapsed);
+			entry->duplicate_rate = div64_u64((u64)(
+				entry->duplicates - stats->rate_duplicates[idx])
+				* NSEC_PER_SEC, elapsed);
+		}
+		stats->rate_passed[idx] = entry->passed;
+		stats->rate_duplicates[idx] = entry->duplicates;
+	}
+	stats->rate_stamp = now;
+}
+
+/**
+ * @brief sample the redundancy status table into the statistics
+ *
+ * Statistics lock must be held when calling this function.
+ *
+ * @param redund redundancy instance
+ */
+static void redun_stats_sample(struct redundancy *redund)
+{
+	struct redun_stats *stats = &redund->stats;
+	struct acmdrv_redun_status status[ACMDRV_REDUN_TABLE_ENTRY_COUNT];
+	struct timespec64 now;
+	unsigned int idx;
+
+	redundancy_block_read(redund, status, ACM_REDUN_STATUSTAB,
+			      sizeof(status));
+
+	for (idx = 0; idx < ACMDRV_REDUN_TABLE_ENTRY_COUNT; ++idx) {
+		u32 prev = stats->status[idx];
+
+		stats->status[idx] = status[idx].status;
+		if (stats->data.samples == 0 ||
+		    test_and_clear_bit(idx, stats->rebase))
+			continue;
+		if (status[idx].status != prev)
+			redun_stats_account(&stats->data.entry[idx], prev,
+					    status[idx].status);
+	}
+
+	now = ktime_to_timespec64(
+		scheduler_ktime_get_ptp(redund->acm->scheduler));
+	stats->data.samples++;
+	stats->data.timestamp.tv_sec = now.tv_sec;
+	stats->data.timestamp.tv_nsec = now.tv_nsec;
+	redun_stats_rates(stats);
+}
+
+/**
+ * @brief read the FRER statistics
+ *
+ * @param redund redundancy instance
+ * @param stats returns the statistics
+ */
+void redundancy_stats_read(struct redundancy *redund,
+			   struct acmdrv_redun_stats *stats)
+{
+	mutex_lock(&redund->stats.lock);
+	*stats = redund->stats.data;
+	mutex_unlock(&redund->stats.lock);
+}
+
+/**
+ * @brief reset the FRER statistics
+ *
+ * The next sample only takes the reference of the status table.
+ *
+ * @param redund redundancy instance
+ */
+void redundancy_stats_reset(struct redundancy *redund)
+{
+	struct redun_stats *stats = &redund->stats;
+
+	mutex_lock(&stats->lock);
+	memset(&stats->data, 0, sizeof(stats->data));
+	bitmap_zero(stats->rebase, ACMDRV_REDUN_TABLE_ENTRY_COUNT);
+	stats->rate_stamp = 0;
+	mutex_unlock(&stats->lock);
+}
+
 /**
  * @brief Start/stop recovery timer
  *
@@ -577,26 +870,30 @@ static void set_recovery_tick(struct recovery *recovery,
  * @param redund redundancy instance
  * @param module bypass module index
  * @param rule rule index within the bypass module
+ * @return true if the receive timeout has been hit
  */
-static void individual_recovery_process(struct redundancy *redund,
+static bool individual_recovery_process(struct redundancy *redund,
 	unsigned int module, unsigned int rule)
 {
 	struct recovery_data *individual;
+	bool timeout = false;
 
 	individual = &redund->recovery.individual[rule][module];
 
 	if (individual->frer_seq_rcvy_reset_msec == 0)
-		return;
+		return false;
 
 	/* check, if no frame has been received */
 	if (individual_recovery_no_frame_received(redund, module, rule)) {
 		individual->remaining_ticks--;
 		if (individual->remaining_ticks > 0)
-			return;
+			return false;
 		individual_recovery_receive_timeout(redund, module, rule);
+		timeout = true;
 	}
 
 	reset_remaining_ticks(individual);
+	return timeout;
 }
 
 
@@ -605,25 +902,29 @@ static void individual_recovery_process(struct redundancy *redund,
  *
  * @param redund redundancy instance
  * @param idx IntSeqNum table index
+ * @return true if the receive timeout has been hit
  */
-static void base_recovery_process(struct redundancy *redund,
+static bool base_recovery_process(struct redundancy *redund,
 	unsigned int idx)
 {
 	struct base_recovery_data *base = &redund->recovery.base[idx];
 	u16 intseqnum;
+	bool timeout = false;
 
 	if (base->data.frer_seq_rcvy_reset_msec == 0)
-		return;
+		return false;
 
 	intseqnum = read_intseqnum(redund, idx);
 	if (intseqnum == base->intseqnum) {
 		base->data.remaining_ticks--;
 		if (base->data.remaining_ticks > 0)
-			return;
+			return false;
 		base_recovery_receive_timeout(redund, idx);
+		timeout = true;
 	}
 	base->intseqnum = intseqnum;
 	reset_remaining_ticks(&base->data);
+	return timeout;
 }
 
 /**
@@ -637,16 +938,33 @@ static void recovery_process(struct recovery *recovery)
 {
 	unsigned int module;
 	unsigned int idx;
+	unsigned int timeouts = 0;
+	u64 start = acm_latency_start();
 
 	struct redundancy *redund = container_of(recovery, struct redundancy,
 						 recovery);
+	struct acmdrv_redun_stats *stats = &redund->stats.data;
+
+	mutex_lock(&redund->stats.lock);
 
 	for (module = 0; module < ACMDRV_BYPASS_MODULES_COUNT; ++module)
 		for (idx = 0; idx < ACMDRV_BYPASS_NR_RULES; ++idx)
-			individual_recovery_process(redund, module, idx);
+			if (individual_recovery_process(redund, module, idx)) {
+				stats->individual_timeouts[module][idx]++;
+				timeouts++;
+			}
 
 	for (idx = 0; idx < ACMDRV_REDUN_TABLE_ENTRY_COUNT; ++idx)
-		base_recovery_process(redund, idx);
+		if (base_recovery_process(redund, idx)) {
+			stats->entry[idx].timeouts++;
+			timeouts++;
+		}
+
+	redun_stats_sample(redund);
+	mutex_unlock(&redund->stats.lock);
+
+	acm_latency_record(redund->acm, ACM_LAT_RECOVERY_TICK, start);
+	trace_acm_recovery_tick(timeouts, acm_latency_start() - start);
 }
 
 /**
@@ -735,9 +1053,10 @@ int __must_check redundancy_init(struct acm *acm)
 	if (!redundancy)
 		return -ENOMEM;
 	redundancy->acm = acm;
+	mutex_init(&redundancy->stats.lock);
 
 	res = platform_get_resource_byname(pdev, IORESOURCE_MEM, "Redundancy");
-	redundancy->base = devm_ioremap_resource(dev, res);
+	redundancy->base = acm_ioremap_resource(dev, res);
 	if (IS_ERR(redundancy->base))
 		return PTR_ERR(redundancy->base);
 	redundancy->size = resource_size(res);
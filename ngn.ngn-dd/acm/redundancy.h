@@ -48,6 +48,7 @@ struct acm;
 int __must_check redundancy_init(struct acm *acm);
 void redundancy_exit(struct acm *acm);
 void redundancy_cleanup(struct redundancy *redundancy);
+void redundancy_cleanup_module(struct redundancy *redundancy, int module);
 u32 redundancy_area_read(struct redundancy *redundancy, off_t area,
 			 off_t offset);
 void redundancy_area_write(struct redundancy *redundancy, off_t area,
@@ -66,8 +67,13 @@ int __must_check redundancy_get_base_recovery_timeout(
 	struct redundancy *redund, unsigned int idx, u32 *timeout);
 int __must_check redundancy_set_base_recovery_timeout(
 	struct redundancy *redund, unsigned int idx, u32 timeout);
+void redundancy_recovery_reset_module(struct redundancy *redund,
+				      unsigned int module);
 unsigned int redundancy_get_redund_frames_produced(struct redundancy *redund,
 	unsigned int module);
+void redundancy_stats_read(struct redundancy *redund,
+			   struct acmdrv_redun_stats *stats);
+void redundancy_stats_reset(struct redundancy *redund);
 /**@} hwaccredund */
 
 #endif /* ACM_REDUN_H_ */
@@ -33,13 +33,18 @@
 #include <linux/mutex.h>
 #include <linux/delay.h>
 #include <linux/io.h>
+#include <linux/hrtimer.h>
+#include <linux/math64.h>
 
 #include "edge.h"
 
 #include "acm-module.h"
 #include "scheduler.h"
+#include "acmio.h"
 #include "acmbitops.h"
 #include "bypass.h"
+#include "latency.h"
+#include "trace.h"
 
 #include <linux/delay.h>
 
@@ -48,30 +53,72 @@
  */
 #define ACM_SCHEDULER_MAX_FUTURE_MSECS	64000
 
+/**
+ * @brief minimum time between writing the start time and the start itself
+ */
+#define ACM_SCHEDULER_START_MARGIN_NSECS	(2 * NSEC_PER_MSEC)
+
+/**
+ * @brief number of fractional bits of sub-nanosecond values
+ */
+#define ACM_SCHEDULER_SUBNS_SHIFT	24
+
+/**
+ * @brief poll interval for table switch detection
+ */
+#define ACM_SCHEDULER_SWITCH_POLL_MSECS	1
+
+/**
+ * @brief give up table switch detection this long after the start time
+ */
+#define ACM_SCHEDULER_SWITCH_TIMEOUT_MSECS	1000
+
 struct scheduler;
 /**
  * @struct sched_table
  * @brief data per scheduler table
  *
  * @struct sched_table::sched_table_work
- * @brief extension of delayed_work
+ * @brief hrtimer armed work writing the start time
  */
 struct sched_table {
 	void __iomem *base;		/**< base address */
+	int sidx;			/**< index of scheduler */
+	int tidx;			/**< index of table */
 
 	struct mutex table_row_lock;	/**< table row access lock */
 	struct mutex cycle_time_lock;	/**< cycle time access lock */
 
-	struct timespec64 time;		/**< the requested start time */
+	struct timespec64 requested;	/**< the requested start time */
+	struct timespec64 time;		/**< the achieved start time */
+	u32 subns;			/**< subns of the achieved start */
 	bool trigger;			/**< trigger schedule start */
 	struct sched_table_work {
 		struct scheduler *sched;	/**< backward reference */
-		struct delayed_work dwork;	/**< kernel delayed work */
-	} work;				/**< delayed work */
+		struct hrtimer timer;		/**< start time write timer */
+		struct work_struct work;	/**< start time write work */
+	} work;				/**< start time write work */
 	struct completion complete;	/**< completion of write start time */
 	struct mutex lock;		/**< prohibit simultaneous writes */
 };
 
+/**
+ * @struct sched_switch
+ * @brief table switch detection per scheduler
+ *
+ * After a table has been started, its status is polled until the IP
+ * reports it in use. The switch is then published as event.
+ */
+struct sched_switch {
+	struct scheduler *sched;	/**< backward reference */
+	int sidx;			/**< index of scheduler */
+	int tidx;			/**< table expected to become active */
+	ktime_t timeout;		/**< PTP time to give up detection */
+	struct delayed_work dwork;	/**< detection work */
+	struct mutex lock;		/**< event access lock */
+	struct acmdrv_sched_switch_event event;	/**< last event */
+};
+
 /**
  * @struct sched_data
  * @brief data per scheduler
@@ -90,6 +137,7 @@ struct sched_data {
 
 	bool active;	/**< active state of scheduler */
 	struct sched_table table[ACMDRV_SCHED_TBL_COUNT];
+	struct sched_switch sw;	/**< table switch detection */
 };
 
 /**
@@ -191,6 +239,56 @@ static void write_start_time_done(struct sched_table *table)
 	complete_all(&table->complete);
 }
 
+/**
+ * @brief Cancel a pending start time write
+ *
+ * The timer queues the work and the work may rearm the timer, so both are
+ * cancelled until neither of them is pending anymore.
+ *
+ * @return true if a pending write has been cancelled
+ */
+static bool write_start_time_cancel(struct sched_table *table)
+{
+	bool cancelled = false;
+
+	do {
+		cancelled |= hrtimer_cancel(&table->work.timer);
+		cancelled |= cancel_work_sync(&table->work.work);
+	} while (hrtimer_active(&table->work.timer) ||
+		 work_pending(&table->work.work));
+
+	return cancelled;
+}
+
+/**
+ * @brief Mark the switch to a table pending as soon as its start is accepted
+ *
+ * The start time of a table far in the future is written by the timer later,
+ * but waiters must not take the event of a previous switch for this one.
+ */
+static void sched_switch_pend(struct sched_table *table)
+{
+	struct scheduler *sched = table->work.sched;
+	struct sched_switch *sw = &sched->data[table->sidx].sw;
+
+	/* a detection still running belongs to a superseded start */
+	cancel_delayed_work_sync(&sw->dwork);
+
+	mutex_lock(&sw->lock);
+	sw->tidx = table->tidx;
+	sw->event.table = table->tidx;
+	sw->event.status = 0;
+	sw->event.pending = 1;
+	sw->event.start.tv_sec = table->requested.tv_sec;
+	sw->event.start.tv_nsec = table->requested.tv_nsec;
+	sw->event.detected.tv_sec = 0;
+	sw->event.detected.tv_nsec = 0;
+	sw->event.requested = sw->event.start;
+	sw->event.start_subns = 0;
+	sw->event.slip = 0;
+	mutex_unlock(&sw->lock);
+}
+
 /**
  * @brief Prepare eventually async write f start time
  */
@@ -199,14 +297,18 @@ static int write_start_time_prepare(struct sched_table *table,
 {
 	pr_debug("%s(%p)\n", __func__, table);
 
-	if (cancel_delayed_work_sync(&table->work.dwork))
+	if (write_start_time_cancel(table))
 		pr_debug("%s(%p): Work triggering at %lld.%09lu has been cancelled\n",
-			__func__, table, table->time.tv_sec,
-			table->time.tv_nsec);
+			__func__, table, table->requested.tv_sec,
+			table->requested.tv_nsec);
 
 	reinit_completion(&table->complete);
+	table->requested = *time;
 	table->time = *time;
+	table->subns = 0;
 	table->trigger = trig;
+	if (trig)
+		sched_switch_pend(table);
 	return 0;
 }
 
@@ -218,84 +320,291 @@ ktime_t scheduler_ktime_get_ptp(struct scheduler *scheduler)
 	if (!scheduler)
 		return ktime_set(0, 0);
 
+	/* emulated ACM */
+	if (!scheduler->frtc)
+		return ktime_get_clocktai();
+
 	return edgx_ktime_get_worker_ptp(scheduler->frtc);
 }
 
 
 /**
- * @brief Trigger delayed write of schedule start time if required
+ * @brief convert ktime_t to struct acmdrv_timespec64
  */
-static void write_start_time_execute(struct sched_table *table)
+static struct acmdrv_timespec64 ktime_to_acmdrv_timespec64(ktime_t kt)
 {
-	ktime_t start, now;
-	u64 future_msecs;
+	struct timespec64 ts = ktime_to_timespec64(kt);
 
-	now = scheduler_ktime_get_ptp(table->work.sched);
+	return (struct acmdrv_timespec64){
+		.tv_sec = ts.tv_sec,
+		.tv_nsec = ts.tv_nsec
+	};
+}
 
-	pr_debug("%s(%p): PTP time: %lld.%09lu\n", __func__, table,
-		ktime_to_timespec64(now).tv_sec,
-		ktime_to_timespec64(now).tv_nsec);
+/**
+ * @brief Start detection of the switch to a started table
+ */
+static void sched_switch_arm(struct sched_table *table, ktime_t start,
+			     ktime_t now, s64 slip)
+{
+	struct scheduler *sched = table->work.sched;
+	struct sched_switch *sw = &sched->data[table->sidx].sw;
+	s64 delay = ktime_ms_delta(start, now);
+
+	mutex_lock(&sw->lock);
+	if (!sw->event.pending || sw->tidx != table->tidx) {
+		/* superseded by the start of another table meanwhile */
+		mutex_unlock(&sw->lock);
+		return;
+	}
+	sw->timeout = ktime_add_ms(start, ACM_SCHEDULER_SWITCH_TIMEOUT_MSECS);
+	sw->event.start = ktime_to_acmdrv_timespec64(start);
+	sw->event.start_subns = table->subns;
+	sw->event.slip = slip;
+	mutex_unlock(&sw->lock);
+
+	mod_delayed_work(system_wq, &sw->dwork,
+			 delay > 0 ? msecs_to_jiffies(delay) : 0);
+}
+
+/**
+ * @brief Publish the result of a switch detection, sw->lock held
+ *
+ * The lock is released by this function.
+ */
+static void sched_switch_complete(struct sched_switch *sw, u16 status,
+				  ktime_t now)
+{
+	sw->event.seq++;
+	sw->event.status = status;
+	sw->event.pending = 0;
+	sw->event.detected = ktime_to_acmdrv_timespec64(now);
+	mutex_unlock(&sw->lock);
+
+	trace_acm_sched_switch(sw->sidx, sw->tidx, status,
+			       ktime_to_ns(now));
+	sysfs_notify(&sw->sched->acm->dev.kobj,
+		     __stringify(ACMDRV_SYSFS_CONFIG_GROUP),
+		     "sched_switch_event");
+}
+
+/**
+ * @brief Fail the pending switch to a table whose start cannot be written
+ */
+static void sched_switch_fail(struct sched_table *table)
+{
+	struct scheduler *sched = table->work.sched;
+	struct sched_switch *sw = &sched->data[table->sidx].sw;
+
+	mutex_lock(&sw->lock);
+	if (!sw->event.pending || sw->tidx != table->tidx) {
+		mutex_unlock(&sw->lock);
+		return;
+	}
+	sched_switch_complete(sw, 0, scheduler_ktime_get_ptp(sched));
+}
+
+/**
+ * @brief Worker function for table switch detection
+ */
+static void sched_switch_worker_func(struct work_struct *work)
+{
+	struct sched_switch *sw =
+		container_of(work, struct sched_switch, dwork.work);
+	ktime_t now;
+	u16 status;
+
+	mutex_lock(&sw->lock);
+	if (!sw->event.pending) {
+		mutex_unlock(&sw->lock);
+		return;
+	}
+
+	status = scheduler_read_table_status(sw->sched, sw->sidx, sw->tidx);
+	now = scheduler_ktime_get_ptp(sw->sched);
+
+	if (!(status & TBL_GEN_IN_USE) && ktime_before(now, sw->timeout)) {
+		mutex_unlock(&sw->lock);
+		mod_delayed_work(system_wq, &sw->dwork,
+			msecs_to_jiffies(ACM_SCHEDULER_SWITCH_POLL_MSECS));
+		return;
+	}
+
+	sched_switch_complete(sw, status, now);
+}
+
+/**
+ * @brief read last table switch event of a scheduler
+ */
+void scheduler_read_switch_event(struct scheduler *sched, int sidx,
+				 struct acmdrv_sched_switch_event *event)
+{
+	struct sched_switch *sw;
+
+	if (sidx >= ACMDRV_SCHEDULER_COUNT) {
+		dev_err(acm_dev(sched->acm),
+			"%s: scheduler index out of range: %d\n", __func__,
+			sidx);
+		memset(event, 0, sizeof(*event));
+		return;
+	}
+
+	sw = &sched->data[sidx].sw;
+	mutex_lock(&sw->lock);
+	*event = sw->event;
+	mutex_unlock(&sw->lock);
+}
+
+/**
+ * @brief offset of a number of cycles with sub-nanosecond cycle time
+ *
+ * @param n number of cycles
+ * @param cycle_time cycle time
+ * @param subns returns the sub-nanoseconds of the offset
+ * @return offset in whole nanoseconds
+ */
+static u64 sched_cycle_offset(u64 n,
+			      const struct acmdrv_sched_cycle_time *cycle_time,
+			      u32 *subns)
+{
+	const u64 mask = BIT_ULL(ACM_SCHEDULER_SUBNS_SHIFT) - 1;
+
+	*subns = ((n & mask) * cycle_time->subns) & mask;
+
+	return n * cycle_time->ns +
+		mul_u64_u32_shr(n, cycle_time->subns,
+				ACM_SCHEDULER_SUBNS_SHIFT);
+}
+
+/**
+ * @brief advance start by whole cycles until it is not before earliest
+ *
+ * Cycles are counted including their sub-nanoseconds, so the adjusted start
+ * keeps the phase of the requested one. As the hardware start time has no
+ * sub-nanoseconds, the start is rounded down to whole nanoseconds and the
+ * fraction is returned in subns.
+ *
+ * @return adjusted start, KTIME_MAX if the cycle time is not set
+ */
+static ktime_t sched_start_align(struct sched_table *table, ktime_t start,
+				 ktime_t earliest, u32 *subns)
+{
+	struct acmdrv_sched_cycle_time cycle_time;
+	u64 delta, offset, n, step;
+
+	*subns = 0;
+	if (!ktime_before(start, earliest))
+		return start;
+
+	read_cycle_time(table, &cycle_time);
+	if (cycle_time.ns == 0)
+		return KTIME_MAX;
 
 	/*
-	 * do not write start time directly, but support the scheduler's
-	 * start time window.
+	 * A cycle is at least ns and less than ns + 1 nanoseconds long, so
+	 * stepping by (delta - offset) / (ns + 1) cycles never overshoots
+	 * and converges within a few iterations.
 	 */
-	start = timespec64_to_ktime(table->time);
+	delta = ktime_to_ns(ktime_sub(earliest, start));
+	n = 0;
+	offset = 0;
+	while (offset < delta) {
+		step = div64_u64(delta - offset, (u64)cycle_time.ns + 1);
+		n += step ? step : 1;
+		offset = sched_cycle_offset(n, &cycle_time, subns);
+	}
 
-	if (ktime_before(start, now)) {
-		/* start is in the past */
-		struct acmdrv_sched_cycle_time cycle_time;
-		ktime_t delta = ktime_sub(now, start);
-		s64 count;
+	return ktime_add_ns(start, offset);
+}
 
-		read_cycle_time(table, &cycle_time);
+/**
+ * @brief Write schedule start time or arm the timer for a later write
+ *
+ * The start time is written immediately if it is within the reach of the
+ * hardware start time register, otherwise the timer is armed to retry
+ * once it is. A start time closer than the programming margin or in the
+ * past is advanced by whole cycles.
+ */
+static void write_start_time_execute(struct sched_table *table)
+{
+	ktime_t requested, start, earliest, now;
+	s64 lead, slip;
+	u32 subns;
 
-		/* FIXME: support subns */
-		if (cycle_time.subns != 0)
-			pr_warn("%s(%p): Cycle time sub nanoseconds ignored",
-				__func__, table);
+	now = scheduler_ktime_get_ptp(table->work.sched);
 
-		if (cycle_time.ns == 0) {
-			pr_err("%s(%p): Cycle time on not set", __func__,
-				table);
-			return;
-		}
-		count = ktime_divns(delta, cycle_time.ns) + 1;
-		start = ktime_add_ns(start, count * cycle_time.ns);
+	pr_debug("%s(%p): PTP time: %lld.%09lu\n", __func__, table,
+		ktime_to_timespec64(now).tv_sec,
+		ktime_to_timespec64(now).tv_nsec);
 
+	requested = timespec64_to_ktime(table->requested);
+	earliest = ktime_add_ns(now, ACM_SCHEDULER_START_MARGIN_NSECS);
+	start = sched_start_align(table, requested, earliest, &subns);
+	if (start == KTIME_MAX) {
+		pr_err("%s(%p): Cycle time on not set", __func__, table);
+		if (table->trigger)
+			sched_switch_fail(table);
+		return;
+	}
+	if (start != requested)
 		pr_debug("%s(%p): Start adjusted: %lld.%09lu\n",
 			__func__, table, ktime_to_timespec64(start).tv_sec,
 			ktime_to_timespec64(start).tv_nsec);
-	}
-
-	future_msecs = ktime_ms_delta(start, now);
 
-	if (future_msecs > ACM_SCHEDULER_MAX_FUTURE_MSECS) {
+	lead = ktime_to_ns(ktime_sub(start, now));
+	if (lead > ms_to_ktime(ACM_SCHEDULER_MAX_FUTURE_MSECS)) {
 		/* Too far away in the future to be handled now. */
-		future_msecs = do_div(future_msecs,
-			ACM_SCHEDULER_MAX_FUTURE_MSECS);
+		lead -= ms_to_ktime(ACM_SCHEDULER_MAX_FUTURE_MSECS);
 
 		pr_info("%s(%p): Delaying write start time for %lld milliseconds\n",
-			__func__, table, future_msecs);
-		mod_delayed_work(system_wq, &table->work.dwork,
-			msecs_to_jiffies(future_msecs));
+			__func__, table, div_s64(lead, NSEC_PER_MSEC));
+		hrtimer_start(&table->work.timer, ns_to_ktime(lead),
+			      HRTIMER_MODE_REL);
 
 		return;
 	}
 
 	table->time = ktime_to_timespec64(start);
+	table->subns = subns;
+	slip = ktime_to_ns(ktime_sub(start, requested));
 
 	write_start_time(table);
+
+	now = scheduler_ktime_get_ptp(table->work.sched);
+	if (!ktime_before(now, start))
+		pr_warn("%s(%p): Start time %lld.%09lu written late: %lld.%09lu\n",
+			__func__, table, table->time.tv_sec,
+			table->time.tv_nsec, ktime_to_timespec64(now).tv_sec,
+			ktime_to_timespec64(now).tv_nsec);
+
+	trace_acm_sched_start(table->sidx, table->tidx,
+			      ktime_to_ns(requested), ktime_to_ns(start),
+			      subns, slip);
+	if (table->trigger)
+		sched_switch_arm(table, start, now, slip);
 	write_start_time_done(table);
 }
 
+/**
+ * @brief Timer function for delayed schedule start time write
+ */
+static enum hrtimer_restart write_start_time_timer_func(struct hrtimer *timer)
+{
+	struct sched_table *table =
+		container_of(timer, struct sched_table, work.timer);
+
+	queue_work(system_highpri_wq, &table->work.work);
+
+	return HRTIMER_NORESTART;
+}
+
 /**
  * @brief Worker function for delayed schedule start time write
  */
 static void write_start_time_worker_func(struct work_struct *work)
 {
 	struct sched_table *table =
-		container_of(work, struct sched_table, work.dwork.work);
+		container_of(work, struct sched_table, work.work);
 
 	pr_debug("%s(%p)\n", __func__, table);
 
@@ -376,8 +685,12 @@ void scheduler_write_sched_down_counter(struct scheduler *sched, int sidx,
 #define WAIT_TABLE_ROW_DELAY	4
 /**
  * @brief wait for a table row transfer to finish
+ *
+ * @param scheduler scheduler instance
+ * @param retries number of retries needed is stored here
+ * @return 0 on success, -ETIMEDOUT if the transfer did not finish
  */
-static int _wait_table_row_transfer(struct scheduler *scheduler)
+static int _wait_table_row_transfer(struct scheduler *scheduler, int *retries)
 {
 	int i;
 	u16 cmd0;
@@ -386,7 +699,7 @@ static int _wait_table_row_transfer(struct scheduler *scheduler)
 	for (i = 0; i < WAIT_TABLE_ROW_RETRY; ++i) {
 		bool in_xfer;
 
-		cmd0 = readw(SCHED_COMMON(scheduler, ROW_ACCESS_CMD0));
+		cmd0 = acm_readw(SCHED_COMMON(scheduler, ROW_ACCESS_CMD0));
 		in_xfer = read_bitmask16(&cmd0, CMD0_TRANSFER);
 
 		if (in_xfer)
@@ -395,6 +708,7 @@ static int _wait_table_row_transfer(struct scheduler *scheduler)
 			break;
 	}
 
+	*retries = i;
 	if (i < WAIT_TABLE_ROW_RETRY)
 		return 0;
 
@@ -409,6 +723,8 @@ int __must_check scheduler_read_table_row(struct scheduler *scheduler,
 					  struct acmdrv_sched_tbl_row *row)
 {
 	int ret;
+	int retries;
+	u64 start;
 	u16 cmd1 = 0;
 	u16 cmd0 = 0;
 
@@ -439,23 +755,27 @@ int __must_check scheduler_read_table_row(struct scheduler *scheduler,
 		return ret;
 
 	/* trigger read */
+	start = acm_latency_start();
 	write_bitmask16(row_id, &cmd1, CMD1_ROW_NUMBER);
-	writew(cmd1, SCHED_COMMON(scheduler, ROW_ACCESS_CMD1));
+	acm_writew(cmd1, SCHED_COMMON(scheduler, ROW_ACCESS_CMD1));
 	write_bitmask16(sched_id, &cmd0, CMD0_SCHEDULER);
 	write_bitmask16(tab_id, &cmd0, CMD0_TABLE);
 	write_bitmask16(0, &cmd0, CMD0_WRITE);
 	write_bitmask16(1, &cmd0, CMD0_TRANSFER);
-	writew(cmd0, SCHED_COMMON(scheduler, ROW_ACCESS_CMD0));
+	acm_writew(cmd0, SCHED_COMMON(scheduler, ROW_ACCESS_CMD0));
 
-	ret = _wait_table_row_transfer(scheduler);
+	ret = _wait_table_row_transfer(scheduler, &retries);
 	if (ret)
 		goto out;
 
-	row->cmd = (readw(SCHED_COMMON(scheduler, ROW_ACCESS_DATA1)) << 16)
-			+ readw(SCHED_COMMON(scheduler, ROW_ACCESS_DATA0));
-	row->delta_cycle = readw(SCHED_COMMON(scheduler, ROW_ACCESS_DATA4));
+	row->cmd = (acm_readw(SCHED_COMMON(scheduler, ROW_ACCESS_DATA1)) << 16)
+			+ acm_readw(SCHED_COMMON(scheduler, ROW_ACCESS_DATA0));
+	row->delta_cycle = acm_readw(SCHED_COMMON(scheduler, ROW_ACCESS_DATA4));
 
 out:
+	acm_latency_record(scheduler->acm, ACM_LAT_SCHED_ROW_XFER, start);
+	trace_acm_sched_row_transfer(sched_id, tab_id, row_id, false, retries,
+				     acm_latency_start() - start, ret);
 	mutex_unlock(&scheduler->data[sched_id].table[tab_id].table_row_lock);
 	return ret;
 }
@@ -468,6 +788,8 @@ int __must_check scheduler_write_table_row(struct scheduler *scheduler,
 		const struct acmdrv_sched_tbl_row *row)
 {
 	int ret;
+	int retries;
+	u64 start;
 	u16 cmd1 = 0;
 	u16 cmd0 = 0;
 
@@ -497,21 +819,26 @@ int __must_check scheduler_write_table_row(struct scheduler *scheduler,
 	if (ret)
 		return ret;
 
-	writew(low_16bits(row->cmd), SCHED_COMMON(scheduler, ROW_ACCESS_DATA0));
-	writew(high_16bits(row->cmd),
-	       SCHED_COMMON(scheduler, ROW_ACCESS_DATA1));
-	writew(row->delta_cycle, SCHED_COMMON(scheduler, ROW_ACCESS_DATA4));
+	start = acm_latency_start();
+	acm_writew(low_16bits(row->cmd),
+		   SCHED_COMMON(scheduler, ROW_ACCESS_DATA0));
+	acm_writew(high_16bits(row->cmd),
+		   SCHED_COMMON(scheduler, ROW_ACCESS_DATA1));
+	acm_writew(row->delta_cycle, SCHED_COMMON(scheduler, ROW_ACCESS_DATA4));
 
 	write_bitmask16(row_id, &cmd1, CMD1_ROW_NUMBER);
-	writew(cmd1, SCHED_COMMON(scheduler, ROW_ACCESS_CMD1));
+	acm_writew(cmd1, SCHED_COMMON(scheduler, ROW_ACCESS_CMD1));
 
 	write_bitmask16(sched_id, &cmd0, CMD0_SCHEDULER);
 	write_bitmask16(tab_id, &cmd0, CMD0_TABLE);
 	write_bitmask16(1, &cmd0, CMD0_WRITE);
 	write_bitmask16(1, &cmd0, CMD0_TRANSFER);
-	writew(cmd0, SCHED_COMMON(scheduler, ROW_ACCESS_CMD0));
+	acm_writew(cmd0, SCHED_COMMON(scheduler, ROW_ACCESS_CMD0));
 
-	ret = _wait_table_row_transfer(scheduler);
+	ret = _wait_table_row_transfer(scheduler, &retries);
+	acm_latency_record(scheduler->acm, ACM_LAT_SCHED_ROW_XFER, start);
+	trace_acm_sched_row_transfer(sched_id, tab_id, row_id, true, retries,
+				     acm_latency_start() - start, ret);
 
 	mutex_unlock(&scheduler->data[sched_id].table[tab_id].table_row_lock);
 	return ret;
@@ -726,12 +1053,24 @@ void scheduler_write_emergency_disable(struct scheduler *sched,
 
 
 /**
- * @brief entire scheduler module cleanup/initialization of hardware
+ * @brief cleanup/initialization of a single scheduler's hardware
+ *
+ * A minimal schedule is started on an unused table, which is executed once
+ * only. Afterwards all other tables of the scheduler are nulled.
+ *
+ * @param scheduler scheduler instance
+ * @param sidx index of scheduler to clean up
  */
-void scheduler_cleanup(struct scheduler *scheduler)
+void scheduler_cleanup_sched(struct scheduler *scheduler, int sidx)
 {
 	int ret;
-	int sidx;
+	int tidx;
+	int i, j;
+	u16 tbl_gen;
+	ktime_t now;
+	struct timespec64 starttime;
+	struct sched_table *table;
+	struct sched_data *data;
 
 	const int min_delta_cycle = 8;
 	const struct acmdrv_sched_tbl_row stop_row = {
@@ -749,113 +1088,117 @@ void scheduler_cleanup(struct scheduler *scheduler)
 		.ns = 1000 / read_clk_freq(scheduler) * min_delta_cycle
 	};
 
+	if (sidx < 0 || sidx >= ARRAY_SIZE(scheduler->data)) {
+		dev_err(acm_dev(scheduler->acm),
+			"%s: scheduler index out of range: %d\n", __func__,
+			sidx);
+		return;
+	}
+	data = &scheduler->data[sidx];
 
-	for (sidx = 0; sidx < ARRAY_SIZE(scheduler->data); ++sidx) {
-		int tidx;
-		int i, j;
-		u16 tbl_gen;
-		ktime_t now;
-		struct timespec64 starttime;
-		struct sched_table *table;
-		struct sched_data *data = &scheduler->data[sidx];
-
-		/* find unused table */
-		for (tidx = 0; tidx < ACMDRV_SCHED_TBL_COUNT; ++tidx) {
-			u16 status;
-
-			status = scheduler_read_table_status(scheduler, sidx,
-							     tidx);
-			if (!(status & TBL_GEN_IN_USE))
-				break;
-		}
+	/* find unused table */
+	for (tidx = 0; tidx < ACMDRV_SCHED_TBL_COUNT; ++tidx) {
+		u16 status;
 
-		if (tidx >= ACMDRV_SCHED_TBL_COUNT) {
-			dev_err(acm_dev(scheduler->acm),
-				"%s: Cannot find unused scheduling table(%d)\n",
-				__func__, sidx);
-			continue;
-		}
+		status = scheduler_read_table_status(scheduler, sidx, tidx);
+		if (!(status & TBL_GEN_IN_USE))
+			break;
+	}
 
-		dev_dbg(acm_dev(scheduler->acm),
-			"%s: Using table %d for scheduler %d\n", __func__, tidx,
-			sidx);
+	if (tidx >= ACMDRV_SCHED_TBL_COUNT) {
+		dev_err(acm_dev(scheduler->acm),
+			"%s: Cannot find unused scheduling table(%d)\n",
+			__func__, sidx);
+		return;
+	}
+
+	dev_dbg(acm_dev(scheduler->acm),
+		"%s: Using table %d for scheduler %d\n", __func__, tidx, sidx);
 
 
-		/* write stop row entry to scheduling table */
-		ret = scheduler_write_table_row(scheduler, sidx, tidx, 0,
-						&stop_row);
+	/* write stop row entry to scheduling table */
+	ret = scheduler_write_table_row(scheduler, sidx, tidx, 0, &stop_row);
+	if (ret)
+		dev_err(acm_dev(scheduler->acm),
+			"scheduler_write_table_row(%d, %d, 0) failed: %d",
+			sidx, tidx, ret);
+	/* set the rest of the table to null */
+	for (i = 1; i < ACMDRV_SCHED_TBL_ROW_COUNT; ++i) {
+		ret = scheduler_write_table_row(scheduler, sidx, tidx, i,
+						&nullrow);
 		if (ret)
 			dev_err(acm_dev(scheduler->acm),
-				"scheduler_write_table_row(%d, %d, 0) failed: %d",
-				sidx, tidx, ret);
-		/* set the rest of the table to null */
-		for (i = 1; i < ACMDRV_SCHED_TBL_ROW_COUNT; ++i) {
-			ret = scheduler_write_table_row(scheduler, sidx,
-							tidx, i, &nullrow);
-			if (ret)
-				dev_err(acm_dev(scheduler->acm),
-					"scheduler_write_table_row(%d, %d, %d) failed: %d",
-					sidx, tidx, i, ret);
-		}
+				"scheduler_write_table_row(%d, %d, %d) failed: %d",
+				sidx, tidx, i, ret);
+	}
 
-		/* set minimal cycle time */
-		scheduler_write_cycle_time(scheduler, sidx, tidx,
-			&cycletime);
+	/* set minimal cycle time */
+	scheduler_write_cycle_time(scheduler, sidx, tidx, &cycletime);
 
-		/* set start time to start immediately */
-		now = edgx_ktime_get_worker_ptp(scheduler->frtc);
-		starttime = ktime_to_timespec64(now);
+	/* set start time to start immediately */
+	now = scheduler_ktime_get_ptp(scheduler);
+	starttime = ktime_to_timespec64(now);
 
-		dev_dbg(acm_dev(scheduler->acm),
-			"%s/ST%d:%d: PTP time: %lld.%09ld\n", __func__,
-			sidx, tidx, starttime.tv_sec, starttime.tv_nsec);
+	dev_dbg(acm_dev(scheduler->acm),
+		"%s/ST%d:%d: PTP time: %lld.%09ld\n", __func__,
+		sidx, tidx, starttime.tv_sec, starttime.tv_nsec);
 
-		ret = scheduler_write_start_time_sync(scheduler, sidx, tidx,
-			&starttime, false, 1000);
-		if (ret != 0) {
-			dev_err(acm_dev(scheduler->acm),
-				"%s: scheduler_write_start_time_sync(%d, %d) failed: %d",
-				__func__, sidx, tidx, ret);
-			continue;
-		}
+	ret = scheduler_write_start_time_sync(scheduler, sidx, tidx,
+		&starttime, false, 1000);
+	if (ret != 0) {
+		dev_err(acm_dev(scheduler->acm),
+			"%s: scheduler_write_start_time_sync(%d, %d) failed: %d",
+			__func__, sidx, tidx, ret);
+		return;
+	}
 
-		table = &data->table[tidx];
+	table = &data->table[tidx];
 
-		/* we only schedule once */
-		writew(1, SCHED_TABLE(table, LAST_CYCLE));
+	/* we only schedule once */
+	writew(1, SCHED_TABLE(table, LAST_CYCLE));
 
-		/* enable last cycle and start schedule */
-		tbl_gen = readw(SCHED_TABLE(table, TBL_GEN));
-		tbl_gen |= TBL_GEN_CAN_BE_TAKEN;
-		tbl_gen |= TBL_GEN_LAST_CYC_NR_EN;
-		writew(tbl_gen, SCHED_TABLE(table, TBL_GEN));
-		pr_debug("%s(%p): Schedule started\n", __func__, table);
+	/* enable last cycle and start schedule */
+	tbl_gen = readw(SCHED_TABLE(table, TBL_GEN));
+	tbl_gen |= TBL_GEN_CAN_BE_TAKEN;
+	tbl_gen |= TBL_GEN_LAST_CYC_NR_EN;
+	writew(tbl_gen, SCHED_TABLE(table, TBL_GEN));
+	pr_debug("%s(%p): Schedule started\n", __func__, table);
 
-		/* wait until table has been activated and last cycle reached */
-		do {
-			tbl_gen = readw(SCHED_TABLE(table, TBL_GEN));
-			cond_resched();
-		} while ((tbl_gen & (TBL_GEN_IN_USE | TBL_GEN_LAST_CYC_REACHED))
-			!= (TBL_GEN_IN_USE | TBL_GEN_LAST_CYC_REACHED));
-		pr_debug("%s(%p): Last cycle reached, tbl_gen: 0x%04x\n",
-			__func__, table, tbl_gen);
-
-		/* finally null the other scheduling tables */
-		for (i = 0; i < ACMDRV_SCHED_TBL_COUNT; ++i) {
-			if (i == tidx)
-				continue;
-			for (j = 0; j < ACMDRV_SCHED_TBL_ROW_COUNT; ++j) {
-				ret = scheduler_write_table_row(scheduler, sidx,
-					i, j, &nullrow);
-				if (ret)
-					dev_err(acm_dev(scheduler->acm),
-						"scheduler_write_table_row(%d, %d, %d) failed: %d",
-						sidx, i, j, ret);
-			}
+	/* wait until table has been activated and last cycle reached */
+	do {
+		tbl_gen = readw(SCHED_TABLE(table, TBL_GEN));
+		cond_resched();
+	} while ((tbl_gen & (TBL_GEN_IN_USE | TBL_GEN_LAST_CYC_REACHED))
+		!= (TBL_GEN_IN_USE | TBL_GEN_LAST_CYC_REACHED));
+	pr_debug("%s(%p): Last cycle reached, tbl_gen: 0x%04x\n",
+		__func__, table, tbl_gen);
+
+	/* finally null the other scheduling tables */
+	for (i = 0; i < ACMDRV_SCHED_TBL_COUNT; ++i) {
+		if (i == tidx)
+			continue;
+		for (j = 0; j < ACMDRV_SCHED_TBL_ROW_COUNT; ++j) {
+			ret = scheduler_write_table_row(scheduler, sidx, i, j,
+							&nullrow);
+			if (ret)
+				dev_err(acm_dev(scheduler->acm),
+					"scheduler_write_table_row(%d, %d, %d) failed: %d",
+					sidx, i, j, ret);
 		}
 	}
 }
 
+/**
+ * @brief entire scheduler module cleanup/initialization of hardware
+ */
+void scheduler_cleanup(struct scheduler *scheduler)
+{
+	int sidx;
+
+	for (sidx = 0; sidx < ARRAY_SIZE(scheduler->data); ++sidx)
+		scheduler_cleanup_sched(scheduler, sidx);
+}
+
 /**
  * @brief activate/deactivate scheduler
  */
@@ -881,16 +1224,21 @@ static void scheduler_data_table_init(struct scheduler *sched,
 	struct sched_table *table = &data->table[idx];
 
 	table->base = data->base + ACM_SCHEDULER_SCHED_TAB(idx);
+	table->sidx = data - sched->data;
+	table->tidx = idx;
 
 	mutex_init(&table->table_row_lock);
 	mutex_init(&table->cycle_time_lock);
 
+	table->requested = (struct timespec64){ 0, 0 };
 	table->time = (struct timespec64){ 0, 0 };
+	table->subns = 0;
 	table->trigger = false;
 	init_completion(&table->complete);
 	table->work.sched = sched;
-	INIT_DELAYED_WORK(&table->work.dwork,
-			write_start_time_worker_func);
+	hrtimer_init(&table->work.timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	table->work.timer.function = write_start_time_timer_func;
+	INIT_WORK(&table->work.work, write_start_time_worker_func);
 	mutex_init(&table->lock);
 }
 
@@ -901,7 +1249,7 @@ static void scheduler_data_table_exit(struct sched_data *data, int idx)
 {
 	struct sched_table *table = &data->table[idx];
 
-	cancel_delayed_work_sync(&table->work.dwork);
+	write_start_time_cancel(table);
 	complete_all(&table->complete);
 }
 
@@ -918,6 +1266,11 @@ static void scheduler_data_init(struct scheduler *sched, int idx)
 
 	for (i = 0; i < ARRAY_SIZE(data->table); ++i)
 		scheduler_data_table_init(sched, data, i);
+
+	data->sw.sched = sched;
+	data->sw.sidx = idx;
+	mutex_init(&data->sw.lock);
+	INIT_DELAYED_WORK(&data->sw.dwork, sched_switch_worker_func);
 }
 
 /**
@@ -930,6 +1283,8 @@ static void scheduler_data_exit(struct scheduler *sched, int idx)
 
 	for (i = 0; i < ARRAY_SIZE(data->table); ++i)
 		scheduler_data_table_exit(data, i);
+
+	cancel_delayed_work_sync(&data->sw.dwork);
 }
 
 /**
@@ -956,9 +1311,9 @@ int __must_check scheduler_init(struct acm *acm)
 	pr_warn("Scheduler probe platform_get_resource_byname\n");
 	mdelay(5);
 	res = platform_get_resource_byname(pdev, IORESOURCE_MEM, "Scheduler");
-	pr_warn("Scheduler probe devm_ioremap_resource\n");
+	pr_warn("Scheduler probe acm_ioremap_resource\n");
 	mdelay(5);
-	scheduler->base = devm_ioremap_resource(dev, res);
+	scheduler->base = acm_ioremap_resource(dev, res);
 	pr_warn("Scheduler probe base addr:%p\n", scheduler->base);
 	mdelay(5);
 	if (IS_ERR(scheduler->base))
@@ -973,18 +1328,21 @@ int __must_check scheduler_init(struct acm *acm)
 	pr_warn("Scheduler probe of_parse_phandle\n");
 	mdelay(5);
 
-	ptp_node = of_parse_phandle(np, "ptp_worker", 0);
-	if (!ptp_node) {
-		pr_warn("Mandatory ptp_worker not defined");
-		return -EINVAL;
-	}
-	dev_dbg(dev, "Scheduler probe of_find_device_by_node\n");
-	mdelay(5);
+	/* an emulated ACM uses CLOCK_TAI instead of a PTP worker clock */
+	if (!emu_is_emulated(dev)) {
+		ptp_node = of_parse_phandle(np, "ptp_worker", 0);
+		if (!ptp_node) {
+			pr_warn("Mandatory ptp_worker not defined");
+			return -EINVAL;
+		}
+		dev_dbg(dev, "Scheduler probe of_find_device_by_node\n");
+		mdelay(5);
 
-	scheduler->frtc = of_find_device_by_node(ptp_node);
-	/* defer probing until deipce got loaded */
-	if (!scheduler->frtc)
-		return -EPROBE_DEFER;
+		scheduler->frtc = of_find_device_by_node(ptp_node);
+		/* defer probing until deipce got loaded */
+		if (!scheduler->frtc)
+			return -EPROBE_DEFER;
+	}
 
 	/*
 	 * Issue 680: The emergency Status register
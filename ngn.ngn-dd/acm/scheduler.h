@@ -174,8 +174,11 @@ void scheduler_write_emergency_disable(struct scheduler *scheduler,
 				       int sched_id, u16 emerg_disable);
 
 void scheduler_set_active(struct scheduler *scheduler, int i, bool active);
+void scheduler_read_switch_event(struct scheduler *sched, int sidx,
+				 struct acmdrv_sched_switch_event *event);
 bool scheduler_get_active(struct scheduler *scheduler, int i);
 
+void scheduler_cleanup_sched(struct scheduler *scheduler, int sidx);
 void scheduler_cleanup(struct scheduler *scheduler);
 
 ktime_t scheduler_ktime_get_ptp(struct scheduler *scheduler);
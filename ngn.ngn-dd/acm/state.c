@@ -24,11 +24,13 @@
  *
  * @{
  */
+#include <linux/bitops.h>
 #include <linux/mutex.h>
 
 #include "acm-module.h"
 #include "state.h"
 #include "config.h"
+#include "bypass.h"
 
 /**
  * @brief ACM state handler instance
@@ -38,8 +40,27 @@ struct acm_state {
 
 	struct mutex lock;	/**< state access lock */
 	enum acmdrv_status status;	/**< ACM state */
+	unsigned long modules;	/**< modules of the configuration session */
+	unsigned long running;	/**< modules forwarding with their config */
+	/** message buffers referenced by the modules kept running */
+	u32 msgbufs[ACMDRV_BYPASS_MODULES_COUNT];
 };
 
+/**
+ * @brief remember the message buffers of the modules kept running
+ *
+ * Called before a configuration session of the modules selected by
+ * state->modules starts.
+ */
+static void acm_state_keep_modules(struct acm_state *state)
+{
+	int i;
+
+	for (i = 0; i < ACMDRV_BYPASS_MODULES_COUNT; ++i)
+		state->msgbufs[i] = test_bit(i, &state->modules) ? 0 :
+			bypass_msgbuf_usage(state->acm->bypass[i]);
+}
+
 /**
  * Getter method for ACM state
  */
@@ -62,19 +83,31 @@ int acm_state_set(struct acm_state *state, enum acmdrv_status status)
 
 	switch (status) {
 	case ACMDRV_CONFIG_START_STATE:
-		ret = acm_config_start(state->acm, &new_status);
+		acm_state_keep_modules(state);
+		WRITE_ONCE(state->running, state->running & ~state->modules);
+		ret = acm_config_start(state->acm, state->modules, &new_status);
 		break;
 	case ACMDRV_CONFIG_END_STATE:
-		ret = acm_config_end(state->acm, &new_status);
+		ret = acm_config_end(state->acm, state->modules, &new_status);
+		if (ret == 0) {
+			WRITE_ONCE(state->running,
+				   state->running | state->modules);
+			state->modules = ACMDRV_CONFIG_MODULES_ALL;
+		}
 		break;
 	case ACMDRV_DESYNC_STATE:
+		WRITE_ONCE(state->running, 0);
 		ret = acm_config_stop_running(state->acm, &new_status);
 		break;
 	case ACMDRV_RESTART_STATE:
 		ret = acm_config_restart_running(state->acm, &new_status);
+		if (ret == 0)
+			WRITE_ONCE(state->running, ACMDRV_CONFIG_MODULES_ALL);
 		break;
 	case ACMDRV_INIT_STATE:
 		new_status = status;
+		WRITE_ONCE(state->running, 0);
+		state->modules = ACMDRV_CONFIG_MODULES_ALL;
 		break;
 	default:
 		ret = -EINVAL;
@@ -89,6 +122,35 @@ int acm_state_set(struct acm_state *state, enum acmdrv_status status)
 	return ret;
 }
 
+/**
+ * Getter method for the modules of the configuration session
+ */
+unsigned long acm_state_get_modules(struct acm_state *state)
+{
+	return state->modules;
+}
+
+/**
+ * Setter method for the modules of the next configuration session
+ */
+int acm_state_set_modules(struct acm_state *state, unsigned long modules)
+{
+	int ret;
+
+	if (!modules || (modules & ~ACMDRV_CONFIG_MODULES_ALL))
+		return -EINVAL;
+
+	ret = mutex_lock_interruptible(&state->lock);
+	if (ret)
+		return ret;
+
+	state->modules = modules;
+
+	mutex_unlock(&state->lock);
+
+	return 0;
+}
+
 /**
  * check is ACM is in running state
  */
@@ -97,6 +159,29 @@ bool acm_state_is_running(struct acm_state *state)
 	return state->status == ACMDRV_RUN_STATE;
 }
 
+/**
+ * @brief check if a message buffer may be accessed
+ *
+ * Besides the running state of the ACM, this is the case for the message
+ * buffers referenced by a module which keeps running while another module
+ * is reconfigured.
+ */
+bool acm_state_msgbuf_is_running(struct acm_state *state, unsigned int idx)
+{
+	unsigned long running;
+	int i;
+
+	if (acm_state_is_running(state))
+		return true;
+
+	running = READ_ONCE(state->running);
+	for_each_set_bit(i, &running, ACMDRV_BYPASS_MODULES_COUNT)
+		if (state->msgbufs[i] & BIT(idx))
+			return true;
+
+	return false;
+}
+
 /**
  * @brief initialize ACM state handler
  */
@@ -114,6 +199,7 @@ int __must_check acm_state_init(struct acm *acm)
 
 	mutex_init(&state->lock);
 	state->status = ACMDRV_INIT_STATE;
+	state->modules = ACMDRV_CONFIG_MODULES_ALL;
 
 	acm->status = state;
 
@@ -26,7 +26,10 @@ struct acm_state;
 
 enum acmdrv_status acm_state_get(struct acm_state *state);
 int acm_state_set(struct acm_state *state, enum acmdrv_status status);
+unsigned long acm_state_get_modules(struct acm_state *state);
+int acm_state_set_modules(struct acm_state *state, unsigned long modules);
 
 bool acm_state_is_running(struct acm_state *state);
+bool acm_state_msgbuf_is_running(struct acm_state *state, unsigned int idx);
 
 #endif /* ACM_STATE_H_ */
@@ -453,13 +453,60 @@ static ssize_t config_state_write(struct file *file, struct kobject *kobj,
  */
 static BIN_ATTR_RW(config_state, sizeof(enum acmdrv_status));
 
+/**
+ * @brief read function for config_modules
+ */
+static ssize_t config_modules_read(struct file *file, struct kobject *kobj,
+				   struct bin_attribute *bin_attr, char *buf,
+				   loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, sizeof(u32));
+	if (ret)
+		return ret;
+
+	put_unaligned((u32)acm_state_get_modules(acm->status), (u32 *)buf);
+
+	return size;
+}
+
+/**
+ * @brief write function for config_modules
+ */
+static ssize_t config_modules_write(struct file *file, struct kobject *kobj,
+				    struct bin_attribute *bin_attr, char *buf,
+				    loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, sizeof(u32));
+	if (ret)
+		return ret;
+
+	ret = acm_state_set_modules(acm->status,
+				    get_unaligned((u32 *)buf));
+	if (ret)
+		return ret;
+
+	return size;
+}
+
+/**
+ * @brief Config attribute config_modules
+ */
+static BIN_ATTR_RW(config_modules, sizeof(u32));
+
 /**
  * @brief Read the message buffer descriptor(s)
  *
  * The first and last descriptors read are determined by off and count which
  * must be aligned to sizeof(msgbuf_desc_t). Furthermore the otherwise
  * unused reserv2 bit (Bit 30) is used to indicate time-stamping flag of the
- * corresponding message buffer character device.
+ * corresponding message buffer character device and the unused bit 18 to
+ * indicate its auto lock flag.
  *
  * @param file Standard parameter not used in here
  * @param kobj kernel object the attribute belongs to
@@ -498,6 +545,9 @@ static ssize_t msg_buff_desc_read(struct file *file, struct kobject *kobj,
 		*desc &= ~ACMDRV_BUFF_DESC_HAS_TIMESTAMP;
 		*desc |= acm_dev_get_timestamping(adev) ?
 			ACMDRV_BUFF_DESC_HAS_TIMESTAMP : 0;
+		*desc &= ~ACMDRV_BUFF_DESC_AUTO_LOCK;
+		*desc |= acm_dev_get_auto_lock(adev) ?
+			ACMDRV_BUFF_DESC_AUTO_LOCK : 0;
 	}
 	memcpy(buf, ((u8 *)&bounce[first]), size);
 
@@ -510,7 +560,8 @@ static ssize_t msg_buff_desc_read(struct file *file, struct kobject *kobj,
  * The first and last descriptors written are determined by off and count which
  * must be aligned to sizeof(msgbuf_desc_t). Furthermore the otherwise
  * unused reserv2 bit (Bit 30) is used to set/unset the time-stamping flag of
- * the corresponding message buffer character device.
+ * the corresponding message buffer character device and the unused bit 18
+ * to set/unset its auto lock flag.
  *
  * @param file Standard parameter not used in here
  * @param kobj kernel object the attribute belongs to
@@ -549,6 +600,10 @@ static ssize_t msg_buff_desc_write(struct file *file, struct kobject *kobj,
 			acm_dev_set_timestamping(adev, false);
 
 		*desc &= ~ACMDRV_BUFF_DESC_HAS_TIMESTAMP;
+
+		acm_dev_set_auto_lock(adev,
+				      !!(*desc & ACMDRV_BUFF_DESC_AUTO_LOCK));
+		*desc &= ~ACMDRV_BUFF_DESC_AUTO_LOCK;
 	}
 	ret = msgbuf_desc_write(acm->msgbuf, first, last, &bounce[first]);
 	if (ret)
@@ -1042,6 +1097,38 @@ static BIN_ATTR_RO(table_status, ACMDRV_SCHEDULER_COUNT *
 		   ACMDRV_SCHED_TBL_COUNT *
 		   sizeof(struct acmdrv_sched_tbl_status));
 
+/**
+ * @brief read function for sched_switch_event
+ */
+static ssize_t sched_switch_event_read(struct file *filp, struct kobject *kobj,
+				       struct bin_attribute *bin_attr,
+				       char *buf, loff_t off, size_t size)
+{
+	int ret;
+	unsigned int i;
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t elsize = sizeof(struct acmdrv_sched_switch_event);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, elsize);
+	if (ret)
+		return ret;
+
+	foreach_item(i, off, size, elsize) {
+		struct acmdrv_sched_switch_event event;
+
+		scheduler_read_switch_event(acm->scheduler, i, &event);
+		memcpy(buf, &event, elsize);
+		buf += elsize;
+	}
+	return size;
+}
+
+/**
+ * @brief Config attribute sched_switch_event
+ */
+static BIN_ATTR_RO(sched_switch_event, ACMDRV_SCHEDULER_COUNT *
+		   sizeof(struct acmdrv_sched_switch_event));
+
 /**
  * @brief read function for sched_cycle_time
  */
@@ -1246,6 +1333,98 @@ static ssize_t emergency_disable_write(struct file *filp, struct kobject *kobj,
 static BIN_ATTR_RW(emergency_disable, ACMDRV_SCHEDULER_COUNT *
 	sizeof(struct acmdrv_sched_emerg_disable));
 
+/**
+ * @brief read function for failover_policy
+ */
+static ssize_t failover_policy_read(struct file *filp, struct kobject *kobj,
+				    struct bin_attribute *bin_attr, char *buf,
+				    loff_t off, size_t size)
+{
+	int ret;
+	unsigned int i;
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t elsize = sizeof(struct acmdrv_failover_policy);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, elsize);
+	if (ret)
+		return ret;
+
+	foreach_item(i, off, size, elsize) {
+		struct acmdrv_failover_policy policy;
+
+		bypass_failover_read_policy(acm->bypass[i], &policy);
+		memcpy(buf, &policy, elsize);
+		buf += elsize;
+	}
+	return size;
+}
+
+/**
+ * @brief write function for failover_policy
+ */
+static ssize_t failover_policy_write(struct file *filp, struct kobject *kobj,
+				     struct bin_attribute *bin_attr,
+				     char *buf, loff_t off, size_t size)
+{
+	int ret;
+	unsigned int i;
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t elsize = sizeof(struct acmdrv_failover_policy);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, elsize);
+	if (ret)
+		return ret;
+
+	foreach_item(i, off, size, elsize) {
+		struct acmdrv_failover_policy policy;
+
+		memcpy(&policy, buf, elsize);
+		ret = bypass_failover_write_policy(acm->bypass[i], &policy);
+		if (ret)
+			return ret;
+		buf += elsize;
+	}
+	return size;
+}
+
+/**
+ * @brief Config attribute failover_policy
+ */
+static BIN_ATTR_RW(failover_policy, ACMDRV_BYPASS_MODULES_COUNT *
+		   sizeof(struct acmdrv_failover_policy));
+
+/**
+ * @brief read function for link_event
+ */
+static ssize_t link_event_read(struct file *filp, struct kobject *kobj,
+			       struct bin_attribute *bin_attr, char *buf,
+			       loff_t off, size_t size)
+{
+	int ret;
+	unsigned int i;
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t elsize = sizeof(struct acmdrv_link_event);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, elsize);
+	if (ret)
+		return ret;
+
+	foreach_item(i, off, size, elsize) {
+		struct acmdrv_link_event event;
+
+		bypass_failover_read_event(acm->bypass[i], &event);
+		memcpy(buf, &event, elsize);
+		buf += elsize;
+	}
+	return size;
+}
+
+/**
+ * @brief Config attribute link_event
+ */
+static BIN_ATTR_RO(link_event, ACMDRV_BYPASS_MODULES_COUNT *
+		   sizeof(struct acmdrv_link_event));
+
 /**
  * @brief read function for configuration_id
  */
@@ -1627,6 +1806,7 @@ static struct bin_attribute *config_attributes[] = {
 
 	/* State control */
 	&bin_attr_config_state,
+	&bin_attr_config_modules,
 
 	/* Message Buffer configuration */
 	&bin_attr_msg_buff_desc,
@@ -1649,6 +1829,7 @@ static struct bin_attribute *config_attributes[] = {
 	&bin_attr_sched_down_counter,
 	&bin_attr_sched_tab_row,
 	&bin_attr_table_status,
+	&bin_attr_sched_switch_event,
 	&bin_attr_sched_cycle_time,
 	&bin_attr_sched_start_table,
 	&bin_attr_emergency_disable,
@@ -1670,6 +1851,10 @@ static struct bin_attribute *config_attributes[] = {
 	&bin_attr_individual_recovery,
 	&bin_attr_base_recovery,
 
+	/* Failover on link changes */
+	&bin_attr_failover_policy,
+	&bin_attr_link_event,
+
 	NULL
 };
 
@@ -31,6 +31,7 @@
 
 #include "acm-module.h"
 #include "msgbuf.h"
+#include "cyclic.h"
 #include "commreg.h"
 #include "sysfs.h"
 #include "sysfs_control.h"
@@ -161,6 +162,162 @@ static ssize_t overwritten_read(struct file *filp, struct kobject *kobj,
 	return size;
 }
 
+/**
+ * @brief Attribute read function for cyclic_image
+ */
+static ssize_t cyclic_image_read(struct file *filp, struct kobject *kobj,
+				 struct bin_attribute *bin_attr, char *buf,
+				 loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, sizeof(u8));
+	if (ret)
+		return ret;
+
+	memcpy(buf, cyclic_image(acm->cyclic) + off, size);
+
+	return size;
+}
+
+/**
+ * @brief Attribute write function for cyclic_image
+ */
+static ssize_t cyclic_image_write(struct file *filp, struct kobject *kobj,
+				  struct bin_attribute *bin_attr, char *buf,
+				  loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, sizeof(u8));
+	if (ret)
+		return ret;
+
+	memcpy(cyclic_image(acm->cyclic) + off, buf, size);
+
+	return size;
+}
+
+/**
+ * @brief Attribute mmap function for cyclic_image
+ */
+static int cyclic_image_mmap(struct file *filp, struct kobject *kobj,
+			     struct bin_attribute *bin_attr,
+			     struct vm_area_struct *vma)
+{
+	struct acm *acm = kobj_to_acm(kobj);
+
+	return cyclic_image_map(acm->cyclic, vma);
+}
+
+/**
+ * @brief Attribute read function for cyclic_jobs
+ */
+static ssize_t cyclic_jobs_read(struct file *filp, struct kobject *kobj,
+				struct bin_attribute *bin_attr, char *buf,
+				loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t elsize = sizeof(struct acmdrv_cyclic_job);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, elsize);
+	if (ret)
+		return ret;
+
+	ret = cyclic_get_jobs(acm->cyclic, off / elsize,
+			      (off + size) / elsize - 1, buf);
+	if (ret)
+		return ret;
+
+	return size;
+}
+
+/**
+ * @brief Attribute write function for cyclic_jobs
+ */
+static ssize_t cyclic_jobs_write(struct file *filp, struct kobject *kobj,
+				 struct bin_attribute *bin_attr, char *buf,
+				 loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t elsize = sizeof(struct acmdrv_cyclic_job);
+
+	ret = sysfs_bin_attr_check(bin_attr, off, size, elsize);
+	if (ret)
+		return ret;
+
+	ret = cyclic_set_jobs(acm->cyclic, off / elsize,
+			      (off + size) / elsize - 1, buf);
+	if (ret)
+		return ret;
+
+	return size;
+}
+
+/**
+ * @brief Attribute read function for cyclic_control
+ */
+static ssize_t cyclic_control_read(struct file *filp, struct kobject *kobj,
+				   struct bin_attribute *bin_attr, char *buf,
+				   loff_t off, size_t size)
+{
+	struct acm *acm = kobj_to_acm(kobj);
+	struct acmdrv_cyclic_control control;
+
+	if ((off != 0) || size != sizeof(control))
+		return -EINVAL;
+
+	cyclic_get_control(acm->cyclic, &control);
+	memcpy(buf, &control, size);
+
+	return size;
+}
+
+/**
+ * @brief Attribute write function for cyclic_control
+ */
+static ssize_t cyclic_control_write(struct file *filp, struct kobject *kobj,
+				    struct bin_attribute *bin_attr, char *buf,
+				    loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+	struct acmdrv_cyclic_control control;
+
+	if ((off != 0) || size != sizeof(control))
+		return -EINVAL;
+
+	memcpy(&control, buf, size);
+	ret = cyclic_set_control(acm->cyclic, &control);
+	if (ret)
+		return ret;
+
+	return size;
+}
+
+/**
+ * @brief Attribute read function for cyclic_stats
+ */
+static ssize_t cyclic_stats_read(struct file *filp, struct kobject *kobj,
+				 struct bin_attribute *bin_attr, char *buf,
+				 loff_t off, size_t size)
+{
+	struct acm *acm = kobj_to_acm(kobj);
+	struct acmdrv_cyclic_stats stats;
+
+	if ((off != 0) || size != sizeof(stats))
+		return -EINVAL;
+
+	cyclic_get_stats(acm->cyclic, &stats);
+	memcpy(buf, &stats, size);
+
+	return size;
+}
+
 /**
  * @brief Control attribute lock_msg_bufs
  */
@@ -173,6 +330,23 @@ static BIN_ATTR_RW(unlock_msg_bufs, sizeof(struct acmdrv_msgbuf_lock_ctrl));
  * @brief Control attribute overwritten
  */
 static BIN_ATTR_RO(overwritten, 0 /* size set by init */);
+/**
+ * @brief Control attribute cyclic_image
+ */
+static BIN_ATTR_RW(cyclic_image, ACMDRV_CYCLIC_IMAGE_SIZE);
+/**
+ * @brief Control attribute cyclic_jobs
+ */
+static BIN_ATTR_RW(cyclic_jobs,
+		   ACMDRV_CYCLIC_JOBS_MAX * sizeof(struct acmdrv_cyclic_job));
+/**
+ * @brief Control attribute cyclic_control
+ */
+static BIN_ATTR_RW(cyclic_control, sizeof(struct acmdrv_cyclic_control));
+/**
+ * @brief Control attribute cyclic_stats
+ */
+static BIN_ATTR_RO(cyclic_stats, sizeof(struct acmdrv_cyclic_stats));
 
 /**
  * @brief sysfs attributes of control section
@@ -181,6 +355,10 @@ static struct bin_attribute *control_attributes[] = {
 	&bin_attr_lock_msg_bufs,
 	&bin_attr_unlock_msg_bufs,
 	&bin_attr_overwritten,
+	&bin_attr_cyclic_image,
+	&bin_attr_cyclic_jobs,
+	&bin_attr_cyclic_control,
+	&bin_attr_cyclic_stats,
 	NULL
 };
 
@@ -201,6 +379,7 @@ const struct attribute_group *sysfs_control_init(struct acm *acm)
 {
 	bin_attr_overwritten.size =
 		commreg_read_msgbuf_count(acm->commreg) * sizeof(u32);
+	bin_attr_cyclic_image.mmap = cyclic_image_mmap;
 
 	return &control_group;
 }
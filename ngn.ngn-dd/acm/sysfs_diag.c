@@ -35,6 +35,7 @@
 #include "sysfs_diag.h"
 #include "acm-module.h"
 #include "bypass.h"
+#include "redundancy.h"
 #include "sysfs.h"
 
 /**
@@ -76,6 +77,27 @@ static struct diag_bin_attribute diag_binattr_##_name##_M1 =	\
 				_size),				\
 }
 
+/**
+ * @def ACM_DIAG_BINATTR_RO
+ * @brief static initializer helper macro for read-only diag_bin_attribute
+ *
+ * @param _name base name of the attribute
+ * @param _size size of binary data
+ */
+#define ACM_DIAG_BINATTR_RO(_name, _size)			\
+static struct diag_bin_attribute diag_binattr_##_name##_M0 =	\
+{								\
+	.index		= 0,					\
+	.bin_attr	= __BIN_ATTR(_name##_M0, 0444,		\
+				_name##_read, NULL, _size),	\
+};								\
+static struct diag_bin_attribute diag_binattr_##_name##_M1 =	\
+{								\
+	.index		= 1,					\
+	.bin_attr	= __BIN_ATTR(_name##_M1, 0444,		\
+				_name##_read, NULL, _size),	\
+}
+
 /**
  * @def ACM_DIAG_ATTR_RW
  * @brief static initializer helper macro for struct diag_device_attribute
@@ -222,6 +244,171 @@ static ssize_t diag_poll_time_store(struct device *dev,
 	return count;
 }
 
+/**
+ * @brief Read function for FRER statistics
+ *
+ * The statistics have to be read at once.
+ *
+ * @param file Standard parameter not used in here
+ * @param kobj Kernel object the attribute belongs to
+ * @param bin_attr binary attribute given
+ * @param buf Data buffer to read into
+ * @param off Offset where to read the data from within the binary attribute
+ * @param size Amount of data to read
+ * @return Return number of bytes read into the buffer or negative error id
+ */
+static ssize_t redund_stats_read(struct file *file, struct kobject *kobj,
+	struct bin_attribute *bin_attr, char *buf, loff_t off, size_t size)
+{
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t data_size = sizeof(struct acmdrv_redun_stats);
+
+	if (size == 0)
+		return 0;
+
+	if (off != 0 || size < data_size)
+		return -EINVAL;
+
+	redundancy_stats_read(acm->redundancy, (void *)buf);
+
+	return data_size;
+}
+
+/**
+ * @brief write function for FRER statistics
+ *
+ * Any write access resets the statistics.
+ *
+ * @param file Standard parameter not used in here
+ * @param kobj Kernel object the attribute belongs to
+ * @param bin_attr Binary attribute given
+ * @param buf Data buffer to read from
+ * @param off Offset where to write the data from within the binary attribute
+ * @param size Amount of data to write
+ * @return Returns number of bytes written or negative error id
+ */
+static ssize_t redund_stats_write(struct file *file, struct kobject *kobj,
+	struct bin_attribute *bin_attr, char *buf, loff_t off, size_t size)
+{
+	struct acm *acm = kobj_to_acm(kobj);
+
+	redundancy_stats_reset(acm->redundancy);
+
+	return size;
+}
+
+/**
+ * @brief Read function for diagnostic counter thresholds
+ *
+ * The thresholds of a module have to be read at once.
+ *
+ * @param file Standard parameter not used in here
+ * @param kobj Kernel object the attribute belongs to
+ * @param bin_attr binary attribute given
+ * @param buf Data buffer to read into
+ * @param off Offset where to read the data from within the binary attribute
+ * @param size Amount of data to read
+ * @return Return number of bytes read into the buffer or negative error id
+ */
+static ssize_t diag_thresholds_read(struct file *file, struct kobject *kobj,
+	struct bin_attribute *bin_attr, char *buf, loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t data_size = sizeof(struct acmdrv_diag_thresholds);
+	struct diag_bin_attribute *diagnostics;
+
+	diagnostics = container_of(bin_attr, struct diag_bin_attribute,
+		bin_attr);
+
+	if (size == 0)
+		return 0;
+
+	if (off != 0 || size < data_size)
+		return -EINVAL;
+
+	ret = bypass_diag_read_thresholds(acm->bypass[diagnostics->index],
+					  (void *)buf);
+	if (ret)
+		return ret;
+
+	return data_size;
+}
+
+/**
+ * @brief write function for diagnostic counter thresholds
+ *
+ * The thresholds of a module have to be written at once.
+ *
+ * @param file Standard parameter not used in here
+ * @param kobj Kernel object the attribute belongs to
+ * @param bin_attr Binary attribute given
+ * @param buf Data buffer to read from
+ * @param off Offset where to write the data from within the binary attribute
+ * @param size Amount of data to write
+ * @return Returns number of bytes written or negative error id
+ */
+static ssize_t diag_thresholds_write(struct file *file, struct kobject *kobj,
+	struct bin_attribute *bin_attr, char *buf, loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t data_size = sizeof(struct acmdrv_diag_thresholds);
+	struct diag_bin_attribute *diagnostics;
+
+	diagnostics = container_of(bin_attr, struct diag_bin_attribute,
+		bin_attr);
+
+	if (off != 0 || size != data_size)
+		return -EINVAL;
+
+	ret = bypass_diag_write_thresholds(acm->bypass[diagnostics->index],
+					   (void *)buf);
+	if (ret)
+		return ret;
+
+	return size;
+}
+
+/**
+ * @brief Read function for diagnostic threshold breaches
+ *
+ * The breaches of a module have to be read at once. Reading clears the
+ * breached rule bitmasks.
+ *
+ * @param file Standard parameter not used in here
+ * @param kobj Kernel object the attribute belongs to
+ * @param bin_attr binary attribute given
+ * @param buf Data buffer to read into
+ * @param off Offset where to read the data from within the binary attribute
+ * @param size Amount of data to read
+ * @return Return number of bytes read into the buffer or negative error id
+ */
+static ssize_t diag_alarm_read(struct file *file, struct kobject *kobj,
+	struct bin_attribute *bin_attr, char *buf, loff_t off, size_t size)
+{
+	int ret;
+	struct acm *acm = kobj_to_acm(kobj);
+	const size_t data_size = sizeof(struct acmdrv_diag_alarm);
+	struct diag_bin_attribute *diagnostics;
+
+	diagnostics = container_of(bin_attr, struct diag_bin_attribute,
+		bin_attr);
+
+	if (size == 0)
+		return 0;
+
+	if (off != 0 || size < data_size)
+		return -EINVAL;
+
+	ret = bypass_diag_read_alarm(acm->bypass[diagnostics->index],
+				     (void *)buf);
+	if (ret)
+		return ret;
+
+	return data_size;
+}
+
 /**
  * @brief Diagnostic binary attribute diagnostics
  */
@@ -232,12 +419,32 @@ ACM_DIAG_BINATTR_RW(diagnostics, sizeof(struct acmdrv_diagnostics));
  */
 ACM_DIAG_ATTR_RW(diag_poll_time);
 
+/**
+ * @brief Diagnostic binary attribute redund_stats
+ */
+static BIN_ATTR_RW(redund_stats, sizeof(struct acmdrv_redun_stats));
+
+/**
+ * @brief Diagnostic binary attribute diag_thresholds
+ */
+ACM_DIAG_BINATTR_RW(diag_thresholds, sizeof(struct acmdrv_diag_thresholds));
+
+/**
+ * @brief Diagnostic binary attribute diag_alarm
+ */
+ACM_DIAG_BINATTR_RO(diag_alarm, sizeof(struct acmdrv_diag_alarm));
+
 /**
  * @brief sysfs binary attributes of diagnostic section
  */
 static struct bin_attribute *diag_bin_attrs[] = {
 	&diag_binattr_diagnostics_M0.bin_attr,
 	&diag_binattr_diagnostics_M1.bin_attr,
+	&bin_attr_redund_stats,
+	&diag_binattr_diag_thresholds_M0.bin_attr,
+	&diag_binattr_diag_thresholds_M1.bin_attr,
+	&diag_binattr_diag_alarm_M0.bin_attr,
+	&diag_binattr_diag_alarm_M1.bin_attr,
 	NULL
 };
 
@@ -37,6 +37,7 @@
 #include "acmbitops.h"
 #include "commreg.h"
 #include "redundancy.h"
+#include "latency.h"
 
 /**
  * @brief Represents a register partitioned by bit fields
@@ -544,6 +545,27 @@ static ssize_t redund_frames_produced_M1_show(struct device *dev,
 				 1));
 }
 
+/**
+ * @brief Status attribute latency show function
+ */
+static ssize_t latency_show(struct device *dev,
+			    struct device_attribute *attr, char *buf)
+{
+	return acm_latency_print(dev_to_acm(dev), buf, PAGE_SIZE);
+}
+
+/**
+ * @brief Status attribute latency store function, any write resets
+ */
+static ssize_t latency_store(struct device *dev,
+			     struct device_attribute *attr,
+			     const char *buf, size_t count)
+{
+	acm_latency_reset(dev_to_acm(dev));
+
+	return count;
+}
+
 /* debug IP register interface */
 /**
  * @brief Status attribute rx_bytes
@@ -803,6 +825,13 @@ static DEVICE_VATTR_RO(msgbuf_count, ACM_IF_4_0, ACM_IF_DONT_CARE, false);
  */
 static DEVICE_VATTR_RO(msgbuf_datawidth, ACM_IF_4_0, ACM_IF_DONT_CARE, false);
 
+/**
+ * @brief Status attribute latency
+ */
+static struct visible_device_attribute vdev_attr_latency =
+	__VATTR(latency, 0644, latency_show, latency_store, ACM_IF_DONT_CARE,
+		ACM_IF_DONT_CARE, false);
+
 /**
  * @brief Status attributes for ACM IP
  */
@@ -851,6 +880,7 @@ static struct attribute *status_attributes[] = {
 	&vdev_attr_msgbuf_datawidth.dattr.attr,
 	&vdev_attr_redund_frames_produced_M0.dattr.attr,
 	&vdev_attr_redund_frames_produced_M1.dattr.attr,
+	&vdev_attr_latency.dattr.attr,
 	&status_attr_rx_bytes_M0.vattr.dattr.attr,
 	&status_attr_rx_bytes_M1.vattr.dattr.attr,
 	&status_attr_rx_frames_M0.vattr.dattr.attr,
@@ -0,0 +1,291 @@
+/* SPDX-License-Identifier: GPL-2.0
+ *
+ * TTTech ACM Linux driver
+ * Copyright(c) 2019 TTTech Industrial Automation AG.
+ *
+ * Contact Information:
+ * support@tttech-industrial.com
+ * TTTech Industrial Automation AG, Schoenbrunnerstrasse 7, 1040 Vienna, Austria
+ */
+/**
+ * @file trace.h
+ * @brief ACM Driver Tracepoints
+ *
+ * The events are available below /sys/kernel/debug/tracing/events/acm when
+ * the kernel supports tracing. All durations are given in nanoseconds.
+ */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM acm
+
+#if !defined(ACM_TRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#define ACM_TRACE_H_
+
+#include <linux/tracepoint.h>
+
+/**
+ * @brief message buffer access from/to user space
+ */
+TRACE_EVENT(acm_msgbuf_access,
+
+	TP_PROTO(int idx, bool write, size_t size, u64 duration, int ret),
+
+	TP_ARGS(idx, write, size, duration, ret),
+
+	TP_STRUCT__entry(
+		__field(int, idx)
+		__field(bool, write)
+		__field(size_t, size)
+		__field(u64, duration)
+		__field(int, ret)
+	),
+
+	TP_fast_assign(
+		__entry->idx = idx;
+		__entry->write = write;
+		__entry->size = size;
+		__entry->duration = duration;
+		__entry->ret = ret;
+	),
+
+	TP_printk("msgbuf=%d %s size=%zu duration=%llu ret=%d",
+		  __entry->idx, __entry->write ? "write" : "read",
+		  __entry->size, __entry->duration, __entry->ret)
+);
+
+/**
+ * @brief contended wait for a driver lock
+ */
+TRACE_EVENT(acm_lock_contended,
+
+	TP_PROTO(const char *lock, int idx, u64 wait),
+
+	TP_ARGS(lock, idx, wait),
+
+	TP_STRUCT__entry(
+		__string(lock, lock)
+		__field(int, idx)
+		__field(u64, wait)
+	),
+
+	TP_fast_assign(
+		__assign_str(lock, lock);
+		__entry->idx = idx;
+		__entry->wait = wait;
+	),
+
+	TP_printk("lock=%s idx=%d wait=%llu", __get_str(lock), __entry->idx,
+		  __entry->wait)
+);
+
+/**
+ * @brief scheduler table row transfer
+ */
+TRACE_EVENT(acm_sched_row_transfer,
+
+	TP_PROTO(int sched, int table, int row, bool write, int retries,
+		 u64 duration, int ret),
+
+	TP_ARGS(sched, table, row, write, retries, duration, ret),
+
+	TP_STRUCT__entry(
+		__field(int, sched)
+		__field(int, table)
+		__field(int, row)
+		__field(bool, write)
+		__field(int, retries)
+		__field(u64, duration)
+		__field(int, ret)
+	),
+
+	TP_fast_assign(
+		__entry->sched = sched;
+		__entry->table = table;
+		__entry->row = row;
+		__entry->write = write;
+		__entry->retries = retries;
+		__entry->duration = duration;
+		__entry->ret = ret;
+	),
+
+	TP_printk("sched=%d table=%d row=%d %s retries=%d duration=%llu ret=%d",
+		  __entry->sched, __entry->table, __entry->row,
+		  __entry->write ? "write" : "read", __entry->retries,
+		  __entry->duration, __entry->ret)
+);
+
+/**
+ * @brief start time written to a scheduler table
+ */
+TRACE_EVENT(acm_sched_start,
+
+	TP_PROTO(int sched, int table, s64 requested, s64 start, u32 subns,
+		 s64 slip),
+
+	TP_ARGS(sched, table, requested, start, subns, slip),
+
+	TP_STRUCT__entry(
+		__field(int, sched)
+		__field(int, table)
+		__field(s64, requested)
+		__field(s64, start)
+		__field(u32, subns)
+		__field(s64, slip)
+	),
+
+	TP_fast_assign(
+		__entry->sched = sched;
+		__entry->table = table;
+		__entry->requested = requested;
+		__entry->start = start;
+		__entry->subns = subns;
+		__entry->slip = slip;
+	),
+
+	TP_printk("sched=%d table=%d requested=%lld start=%lld subns=%u "
+		  "slip=%lld", __entry->sched, __entry->table, __entry->requested,
+		  __entry->start, __entry->subns, __entry->slip)
+);
+
+/**
+ * @brief detected switch to a started scheduler table
+ */
+TRACE_EVENT(acm_sched_switch,
+
+	TP_PROTO(int sched, int table, u16 status, s64 detected),
+
+	TP_ARGS(sched, table, status, detected),
+
+	TP_STRUCT__entry(
+		__field(int, sched)
+		__field(int, table)
+		__field(u16, status)
+		__field(s64, detected)
+	),
+
+	TP_fast_assign(
+		__entry->sched = sched;
+		__entry->table = table;
+		__entry->status = status;
+		__entry->detected = detected;
+	),
+
+	TP_printk("sched=%d table=%d status=0x%04x detected=%lld",
+		  __entry->sched, __entry->table, __entry->status,
+		  __entry->detected)
+);
+
+/**
+ * @brief update of the diagnostics cache of a bypass module
+ */
+TRACE_EVENT(acm_diag_update,
+
+	TP_PROTO(int module, int retries, u64 duration, int ret),
+
+	TP_ARGS(module, retries, duration, ret),
+
+	TP_STRUCT__entry(
+		__field(int, module)
+		__field(int, retries)
+		__field(u64, duration)
+		__field(int, ret)
+	),
+
+	TP_fast_assign(
+		__entry->module = module;
+		__entry->retries = retries;
+		__entry->duration = duration;
+		__entry->ret = ret;
+	),
+
+	TP_printk("module=%d retries=%d duration=%llu ret=%d",
+		  __entry->module, __entry->retries, __entry->duration,
+		  __entry->ret)
+);
+
+/**
+ * @brief breach of a diagnostic counter threshold of a bypass module
+ */
+TRACE_EVENT(acm_diag_alarm,
+
+	TP_PROTO(int module, int counter, int rule, u32 delta),
+
+	TP_ARGS(module, counter, rule, delta),
+
+	TP_STRUCT__entry(
+		__field(int, module)
+		__field(int, counter)
+		__field(int, rule)
+		__field(u32, delta)
+	),
+
+	TP_fast_assign(
+		__entry->module = module;
+		__entry->counter = counter;
+		__entry->rule = rule;
+		__entry->delta = delta;
+	),
+
+	TP_printk("module=%d counter=%d rule=%d delta=%u",
+		  __entry->module, __entry->counter, __entry->rule,
+		  __entry->delta)
+);
+
+/**
+ * @brief failover actions performed on a link change of a bypass module
+ */
+TRACE_EVENT(acm_link_failover,
+
+	TP_PROTO(int module, bool up, u32 actions, u64 duration),
+
+	TP_ARGS(module, up, actions, duration),
+
+	TP_STRUCT__entry(
+		__field(int, module)
+		__field(bool, up)
+		__field(u32, actions)
+		__field(u64, duration)
+	),
+
+	TP_fast_assign(
+		__entry->module = module;
+		__entry->up = up;
+		__entry->actions = actions;
+		__entry->duration = duration;
+	),
+
+	TP_printk("module=%d link=%s actions=0x%x duration=%llu",
+		  __entry->module, __entry->up ? "up" : "down",
+		  __entry->actions, __entry->duration)
+);
+
+/**
+ * @brief processing of a redundancy recovery tick
+ */
+TRACE_EVENT(acm_recovery_tick,
+
+	TP_PROTO(unsigned int timeouts, u64 duration),
+
+	TP_ARGS(timeouts, duration),
+
+	TP_STRUCT__entry(
+		__field(unsigned int, timeouts)
+		__field(u64, duration)
+	),
+
+	TP_fast_assign(
+		__entry->timeouts = timeouts;
+		__entry->duration = duration;
+	),
+
+	TP_printk("timeouts=%u duration=%llu", __entry->timeouts,
+		  __entry->duration)
+);
+
+#endif /* ACM_TRACE_H_ */
+
+/* this part must be outside protection */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE trace
+#include <trace/define_trace.h>
@@ -0,0 +1,157 @@
+#include "unity.h"
+#include <stdlib.h>
+
+#include "acmdrv.h"
+
+#define MSIZE	16
+
+static size_t size, first, last, word[2];
+
+/* emulated message buffer write using 32-bit word accesses only */
+static void write_words(uint8_t *buffer, size_t offset, size_t len,
+			const uint8_t *from)
+{
+	uint8_t bounce[MSIZE];
+	unsigned int n, k;
+
+	memset(bounce, 0xee, sizeof(bounce));
+	size = len;
+	if (!acmdrv_msgbuf_word_range(MSIZE, offset, &size, &first, &last))
+		return;
+
+	memcpy(bounce + offset, from, size);
+	n = acmdrv_msgbuf_partial_words(offset, size, first, last, word);
+	for (k = 0; k < n; k++)
+		acmdrv_msgbuf_merge_word(bounce, word[k], buffer + word[k],
+					 offset, size);
+	memcpy(buffer + first, bounce + first, last - first);
+}
+
+void setUp(void)
+{
+	size = first = last = 0;
+	word[0] = word[1] = 0xdead;
+}
+
+void tearDown(void)
+{
+}
+
+void test_acmdrv_msgbuf_word_range_unaligned_offset(void)
+{
+	size = 8;
+
+	TEST_ASSERT_TRUE(acmdrv_msgbuf_word_range(MSIZE, 5, &size, &first,
+						  &last));
+	TEST_ASSERT_EQUAL(8, size);
+	TEST_ASSERT_EQUAL(4, first);
+	TEST_ASSERT_EQUAL(16, last);
+
+	TEST_ASSERT_EQUAL(2, acmdrv_msgbuf_partial_words(5, size, first, last,
+							 word));
+	TEST_ASSERT_EQUAL(4, word[0]);
+	TEST_ASSERT_EQUAL(12, word[1]);
+}
+
+void test_acmdrv_msgbuf_word_range_unaligned_length(void)
+{
+	size = 6;
+
+	TEST_ASSERT_TRUE(acmdrv_msgbuf_word_range(MSIZE, 0, &size, &first,
+						  &last));
+	TEST_ASSERT_EQUAL(6, size);
+	TEST_ASSERT_EQUAL(0, first);
+	TEST_ASSERT_EQUAL(8, last);
+
+	TEST_ASSERT_EQUAL(1, acmdrv_msgbuf_partial_words(0, size, first, last,
+							 word));
+	TEST_ASSERT_EQUAL(4, word[0]);
+}
+
+void test_acmdrv_msgbuf_word_range_single_word(void)
+{
+	size = 2;
+
+	TEST_ASSERT_TRUE(acmdrv_msgbuf_word_range(MSIZE, 9, &size, &first,
+						  &last));
+	TEST_ASSERT_EQUAL(2, size);
+	TEST_ASSERT_EQUAL(8, first);
+	TEST_ASSERT_EQUAL(12, last);
+
+	/* the only word is read once only */
+	TEST_ASSERT_EQUAL(1, acmdrv_msgbuf_partial_words(9, size, first, last,
+							 word));
+	TEST_ASSERT_EQUAL(8, word[0]);
+}
+
+void test_acmdrv_msgbuf_word_range_end_of_buffer(void)
+{
+	size = 10;
+
+	TEST_ASSERT_TRUE(acmdrv_msgbuf_word_range(MSIZE, 14, &size, &first,
+						  &last));
+	TEST_ASSERT_EQUAL(2, size);
+	TEST_ASSERT_EQUAL(12, first);
+	TEST_ASSERT_EQUAL(MSIZE, last);
+
+	TEST_ASSERT_EQUAL(1, acmdrv_msgbuf_partial_words(14, size, first, last,
+							 word));
+	TEST_ASSERT_EQUAL(12, word[0]);
+}
+
+void test_acmdrv_msgbuf_word_range_aligned(void)
+{
+	size = 8;
+
+	TEST_ASSERT_TRUE(acmdrv_msgbuf_word_range(MSIZE, 4, &size, &first,
+						  &last));
+	TEST_ASSERT_EQUAL(8, size);
+	TEST_ASSERT_EQUAL(4, first);
+	TEST_ASSERT_EQUAL(12, last);
+
+	TEST_ASSERT_EQUAL(0, acmdrv_msgbuf_partial_words(4, size, first, last,
+							 word));
+}
+
+void test_acmdrv_msgbuf_word_range_empty(void)
+{
+	size = 0;
+
+	TEST_ASSERT_FALSE(acmdrv_msgbuf_word_range(MSIZE, 3, &size, &first,
+						   &last));
+}
+
+void test_acmdrv_msgbuf_merge_word(void)
+{
+	const uint8_t cur[] = { 0x10, 0x11, 0x12, 0x13 };
+	uint8_t buf[8] = { 0, 0, 0, 0, 0xa0, 0xa1, 0, 0 };
+	const uint8_t expect[] = { 0, 0, 0, 0, 0xa0, 0xa1, 0x12, 0x13 };
+
+	acmdrv_msgbuf_merge_word(buf, 4, cur, 4, 2);
+
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expect, buf, sizeof(expect));
+}
+
+void test_acmdrv_msgbuf_word_range_merge(void)
+{
+	const uint8_t from[] = { 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6 };
+	const uint8_t expect[MSIZE] = {
+		0x00, 0x01, 0x02, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4,
+		0xa5, 0xa6, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+	};
+	const uint8_t expect_single[MSIZE] = {
+		0x00, 0x01, 0x02, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4,
+		0xa5, 0xa0, 0xa1, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+	};
+	uint8_t buffer[MSIZE];
+	size_t i;
+
+	for (i = 0; i < MSIZE; i++)
+		buffer[i] = i;
+
+	write_words(buffer, 3, sizeof(from), from);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expect, buffer, MSIZE);
+
+	write_words(buffer, 9, 2, from);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expect_single, buffer, MSIZE);
+}
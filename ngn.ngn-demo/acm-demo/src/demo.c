@@ -32,6 +32,7 @@
 #include "monitor_server.h"
 #include "dump.h"
 #include "sps_demo.h"
+#include "timebase.h"
 
 static struct argv_param acm_demo_params;
 static int stopping = 0;
@@ -119,11 +120,21 @@ const bool get_param_distribute(void)
 	return acm_demo_params.distribute;
 }
 
+bool get_param_executive(void)
+{
+	return acm_demo_params.executive;
+}
+
 int get_param_rxoffset(void)
 {
 	return acm_demo_params.rxoffset;
 }
 
+uint32_t get_param_calibrate(void)
+{
+	return acm_demo_params.calibrate;
+}
+
 static int disable_rt_throttling(void)
 {
 	int fd, ret = 0;
@@ -316,6 +327,10 @@ int main(int argc, char *argv[])
 	LOGGING_INFO("Starting %s", acm_demo_params.version);
 	log_args(LOGLEVEL_DEBUG, argv[0], &acm_demo_params);
 
+	ret = timebase_init(acm_demo_params.clock);
+	if (ret)
+		goto out;
+
 	ret = sps_demo_init();
 	if (ret)
 		LOGGING_ERR("sps_demo_init() failed: %s, ignoring", strerror(-ret));
@@ -416,6 +431,7 @@ free_configs:
 	empty_configurations(&configurations);
 out:
 	sps_demo_exit();
+	timebase_exit();
 	free_args(&acm_demo_params);
 	return ret;
 }
@@ -99,7 +99,9 @@ uint16_t get_param_pc_port(void);
 const char *get_param_pc_host(void);
 const cpu_set_t *get_param_cpuset(void);
 const  bool get_param_distribute(void);
+bool get_param_executive(void);
 int get_param_rxoffset(void);
+uint32_t get_param_calibrate(void);
 
 void force_stop(void);
 
@@ -55,6 +55,14 @@ static int monitor_dump_buffer(struct worker *worker, struct client *client,
 	if (ret)
 		goto out;
 
+	if ((version == 2) && worker->executive)
+		ret = client_send(client,
+			"budget=%u/%u, overruns=%u, deadline missed=%u, ",
+			monitor->budget_used_max, monitor->budget,
+			monitor->budget_overrun, monitor->deadline_missed);
+	if (ret)
+		goto out;
+
 	ret = client_send(client, "TS = [%u, %u, %u]",
 		monitor->rx_timestamp_min,
 		monitor->rx_timestamp_avg,
@@ -331,6 +339,103 @@ out:
 	return ret;
 }
 
+static const double monitor_percentiles[] = {
+	50.0, 90.0, 99.0, 99.9, 99.99, 100.0
+};
+#define NUM_PERCENTILES	\
+	(sizeof(monitor_percentiles) / sizeof(monitor_percentiles[0]))
+
+static int monitor_dump_histogram(struct client *client, const char *name,
+	const struct histogram *hist)
+{
+	int i;
+	int ret;
+	struct histogram snap;
+
+	histogram_snapshot(hist, &snap);
+
+	ret = client_send(client, "  %-16s n=%" PRIu64 ", min=%u, [", name,
+		snap.total, snap.total ? snap.min : 0);
+	if (ret)
+		goto out;
+
+	for (i = 0; i < NUM_PERCENTILES; ++i) {
+		ret = client_send(client, "%s%u", i ? ", " : "",
+			histogram_percentile(&snap, monitor_percentiles[i]));
+		if (ret)
+			goto out;
+	}
+
+	ret = client_send(client, "]\n");
+out:
+	return ret;
+}
+
+/**
+ * @brief dump percentiles of the worker histograms
+ *
+ * If reset is set, all histograms are restarted after dumping, so that
+ * consecutive dumps cover the respective monitoring interval only.
+ */
+int monitor_dump_histograms(struct client *client, bool reset)
+{
+	int i;
+	int ret;
+	struct worker *worker;
+
+	ret = client_send(client, "Percentiles in ns:");
+	if (ret)
+		goto out;
+	for (i = 0; i < NUM_PERCENTILES; ++i) {
+		ret = client_send(client, "%sP%g", i ? ", " : " [",
+			monitor_percentiles[i]);
+		if (ret)
+			goto out;
+	}
+	ret = client_send(client, "]\n");
+	if (ret)
+		goto out;
+
+	STAILQ_FOREACH(worker, &workers, entries) {
+		struct monitor *monitor = &worker->monitor;
+
+		ret = client_send(client, "%10s)\n", worker->name);
+		if (ret)
+			goto out;
+
+		ret = monitor_dump_histogram(client, "latency",
+			&monitor->latency_hist);
+		if (ret)
+			goto out;
+
+		if (monitor->timestamp_monitoring_enabled) {
+			ret = monitor_dump_histogram(client, "buf_access_time",
+				&monitor->function_duration_hist);
+			if (ret)
+				goto out;
+		}
+
+		if (worker->transfer.direction == ACMDRV_BUFF_DESC_BUFF_TYPE_RX) {
+			ret = monitor_dump_histogram(client, "TS",
+				&monitor->rx_timestamp_hist);
+			if (ret)
+				goto out;
+		}
+
+		if (reset) {
+			histogram_request_reset(&monitor->latency_hist);
+			histogram_request_reset(
+				&monitor->function_duration_hist);
+			histogram_request_reset(&monitor->rx_timestamp_hist);
+		}
+	}
+
+	/* indicate end of message */
+	ret = client_send(client, "\n\n");
+out:
+	return ret;
+}
+
 static void printbin16(char *buf, uint16_t val)
 {
 	int i;
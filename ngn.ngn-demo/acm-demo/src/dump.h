@@ -13,6 +13,7 @@
 #define DUMP_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 struct client;
 struct diag_worker;
@@ -20,6 +21,7 @@ struct diag_worker;
 int monitor_dump(struct client *client);
 int monitor_dump2(struct client *client);
 int monitor_dump_cycles(struct client *client);
+int monitor_dump_histograms(struct client *client, bool reset);
 int monitor_dump_diag_data(struct client *client,
 	struct diag_worker *diag_worker);
 
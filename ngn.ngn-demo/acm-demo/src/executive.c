@@ -0,0 +1,332 @@
+/**
+ * @file executive.c
+ *
+ * Cyclic executive for workers
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#define _GNU_SOURCE
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "executive.h"
+#include "worker.h"
+#include "configuration.h"
+#include "logging.h"
+#include "demo.h"
+#include "monitor.h"
+
+/* limit the hyperperiod reported for incommensurable intervals */
+#define EXECUTIVE_MAX_HYPERPERIOD_NS	((uint64_t)60 * NSEC_PER_SEC)
+
+struct executive {
+	char *name;
+
+	pthread_t thread;
+	pthread_attr_t attr;
+	cpu_set_t affinity;
+	bool is_running;
+
+	clockid_t clock_id;
+	uint64_t hyperperiod_ns;
+
+	unsigned int num_workers;
+	struct worker **workers;
+
+	STAILQ_ENTRY(executive) entries;
+};
+
+static unsigned int executive_count = 0;
+static STAILQ_HEAD(executive_list, executive) executives =
+	STAILQ_HEAD_INITIALIZER(executives);
+
+static inline uint64_t ts_to_ns(const struct timespec *ts)
+{
+	return ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static uint64_t gcd(uint64_t a, uint64_t b)
+{
+	while (b) {
+		uint64_t t = a % b;
+
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+static struct executive *find_executive(const cpu_set_t *affinity)
+{
+	struct executive *ex;
+
+	STAILQ_FOREACH(ex, &executives, entries)
+		if (CPU_EQUAL(&ex->affinity, affinity))
+			return ex;
+
+	return NULL;
+}
+
+static struct executive *create_executive(struct worker *worker)
+{
+	int ret;
+	int policy;
+	struct sched_param param;
+	struct executive *ex = calloc(1, sizeof(*ex));
+
+	if (!ex) {
+		LOGGING_ERR("%s: %s", __func__, strerror(ENOMEM));
+		return NULL;
+	}
+
+	if (asprintf(&ex->name, "executive%d", executive_count++) < 0)
+		goto out_free;
+
+	ex->affinity = worker->affinity;
+	ex->clock_id = worker->clock_id;
+	ex->is_running = false;
+	ex->hyperperiod_ns = 1;
+
+	/* executive inherits the scheduling settings of its workers */
+	ret = pthread_attr_init(&ex->attr);
+	if (ret) {
+		LOGGING_ERR("Cannot initialize thread attribute for %s: %s",
+			ex->name, strerror(ret));
+		goto out_free_name;
+	}
+
+	ret = pthread_attr_getschedpolicy(&worker->attr, &policy);
+	if (!ret)
+		ret = pthread_attr_getschedparam(&worker->attr, &param);
+	if (!ret)
+		ret = pthread_attr_setinheritsched(&ex->attr,
+			PTHREAD_EXPLICIT_SCHED);
+	if (!ret)
+		ret = pthread_attr_setschedpolicy(&ex->attr, policy);
+	if (!ret)
+		ret = pthread_attr_setschedparam(&ex->attr, &param);
+	if (!ret)
+		ret = pthread_attr_setaffinity_np(&ex->attr, sizeof(cpu_set_t),
+			&ex->affinity);
+	if (!ret)
+		ret = pthread_attr_setstacksize(&ex->attr, 0x40000);
+	if (ret) {
+		LOGGING_ERR("Cannot set thread attributes for %s: %s",
+			ex->name, strerror(ret));
+		goto out_attr_destroy;
+	}
+
+	STAILQ_INSERT_TAIL(&executives, ex, entries);
+	return ex;
+
+out_attr_destroy:
+	pthread_attr_destroy(&ex->attr);
+out_free_name:
+	free(ex->name);
+out_free:
+	free(ex);
+	return NULL;
+}
+
+static int executive_add_worker(struct executive *ex, struct worker *worker)
+{
+	struct worker **workers;
+	uint64_t interval = worker->interval_ns;
+
+	workers = realloc(ex->workers,
+		(ex->num_workers + 1) * sizeof(*ex->workers));
+	if (!workers)
+		return -ENOMEM;
+
+	ex->workers = workers;
+	ex->workers[ex->num_workers++] = worker;
+	worker->executive = ex;
+
+	if (ex->hyperperiod_ns <= EXECUTIVE_MAX_HYPERPERIOD_NS)
+		ex->hyperperiod_ns = ex->hyperperiod_ns /
+			gcd(ex->hyperperiod_ns, interval) * interval;
+
+	return 0;
+}
+
+/**
+ * @brief run a due worker and account its budget
+ */
+static void executive_run(struct executive *ex, struct worker *worker,
+	const struct timespec *now)
+{
+	struct monitor *monitor = &worker->monitor;
+	struct timespec end;
+	uint64_t deadline;
+	uint32_t used;
+
+	deadline = ts_to_ns(&worker->next) + worker->interval_ns;
+
+	worker_cycle(worker, now);
+
+	clock_gettime(ex->clock_id, &end);
+	used = calcdiff_ns(&end, now);
+	if (used > monitor->budget_used_max)
+		monitor->budget_used_max = used;
+	if (used > monitor->budget)
+		++monitor->budget_overrun;
+	if (ts_to_ns(&end) > deadline)
+		++monitor->deadline_missed;
+
+	worker_advance(worker);
+}
+
+static void *executive_func(void *data)
+{
+	struct executive *ex = data;
+	struct timespec now;
+	unsigned int i;
+
+	pthread_setname_np(pthread_self(), ex->name);
+
+	for (i = 0; i < ex->num_workers; ++i) {
+		struct worker *worker = ex->workers[i];
+
+		worker->monitor.budget = worker->interval_ns / ex->num_workers;
+		worker->is_running = true;
+		worker_flush_rx(worker);
+		if (worker_sync_start(worker)) {
+			force_stop();
+			pthread_exit(NULL);
+		}
+	}
+
+	while (ex->is_running) {
+		struct worker *due = NULL;
+		struct timespec *wakeup = NULL;
+		uint64_t due_deadline = UINT64_MAX;
+
+		if (clock_gettime(ex->clock_id, &now) < 0) {
+			LOGGING_ERR("%s: clock_gettime() failed: %s",
+				ex->name, strerror(errno));
+			force_stop();
+			break;
+		}
+
+		/* earliest deadline among due workers, else earliest release */
+		for (i = 0; i < ex->num_workers; ++i) {
+			struct worker *worker = ex->workers[i];
+			uint64_t deadline;
+
+			if (tsgreater(&worker->next, &now)) {
+				if (!wakeup || tsgreater(wakeup, &worker->next))
+					wakeup = &worker->next;
+				continue;
+			}
+
+			deadline = ts_to_ns(&worker->next) + worker->interval_ns;
+			if (deadline < due_deadline) {
+				due = worker;
+				due_deadline = deadline;
+			}
+		}
+
+		if (due) {
+			executive_run(ex, due, &now);
+			continue;
+		}
+
+		if (wakeup) {
+			struct timespec next = *wakeup;
+			int ret;
+
+			ret = clock_nanosleep(ex->clock_id, TIMER_ABSTIME,
+				&next, NULL);
+			if (ret && ret != EINTR) {
+				LOGGING_ERR("%s: clock_nanosleep() failed: %s",
+					ex->name, strerror(ret));
+				force_stop();
+				break;
+			}
+		}
+	}
+
+	LOGGING_DEBUG("Exiting %s", ex->name);
+	pthread_exit(NULL);
+}
+
+/**
+ * @brief group workers by CPU affinity and start one executive per group
+ */
+int start_executives(struct worker_list *workers)
+{
+	int ret;
+	struct worker *worker;
+	struct executive *ex;
+
+	STAILQ_FOREACH(worker, workers, entries) {
+		ex = find_executive(&worker->affinity);
+		if (!ex)
+			ex = create_executive(worker);
+		if (!ex)
+			return -ENOMEM;
+
+		ret = executive_add_worker(ex, worker);
+		if (ret)
+			return ret;
+	}
+
+	STAILQ_FOREACH(ex, &executives, entries) {
+		if (ex->hyperperiod_ns > EXECUTIVE_MAX_HYPERPERIOD_NS)
+			LOGGING_INFO("%s: %u workers, hyperperiod > %" PRIu64 "us",
+				ex->name, ex->num_workers,
+				EXECUTIVE_MAX_HYPERPERIOD_NS / NSEC_PER_USEC);
+		else
+			LOGGING_INFO("%s: %u workers, hyperperiod %" PRIu64 "us",
+				ex->name, ex->num_workers,
+				ex->hyperperiod_ns / NSEC_PER_USEC);
+
+		ex->is_running = true;
+		/* error codes are negative */
+		ret = -pthread_create(&ex->thread, &ex->attr, executive_func,
+			ex);
+		if (ret) {
+			ex->is_running = false;
+			LOGGING_ERR("Cannot start %s: %s", ex->name,
+				strerror(-ret));
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+void stop_executives(void)
+{
+	struct executive *ex;
+	void *thread_ret;
+
+	STAILQ_FOREACH(ex, &executives, entries) {
+		if (!ex->is_running)
+			continue;
+
+		ex->is_running = false;
+		pthread_join(ex->thread, &thread_ret);
+	}
+}
+
+void free_executives(void)
+{
+	struct executive *ex;
+
+	stop_executives();
+
+	while (!STAILQ_EMPTY(&executives)) {
+		ex = STAILQ_FIRST(&executives);
+		STAILQ_REMOVE_HEAD(&executives, entries);
+		pthread_attr_destroy(&ex->attr);
+		free(ex->workers);
+		free(ex->name);
+		free(ex);
+	}
+}
@@ -0,0 +1,26 @@
+/**
+ * @file executive.h
+ *
+ * Cyclic executive for workers
+ *
+ * Instead of one thread per worker, all workers sharing the same CPU
+ * affinity are run by a single thread. Whenever several workers are due,
+ * the one with the earliest deadline (end of its current interval) is run
+ * first (EDF). Each worker is granted a budget of its interval divided by
+ * the number of workers of the executive, so the executive is schedulable
+ * as long as no worker exceeds its budget.
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#ifndef EXECUTIVE_H_
+#define EXECUTIVE_H_
+
+struct worker_list;
+
+int start_executives(struct worker_list *workers);
+void stop_executives(void);
+void free_executives(void);
+
+#endif /* EXECUTIVE_H_ */
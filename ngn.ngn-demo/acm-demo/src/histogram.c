@@ -0,0 +1,90 @@
+/**
+ * @file histogram.c
+ *
+ * Logarithmic latency histograms
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#include "histogram.h"
+
+/* highest value counted in the respective bucket */
+static uint32_t histogram_bucket_max(unsigned int bucket)
+{
+	unsigned int shift;
+	uint64_t low;
+
+	if (bucket < 2 * HISTOGRAM_SUB_BUCKETS)
+		return bucket;
+
+	shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+	low = (uint64_t)(bucket % HISTOGRAM_SUB_BUCKETS +
+			 HISTOGRAM_SUB_BUCKETS) << shift;
+
+	return low + (1ULL << shift) - 1;
+}
+
+void histogram_init(struct histogram *hist)
+{
+	hist->reset_pending = false;
+	histogram_clear(hist);
+}
+
+/**
+ * @brief copy histogram data concurrently to its writer
+ *
+ * The snapshot is not an atomic image of the histogram, but each value
+ * recorded before the snapshot has been started is contained.
+ */
+void histogram_snapshot(const struct histogram *hist, struct histogram *snap)
+{
+	unsigned int i;
+
+	snap->total = __atomic_load_n(&hist->total, __ATOMIC_ACQUIRE);
+	snap->min = __atomic_load_n(&hist->min, __ATOMIC_RELAXED);
+	snap->max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+	snap->reset_pending = false;
+
+	for (i = 0; i < HISTOGRAM_BUCKETS; ++i)
+		snap->count[i] = __atomic_load_n(&hist->count[i],
+			__ATOMIC_RELAXED);
+}
+
+/**
+ * @brief get the value below or equal to which <percentile> percent of all
+ * recorded values are located
+ *
+ * The result is the highest value equivalent to the matching bucket, but
+ * never exceeds the maximum value recorded. Returns 0 for an empty histogram.
+ */
+uint32_t histogram_percentile(const struct histogram *hist, double percentile)
+{
+	unsigned int i;
+	uint64_t sum, total, threshold;
+
+	/* use sum of buckets, total might be ahead for a snapshot */
+	for (i = 0, total = 0; i < HISTOGRAM_BUCKETS; ++i)
+		total += hist->count[i];
+
+	if (total == 0)
+		return 0;
+
+	if (percentile >= 100.0)
+		return hist->max;
+
+	threshold = (uint64_t)(percentile / 100.0 * total + 0.5);
+	if (threshold == 0)
+		threshold = 1;
+
+	for (i = 0, sum = 0; i < HISTOGRAM_BUCKETS; ++i) {
+		sum += hist->count[i];
+		if (sum >= threshold) {
+			uint32_t val = histogram_bucket_max(i);
+
+			return val < hist->max ? val : hist->max;
+		}
+	}
+
+	return hist->max;
+}
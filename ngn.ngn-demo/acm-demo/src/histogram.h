@@ -0,0 +1,95 @@
+/**
+ * @file histogram.h
+ *
+ * Logarithmic latency histograms
+ *
+ * Fixed size HDR style histograms: values below 2 * HISTOGRAM_SUB_BUCKETS
+ * are counted exactly, larger values are counted in buckets with a relative
+ * width of 1 / HISTOGRAM_SUB_BUCKETS (i.e. a precision of about 6%) up to
+ * the full 32 bit range.
+ *
+ * Each histogram has exactly one writer (the worker thread owning it), which
+ * updates it without any lock. Readers (the monitor server) take snapshots
+ * and request a reset, which is executed by the writer on its next update.
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define HISTOGRAM_SUB_BUCKET_BITS	4
+#define HISTOGRAM_SUB_BUCKETS		(1 << HISTOGRAM_SUB_BUCKET_BITS)
+/* number of buckets needed to cover the full uint32_t range */
+#define HISTOGRAM_BUCKETS	\
+	((32 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+struct histogram {
+	uint32_t count[HISTOGRAM_BUCKETS];
+	uint64_t total;
+	uint32_t min;
+	uint32_t max;
+	bool reset_pending;
+};
+
+static inline unsigned int histogram_bucket(uint32_t val)
+{
+	unsigned int shift;
+
+	if (val < 2 * HISTOGRAM_SUB_BUCKETS)
+		return val;
+
+	shift = 31 - __builtin_clz(val) - HISTOGRAM_SUB_BUCKET_BITS;
+
+	return (shift + 1) * HISTOGRAM_SUB_BUCKETS +
+		(val >> shift) - HISTOGRAM_SUB_BUCKETS;
+}
+
+static inline void histogram_clear(struct histogram *hist)
+{
+	memset(hist->count, 0, sizeof(hist->count));
+	__atomic_store_n(&hist->total, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&hist->min, UINT32_MAX, __ATOMIC_RELAXED);
+	__atomic_store_n(&hist->max, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief add a value to the histogram
+ *
+ * Must only be called by the single writer of the histogram.
+ */
+static inline void histogram_record(struct histogram *hist, uint32_t val)
+{
+	uint32_t *count = &hist->count[histogram_bucket(val)];
+
+	if (__atomic_load_n(&hist->reset_pending, __ATOMIC_ACQUIRE)) {
+		histogram_clear(hist);
+		__atomic_store_n(&hist->reset_pending, false, __ATOMIC_RELEASE);
+	}
+
+	__atomic_store_n(count, *count + 1, __ATOMIC_RELAXED);
+	if (val < hist->min)
+		__atomic_store_n(&hist->min, val, __ATOMIC_RELAXED);
+	if (val > hist->max)
+		__atomic_store_n(&hist->max, val, __ATOMIC_RELAXED);
+	__atomic_store_n(&hist->total, hist->total + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief request the writer to restart the histogram with its next update
+ */
+static inline void histogram_request_reset(struct histogram *hist)
+{
+	__atomic_store_n(&hist->reset_pending, true, __ATOMIC_RELEASE);
+}
+
+void histogram_init(struct histogram *hist);
+void histogram_snapshot(const struct histogram *hist, struct histogram *snap);
+uint32_t histogram_percentile(const struct histogram *hist, double percentile);
+
+#endif /* HISTOGRAM_H_ */
@@ -28,6 +28,7 @@
 #include "worker.h"
 #include "configuration.h"
 #include "logging.h"
+#include "histogram.h"
 
 void monitor_send_rxbuffer(struct worker *worker, int rx_msg_len);
 
@@ -85,6 +86,7 @@ static inline int monitor_trace_latency(struct worker *worker,
 //	pthread_mutex_unlock(&lt->lock);
 
 	lat = calcdiff_ns(now, &worker->next);
+	histogram_record(&worker->monitor.latency_hist, lat);
 	if (lat > lt->max_latency)
 		lt->max_latency = lat;
 
@@ -172,6 +174,7 @@ static inline int monitor_function_duration(struct worker *worker)
 			monitor->function_duration_count);
 
 		monitor->function_duration_count++;
+		histogram_record(&monitor->function_duration_hist, diff);
 
 		return monitor_check_durationlimit(worker, diff);
 	}
@@ -190,6 +193,35 @@ static inline void monitor_packet_transferred(struct worker *worker)
 	++worker->monitor.packet_count;
 }
 
+/**
+ * @brief record RX timestamp (within cycle) during phase calibration
+ *
+ * Timestamps are kept relative to the first one in the range of
+ * +/- half an interval, so arrivals around the cycle start do not wrap.
+ */
+static inline void monitor_calibrate_rx_timestamp(struct worker *worker,
+	uint32_t timestamp)
+{
+	struct calibration *cal = &worker->calibration;
+	int32_t rel;
+
+	if (cal->phase_done)
+		return;
+
+	if (cal->rx_count++ == 0) {
+		cal->rx_phase_first = timestamp;
+		cal->rx_phase_late = 0;
+		return;
+	}
+
+	rel = (timestamp + worker->interval_ns - cal->rx_phase_first)
+		% worker->interval_ns;
+	if (rel >= worker->interval_ns / 2)
+		rel -= (int32_t)worker->interval_ns;
+	if (rel > cal->rx_phase_late)
+		cal->rx_phase_late = rel;
+}
+
 static inline int monitor_rx_timestamp(struct worker *worker)
 {
 	uint32_t timestamp;
@@ -205,6 +237,9 @@ static inline int monitor_rx_timestamp(struct worker *worker)
 		 * nothing received, thus reading the same
 		 * packet again
 		 */
+		if (worker->calibration.cycles)
+			return 0;
+
 		++monitor->packet_lost;
 		if (monitor->break_on_loss &&
 		    (monitor->packet_lost >= monitor->break_on_loss)) {
@@ -229,6 +264,11 @@ static inline int monitor_rx_timestamp(struct worker *worker)
 	timestamp &= 0x3FFFFFFF; /* ignore seconds */
 	timestamp %= worker->interval_ns;
 
+	if (worker->calibration.cycles) {
+		monitor_calibrate_rx_timestamp(worker, timestamp);
+		return 0;
+	}
+
 	if (timestamp > monitor->rx_timestamp_max)
 		monitor->rx_timestamp_max = timestamp;
 	if (timestamp < monitor->rx_timestamp_min)
@@ -237,6 +277,7 @@ static inline int monitor_rx_timestamp(struct worker *worker)
 	monitor->rx_timestamp_avg = calc_cum_avg(
 		monitor->rx_timestamp_avg,
 		timestamp, monitor->rx_timestamp_count++);
+	histogram_record(&monitor->rx_timestamp_hist, timestamp);
 
 	return 0;
 }
@@ -251,6 +292,12 @@ static inline int monitor_packet_identifier(struct worker *worker,
 	uint32_t target_id = transfer->packet_id - transfer->packet_id_offs;
 	target_id &= mask;
 
+	if (worker->calibration.cycles) {
+		worker->calibration.packet_id_diff =
+			(transfer->packet_id - transfer->rx_packet_id) & mask;
+		return 0;
+	}
+
 	switch (target_id - (transfer->rx_packet_id & mask)) {
 	case 0:
 		monitor_packet_transferred(worker);
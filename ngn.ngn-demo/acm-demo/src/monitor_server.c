@@ -70,6 +70,12 @@ static int process(struct client *client, const char *cmd)
 	} else if (!strcmp(cmd, "DUMPCYC")) {
 		/* dump monitor data */
 		ret = monitor_dump_cycles(client);
+	} else if (!strcmp(cmd, "DUMPHIST")) {
+		/* dump latency percentiles since last reset */
+		ret = monitor_dump_histograms(client, false);
+	} else if (!strcmp(cmd, "DUMPHIST RESET")) {
+		/* dump latency percentiles and start a new interval */
+		ret = monitor_dump_histograms(client, true);
 	} else if (!strncmp(cmd, "DIAGNOSTICS", strlen("DIAGNOSTICS"))) {
 		/* get diagnostics parameter:
 		 * DIAGNOSTICS <cycle offset in us> <cycle interval multiplicator> <count>
@@ -44,6 +44,9 @@ static const struct option options[] = {
 	{ "version",		no_argument, 		NULL, 0 },
 	{ "rxoffset",		required_argument, 	NULL, 0 },
 	{ "distribute",		no_argument,		NULL, 0 },
+	{ "executive",		no_argument,		NULL, 0 },
+	{ "clock",		required_argument,	NULL, 0 },
+	{ "calibrate",		required_argument,	NULL, 0 },
 	{ NULL, 		no_argument,		NULL, 0 }
 };
 
@@ -71,7 +74,10 @@ static void print_usage(char *varName)
 	printf("\t     --port <port>              Host PC UDP-Port.\n");
 	printf("\t     --cpu-mask <mask value>    CPU Bitmask for worker threads.\n");
 	printf("\t     --distribute               Distribute workers on available CPU cores.\n");
+	printf("\t     --executive                Run workers sharing CPU cores in one thread (EDF).\n");
 	printf("\t     --rxoffset <packet count>  Offset for RX packet count check (defaults to 1).\n");
+	printf("\t     --clock <clock>            Worker clock: realtime (default), tai or PHC device, e.g. /dev/ptp0.\n");
+	printf("\t     --calibrate <cycles>       Calibrate RX worker phase and offset within <cycles> (0 = off).\n");
 	printf("\t-[h,?] | --help                 display the version and this help and exit\n");
 	fflush(stdout);
 }
@@ -115,7 +121,13 @@ void log_args(int loglvl, char *name, struct argv_param *args)
 	LOG(loglvl, "HW cycle = %uus", args->hw_cycle_us);
 	LOG(loglvl, "CPU mask = %u", cpu_set_to_int(&args->cpuset));
 	LOG(loglvl, "distribute = %s", args->distribute ? "enabled" : "disabled");
+	LOG(loglvl, "executive = %s", args->executive ? "enabled" : "disabled");
 	LOG(loglvl, "RX packet counter offset = %u", args->rxoffset);
+	LOG(loglvl, "clock = %s", args->clock);
+	if (args->calibrate > 0)
+		LOG(loglvl, "RX calibration = %u cycles", args->calibrate);
+	else
+		LOG(loglvl, "RX calibration: disabled");
 #ifdef FTRACE_SUPPORT_ENABLED
 	if (args->tracelimit > 0)
 		LOG(loglvl, "tracelimit = %uus", args->tracelimit);
@@ -148,7 +160,10 @@ void parse_args(int argc, char *argv[], struct argv_param *param) {
 	CPU_ZERO(&param->cpuset);
 	sched_getaffinity(0, sizeof(param->cpuset), &param->cpuset);
 	param->distribute = false;
+	param->executive = false;
 	param->rxoffset = 1;
+	param->calibrate = 0;		/* 0 means off */
+	param->clock = "realtime";
 #ifdef FTRACE_SUPPORT_ENABLED
 	param->tracelimit = 0;		/* 0 means off */
 	param->lat_break = 0;		/* 0 means off */
@@ -248,6 +263,15 @@ void parse_args(int argc, char *argv[], struct argv_param *param) {
 			if (strcmp("distribute", options[lindex].name) == 0) {
 				param->distribute = true;
 			}
+			if (strcmp("executive", options[lindex].name) == 0) {
+				param->executive = true;
+			}
+			if (strcmp("clock", options[lindex].name) == 0) {
+				param->clock = optarg;
+			}
+			if (strcmp("calibrate", options[lindex].name) == 0) {
+				param->calibrate = atoi(optarg);
+			}
 			break;
 
 		default:
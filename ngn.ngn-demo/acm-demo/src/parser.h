@@ -28,7 +28,10 @@ struct argv_param {
 	uint32_t	hw_cycle_us;		/* HW cycle time in us */
 	cpu_set_t	cpuset;			/* cpu affinity mask */
 	bool		distribute;		/* even worker thread distribution */
+	bool		executive;		/* one EDF executive per CPU set */
 	int		rxoffset;		/* RX packet counter offset */
+	uint32_t	calibrate;		/* RX phase calibration cycles */
+	char		*clock;			/* worker clock */
 #ifdef FTRACE_SUPPORT_ENABLED
 	uint32_t	tracelimit;		/* trace limit in us */
 	uint32_t	lat_break;		/* latency limit in ns */
@@ -0,0 +1,216 @@
+/**
+ * @file timebase.c
+ *
+ * Time base of the workers
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "timebase.h"
+#include "logging.h"
+#include "demo.h"
+
+#ifndef CLOCK_TAI
+#define CLOCK_TAI	11
+#endif
+
+/* see clock_getres(2), dynamic posix clocks */
+#define FD_TO_CLOCKID(fd)	((~(clockid_t)(fd) << 3) | 3)
+
+/* number of samples to take for measuring the PHC offset */
+#define TIMEBASE_OFFSET_SAMPLES	5
+
+/* interval for measuring the PHC offset again */
+#define TIMEBASE_RESYNC_NS	NSEC_PER_SEC
+
+static clockid_t clock_id = CLOCK_REALTIME;
+static int phc_fd = -1;
+static int64_t phc_offset_ns;
+static int64_t resync_next_ns;
+static pthread_mutex_t resync_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline int64_t ts_to_ns(const struct timespec *ts)
+{
+	return (int64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+/**
+ * @brief measure offset of PHC relative to the system clock
+ *
+ * The PHC reading is bracketed by two system clock readings and the
+ * sample with the shortest bracket is used.
+ */
+static int timebase_measure_offset(clockid_t phc, int64_t *offset)
+{
+	int i;
+	int64_t shortest = INT64_MAX;
+
+	for (i = 0; i < TIMEBASE_OFFSET_SAMPLES; ++i) {
+		struct timespec t1, tp, t2;
+		int64_t delay;
+
+		if (clock_gettime(clock_id, &t1) ||
+		    clock_gettime(phc, &tp) ||
+		    clock_gettime(clock_id, &t2))
+			return -errno;
+
+		delay = ts_to_ns(&t2) - ts_to_ns(&t1);
+		if (delay < shortest) {
+			shortest = delay;
+			*offset = ts_to_ns(&tp) - ts_to_ns(&t1) - delay / 2;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief select the worker clock
+ *
+ * @param clock_name "realtime", "tai" or the path of a PHC device
+ */
+int timebase_init(const char *clock_name)
+{
+	int ret;
+
+	phc_offset_ns = 0;
+	resync_next_ns = 0;
+
+	if (!clock_name || strcmp(clock_name, "realtime") == 0) {
+		clock_id = CLOCK_REALTIME;
+		return 0;
+	}
+
+	if (strcmp(clock_name, "tai") == 0) {
+		clock_id = CLOCK_TAI;
+		return 0;
+	}
+
+	phc_fd = open(clock_name, O_RDONLY);
+	if (phc_fd < 0) {
+		ret = -errno;
+		LOGGING_ERR("Cannot open clock %s: %s", clock_name,
+			strerror(errno));
+		return ret;
+	}
+
+	clock_id = CLOCK_TAI;
+	ret = timebase_measure_offset(FD_TO_CLOCKID(phc_fd), &phc_offset_ns);
+	if (ret) {
+		LOGGING_ERR("Cannot read clock %s: %s", clock_name,
+			strerror(-ret));
+		timebase_exit();
+		return ret;
+	}
+
+	LOGGING_INFO("%s: offset to CLOCK_TAI %" PRId64 "ns", clock_name,
+		phc_offset_ns);
+	return 0;
+}
+
+void timebase_exit(void)
+{
+	if (phc_fd >= 0)
+		close(phc_fd);
+	phc_fd = -1;
+	phc_offset_ns = 0;
+	clock_id = CLOCK_REALTIME;
+}
+
+/**
+ * @brief clock to be used for clock_gettime() and clock_nanosleep()
+ */
+clockid_t timebase_clock_id(void)
+{
+	return clock_id;
+}
+
+/**
+ * @brief offset of the selected PHC to the worker clock, 0 if none
+ */
+int64_t timebase_offset_ns(void)
+{
+	return __atomic_load_n(&phc_offset_ns, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief measure the PHC offset again, if it is due
+ *
+ * Called by the workers with their current time each cycle, only one of
+ * them measures per TIMEBASE_RESYNC_NS.
+ *
+ * @param now time read from timebase_clock_id()
+ */
+void timebase_resync(const struct timespec *now)
+{
+	int64_t offset;
+
+	if (phc_fd < 0 ||
+	    ts_to_ns(now) < __atomic_load_n(&resync_next_ns, __ATOMIC_RELAXED))
+		return;
+
+	/* another worker is measuring already */
+	if (pthread_mutex_trylock(&resync_lock))
+		return;
+
+	if (ts_to_ns(now) >= resync_next_ns) {
+		__atomic_store_n(&resync_next_ns, ts_to_ns(now) +
+			TIMEBASE_RESYNC_NS, __ATOMIC_RELAXED);
+		if (!timebase_measure_offset(FD_TO_CLOCKID(phc_fd), &offset))
+			__atomic_store_n(&phc_offset_ns, offset,
+				__ATOMIC_RELAXED);
+	}
+
+	pthread_mutex_unlock(&resync_lock);
+}
+
+/**
+ * @brief move a worker clock time by the change of the PHC offset
+ *
+ * A PHC running ahead of the worker clock reaches its cycle starts earlier
+ * in worker clock time, so ts is moved back by the increase of the offset.
+ *
+ * @param ts worker clock time of a PHC event, computed with *base_ns
+ * @param base_ns offset ts is based on, updated to the current offset
+ */
+void timebase_follow(struct timespec *ts, int64_t *base_ns)
+{
+	int64_t offset = timebase_offset_ns();
+	int64_t time;
+
+	if (offset == *base_ns)
+		return;
+
+	time = ts_to_ns(ts) - (offset - *base_ns);
+	ts->tv_sec = time / NSEC_PER_SEC;
+	ts->tv_nsec = time % NSEC_PER_SEC;
+	*base_ns = offset;
+}
+
+/**
+ * @brief position of a worker clock time within the network cycle
+ *
+ * @param ts time read from timebase_clock_id()
+ * @param interval_ns cycle length
+ *
+ * @return offset of ts to the last cycle start of the PHC in ns
+ */
+uint32_t timebase_phase_ns(const struct timespec *ts, uint32_t interval_ns)
+{
+	int64_t phase;
+
+	phase = (ts_to_ns(ts) + timebase_offset_ns()) % interval_ns;
+	if (phase < 0)
+		phase += interval_ns;
+
+	return phase;
+}
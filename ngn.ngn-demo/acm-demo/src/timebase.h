@@ -0,0 +1,33 @@
+/**
+ * @file timebase.h
+ *
+ * Time base of the workers
+ *
+ * Workers schedule against CLOCK_REALTIME (default), CLOCK_TAI or a PTP
+ * hardware clock (PHC). Since dynamic posix clocks cannot be used with
+ * clock_nanosleep(), a PHC is followed by sleeping on CLOCK_TAI and
+ * translating cycle starts by the offset between PHC and CLOCK_TAI. The
+ * offset is measured again once per second while the workers run, so they
+ * follow the PHC also without a daemon synchronizing the system clock.
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+#include <time.h>
+
+int timebase_init(const char *clock_name);
+void timebase_exit(void);
+
+clockid_t timebase_clock_id(void);
+int64_t timebase_offset_ns(void);
+void timebase_resync(const struct timespec *now);
+void timebase_follow(struct timespec *ts, int64_t *base_ns);
+
+uint32_t timebase_phase_ns(const struct timespec *ts, uint32_t interval_ns);
+
+#endif /* TIMEBASE_H_ */
@@ -28,13 +28,21 @@
 #include "monitor.h"
 #include "acmif.h"
 #include "parser.h"
+#include "executive.h"
+#include "timebase.h"
 
 #define DEVBASE	"/dev/"
 
+/* cycles to measure the packet identifier offset after phase calibration */
+#define CALIBRATION_OFFSET_CYCLES	4
+/* minimum distance of buffer reads to the latest frame reception */
+#define CALIBRATION_GUARD_NS		(10 * NSEC_PER_USEC)
+
 struct worker_list workers = STAILQ_HEAD_INITIALIZER(workers);
 
 /* all workers share a common basic start time */
 static struct timespec starttime;
+static int64_t starttime_offset_ns;
 
 int get_num_workers(void)
 {
@@ -116,7 +124,7 @@ static struct worker *create_worker(struct configuration_entry *config)
 	lt = &worker->monitor.latency_trace;
 	worker->name = strdup(config->buffer_name);
 	worker->is_running = false;
-	worker->clock_id = CLOCK_REALTIME;
+	worker->clock_id = timebase_clock_id();
 	worker->interval_ns = NSEC_PER_USEC * config->period;
 	worker->max_cycle = get_param_max_frame_counter();
 	worker->config = config;
@@ -127,6 +135,9 @@ static struct worker *create_worker(struct configuration_entry *config)
 	worker->transfer.direction =
 		acmdrv_buff_desc_type_read(&config->msgbuf->desc);
 
+	if (worker->transfer.direction == ACMDRV_BUFF_DESC_BUFF_TYPE_RX)
+		worker->calibration.cycles = get_param_calibrate();
+
 	worker->monitor.udp_buffer = NULL;
 	worker->monitor.udp_socket = -1;
 
@@ -146,6 +157,10 @@ static struct worker *create_worker(struct configuration_entry *config)
 	worker->monitor.rx_timestamp_avg = 0;
 	worker->monitor.rx_timestamp_count = 0;
 
+	histogram_init(&worker->monitor.latency_hist);
+	histogram_init(&worker->monitor.function_duration_hist);
+	histogram_init(&worker->monitor.rx_timestamp_hist);
+
 	worker->monitor.break_on_loss = get_param_break_on_loss();
 	worker->monitor.break_on_double = get_param_break_on_double();
 	worker->monitor.break_on_invalid = get_param_break_on_invalid();
@@ -232,9 +247,10 @@ static struct worker *create_worker(struct configuration_entry *config)
 			}
 			--chosen_cpu;
 		}
-		ret = worker_setaffinity(worker, &affinity);
 	} else
-		ret = worker_setaffinity(worker, get_param_cpuset());
+		affinity = *get_param_cpuset();
+	worker->affinity = affinity;
+	ret = worker_setaffinity(worker, &affinity);
 	if (ret)
 		goto out_attr_destroy;
 
@@ -262,34 +278,36 @@ out_free_worker:
 	return NULL;
 }
 
-static void *worker_func(void *data)
+/**
+ * @brief dummy read to get eventually old data from an RX buffer
+ */
+void worker_flush_rx(struct worker *worker)
 {
-	struct timespec now;
-	struct worker *worker = data;
+	int i;
 
-	pthread_setname_np(pthread_self(), worker->name);
-	worker->is_running = true;
+	if (worker->transfer.direction != ACMDRV_BUFF_DESC_BUFF_TYPE_RX)
+		return;
 
-	worker->next = worker->start;
+	for (i = 0; i < 10; ++i)
+		read(worker->transfer.msgbuf, worker->transfer.data,
+			worker->transfer.size);
+}
 
-	if (worker->transfer.direction == ACMDRV_BUFF_DESC_BUFF_TYPE_RX) {
-		int i;
-		/* dummy read to get eventually old data from buffer */
-		for (i = 0; i < 10; ++i)
-			read(worker->transfer.msgbuf, worker->transfer.data,
-				worker->transfer.size);
-	}
+/**
+ * @brief sync next activation of worker to next interval start
+ */
+int worker_sync_start(struct worker *worker)
+{
+	struct timespec now;
+
+	worker->next = worker->start;
+	timebase_follow(&worker->next, &worker->phc_offset_ns);
 
-	/* sync to next interval start */
 	do {
 		if (clock_gettime(worker->clock_id, &now) < 0) {
 			LOGGING_ERR("%s: clock_gettime() failed: %s",
 				worker->name, strerror(errno));
-			force_stop();
-			while (worker->is_running) {
-				usleep(10000);
-			}
-			pthread_exit(NULL);
+			return -errno;
 		}
 		tsinc(&worker->next, worker->interval_ns);
 	} while (tsgreater(&now, &worker->next));
@@ -309,6 +327,138 @@ static void *worker_func(void *data)
 		tsinc(&worker->next, worker->interval_ns);
 	}
 
+	return 0;
+}
+
+/**
+ * @brief execute worker function for the activation at worker->next
+ */
+void worker_cycle(struct worker *worker, const struct timespec *now)
+{
+	int ret;
+
+	/* derive packet counter from time */
+	worker->transfer.packet_id = (worker->next.tv_sec * NSEC_PER_SEC
+		+ worker->next.tv_nsec) / worker->interval_ns;
+
+	ret = (*(worker->config->function))(worker);
+
+	if (monitor_function_duration(worker))
+		force_stop();
+	if (monitor_trace_latency(worker, now))
+		force_stop();
+	if (monitor_max_cycle_reached(worker))
+		force_stop();
+
+	/* ignore ENODATA */
+	if ((ret < 0) && (ret != -ENODATA)) {
+		LOGGING_ERR("%s: worker function failed: %s",
+			worker->name, strerror(-ret));
+		force_stop();
+	}
+}
+
+/**
+ * @brief advance next activation of worker, skipping missed intervals
+ */
+void worker_advance(struct worker *worker)
+{
+	struct timespec now;
+
+	/* add at least one interval */
+	tsinc(&worker->next, worker->interval_ns);
+
+	if (clock_gettime(worker->clock_id, &now) < 0) {
+		LOGGING_ERR("%s: clock_gettime() failed: %s",
+			worker->name, strerror(errno));
+		force_stop();
+	}
+
+	/* follow the drift of the PHC to the worker clock */
+	timebase_resync(&now);
+	timebase_follow(&worker->next, &worker->phc_offset_ns);
+
+	while (tsgreater(&now, &worker->next)) {
+		if (monitor_interval_exceeded(worker, &now))
+			force_stop();
+		tsinc(&worker->next, worker->interval_ns);
+	}
+
+	worker_calibrate(worker);
+}
+
+static void calibrate_phase(struct worker *worker)
+{
+	struct calibration *cal = &worker->calibration;
+	uint32_t guard, target, phase, shift;
+
+	if (!cal->rx_count) {
+		LOGGING_WARN("%s: no RX timestamps, keeping phase",
+			worker->name);
+		return;
+	}
+
+	guard = CALIBRATION_GUARD_NS;
+	if (guard > worker->interval_ns / 4)
+		guard = worker->interval_ns / 4;
+
+	target = (cal->rx_phase_first + worker->interval_ns +
+		cal->rx_phase_late + guard) % worker->interval_ns;
+	phase = timebase_phase_ns(&worker->next, worker->interval_ns);
+	shift = (target + worker->interval_ns - phase) % worker->interval_ns;
+
+	tsinc(&worker->next, shift);
+	LOGGING_INFO("%s: phase calibrated from %uns to %uns (latest RX at %uns)",
+		worker->name, phase, target,
+		(target + worker->interval_ns - guard) % worker->interval_ns);
+}
+
+/**
+ * @brief advance automatic phase calibration of an RX worker
+ *
+ * During the first stage the RX timestamps are collected and the worker
+ * phase is moved right behind the latest frame reception. During the
+ * second stage the offset between the packet identifier derived from the
+ * worker time and the received one is measured and used as RX offset.
+ * Packet statistics are not accounted while calibrating.
+ */
+void worker_calibrate(struct worker *worker)
+{
+	struct calibration *cal = &worker->calibration;
+
+	if (!cal->cycles || --cal->cycles)
+		return;
+
+	if (!cal->phase_done) {
+		calibrate_phase(worker);
+		cal->phase_done = true;
+		cal->cycles = CALIBRATION_OFFSET_CYCLES;
+		return;
+	}
+
+	worker->transfer.packet_id_offs = cal->packet_id_diff;
+	LOGGING_INFO("%s: RX packet counter offset calibrated to %u",
+		worker->name, cal->packet_id_diff);
+}
+
+static void *worker_func(void *data)
+{
+	struct timespec now;
+	struct worker *worker = data;
+
+	pthread_setname_np(pthread_self(), worker->name);
+	worker->is_running = true;
+
+	worker_flush_rx(worker);
+
+	if (worker_sync_start(worker)) {
+		force_stop();
+		while (worker->is_running) {
+			usleep(10000);
+		}
+		pthread_exit(NULL);
+	}
+
 	while (worker->is_running) {
 		int ret, ret1;
 
@@ -328,41 +478,8 @@ static void *worker_func(void *data)
 			force_stop();
 		}
 
-		/* derive packet counter from time */
-		worker->transfer.packet_id = (worker->next.tv_sec * NSEC_PER_SEC
-			+ worker->next.tv_nsec) / worker->interval_ns;
-
-		ret = (*(worker->config->function))(worker);
-
-		if (monitor_function_duration(worker))
-			force_stop();
-		if (monitor_trace_latency(worker, &now))
-			force_stop();
-		if (monitor_max_cycle_reached(worker))
-			force_stop();
-
-		/* ignore ENODATA */
-		if ((ret < 0) && (ret != -ENODATA)) {
-			LOGGING_ERR("%s: worker function failed: %s",
-				worker->name, strerror(-ret));
-			force_stop();
-		}
-
-		/* add at least one interval */
-		tsinc(&worker->next, worker->interval_ns);
-
-		ret = clock_gettime(worker->clock_id, &now);
-		if (ret < 0) {
-			LOGGING_ERR("%s: clock_gettime() failed: %s",
-				worker->name, strerror(errno));
-			force_stop();
-		}
-
-		while (tsgreater(&now, &worker->next)) {
-			if (monitor_interval_exceeded(worker, &now))
-				force_stop();
-			tsinc(&worker->next, worker->interval_ns);
-		}
+		worker_cycle(worker, &now);
+		worker_advance(worker);
 	}
 
 	LOGGING_DEBUG("Exiting %s worker", worker->name);
@@ -378,6 +495,7 @@ static int start_worker(struct worker *worker)
 	 * worker specific offset
 	 */
 	worker->start = starttime;
+	worker->phc_offset_ns = starttime_offset_ns;
 	worker->start.tv_nsec += worker->config->time_offs * NSEC_PER_USEC;
 	tsnorm(&worker->start);
 
@@ -391,6 +509,10 @@ static int start_worker(struct worker *worker)
 		if (ret != 0)
 			goto out;
 	}
+	/* the worker is run by the cyclic executive of its CPUs */
+	if (get_param_executive())
+		return 0;
+
 	/* error codes are negative */
 	ret = -pthread_create(&worker->thread, &worker->attr, worker_func,
 			      worker);
@@ -401,17 +523,17 @@ out:
 	return ret;
 }
 
-static int _calculate_starttime(struct timespec *time, uint32_t interval_us,
-	unsigned int delay)
+static int _calculate_starttime(struct timespec *time, int64_t *offset_ns,
+	uint32_t interval_us, unsigned int delay)
 {
 	int ret;
 	uint32_t rem;
 	const uint64_t cycns = interval_us * NSEC_PER_USEC;
+	int64_t offs;
 
-	ret = clock_gettime(CLOCK_REALTIME, time);
+	ret = clock_gettime(timebase_clock_id(), time);
 	if (ret < 0) {
-		LOGGING_ERR("clock_gettime(CLOCK_REALTIME) failed: %s",
-			strerror(errno));
+		LOGGING_ERR("clock_gettime() failed: %s", strerror(errno));
 		return -errno;
 	}
 
@@ -423,6 +545,13 @@ static int _calculate_starttime(struct timespec *time, uint32_t interval_us,
 	rem = (((time->tv_sec % cycns) * (NSEC_PER_SEC % cycns)) % cycns +
 		(time->tv_nsec % cycns)) % cycns;
 
+	/* align to the cycle start of the PHC, if any */
+	*offset_ns = timebase_offset_ns();
+	offs = *offset_ns % (int64_t)cycns;
+	if (offs < 0)
+		offs += cycns;
+	rem = (rem + offs) % cycns;
+
 	time->tv_nsec -= rem % NSEC_PER_SEC;
 	while (time->tv_nsec < 0) {
 		time->tv_nsec += NSEC_PER_SEC;
@@ -435,7 +564,8 @@ static int _calculate_starttime(struct timespec *time, uint32_t interval_us,
 
 static int calculate_starttime(struct timespec *time)
 {
-	return _calculate_starttime(time, get_param_hw_cycle_us(), 16);
+	return _calculate_starttime(time, &starttime_offset_ns,
+		get_param_hw_cycle_us(), 16);
 }
 
 
@@ -455,6 +585,9 @@ int start_workers(void)
 			return ret;
 	}
 
+	if (get_param_executive())
+		return start_executives(&workers);
+
 	return 0;
 }
 
@@ -463,7 +596,8 @@ static void stop_worker(struct worker* worker)
 	void *thread_ret;
 
 	worker->is_running = false;
-	pthread_join(worker->thread, &thread_ret);
+	if (!worker->executive)
+		pthread_join(worker->thread, &thread_ret);
 
 	if (worker->monitor.udp_socket > 0)
 		close(worker->monitor.udp_socket);
@@ -474,6 +608,7 @@ void stop_workers(void)
 {
 	struct worker *worker;
 
+	stop_executives();
 	STAILQ_FOREACH(worker, &workers, entries)
 		stop_worker(worker);
 }
@@ -523,6 +658,8 @@ void free_workers(void)
 		STAILQ_REMOVE(&workers, worker, worker, entries);
 		free_worker(worker);
 	}
+
+	free_executives();
 }
 
 struct diag_worker {
@@ -579,6 +716,7 @@ struct diag_worker *create_diag_worker(struct client *client, uint32_t offset,
 	uint32_t mult, uint32_t cnt)
 {
 	int ret;
+	int64_t start_offset_ns;
 	struct sched_param param;
 	const int policy = SCHED_FIFO;
 	struct diag_worker *diag_worker = calloc(1, sizeof(*diag_worker));
@@ -599,7 +737,7 @@ struct diag_worker *create_diag_worker(struct client *client, uint32_t offset,
 		goto out_free_name;
 
 	diag_worker->is_running = false;
-	diag_worker->clock_id = CLOCK_REALTIME;
+	diag_worker->clock_id = timebase_clock_id();
 	diag_worker->max_cycle = cnt;
 	diag_worker->interval_ns = NSEC_PER_USEC * get_param_hw_cycle_us() *
 		mult;
@@ -639,7 +777,7 @@ struct diag_worker *create_diag_worker(struct client *client, uint32_t offset,
 		goto out_attr_destroy;
 	}
 
-	ret = _calculate_starttime(&diag_worker->start,
+	ret = _calculate_starttime(&diag_worker->start, &start_offset_ns,
 		get_param_hw_cycle_us() * mult, 0);
 	if (ret)
 		goto out_free_name;
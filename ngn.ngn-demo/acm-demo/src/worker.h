@@ -21,18 +21,23 @@
 #include <netinet/in.h>
 #include <linux/acm/acmdrv.h>
 
+#include "histogram.h"
+
 struct worker {
 	char *name;
 	struct configuration_entry *config;
 
 	pthread_t thread;
 	pthread_attr_t attr;
+	cpu_set_t affinity;
 	bool is_running;
+	struct executive *executive;	/* cyclic executive running the worker */
 
 	clockid_t clock_id;
 	uint32_t interval_ns;	/* interval from config in ns */
 	struct timespec start;
 	struct timespec next;
+	int64_t phc_offset_ns;	/* PHC offset start and next are based on */
 	uint32_t max_cycle;
 
 #define TO_ASCII(val)	(((val) & 0x3F) + ' ')
@@ -54,6 +59,16 @@ struct worker {
 		enum acmdrv_buff_desc_type direction;
 	} transfer;
 
+	/* automatic phase calibration of RX workers */
+	struct calibration {
+		unsigned int cycles;	/* remaining cycles of current stage */
+		bool phase_done;	/* phase adjusted, measuring offset */
+		unsigned int rx_count;	/* number of RX timestamps seen */
+		uint32_t rx_phase_first; /* first RX timestamp within cycle */
+		int32_t rx_phase_late;	/* latest RX relative to first one */
+		uint32_t packet_id_diff; /* last packet_id - rx_packet_id */
+	} calibration;
+
 	struct monitor {
 		/* worker function duration monitoring */
 		bool timestamp_monitoring_enabled;
@@ -73,6 +88,12 @@ struct worker {
 
 		unsigned int interval_missed;
 
+		/* budget accounting when run by a cyclic executive (in ns) */
+		uint32_t budget;
+		unsigned int budget_used_max;
+		unsigned int budget_overrun;
+		unsigned int deadline_missed;
+
 		uint32_t rx_timestamp_min;
 		uint32_t rx_timestamp_max;
 		uint32_t rx_timestamp_avg;
@@ -97,6 +118,12 @@ struct worker {
 			} time[MONITOR_CYCLE_TRACE_SIZE];
 		} latency_trace;
 
+		/* distributions of wake-up latency, buffer access time and
+		 * RX timestamp offset within the cycle (all in ns) */
+		struct histogram latency_hist;
+		struct histogram function_duration_hist;
+		struct histogram rx_timestamp_hist;
+
 		int break_on_loss;
 		int break_on_double;
 		int break_on_invalid;
@@ -121,6 +148,12 @@ void free_workers(void);
 int start_workers(void);
 void stop_workers(void);
 
+void worker_flush_rx(struct worker *worker);
+int worker_sync_start(struct worker *worker);
+void worker_cycle(struct worker *worker, const struct timespec *now);
+void worker_advance(struct worker *worker);
+void worker_calibrate(struct worker *worker);
+
 struct monitor *worker_getmonitor(struct worker *worker);
 void worker_setmonitor(struct worker *worker, struct monitor *monitor);
 
@@ -0,0 +1,97 @@
+/**
+ * @file iorec.h
+ *
+ * Evaluation of ACM register access recordings
+ *
+ * The ACM driver records the register accesses of configuration transactions
+ * into a ring buffer readable from debugfs (acm/iorecord/records). Each line
+ * of a recording holds
+ *
+ *     <seq> <timestamp_ns> <duration_ns> <area> <r|w><width> <offset> <value>
+ *
+ * where block transfers are recorded per 32 bit word with the duration of
+ * the whole transfer assigned to its first word. Lines starting with '#'
+ * are comments, "# dropped <n>" gives the number of records lost due to
+ * wrap around of the ring buffer.
+ *
+ * Replaying a recording applies its writes to a shadow of the registers,
+ * which reveals the final register image and the redundant writes, i.e.
+ * writes of the value the register was last written with.
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#ifndef IOREC_H_
+#define IOREC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief maximum length of an area name incl. termination
+ */
+#define IOREC_AREA_LEN	24
+
+/**
+ * @brief a recorded register access
+ */
+struct iorec_record {
+	uint64_t seq;			/**< sequence number */
+	uint64_t timestamp;		/**< start of access in ns */
+	uint32_t duration;		/**< duration of access in ns */
+	char area[IOREC_AREA_LEN];	/**< accessed memory region */
+	bool write;			/**< write access */
+	unsigned int width;		/**< access width in bits */
+	uint32_t offset;		/**< offset within area */
+	uint32_t value;			/**< value read or written */
+};
+
+/**
+ * @brief a recording
+ */
+struct iorec_recording {
+	struct iorec_record *record;	/**< records in recording order */
+	size_t count;			/**< number of records */
+	uint64_t dropped;		/**< records lost before the first one */
+};
+
+/**
+ * @brief replayed state of a single register
+ */
+struct iorec_register {
+	const char *area;		/**< memory region */
+	uint32_t offset;		/**< offset within area */
+	unsigned int width;		/**< access width in bits */
+	uint32_t value;			/**< value last written */
+	bool written;			/**< value is valid */
+	size_t writes;			/**< number of writes */
+	size_t redundant;		/**< number of redundant writes */
+};
+
+/**
+ * @brief register image resulting from a replay, sorted by area and offset
+ */
+struct iorec_image {
+	struct iorec_register *reg;	/**< written registers */
+	size_t count;			/**< number of registers */
+};
+
+/**
+ * @brief callback for each redundant write found during replay
+ */
+typedef void (*iorec_redundant_cb)(const struct iorec_record *record,
+				   void *arg);
+
+/* record.c */
+int iorec_load(const char *path, struct iorec_recording *recording);
+void iorec_free(struct iorec_recording *recording);
+int iorec_replay(const struct iorec_recording *recording,
+		 struct iorec_image *image, iorec_redundant_cb redundant,
+		 void *arg);
+void iorec_image_free(struct iorec_image *image);
+int iorec_register_cmp(const struct iorec_register *a,
+		       const struct iorec_register *b);
+
+#endif /* IOREC_H_ */
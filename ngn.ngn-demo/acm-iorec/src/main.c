@@ -0,0 +1,280 @@
+/**
+ * @file main.c
+ *
+ * Evaluate, replay and compare ACM register access recordings
+ *
+ * Usage: acm-iorec <command> <recording> [<recording>]
+ *   stats      access count, redundant writes and time spent per area
+ *   redundant  list the redundant writes
+ *   replay     print the register image written by the recording
+ *   diff       compare the register images of two recordings
+ *
+ * A recording is taken e.g. by
+ *     echo 1 > /sys/kernel/debug/acm/iorecord/enable
+ *     echo > /sys/kernel/debug/acm/iorecord/records
+ *     <apply configuration>
+ *     cat /sys/kernel/debug/acm/iorecord/records > config.rec
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "iorec.h"
+
+/**
+ * @brief maximum number of areas distinguished by the statistics
+ */
+#define STATS_AREA_COUNT	16
+
+/**
+ * @brief access statistics of an area
+ */
+struct area_stats {
+	const char *area;	/**< area name */
+	size_t reads;		/**< number of read accesses */
+	size_t writes;		/**< number of write accesses */
+	size_t redundant;	/**< number of redundant writes */
+	uint64_t time_ns;	/**< accumulated access time */
+};
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"Usage: %s <command> <recording> [<recording>]\n"
+		"  stats <rec>       access statistics per area\n"
+		"  redundant <rec>   list writes not changing the register\n"
+		"  replay <rec>      print the resulting register image\n"
+		"  diff <rec> <rec>  compare the register images\n"
+		"A recording of \"-\" is read from stdin.\n", prog);
+}
+
+static struct area_stats *stats_area(struct area_stats *stats,
+				     size_t *count, const char *area)
+{
+	size_t i;
+
+	for (i = 0; i < *count; ++i)
+		if (strcmp(stats[i].area, area) == 0)
+			return &stats[i];
+
+	if (*count == STATS_AREA_COUNT)
+		return NULL;
+
+	stats[*count].area = area;
+	return &stats[(*count)++];
+}
+
+static int cmd_stats(const struct iorec_recording *recording)
+{
+	int ret;
+	size_t i, count = 0;
+	struct iorec_image image;
+	struct area_stats stats[STATS_AREA_COUNT] = { 0 }, total = { 0 };
+	uint64_t span = 0;
+
+	ret = iorec_replay(recording, &image, NULL, NULL);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < recording->count; ++i) {
+		const struct iorec_record *record = &recording->record[i];
+		struct area_stats *area;
+
+		area = stats_area(stats, &count, record->area);
+		if (!area)
+			continue;
+
+		if (record->write)
+			area->writes++;
+		else
+			area->reads++;
+		area->time_ns += record->duration;
+	}
+
+	for (i = 0; i < image.count; ++i) {
+		struct area_stats *area;
+
+		area = stats_area(stats, &count, image.reg[i].area);
+		if (area)
+			area->redundant += image.reg[i].redundant;
+	}
+
+	if (recording->count)
+		span = recording->record[recording->count - 1].timestamp -
+		       recording->record[0].timestamp;
+
+	printf("records %zu, dropped %" PRIu64 ", span %" PRIu64 " ns\n",
+	       recording->count, recording->dropped, span);
+	printf("%-16s %10s %10s %10s %14s\n", "area", "reads", "writes",
+	       "redundant", "time_ns");
+	for (i = 0; i < count; ++i) {
+		printf("%-16s %10zu %10zu %10zu %14" PRIu64 "\n",
+		       stats[i].area, stats[i].reads, stats[i].writes,
+		       stats[i].redundant, stats[i].time_ns);
+		total.reads += stats[i].reads;
+		total.writes += stats[i].writes;
+		total.redundant += stats[i].redundant;
+		total.time_ns += stats[i].time_ns;
+	}
+	printf("%-16s %10zu %10zu %10zu %14" PRIu64 "\n", "total",
+	       total.reads, total.writes, total.redundant, total.time_ns);
+	printf("registers written %zu\n", image.count);
+
+	iorec_image_free(&image);
+	return 0;
+}
+
+static void print_redundant(const struct iorec_record *record, void *arg)
+{
+	printf("%" PRIu64 " %s w%u 0x%08" PRIx32 " 0x%08" PRIx32 "\n",
+	       record->seq, record->area, record->width, record->offset,
+	       record->value);
+}
+
+static int cmd_redundant(const struct iorec_recording *recording)
+{
+	int ret;
+	struct iorec_image image;
+
+	ret = iorec_replay(recording, &image, print_redundant, NULL);
+	if (ret)
+		return ret;
+
+	iorec_image_free(&image);
+	return 0;
+}
+
+static void print_register(char prefix, const struct iorec_register *reg)
+{
+	printf("%c%s w%u 0x%08" PRIx32 " 0x%08" PRIx32 "\n", prefix,
+	       reg->area, reg->width, reg->offset, reg->value);
+}
+
+static int cmd_replay(const struct iorec_recording *recording)
+{
+	int ret;
+	size_t i;
+	struct iorec_image image;
+
+	ret = iorec_replay(recording, &image, NULL, NULL);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < image.count; ++i)
+		print_register(' ', &image.reg[i]);
+
+	iorec_image_free(&image);
+	return 0;
+}
+
+/**
+ * @return number of differing registers or negative error code
+ */
+static int cmd_diff(const struct iorec_recording *a,
+		    const struct iorec_recording *b)
+{
+	int ret, diffs = 0;
+	size_t i = 0, j = 0;
+	struct iorec_image ia, ib;
+
+	ret = iorec_replay(a, &ia, NULL, NULL);
+	if (ret)
+		return ret;
+	ret = iorec_replay(b, &ib, NULL, NULL);
+	if (ret) {
+		iorec_image_free(&ia);
+		return ret;
+	}
+
+	while (i < ia.count || j < ib.count) {
+		int cmp;
+
+		if (i == ia.count)
+			cmp = 1;
+		else if (j == ib.count)
+			cmp = -1;
+		else
+			cmp = iorec_register_cmp(&ia.reg[i], &ib.reg[j]);
+
+		if (cmp < 0) {
+			print_register('-', &ia.reg[i++]);
+			diffs++;
+		} else if (cmp > 0) {
+			print_register('+', &ib.reg[j++]);
+			diffs++;
+		} else {
+			if (ia.reg[i].value != ib.reg[j].value) {
+				print_register('-', &ia.reg[i]);
+				print_register('+', &ib.reg[j]);
+				diffs++;
+			}
+			i++;
+			j++;
+		}
+	}
+
+	iorec_image_free(&ia);
+	iorec_image_free(&ib);
+	return diffs;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret, i;
+	int nrec;
+	const char *cmd;
+	struct iorec_recording recording[2];
+
+	if (argc < 3) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	cmd = argv[1];
+	nrec = strcmp(cmd, "diff") == 0 ? 2 : 1;
+	if (argc != 2 + nrec) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < nrec; ++i) {
+		ret = iorec_load(argv[2 + i], &recording[i]);
+		if (ret) {
+			fprintf(stderr, "Cannot load %s: %s\n", argv[2 + i],
+				strerror(-ret));
+			while (i--)
+				iorec_free(&recording[i]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (strcmp(cmd, "stats") == 0) {
+		ret = cmd_stats(&recording[0]);
+	} else if (strcmp(cmd, "redundant") == 0) {
+		ret = cmd_redundant(&recording[0]);
+	} else if (strcmp(cmd, "replay") == 0) {
+		ret = cmd_replay(&recording[0]);
+	} else if (strcmp(cmd, "diff") == 0) {
+		ret = cmd_diff(&recording[0], &recording[1]);
+	} else {
+		usage(argv[0]);
+		ret = -EINVAL;
+	}
+
+	for (i = 0; i < nrec; ++i)
+		iorec_free(&recording[i]);
+
+	if (ret < 0) {
+		fprintf(stderr, "%s failed: %s\n", cmd, strerror(-ret));
+		return EXIT_FAILURE;
+	}
+
+	/* like diff(1): 1 if the recordings differ */
+	return ret > 0 ? 1 : EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/**
+ * @file record.c
+ *
+ * Loading and replaying ACM register access recordings
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "iorec.h"
+
+/**
+ * @brief parse a single line of a recording
+ *
+ * @return 1 if a record was parsed, 0 for comments/empty lines, -EINVAL
+ *         on malformed lines
+ */
+static int iorec_parse(const char *line, struct iorec_record *record,
+		       uint64_t *dropped)
+{
+	char op;
+	int ret;
+
+	line += strspn(line, " \t");
+	if (*line == '\0' || *line == '\n')
+		return 0;
+
+	if (*line == '#') {
+		sscanf(line, "# dropped %" SCNu64, dropped);
+		return 0;
+	}
+
+	ret = sscanf(line, "%" SCNu64 " %" SCNu64 " %" SCNu32 " %23s %c%u %"
+		     SCNx32 " %" SCNx32, &record->seq, &record->timestamp,
+		     &record->duration, record->area, &op, &record->width,
+		     &record->offset, &record->value);
+	if (ret != 8 || (op != 'r' && op != 'w') ||
+	    (record->width != 16 && record->width != 32))
+		return -EINVAL;
+
+	record->write = op == 'w';
+	return 1;
+}
+
+/**
+ * @brief load a recording from file, "-" denotes stdin
+ */
+int iorec_load(const char *path, struct iorec_recording *recording)
+{
+	int ret = 0;
+	FILE *file;
+	char *line = NULL;
+	size_t len = 0, size = 0, lineno = 0;
+
+	memset(recording, 0, sizeof(*recording));
+
+	file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+	if (!file)
+		return -errno;
+
+	while (getline(&line, &len, file) >= 0) {
+		++lineno;
+
+		if (recording->count == size) {
+			struct iorec_record *record;
+
+			size = size ? size * 2 : 1024;
+			record = realloc(recording->record,
+					 size * sizeof(*record));
+			if (!record) {
+				ret = -ENOMEM;
+				break;
+			}
+			recording->record = record;
+		}
+
+		ret = iorec_parse(line, &recording->record[recording->count],
+				  &recording->dropped);
+		if (ret < 0) {
+			fprintf(stderr, "%s:%zu: malformed record\n", path,
+				lineno);
+			break;
+		}
+		recording->count += ret;
+		ret = 0;
+	}
+
+	free(line);
+	if (file != stdin)
+		fclose(file);
+	if (ret)
+		iorec_free(recording);
+
+	return ret;
+}
+
+/**
+ * @brief free a loaded recording
+ */
+void iorec_free(struct iorec_recording *recording)
+{
+	free(recording->record);
+	memset(recording, 0, sizeof(*recording));
+}
+
+/**
+ * @brief order registers by area and offset
+ */
+int iorec_register_cmp(const struct iorec_register *a,
+		       const struct iorec_register *b)
+{
+	int ret = strcmp(a->area, b->area);
+
+	if (ret)
+		return ret;
+	if (a->offset != b->offset)
+		return a->offset < b->offset ? -1 : 1;
+
+	return 0;
+}
+
+/**
+ * @brief qsort()/bsearch() wrapper of iorec_register_cmp()
+ */
+static int iorec_register_qcmp(const void *a, const void *b)
+{
+	return iorec_register_cmp(a, b);
+}
+
+/**
+ * @brief replay the writes of a recording into a register shadow
+ *
+ * @param recording recording to be replayed
+ * @param image resulting register image
+ * @param redundant called for each redundant write, may be NULL
+ * @param arg argument passed to @p redundant
+ */
+int iorec_replay(const struct iorec_recording *recording,
+		 struct iorec_image *image, iorec_redundant_cb redundant,
+		 void *arg)
+{
+	size_t i, n;
+
+	image->count = 0;
+	image->reg = calloc(recording->count ? recording->count : 1,
+			    sizeof(*image->reg));
+	if (!image->reg)
+		return -ENOMEM;
+
+	/* collect all written registers */
+	for (i = 0; i < recording->count; ++i) {
+		const struct iorec_record *record = &recording->record[i];
+
+		if (!record->write)
+			continue;
+
+		image->reg[image->count].area = record->area;
+		image->reg[image->count].offset = record->offset;
+		image->reg[image->count].width = record->width;
+		image->count++;
+	}
+
+	qsort(image->reg, image->count, sizeof(*image->reg),
+	      iorec_register_qcmp);
+	for (i = 0, n = 0; i < image->count; ++i)
+		if (n == 0 ||
+		    iorec_register_cmp(&image->reg[n - 1], &image->reg[i]))
+			image->reg[n++] = image->reg[i];
+	image->count = n;
+
+	/* apply writes in recording order */
+	for (i = 0; i < recording->count; ++i) {
+		const struct iorec_record *record = &recording->record[i];
+		struct iorec_register key, *reg;
+
+		if (!record->write)
+			continue;
+
+		key.area = record->area;
+		key.offset = record->offset;
+		reg = bsearch(&key, image->reg, image->count,
+			      sizeof(*image->reg), iorec_register_qcmp);
+
+		reg->writes++;
+		if (reg->written && reg->value == record->value) {
+			reg->redundant++;
+			if (redundant)
+				redundant(record, arg);
+		}
+		reg->value = record->value;
+		reg->width = record->width;
+		reg->written = true;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief free a register image
+ */
+void iorec_image_free(struct iorec_image *image)
+{
+	free(image->reg);
+	memset(image, 0, sizeof(*image));
+}
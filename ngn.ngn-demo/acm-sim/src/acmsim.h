@@ -0,0 +1,102 @@
+/**
+ * @file acmsim.h
+ *
+ * Userspace simulation of the ACM driver interface
+ *
+ * libacmsim.so is preloaded (LD_PRELOAD) into applications using the ACM
+ * driver interface, i.e. libacmconfig and acm-demo. It intercepts the file
+ * access to the driver's SYSFS attributes below ACMDEV_BASE and to the
+ * message buffer devices below MSGBUF_BASE and serves them from an in-memory
+ * model of the ACM IP. All other file accesses are passed to the C library
+ * unchanged.
+ *
+ * Access latencies of the real hardware are emulated according to a
+ * configurable timing model (see timing.c).
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#ifndef ACMSIM_H_
+#define ACMSIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include <linux/acm/acmdrv.h>
+
+#ifndef stringify
+#define stringify(s) _stringify(s)
+#define _stringify(s) #s
+#endif
+
+#ifndef ACMDEV_BASE
+/**
+ * @brief base SYSFS directory of the simulated ACM device
+ */
+#define ACMDEV_BASE "/sys/devices/acm/"
+#endif
+
+#ifndef MSGBUF_BASE
+/**
+ * @brief directory of the simulated message buffer devices
+ */
+#define MSGBUF_BASE "/dev/"
+#endif
+
+/**
+ * @brief number of message buffers provided by the simulated IP
+ */
+#define ACMSIM_MSGBUF_COUNT	32
+
+/**
+ * @brief message buffer data width in bytes
+ */
+#define ACMSIM_MSGBUF_DATAWIDTH	4
+
+/**
+ * @brief maximum size of a single message buffer
+ *
+ * Limited by the sub buffer size field of the message buffer descriptor.
+ */
+#define ACMSIM_MSGBUF_MAXSIZE	\
+	(((BITMASK(ACMDRV_BUFF_DESC_SUB_BUFF_SIZE_BIT) >>	\
+	   ACMDRV_BUFF_DESC_SUB_BUFF_SIZE_BIT_L) + 1) * ACMSIM_MSGBUF_DATAWIDTH)
+
+/**
+ * @brief simulated message buffer memory size
+ */
+#define ACMSIM_MSGBUF_MEMSIZE	(ACMSIM_MSGBUF_COUNT * ACMSIM_MSGBUF_MAXSIZE)
+
+struct acmsim_attr;
+
+/**
+ * @brief state of a file opened within the simulation
+ */
+struct acmsim_file {
+	const struct acmsim_attr *attr;	/**< SYSFS attribute, if any */
+	int msgbuf;			/**< message buffer index otherwise */
+	off_t pos;			/**< current file position */
+	int flags;			/**< open flags */
+};
+
+/* device.c */
+int acmsim_device_open(const char *path, int flags, struct acmsim_file *file);
+ssize_t acmsim_device_read(struct acmsim_file *file, void *buf, size_t size,
+			   off_t off);
+ssize_t acmsim_device_write(struct acmsim_file *file, const void *buf,
+			    size_t size, off_t off);
+bool acmsim_device_is_seekable(const struct acmsim_file *file);
+bool acmsim_path_is_simulated(const char *path);
+int acmsim_port_mac(const char *ifname, uint8_t *mac);
+
+/* timing.c */
+void acmsim_sysfs_delay(size_t size);
+void acmsim_msgbuf_delay(int msgbuf, size_t size);
+void acmsim_dma_update(int module, const struct acmdrv_bypass_dma_command *scatter,
+		       const struct acmdrv_bypass_dma_command *prefetch);
+void acmsim_schedule_update(int module, uint64_t cycle_ns,
+			    const struct acmdrv_timespec64 *start);
+void acmsim_dma_reset(void);
+
+#endif /* ACMSIM_H_ */
@@ -0,0 +1,1047 @@
+/**
+ * @file device.c
+ *
+ * In-memory model of the ACM driver's SYSFS attributes and message buffers
+ *
+ * Binary attributes keep their content in memory and follow the access rules
+ * of the driver, i.e. accesses are restricted to the attribute size and
+ * aligned to the attribute's item size. Attributes with side effects on the
+ * IP state (config_state, clear_all_fpga, sched_start_table, ...) update the
+ * model accordingly. ASCII status and error attributes report a quiescent IP.
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "acmsim.h"
+
+#define ARRAY_SIZE(a)	(sizeof(a) / sizeof((a)[0]))
+
+/**
+ * @brief simulated SYSFS attribute
+ */
+struct acmsim_attr {
+	const char *group;	/**< SYSFS group */
+	const char *name;	/**< attribute name */
+	size_t size;		/**< binary attribute size, 0 for ASCII */
+	size_t elemsize;	/**< access granularity of binary attributes */
+	mode_t mode;		/**< access permissions */
+	int index;		/**< bypass module of ASCII _Mx attributes */
+	/** @brief ASCII attribute content generation */
+	int (*show)(const struct acmsim_attr *attr, char *buf, size_t len);
+	/** @brief ASCII attribute write */
+	int (*store)(const struct acmsim_attr *attr, const char *buf,
+		     size_t len);
+	/** @brief binary attribute side effects after write */
+	int (*update)(const struct acmsim_attr *attr, off_t off, size_t size);
+	uint8_t *data;		/**< binary attribute content */
+};
+
+static int show_status(const struct acmsim_attr *attr, char *buf, size_t len);
+static int show_error(const struct acmsim_attr *attr, char *buf, size_t len);
+static int show_device(const struct acmsim_attr *attr, char *buf, size_t len);
+static int show_poll_time(const struct acmsim_attr *attr, char *buf,
+			  size_t len);
+static int store_poll_time(const struct acmsim_attr *attr, const char *buf,
+			   size_t len);
+static int update_config_state(const struct acmsim_attr *attr, off_t off,
+			       size_t size);
+static int update_config_modules(const struct acmsim_attr *attr, off_t off,
+				 size_t size);
+static int update_clear_all(const struct acmsim_attr *attr, off_t off,
+			    size_t size);
+static int update_dma(const struct acmsim_attr *attr, off_t off, size_t size);
+static int update_schedule(const struct acmsim_attr *attr, off_t off,
+			   size_t size);
+static int update_lock(const struct acmsim_attr *attr, off_t off, size_t size);
+static int update_diagnostics(const struct acmsim_attr *attr, off_t off,
+			      size_t size);
+
+#define BIN_ATTR(_group, _name, _size, _elsize, _mode, _update)	\
+	{							\
+		.group = stringify(_group),			\
+		.name = #_name,					\
+		.size = (_size),				\
+		.elemsize = (_elsize),				\
+		.mode = (_mode),				\
+		.update = (_update),				\
+	}
+
+#define CONFIG_ATTR(_name, _size, _elsize, _mode, _update)	\
+	BIN_ATTR(ACMDRV_SYSFS_CONFIG_GROUP, _name, _size, _elsize, _mode, \
+		 _update)
+
+#define BYPASS_ATTR(_name, _elsize, _elno, _mode, _update)	\
+	CONFIG_ATTR(_name, (_elsize) * ACMDRV_BYPASS_MODULES_COUNT * (_elno), \
+		    _elsize, _mode, _update)
+
+#define BYPASS_REG_ATTR(_name)					\
+	CONFIG_ATTR(_name, sizeof(uint32_t) * ACMDRV_BYPASS_MODULES_COUNT, \
+		    sizeof(uint32_t), 0644, NULL)
+
+#define ASCII_ATTR_M(_group, _name, _show, _store, _mode, _index)	\
+	{							\
+		.group = stringify(_group),			\
+		.name = #_name "_M" #_index,			\
+		.mode = (_mode),				\
+		.index = (_index),				\
+		.show = (_show),				\
+		.store = (_store),				\
+	}
+
+#define STATUS_ATTR(_name)					\
+	ASCII_ATTR_M(ACMDRV_SYSFS_STATUS_GROUP, _name, show_status,	\
+		     NULL, 0444, 0),				\
+	ASCII_ATTR_M(ACMDRV_SYSFS_STATUS_GROUP, _name, show_status,	\
+		     NULL, 0444, 1)
+
+#define ERROR_ATTR(_name)					\
+	ASCII_ATTR_M(ACMDRV_SYSFS_ERROR_GROUP, _name, show_error,	\
+		     NULL, 0444, 0),				\
+	ASCII_ATTR_M(ACMDRV_SYSFS_ERROR_GROUP, _name, show_error,	\
+		     NULL, 0444, 1)
+
+#define DEVICE_ATTR(_name)					\
+	{							\
+		.group = stringify(ACMDRV_SYSFS_STATUS_GROUP), \
+		.name = #_name,					\
+		.mode = 0444,					\
+		.show = show_device,				\
+	}
+
+static struct acmsim_attr attrs[] = {
+	/* config_bin */
+	CONFIG_ATTR(configuration_id, sizeof(uint32_t), sizeof(uint32_t),
+		    0644, NULL),
+	CONFIG_ATTR(config_state, sizeof(enum acmdrv_status),
+		    sizeof(enum acmdrv_status), 0644, update_config_state),
+	CONFIG_ATTR(config_modules, sizeof(uint32_t), sizeof(uint32_t), 0644,
+		    update_config_modules),
+	CONFIG_ATTR(msg_buff_desc,
+		    ACMSIM_MSGBUF_COUNT * sizeof(struct acmdrv_buff_desc),
+		    sizeof(struct acmdrv_buff_desc), 0644, NULL),
+	CONFIG_ATTR(msg_buff_alias,
+		    ACMSIM_MSGBUF_COUNT * sizeof(struct acmdrv_buff_alias),
+		    sizeof(struct acmdrv_buff_alias), 0644, NULL),
+	BYPASS_ATTR(lookup_pattern, sizeof(struct acmdrv_bypass_lookup),
+		    ACMDRV_BYPASS_NR_RULES, 0200, NULL),
+	BYPASS_ATTR(lookup_mask, sizeof(struct acmdrv_bypass_lookup),
+		    ACMDRV_BYPASS_NR_RULES, 0200, NULL),
+	BYPASS_ATTR(layer7_pattern, sizeof(struct acmdrv_bypass_layer7_check),
+		    ACMDRV_BYPASS_NR_RULES, 0200, NULL),
+	BYPASS_ATTR(layer7_mask, sizeof(struct acmdrv_bypass_layer7_check),
+		    ACMDRV_BYPASS_NR_RULES, 0200, NULL),
+	BYPASS_ATTR(stream_trigger, sizeof(struct acmdrv_bypass_stream_trigger),
+		    ACMDRV_BYPASS_NR_RULES + 1, 0200, NULL),
+	BYPASS_ATTR(scatter_dma, sizeof(struct acmdrv_bypass_dma_command),
+		    ACMDRV_BYPASS_SCATTER_DMA_CMD_COUNT, 0200, update_dma),
+	BYPASS_ATTR(prefetch_dma, sizeof(struct acmdrv_bypass_dma_command),
+		    ACMDRV_BYPASS_PREFETCH_DMA_CMD_COUNT, 0200, update_dma),
+	BYPASS_ATTR(gather_dma, sizeof(struct acmdrv_bypass_dma_command),
+		    ACMDRV_BYPASS_GATHER_DMA_CMD_COUNT, 0200, NULL),
+	BYPASS_ATTR(const_buffer, sizeof(struct acmdrv_bypass_const_buffer),
+		    1, 0644, NULL),
+	CONFIG_ATTR(redund_cnt_tab,
+		    ACMDRV_BYPASS_MODULES_COUNT *
+		    ACMDRV_REDUN_TABLE_ENTRY_COUNT *
+		    sizeof(struct acmdrv_redun_ctrl_entry),
+		    sizeof(struct acmdrv_redun_ctrl_entry), 0644, NULL),
+	CONFIG_ATTR(redund_status_tab,
+		    ACMDRV_REDUN_TABLE_ENTRY_COUNT *
+		    sizeof(struct acmdrv_redun_status),
+		    sizeof(struct acmdrv_redun_status), 0444, NULL),
+	CONFIG_ATTR(redund_intseqnum_tab,
+		    ACMDRV_REDUN_TABLE_ENTRY_COUNT *
+		    sizeof(struct acmdrv_redun_intseqnum),
+		    sizeof(struct acmdrv_redun_intseqnum), 0644, NULL),
+	CONFIG_ATTR(sched_down_counter,
+		    ACMDRV_SCHEDULER_COUNT *
+		    sizeof(struct acmdrv_scheduler_down_counter),
+		    sizeof(struct acmdrv_scheduler_down_counter), 0644, NULL),
+	CONFIG_ATTR(sched_tab_row,
+		    ACMDRV_SCHEDULER_COUNT * ACMDRV_SCHED_TBL_COUNT *
+		    ACMDRV_SCHED_TBL_ROW_COUNT *
+		    sizeof(struct acmdrv_sched_tbl_row),
+		    sizeof(struct acmdrv_sched_tbl_row), 0644, NULL),
+	CONFIG_ATTR(table_status,
+		    ACMDRV_SCHEDULER_COUNT * ACMDRV_SCHED_TBL_COUNT *
+		    sizeof(struct acmdrv_sched_tbl_status),
+		    sizeof(struct acmdrv_sched_tbl_status), 0444, NULL),
+	CONFIG_ATTR(sched_switch_event,
+		    ACMDRV_SCHEDULER_COUNT *
+		    sizeof(struct acmdrv_sched_switch_event),
+		    sizeof(struct acmdrv_sched_switch_event), 0444, NULL),
+	CONFIG_ATTR(sched_cycle_time,
+		    ACMDRV_SCHEDULER_COUNT * ACMDRV_SCHED_TBL_COUNT *
+		    sizeof(struct acmdrv_sched_cycle_time),
+		    sizeof(struct acmdrv_sched_cycle_time), 0644, NULL),
+	CONFIG_ATTR(sched_start_table,
+		    ACMDRV_SCHEDULER_COUNT * ACMDRV_SCHED_TBL_COUNT *
+		    sizeof(struct acmdrv_timespec64),
+		    sizeof(struct acmdrv_timespec64), 0644, update_schedule),
+	CONFIG_ATTR(emergency_disable,
+		    ACMDRV_SCHEDULER_COUNT *
+		    sizeof(struct acmdrv_sched_emerg_disable),
+		    sizeof(struct acmdrv_sched_emerg_disable), 0644, NULL),
+	BYPASS_REG_ATTR(cntl_ngn_enable),
+	BYPASS_REG_ATTR(cntl_lookup_enable),
+	BYPASS_REG_ATTR(cntl_layer7_enable),
+	BYPASS_REG_ATTR(cntl_ingress_policing_enable),
+	BYPASS_REG_ATTR(cntl_connection_mode),
+	BYPASS_REG_ATTR(cntl_output_disable),
+	BYPASS_REG_ATTR(cntl_layer7_length),
+	BYPASS_REG_ATTR(cntl_speed),
+	BYPASS_REG_ATTR(cntl_gather_delay),
+	BYPASS_REG_ATTR(cntl_ingress_policing_control),
+	CONFIG_ATTR(clear_all_fpga, sizeof(uint32_t), sizeof(uint32_t), 0200,
+		    update_clear_all),
+	CONFIG_ATTR(individual_recovery,
+		    sizeof(struct acmdrv_redun_individual_recovery),
+		    sizeof(struct acmdrv_redun_individual_recovery), 0644,
+		    NULL),
+	CONFIG_ATTR(base_recovery, sizeof(struct acmdrv_redun_base_recovery),
+		    sizeof(struct acmdrv_redun_base_recovery), 0644, NULL),
+	CONFIG_ATTR(failover_policy,
+		    ACMDRV_BYPASS_MODULES_COUNT *
+		    sizeof(struct acmdrv_failover_policy),
+		    sizeof(struct acmdrv_failover_policy), 0644, NULL),
+	CONFIG_ATTR(link_event,
+		    ACMDRV_BYPASS_MODULES_COUNT *
+		    sizeof(struct acmdrv_link_event),
+		    sizeof(struct acmdrv_link_event), 0444, NULL),
+
+	/* control_bin */
+	BIN_ATTR(ACMDRV_SYSFS_CONTROL_GROUP, lock_msg_bufs,
+		 sizeof(struct acmdrv_msgbuf_lock_ctrl),
+		 sizeof(struct acmdrv_msgbuf_lock_ctrl), 0644, update_lock),
+	BIN_ATTR(ACMDRV_SYSFS_CONTROL_GROUP, unlock_msg_bufs,
+		 sizeof(struct acmdrv_msgbuf_lock_ctrl),
+		 sizeof(struct acmdrv_msgbuf_lock_ctrl), 0644, update_lock),
+	BIN_ATTR(ACMDRV_SYSFS_CONTROL_GROUP, overwritten,
+		 ACMSIM_MSGBUF_COUNT * sizeof(uint32_t), sizeof(uint32_t),
+		 0444, NULL),
+
+	/* status */
+	STATUS_ATTR(rx_bytes),
+	STATUS_ATTR(rx_frames),
+	STATUS_ATTR(fcs_errors),
+	STATUS_ATTR(size_errors),
+	STATUS_ATTR(lookup_match_vec),
+	STATUS_ATTR(layer7_match_vec),
+	STATUS_ATTR(last_stream_trigger),
+	STATUS_ATTR(ingress_win_stat),
+	STATUS_ATTR(sched_trig_cnt_prev_cyc),
+	STATUS_ATTR(sched_1st_cond_trig_cnt_prev_cyc),
+	STATUS_ATTR(pending_req_max_num),
+	STATUS_ATTR(scatter_DMA_frames_cnt_curr),
+	STATUS_ATTR(scatter_DMA_bytes_cnt_prev),
+	STATUS_ATTR(scatter_DMA_bytes_cnt_curr),
+	STATUS_ATTR(tx_bytes_prev),
+	STATUS_ATTR(tx_bytes_curr),
+	STATUS_ATTR(tx_frames_cyc_1st_change),
+	STATUS_ATTR(tx_frames_cyc_last_change),
+	STATUS_ATTR(rx_frames_curr),
+	STATUS_ATTR(runt_frames),
+	STATUS_ATTR(mii_errors),
+	STATUS_ATTR(sof_errors),
+	STATUS_ATTR(layer7_missmatch_cnt),
+	STATUS_ATTR(rx_frames_prev),
+	STATUS_ATTR(rx_frames_cycle_change),
+	STATUS_ATTR(drop_frames_cnt_prev),
+	STATUS_ATTR(scatter_DMA_frames_cnt_prev),
+	STATUS_ATTR(tx_frames_prev),
+	STATUS_ATTR(gmii_errors_set_prev),
+	STATUS_ATTR(gmii_error_prev_cycle),
+	STATUS_ATTR(disable_overrun_prev),
+	STATUS_ATTR(tx_frame_cycle_change),
+	STATUS_ATTR(ifc_version),
+	STATUS_ATTR(config_version),
+	STATUS_ATTR(redund_frames_produced),
+	DEVICE_ATTR(device_id),
+	DEVICE_ATTR(version_id),
+	DEVICE_ATTR(revision_id),
+	DEVICE_ATTR(extended_status),
+	DEVICE_ATTR(testmodule_enable),
+	DEVICE_ATTR(cfg_read_back),
+	DEVICE_ATTR(debug_enable),
+	DEVICE_ATTR(individual_recovery),
+	DEVICE_ATTR(rx_redundancy),
+	DEVICE_ATTR(time_freq),
+	DEVICE_ATTR(msgbuf_memsize),
+	DEVICE_ATTR(msgbuf_count),
+	DEVICE_ATTR(msgbuf_datawidth),
+
+	/* error */
+	ERROR_ATTR(halt_on_error),
+	ERROR_ATTR(halt_on_other_bypass),
+	ERROR_ATTR(error_flags),
+	ERROR_ATTR(policing_flags),
+
+	/* diag */
+	BIN_ATTR(ACMDRV_SYSFS_DIAG_GROUP, diagnostics_M0,
+		 sizeof(struct acmdrv_diagnostics),
+		 sizeof(struct acmdrv_diagnostics), 0644, update_diagnostics),
+	BIN_ATTR(ACMDRV_SYSFS_DIAG_GROUP, diagnostics_M1,
+		 sizeof(struct acmdrv_diagnostics),
+		 sizeof(struct acmdrv_diagnostics), 0644, update_diagnostics),
+	ASCII_ATTR_M(ACMDRV_SYSFS_DIAG_GROUP, diag_poll_time, show_poll_time,
+		     store_poll_time, 0644, 0),
+	ASCII_ATTR_M(ACMDRV_SYSFS_DIAG_GROUP, diag_poll_time, show_poll_time,
+		     store_poll_time, 0644, 1),
+	BIN_ATTR(ACMDRV_SYSFS_DIAG_GROUP, redund_stats,
+		 sizeof(struct acmdrv_redun_stats),
+		 sizeof(struct acmdrv_redun_stats), 0644, update_diagnostics),
+	BIN_ATTR(ACMDRV_SYSFS_DIAG_GROUP, diag_thresholds_M0,
+		 sizeof(struct acmdrv_diag_thresholds),
+		 sizeof(struct acmdrv_diag_thresholds), 0644, NULL),
+	BIN_ATTR(ACMDRV_SYSFS_DIAG_GROUP, diag_thresholds_M1,
+		 sizeof(struct acmdrv_diag_thresholds),
+		 sizeof(struct acmdrv_diag_thresholds), 0644, NULL),
+	BIN_ATTR(ACMDRV_SYSFS_DIAG_GROUP, diag_alarm_M0,
+		 sizeof(struct acmdrv_diag_alarm),
+		 sizeof(struct acmdrv_diag_alarm), 0444, NULL),
+	BIN_ATTR(ACMDRV_SYSFS_DIAG_GROUP, diag_alarm_M1,
+		 sizeof(struct acmdrv_diag_alarm),
+		 sizeof(struct acmdrv_diag_alarm), 0444, NULL),
+};
+
+/**
+ * @brief simulated IP state
+ */
+static struct {
+	pthread_mutex_t lock;
+	enum acmdrv_status status;
+	uint32_t modules;
+	uint32_t live_msgbufs;
+	struct acmdrv_msgbuf_lock_ctrl locked;
+	unsigned int diag_poll_time[ACMDRV_BYPASS_MODULES_COUNT];
+	uint8_t msgbuf[ACMSIM_MSGBUF_COUNT][ACMSIM_MSGBUF_MAXSIZE];
+} ip = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.status = ACMDRV_INIT_STATE,
+	.modules = ACMDRV_CONFIG_MODULES_ALL,
+};
+
+static struct acmsim_attr *find_attr(const char *group, size_t grouplen,
+				     const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(attrs); ++i) {
+		if (strlen(attrs[i].group) == grouplen &&
+		    !strncmp(group, attrs[i].group, grouplen) &&
+		    !strcmp(name, attrs[i].name))
+			return &attrs[i];
+	}
+
+	return NULL;
+}
+
+static void *attr_data(const char *group, const char *name)
+{
+	return find_attr(group, strlen(group), name)->data;
+}
+
+#define CONFIG_DATA(_name)	\
+	attr_data(stringify(ACMDRV_SYSFS_CONFIG_GROUP), #_name)
+
+/**
+ * @brief reset the IP to its state after power on
+ *
+ * Must be called with ip.lock held.
+ */
+static void ip_reset(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(attrs); ++i)
+		if (attrs[i].data)
+			memset(attrs[i].data, 0, attrs[i].size);
+
+	memset(ip.msgbuf, 0, sizeof(ip.msgbuf));
+	ACMDRV_MSGBUF_LOCK_CTRL_ZERO(&ip.locked);
+	acmsim_dma_reset();
+}
+
+static void __attribute__((constructor)) acmsim_device_init(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(attrs); ++i) {
+		if (attrs[i].size == 0)
+			continue;
+
+		attrs[i].data = calloc(1, attrs[i].size);
+		if (!attrs[i].data) {
+			fprintf(stderr, "acmsim: out of memory\n");
+			abort();
+		}
+	}
+
+	*(enum acmdrv_status *)CONFIG_DATA(config_state) = ip.status;
+	*(uint32_t *)CONFIG_DATA(config_modules) = ip.modules;
+}
+
+static struct acmdrv_buff_desc *msgbuf_desc(int i)
+{
+	return (struct acmdrv_buff_desc *)CONFIG_DATA(msg_buff_desc) + i;
+}
+
+static size_t msgbuf_size(int i)
+{
+	return acmdrv_buff_desc_sub_buffer_size_read(msgbuf_desc(i)) *
+		ACMSIM_MSGBUF_DATAWIDTH;
+}
+
+static int show_status(const struct acmsim_attr *attr, char *buf, size_t len)
+{
+	return snprintf(buf, len, "0x%X", 0);
+}
+
+static int show_error(const struct acmsim_attr *attr, char *buf, size_t len)
+{
+	return snprintf(buf, len, "0X%X\n", 0);
+}
+
+static int show_device(const struct acmsim_attr *attr, char *buf, size_t len)
+{
+	if (!strcmp(attr->name, "device_id"))
+		return snprintf(buf, len, "0x%X\n", 0xACC0);
+	if (!strcmp(attr->name, "version_id"))
+		return snprintf(buf, len, "%s\n", "sim");
+	if (!strcmp(attr->name, "revision_id"))
+		return snprintf(buf, len, "%s\n", "0");
+	if (!strcmp(attr->name, "cfg_read_back") ||
+	    !strcmp(attr->name, "individual_recovery") ||
+	    !strcmp(attr->name, "rx_redundancy"))
+		return snprintf(buf, len, "%d\n", 1);
+	if (!strcmp(attr->name, "time_freq"))
+		return snprintf(buf, len, "%u\n", 100);
+	if (!strcmp(attr->name, "msgbuf_memsize"))
+		return snprintf(buf, len, "%u\n",
+				(unsigned int)ACMSIM_MSGBUF_MEMSIZE);
+	if (!strcmp(attr->name, "msgbuf_count"))
+		return snprintf(buf, len, "%u\n", ACMSIM_MSGBUF_COUNT);
+	if (!strcmp(attr->name, "msgbuf_datawidth"))
+		return snprintf(buf, len, "%u\n", ACMSIM_MSGBUF_DATAWIDTH);
+
+	return snprintf(buf, len, "%d\n", 0);
+}
+
+static int show_poll_time(const struct acmsim_attr *attr, char *buf,
+			  size_t len)
+{
+	return snprintf(buf, len, "%u\n", ip.diag_poll_time[attr->index]);
+}
+
+static int store_poll_time(const struct acmsim_attr *attr, const char *buf,
+			   size_t len)
+{
+	char value[32];
+	char *end;
+
+	if (len >= sizeof(value))
+		return -EINVAL;
+
+	memcpy(value, buf, len);
+	value[len] = '\0';
+	ip.diag_poll_time[attr->index] = strtoul(value, &end, 0);
+	if (end == value)
+		return -EINVAL;
+
+	return 0;
+}
+
+/**
+ * @brief message buffers referenced by the DMA commands of a module
+ */
+static uint32_t module_msgbufs(int module)
+{
+	const struct acmdrv_bypass_dma_command *cmd;
+	uint32_t usage = 0;
+	unsigned int i;
+
+	cmd = (const struct acmdrv_bypass_dma_command *)
+		CONFIG_DATA(scatter_dma) +
+		module * ACMDRV_BYPASS_SCATTER_DMA_CMD_COUNT;
+	for (i = 0; i < ACMDRV_BYPASS_SCATTER_DMA_CMD_COUNT; ++i)
+		if (RVAL(ACMDRV_BYPASS_DMA_CMD_S_COMMAND_BIT, cmd[i].cmd))
+			usage |= 1U << RVAL(ACMDRV_BYPASS_DMA_CMD_S_RX_MSGBUF_ID_BIT,
+					    cmd[i].cmd);
+
+	cmd = (const struct acmdrv_bypass_dma_command *)
+		CONFIG_DATA(prefetch_dma) +
+		module * ACMDRV_BYPASS_PREFETCH_DMA_CMD_COUNT;
+	for (i = 0; i < ACMDRV_BYPASS_PREFETCH_DMA_CMD_COUNT; ++i)
+		if (RVAL(ACMDRV_BYPASS_DMA_CMD_P_COMMAND_BIT, cmd[i].cmd) ==
+		    ACMDRV_BYPASS_DMA_CMD_P_COMMAND_MOV_MSG_BUFF)
+			usage |= 1U << RVAL(ACMDRV_BYPASS_DMA_CMD_P_MSGBUF_ID_BIT,
+					    cmd[i].cmd);
+
+	return usage;
+}
+
+/**
+ * @brief remove the configuration of the session's modules only
+ *
+ * Like the driver, message buffers still used by the other module are kept.
+ */
+static void remove_modules(uint32_t modules)
+{
+	struct acmdrv_sched_tbl_status *status = CONFIG_DATA(table_status);
+	struct acmdrv_buff_alias *alias = CONFIG_DATA(msg_buff_alias);
+	uint32_t msgbufs = 0, keep = 0;
+	int module, i;
+
+	for (module = 0; module < ACMDRV_BYPASS_MODULES_COUNT; ++module) {
+		if (modules & (1U << module))
+			msgbufs |= module_msgbufs(module);
+		else
+			keep |= module_msgbufs(module);
+	}
+	msgbufs &= ~keep;
+
+	for (i = 0; i < ACMSIM_MSGBUF_COUNT; ++i) {
+		if (!(msgbufs & (1U << i)))
+			continue;
+		msgbuf_desc(i)->desc = 0;
+		memset(&alias[i], 0, sizeof(alias[i]));
+	}
+
+	for (module = 0; module < ACMDRV_BYPASS_MODULES_COUNT; ++module) {
+		if (!(modules & (1U << module)))
+			continue;
+		memset(&status[module * ACMDRV_SCHED_TBL_COUNT], 0,
+		       ACMDRV_SCHED_TBL_COUNT * sizeof(*status));
+		memset((struct acmdrv_bypass_dma_command *)
+		       CONFIG_DATA(scatter_dma) +
+		       module * ACMDRV_BYPASS_SCATTER_DMA_CMD_COUNT, 0,
+		       ACMDRV_BYPASS_SCATTER_DMA_CMD_COUNT *
+		       sizeof(struct acmdrv_bypass_dma_command));
+		memset((struct acmdrv_bypass_dma_command *)
+		       CONFIG_DATA(prefetch_dma) +
+		       module * ACMDRV_BYPASS_PREFETCH_DMA_CMD_COUNT, 0,
+		       ACMDRV_BYPASS_PREFETCH_DMA_CMD_COUNT *
+		       sizeof(struct acmdrv_bypass_dma_command));
+	}
+	update_dma(NULL, 0, 0);
+}
+
+static int update_config_state(const struct acmsim_attr *attr, off_t off,
+			       size_t size)
+{
+	enum acmdrv_status *state = (enum acmdrv_status *)attr->data;
+	struct acmdrv_sched_tbl_status *status;
+	int i;
+
+	switch (*state) {
+	case ACMDRV_CONFIG_START_STATE:
+		if (ip.modules != ACMDRV_CONFIG_MODULES_ALL) {
+			ip.live_msgbufs = 0;
+			for (i = 0; i < ACMDRV_BYPASS_MODULES_COUNT; ++i)
+				if (ip.status == ACMDRV_RUN_STATE &&
+				    !(ip.modules & (1U << i)))
+					ip.live_msgbufs |= module_msgbufs(i);
+			remove_modules(ip.modules);
+			ip.status = ACMDRV_CONFIG_START_STATE;
+			break;
+		}
+		/* driver removes the running configuration */
+		memset(CONFIG_DATA(msg_buff_desc), 0,
+		       ACMSIM_MSGBUF_COUNT * sizeof(struct acmdrv_buff_desc));
+		status = CONFIG_DATA(table_status);
+		memset(status, 0, ACMDRV_SCHEDULER_COUNT *
+		       ACMDRV_SCHED_TBL_COUNT * sizeof(*status));
+		ACMDRV_MSGBUF_LOCK_CTRL_ZERO(&ip.locked);
+		acmsim_dma_reset();
+		ip.live_msgbufs = 0;
+		ip.status = ACMDRV_CONFIG_START_STATE;
+		break;
+	case ACMDRV_CONFIG_END_STATE:
+		ip.modules = ACMDRV_CONFIG_MODULES_ALL;
+		/* fall through */
+	case ACMDRV_RESTART_STATE:
+		ip.live_msgbufs = 0;
+		ip.status = ACMDRV_RUN_STATE;
+		break;
+	case ACMDRV_INIT_STATE:
+		ip.modules = ACMDRV_CONFIG_MODULES_ALL;
+		/* fall through */
+	case ACMDRV_DESYNC_STATE:
+		ip.live_msgbufs = 0;
+		ip.status = *state;
+		break;
+	default:
+		*state = ip.status;
+		return -EINVAL;
+	}
+
+	*state = ip.status;
+	*(uint32_t *)CONFIG_DATA(config_modules) = ip.modules;
+	return 0;
+}
+
+static int update_config_modules(const struct acmsim_attr *attr, off_t off,
+				 size_t size)
+{
+	uint32_t *modules = (uint32_t *)attr->data;
+
+	if (!*modules || (*modules & ~ACMDRV_CONFIG_MODULES_ALL)) {
+		*modules = ip.modules;
+		return -EINVAL;
+	}
+
+	ip.modules = *modules;
+	return 0;
+}
+
+static int update_clear_all(const struct acmsim_attr *attr, off_t off,
+			    size_t size)
+{
+	if (*(uint32_t *)attr->data != ACMDRV_CLEAR_ALL_PATTERN)
+		return -EINVAL;
+
+	ip_reset();
+	ip.live_msgbufs = 0;
+	ip.status = ACMDRV_CONFIG_START_STATE;
+	ip.modules = ACMDRV_CONFIG_MODULES_ALL;
+	*(enum acmdrv_status *)CONFIG_DATA(config_state) = ip.status;
+	*(uint32_t *)CONFIG_DATA(config_modules) = ip.modules;
+
+	return 0;
+}
+
+static int update_dma(const struct acmsim_attr *attr, off_t off, size_t size)
+{
+	const struct acmdrv_bypass_dma_command *scatter, *prefetch;
+	int module;
+
+	scatter = CONFIG_DATA(scatter_dma);
+	prefetch = CONFIG_DATA(prefetch_dma);
+
+	for (module = 0; module < ACMDRV_BYPASS_MODULES_COUNT; ++module)
+		acmsim_dma_update(module,
+			scatter + module * ACMDRV_BYPASS_SCATTER_DMA_CMD_COUNT,
+			prefetch + module *
+				ACMDRV_BYPASS_PREFETCH_DMA_CMD_COUNT);
+
+	return 0;
+}
+
+/**
+ * @brief apply a written schedule start time
+ *
+ * The IP starts the respective table at the given time and releases the
+ * other table of the scheduler. The simulation switches immediately, hence
+ * the switch event is completed at the start time right away.
+ */
+static int update_schedule(const struct acmsim_attr *attr, off_t off,
+			   size_t size)
+{
+	const struct acmdrv_timespec64 *start = (const void *)attr->data;
+	const struct acmdrv_sched_cycle_time *cycle =
+		CONFIG_DATA(sched_cycle_time);
+	struct acmdrv_sched_tbl_status *status = CONFIG_DATA(table_status);
+	struct acmdrv_sched_switch_event *event =
+		CONFIG_DATA(sched_switch_event);
+	unsigned int i, first, last;
+
+	first = off / attr->elemsize;
+	last = (off + size) / attr->elemsize;
+
+	for (i = first; i < last; ++i) {
+		unsigned int sched = i / ACMDRV_SCHED_TBL_COUNT;
+		unsigned int tbl;
+
+		for (tbl = 0; tbl < ACMDRV_SCHED_TBL_COUNT; ++tbl)
+			status[sched * ACMDRV_SCHED_TBL_COUNT + tbl].status = 0;
+
+		if (start[i].tv_sec == 0 && start[i].tv_nsec == 0) {
+			acmsim_schedule_update(sched, 0, &start[i]);
+			continue;
+		}
+
+		status[i].status = WVAL(ACMDRV_SCHED_TBL_STATUS_IN_USE_BIT, 1);
+		acmsim_schedule_update(sched, cycle[i].ns, &start[i]);
+
+		event[sched].seq++;
+		event[sched].table = i % ACMDRV_SCHED_TBL_COUNT;
+		event[sched].status = status[i].status;
+		event[sched].pending = 0;
+		event[sched].start = start[i];
+		event[sched].detected = start[i];
+		event[sched].requested = start[i];
+		event[sched].start_subns = 0;
+		event[sched].slip = 0;
+	}
+
+	return 0;
+}
+
+static int update_lock(const struct acmsim_attr *attr, off_t off, size_t size)
+{
+	struct acmdrv_msgbuf_lock_ctrl *lock = (void *)attr->data;
+	struct acmdrv_msgbuf_lock_ctrl mask;
+
+	ACMDRV_MSGBUF_LOCK_CTRL_ZERO(&mask);
+	ACMDRV_MSGBUF_LOCK_CTRL_GENMASK(&mask, ACMSIM_MSGBUF_COUNT - 1, 0);
+	ACMDRV_MSGBUF_LOCK_CTRL_AND(lock, lock, &mask);
+
+	if (!strcmp(attr->name, "lock_msg_bufs")) {
+		ACMDRV_MSGBUF_LOCK_CTRL_OR(&ip.locked, &ip.locked, lock);
+	} else {
+		ACMDRV_MSGBUF_LOCK_CTRL_NOT(lock, lock);
+		ACMDRV_MSGBUF_LOCK_CTRL_AND(&ip.locked, &ip.locked, lock);
+	}
+
+	/* read back reflects the current lock state */
+	memcpy(attr_data(attr->group, "lock_msg_bufs"), &ip.locked,
+	       sizeof(ip.locked));
+	ACMDRV_MSGBUF_LOCK_CTRL_NOT(lock, &ip.locked);
+	ACMDRV_MSGBUF_LOCK_CTRL_AND(lock, lock, &mask);
+	memcpy(attr_data(attr->group, "unlock_msg_bufs"), lock, sizeof(*lock));
+
+	return 0;
+}
+
+static int update_diagnostics(const struct acmsim_attr *attr, off_t off,
+			      size_t size)
+{
+	/* any write resets the diagnostic data */
+	memset(attr->data, 0, attr->size);
+	return 0;
+}
+
+static int open_msgbuf(const char *name)
+{
+	const struct acmdrv_buff_alias *alias = CONFIG_DATA(msg_buff_alias);
+	int i;
+
+	for (i = 0; i < ACMSIM_MSGBUF_COUNT; ++i) {
+		if (!acmdrv_buff_desc_valid_read(msgbuf_desc(i)))
+			continue;
+		if (!strncmp(acmdrv_buff_alias_alias_read(&alias[i]), name,
+			     sizeof(alias[i].alias)))
+			return i;
+	}
+
+	return -ENOENT;
+}
+
+/**
+ * @brief check if a path is served by the simulation
+ *
+ * Below MSGBUF_BASE only the aliases of the configured message buffers are
+ * simulated, all other devices there are passed to the C library.
+ */
+bool acmsim_path_is_simulated(const char *path)
+{
+	bool ret;
+
+	if (!strncmp(path, ACMDEV_BASE, strlen(ACMDEV_BASE)))
+		return true;
+	if (strncmp(path, MSGBUF_BASE, strlen(MSGBUF_BASE)))
+		return false;
+
+	pthread_mutex_lock(&ip.lock);
+	ret = open_msgbuf(path + strlen(MSGBUF_BASE)) >= 0;
+	pthread_mutex_unlock(&ip.lock);
+
+	return ret;
+}
+
+/**
+ * @brief open a simulated file
+ *
+ * @param path absolute file name
+ * @param flags open flags
+ * @param file file state to be initialized
+ * @return 0 on success, -ENODEV if the path is not part of the simulation,
+ *         -ENOENT if the attribute or message buffer does not exist,
+ *         negative error value otherwise
+ */
+int acmsim_device_open(const char *path, int flags, struct acmsim_file *file)
+{
+	const struct acmsim_attr *attr;
+	mode_t need = 0;
+	int ret;
+
+	memset(file, 0, sizeof(*file));
+	file->msgbuf = -1;
+	file->flags = flags;
+
+	pthread_mutex_lock(&ip.lock);
+	if (!strncmp(path, ACMDEV_BASE, strlen(ACMDEV_BASE))) {
+		const char *group = path + strlen(ACMDEV_BASE);
+		const char *name = strchr(group, '/');
+
+		attr = name ? find_attr(group, name - group, name + 1) : NULL;
+		if (!attr) {
+			ret = -ENOENT;
+			goto unlock;
+		}
+
+		if ((flags & O_ACCMODE) != O_WRONLY)
+			need |= S_IRUSR;
+		if ((flags & O_ACCMODE) != O_RDONLY)
+			need |= S_IWUSR;
+		if ((attr->mode & need) != need) {
+			ret = -EACCES;
+			goto unlock;
+		}
+
+		file->attr = attr;
+		ret = 0;
+	} else if (!strncmp(path, MSGBUF_BASE, strlen(MSGBUF_BASE))) {
+		/* the buffer may have been removed since the path was checked */
+		ret = open_msgbuf(path + strlen(MSGBUF_BASE));
+		if (ret < 0)
+			goto unlock;
+
+		file->msgbuf = ret;
+		ret = 0;
+	} else {
+		ret = -ENODEV;
+	}
+
+unlock:
+	pthread_mutex_unlock(&ip.lock);
+	return ret;
+}
+
+bool acmsim_device_is_seekable(const struct acmsim_file *file)
+{
+	return file->attr != NULL;
+}
+
+static ssize_t attr_read(const struct acmsim_attr *attr, void *buf,
+			 size_t size, off_t off)
+{
+	if (attr->show) {
+		char text[64];
+		int len;
+
+		len = attr->show(attr, text, sizeof(text));
+		if (off >= len)
+			return 0;
+		if (size > len - off)
+			size = len - off;
+		memcpy(buf, text + off, size);
+
+		return size;
+	}
+
+	if (off < 0)
+		return -EOVERFLOW;
+	if (off >= attr->size)
+		return 0;
+	if (size > attr->size - off)
+		size = attr->size - off;
+	if (size % attr->elemsize != 0 || off % attr->elemsize != 0)
+		return -EINVAL;
+
+	memcpy(buf, attr->data + off, size);
+
+	return size;
+}
+
+static ssize_t attr_write(const struct acmsim_attr *attr, const void *buf,
+			  size_t size, off_t off)
+{
+	int ret;
+
+	if (attr->store) {
+		ret = attr->store(attr, buf, size);
+		return ret ? ret : size;
+	}
+
+	if (!attr->data)
+		return -EIO;
+	if (off < 0)
+		return -EOVERFLOW;
+	if (off >= attr->size)
+		return -EFBIG;
+	if (size > attr->size - off)
+		size = attr->size - off;
+	if (size % attr->elemsize != 0 || off % attr->elemsize != 0)
+		return -EINVAL;
+
+	memcpy(attr->data + off, buf, size);
+
+	if (attr->update) {
+		ret = attr->update(attr, off, size);
+		if (ret)
+			return ret;
+	}
+
+	return size;
+}
+
+static bool msgbuf_auto_lock(int i)
+{
+	return acmdrv_buff_desc_auto_lock_read(msgbuf_desc(i));
+}
+
+/**
+ * @brief check if a message buffer may be accessed
+ *
+ * Like the driver, the message buffers of a module kept running during the
+ * configuration session of another module stay accessible.
+ */
+static bool msgbuf_running(int i)
+{
+	return ip.status == ACMDRV_RUN_STATE || (ip.live_msgbufs & (1U << i));
+}
+
+static ssize_t msgbuf_read(int i, void *buf, size_t size, off_t off)
+{
+	/* in auto lock mode the status word follows the data */
+	uint8_t data[ACMSIM_MSGBUF_MAXSIZE + sizeof(uint32_t)];
+	const uint32_t status = ACMDRV_MSGBUF_STATUS_D_LOCKED;
+	size_t msize = msgbuf_size(i);
+	size_t fsize = msize;
+
+	if (msgbuf_auto_lock(i))
+		fsize += sizeof(status);
+
+	if (!msgbuf_running(i))
+		return -EIO;
+	if (acmdrv_buff_desc_type_read(msgbuf_desc(i)) !=
+	    ACMDRV_BUFF_DESC_BUFF_TYPE_RX &&
+	    !(msgbuf_auto_lock(i) && off >= (off_t)msize))
+		return -EIO;
+
+	if (off < 0)
+		return -EINVAL;
+	if (off >= (off_t)fsize)
+		return 0;
+	if (size > fsize - off)
+		size = fsize - off;
+
+	memcpy(data, ip.msgbuf[i], msize);
+	memcpy(data + msize, &status, sizeof(status));
+	memcpy(buf, data + off, size);
+
+	return size;
+}
+
+static ssize_t msgbuf_write(int i, const void *buf, size_t size, off_t off)
+{
+	if (!msgbuf_running(i))
+		return -EIO;
+	if (acmdrv_buff_desc_type_read(msgbuf_desc(i)) !=
+	    ACMDRV_BUFF_DESC_BUFF_TYPE_TX)
+		return -EFAULT;
+
+	if (off < 0)
+		return -EINVAL;
+	if (off >= msgbuf_size(i))
+		return -ENOSPC;
+	if (size > msgbuf_size(i) - off)
+		size = msgbuf_size(i) - off;
+	memcpy(ip.msgbuf[i] + off, buf, size);
+
+	return size;
+}
+
+static bool msgbuf_locked(int i)
+{
+	return ACMDRV_MSGBUF_LOCK_CTRL_ISSET(i, &ip.locked) ||
+	       msgbuf_auto_lock(i);
+}
+
+/**
+ * @brief read from a simulated file
+ *
+ * @return number of bytes read or negative error value
+ */
+ssize_t acmsim_device_read(struct acmsim_file *file, void *buf, size_t size,
+			   off_t off)
+{
+	ssize_t ret;
+	bool locked = false;
+
+	pthread_mutex_lock(&ip.lock);
+	if (file->attr) {
+		ret = attr_read(file->attr, buf, size, off);
+	} else {
+		ret = msgbuf_read(file->msgbuf, buf, size, off);
+		locked = msgbuf_locked(file->msgbuf);
+	}
+	pthread_mutex_unlock(&ip.lock);
+
+	if (file->attr)
+		acmsim_sysfs_delay(ret > 0 ? ret : 0);
+	else
+		acmsim_msgbuf_delay(locked ? -1 : file->msgbuf,
+				    ret > 0 ? ret : 0);
+
+	return ret;
+}
+
+/**
+ * @brief write to a simulated file
+ *
+ * @return number of bytes written or negative error value
+ */
+ssize_t acmsim_device_write(struct acmsim_file *file, const void *buf,
+			    size_t size, off_t off)
+{
+	ssize_t ret;
+	bool locked = false;
+
+	pthread_mutex_lock(&ip.lock);
+	if (file->attr) {
+		ret = attr_write(file->attr, buf, size, off);
+	} else {
+		ret = msgbuf_write(file->msgbuf, buf, size, off);
+		locked = msgbuf_locked(file->msgbuf);
+	}
+	pthread_mutex_unlock(&ip.lock);
+
+	if (file->attr)
+		acmsim_sysfs_delay(ret > 0 ? ret : 0);
+	else
+		acmsim_msgbuf_delay(locked ? -1 : file->msgbuf,
+				    ret > 0 ? ret : 0);
+
+	return ret;
+}
+
+/**
+ * @brief provide MAC addresses of the ACM switch ports
+ *
+ * Used if the host does not provide the respective network devices.
+ *
+ * @return 0 on success, -ENODEV if ifname is not an ACM port
+ */
+int acmsim_port_mac(const char *ifname, uint8_t *mac)
+{
+	static const char *const ports[] = { "sw0p2", "sw0p3" };
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(ports); ++i) {
+		if (strcmp(ifname, ports[i]))
+			continue;
+
+		/* locally administered unicast address */
+		mac[0] = 0x02;
+		mac[1] = 0x00;
+		mac[2] = 0x5e;
+		mac[3] = 0x00;
+		mac[4] = 0x00;
+		mac[5] = i + 1;
+		return 0;
+	}
+
+	return -ENODEV;
+}
@@ -0,0 +1,419 @@
+/**
+ * @file intercept.c
+ *
+ * C library interposition of the simulated file accesses
+ *
+ * Opening a simulated file opens /dev/null instead to reserve a real file
+ * descriptor, which is associated with the simulated file state. Subsequent
+ * I/O on such file descriptors is served by the simulation, all other calls
+ * are forwarded to the next definition of the respective symbol.
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+
+#include "acmsim.h"
+
+#define ACMSIM_MAX_FILES	1024
+
+#define EXPORT	__attribute__((visibility("default")))
+
+static struct acmsim_file *files[ACMSIM_MAX_FILES];
+static pthread_mutex_t files_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int (*real_open)(const char *path, int flags, ...);
+static int (*real_close)(int fd);
+static ssize_t (*real_read)(int fd, void *buf, size_t count);
+static ssize_t (*real_write)(int fd, const void *buf, size_t count);
+static ssize_t (*real_pread)(int fd, void *buf, size_t count, off_t off);
+static ssize_t (*real_pwrite)(int fd, const void *buf, size_t count,
+			      off_t off);
+static off_t (*real_lseek)(int fd, off_t off, int whence);
+static FILE *(*real_fopen)(const char *path, const char *mode);
+static int (*real_ioctl)(int fd, unsigned long request, ...);
+
+#define RESOLVE(_sym)						\
+	do {							\
+		if (!real_##_sym)				\
+			real_##_sym = dlsym(RTLD_NEXT, #_sym);	\
+	} while (0)
+
+static struct acmsim_file *get_file(int fd)
+{
+	struct acmsim_file *file;
+
+	if (fd < 0 || fd >= ACMSIM_MAX_FILES)
+		return NULL;
+
+	pthread_mutex_lock(&files_lock);
+	file = files[fd];
+	pthread_mutex_unlock(&files_lock);
+
+	return file;
+}
+
+/* returns file descriptor or -1 with errno set */
+static int sim_open(const char *path, int flags)
+{
+	struct acmsim_file *file;
+	int fd, ret;
+
+	file = malloc(sizeof(*file));
+	if (!file) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	ret = acmsim_device_open(path, flags, file);
+	if (ret) {
+		free(file);
+		errno = -ret;
+		return -1;
+	}
+
+	RESOLVE(open);
+	fd = real_open("/dev/null", O_RDWR | (flags & O_CLOEXEC));
+	if (fd < 0) {
+		free(file);
+		return -1;
+	}
+
+	if (fd >= ACMSIM_MAX_FILES) {
+		RESOLVE(close);
+		real_close(fd);
+		free(file);
+		errno = EMFILE;
+		return -1;
+	}
+
+	pthread_mutex_lock(&files_lock);
+	files[fd] = file;
+	pthread_mutex_unlock(&files_lock);
+
+	return fd;
+}
+
+static ssize_t sim_result(ssize_t ret)
+{
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return ret;
+}
+
+EXPORT int open(const char *path, int flags, ...)
+{
+	mode_t mode = 0;
+	va_list ap;
+
+	if (acmsim_path_is_simulated(path))
+		return sim_open(path, flags);
+
+	if (flags & (O_CREAT | O_TMPFILE)) {
+		va_start(ap, flags);
+		mode = va_arg(ap, mode_t);
+		va_end(ap);
+	}
+
+	RESOLVE(open);
+	return real_open(path, flags, mode);
+}
+
+EXPORT int open64(const char *path, int flags, ...)
+{
+	mode_t mode = 0;
+	va_list ap;
+
+	if (flags & (O_CREAT | O_TMPFILE)) {
+		va_start(ap, flags);
+		mode = va_arg(ap, mode_t);
+		va_end(ap);
+	}
+
+	return open(path, flags | O_LARGEFILE, mode);
+}
+
+EXPORT int __open_2(const char *path, int flags)
+{
+	return open(path, flags);
+}
+
+EXPORT int __open64_2(const char *path, int flags)
+{
+	return open64(path, flags);
+}
+
+EXPORT int openat(int dirfd, const char *path, int flags, ...)
+{
+	static int (*real_openat)(int dirfd, const char *path, int flags, ...);
+	mode_t mode = 0;
+	va_list ap;
+
+	if (path[0] == '/' && acmsim_path_is_simulated(path))
+		return sim_open(path, flags);
+
+	if (flags & (O_CREAT | O_TMPFILE)) {
+		va_start(ap, flags);
+		mode = va_arg(ap, mode_t);
+		va_end(ap);
+	}
+
+	RESOLVE(openat);
+	return real_openat(dirfd, path, flags, mode);
+}
+
+EXPORT int openat64(int dirfd, const char *path, int flags, ...)
+{
+	mode_t mode = 0;
+	va_list ap;
+
+	if (flags & (O_CREAT | O_TMPFILE)) {
+		va_start(ap, flags);
+		mode = va_arg(ap, mode_t);
+		va_end(ap);
+	}
+
+	return openat(dirfd, path, flags | O_LARGEFILE, mode);
+}
+
+EXPORT int close(int fd)
+{
+	struct acmsim_file *file = NULL;
+
+	if (fd >= 0 && fd < ACMSIM_MAX_FILES) {
+		pthread_mutex_lock(&files_lock);
+		file = files[fd];
+		files[fd] = NULL;
+		pthread_mutex_unlock(&files_lock);
+	}
+	free(file);
+
+	RESOLVE(close);
+	return real_close(fd);
+}
+
+EXPORT ssize_t read(int fd, void *buf, size_t count)
+{
+	struct acmsim_file *file = get_file(fd);
+	ssize_t ret;
+
+	if (!file) {
+		RESOLVE(read);
+		return real_read(fd, buf, count);
+	}
+
+	ret = acmsim_device_read(file, buf, count, file->pos);
+	if (ret > 0 && acmsim_device_is_seekable(file))
+		file->pos += ret;
+
+	return sim_result(ret);
+}
+
+EXPORT ssize_t __read_chk(int fd, void *buf, size_t count, size_t buflen)
+{
+	if (count > buflen)
+		abort();
+
+	return read(fd, buf, count);
+}
+
+EXPORT ssize_t write(int fd, const void *buf, size_t count)
+{
+	struct acmsim_file *file = get_file(fd);
+	ssize_t ret;
+
+	if (!file) {
+		RESOLVE(write);
+		return real_write(fd, buf, count);
+	}
+
+	ret = acmsim_device_write(file, buf, count, file->pos);
+	if (ret > 0 && acmsim_device_is_seekable(file))
+		file->pos += ret;
+
+	return sim_result(ret);
+}
+
+EXPORT ssize_t pread(int fd, void *buf, size_t count, off_t off)
+{
+	struct acmsim_file *file = get_file(fd);
+
+	if (!file) {
+		RESOLVE(pread);
+		return real_pread(fd, buf, count, off);
+	}
+
+	return sim_result(acmsim_device_read(file, buf, count, off));
+}
+
+EXPORT ssize_t pread64(int fd, void *buf, size_t count, off_t off)
+	__attribute__((alias("pread")));
+
+EXPORT ssize_t __pread_chk(int fd, void *buf, size_t count, off_t off,
+			   size_t buflen)
+{
+	if (count > buflen)
+		abort();
+
+	return pread(fd, buf, count, off);
+}
+
+EXPORT ssize_t __pread64_chk(int fd, void *buf, size_t count, off_t off,
+			     size_t buflen)
+	__attribute__((alias("__pread_chk")));
+
+EXPORT ssize_t pwrite(int fd, const void *buf, size_t count, off_t off)
+{
+	struct acmsim_file *file = get_file(fd);
+
+	if (!file) {
+		RESOLVE(pwrite);
+		return real_pwrite(fd, buf, count, off);
+	}
+
+	return sim_result(acmsim_device_write(file, buf, count, off));
+}
+
+EXPORT ssize_t pwrite64(int fd, const void *buf, size_t count, off_t off)
+	__attribute__((alias("pwrite")));
+
+EXPORT off_t lseek(int fd, off_t off, int whence)
+{
+	struct acmsim_file *file = get_file(fd);
+
+	if (!file) {
+		RESOLVE(lseek);
+		return real_lseek(fd, off, whence);
+	}
+
+	switch (whence) {
+	case SEEK_SET:
+		break;
+	case SEEK_CUR:
+		off += file->pos;
+		break;
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (off < 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* message buffer devices always stay at position 0 */
+	if (acmsim_device_is_seekable(file))
+		file->pos = off;
+
+	return off;
+}
+
+EXPORT off_t lseek64(int fd, off_t off, int whence)
+	__attribute__((alias("lseek")));
+
+static ssize_t cookie_read(void *cookie, char *buf, size_t size)
+{
+	return read((int)(intptr_t)cookie, buf, size);
+}
+
+static ssize_t cookie_write(void *cookie, const char *buf, size_t size)
+{
+	return write((int)(intptr_t)cookie, buf, size);
+}
+
+static int cookie_seek(void *cookie, off64_t *off, int whence)
+{
+	off_t ret = lseek((int)(intptr_t)cookie, *off, whence);
+
+	if (ret < 0)
+		return -1;
+
+	*off = ret;
+	return 0;
+}
+
+static int cookie_close(void *cookie)
+{
+	return close((int)(intptr_t)cookie);
+}
+
+EXPORT FILE *fopen(const char *path, const char *mode)
+{
+	static const cookie_io_functions_t io = {
+		.read = cookie_read,
+		.write = cookie_write,
+		.seek = cookie_seek,
+		.close = cookie_close,
+	};
+	int flags, fd;
+	FILE *stream;
+
+	if (!acmsim_path_is_simulated(path)) {
+		RESOLVE(fopen);
+		return real_fopen(path, mode);
+	}
+
+	if (mode[0] == 'r')
+		flags = strchr(mode, '+') ? O_RDWR : O_RDONLY;
+	else
+		flags = strchr(mode, '+') ? O_RDWR : O_WRONLY;
+
+	fd = sim_open(path, flags);
+	if (fd < 0)
+		return NULL;
+
+	stream = fopencookie((void *)(intptr_t)fd, mode, io);
+	if (!stream)
+		close(fd);
+
+	return stream;
+}
+
+EXPORT FILE *fopen64(const char *path, const char *mode)
+	__attribute__((alias("fopen")));
+
+/**
+ * @brief provide the MAC address of simulated switch ports
+ *
+ * Only SIOCGIFHWADDR requests failing for the missing ACM network devices
+ * are served by the simulation.
+ */
+EXPORT int ioctl(int fd, unsigned long request, ...)
+{
+	struct ifreq *ifr;
+	va_list ap;
+	void *arg;
+	int ret;
+
+	va_start(ap, request);
+	arg = va_arg(ap, void *);
+	va_end(ap);
+
+	RESOLVE(ioctl);
+	ret = real_ioctl(fd, request, arg);
+	if (ret == 0 || request != SIOCGIFHWADDR || errno != ENODEV)
+		return ret;
+
+	ifr = arg;
+	if (acmsim_port_mac(ifr->ifr_name,
+			    (uint8_t *)ifr->ifr_hwaddr.sa_data))
+		return ret;
+
+	return 0;
+}
@@ -0,0 +1,298 @@
+/**
+ * @file timing.c
+ *
+ * Timing model of the simulated ACM IP
+ *
+ * The model charges a fixed latency per access plus a per 32 bit word cost
+ * for the register transfers behind each SYSFS and message buffer access.
+ * Message buffer accesses additionally compete with the IP's scatter and
+ * prefetch DMA for the message buffer memory: the DMA chains configured for a
+ * bypass module are assumed to be executed back to back at the start of each
+ * schedule cycle, so an access within this busy window is delayed until its
+ * end. Locked message buffers are not touched by the DMA and thus not delayed.
+ *
+ * All parameters are taken from the environment (in nanoseconds):
+ *   ACMSIM_SYSFS_LATENCY_NS	fixed cost of a SYSFS access
+ *   ACMSIM_MSGBUF_LATENCY_NS	fixed cost of a message buffer access
+ *   ACMSIM_MMIO_WORD_NS	cost per transferred 32 bit word
+ *   ACMSIM_DMA_CMD_NS		DMA cost per executed command
+ *   ACMSIM_DMA_BYTE_NS		DMA cost per moved byte
+ *
+ * ACMSIM_STATS=1 prints access statistics when the process terminates.
+ *
+ * @copyright (C) 2019 TTTech. All rights reserved. Confidential proprietary.
+ *            Schoenbrunnerstrasse 7, A-1040 Wien, Austria. office@tttech.com
+ *
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "acmsim.h"
+
+#define NSEC_PER_SEC	1000000000ULL
+
+/* delays below are spun to avoid the scheduling latency of sleeping */
+#define SPIN_THRESHOLD_NS	50000ULL
+
+/**
+ * @brief timing parameters
+ */
+static struct {
+	uint64_t sysfs_ns;
+	uint64_t msgbuf_ns;
+	uint64_t word_ns;
+	uint64_t dma_cmd_ns;
+	uint64_t dma_byte_ns;
+	bool stats;
+} param = {
+	.sysfs_ns = 10000,
+	.msgbuf_ns = 1000,
+	.word_ns = 100,
+	.dma_cmd_ns = 40,
+	.dma_byte_ns = 8,
+};
+
+/**
+ * @brief DMA model per bypass module
+ */
+struct dma_model {
+	uint64_t busy_ns;	/**< DMA busy time at start of each cycle */
+	uint64_t cycle_ns;	/**< schedule cycle time */
+	uint64_t start_ns;	/**< schedule start time */
+	uint32_t msgbufs;	/**< message buffers accessed by the DMA */
+};
+
+static struct dma_model dma[ACMDRV_BYPASS_MODULES_COUNT];
+
+/**
+ * @brief access statistics
+ */
+static struct {
+	uint64_t sysfs_accesses;
+	uint64_t sysfs_bytes;
+	uint64_t msgbuf_accesses;
+	uint64_t msgbuf_bytes;
+	uint64_t dma_waits;
+	uint64_t delay_ns;
+} stats;
+
+static uint64_t getenv_ns(const char *name, uint64_t def)
+{
+	const char *value = getenv(name);
+	char *end;
+	unsigned long long ns;
+
+	if (!value || !*value)
+		return def;
+
+	ns = strtoull(value, &end, 0);
+	if (*end) {
+		fprintf(stderr, "acmsim: invalid value %s=%s ignored\n", name,
+			value);
+		return def;
+	}
+
+	return ns;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void delay_ns(uint64_t ns)
+{
+	struct timespec ts;
+	uint64_t end;
+
+	if (ns == 0)
+		return;
+
+	__atomic_add_fetch(&stats.delay_ns, ns, __ATOMIC_RELAXED);
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	end = ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec + ns;
+
+	if (ns >= SPIN_THRESHOLD_NS) {
+		ts.tv_sec = end / NSEC_PER_SEC;
+		ts.tv_nsec = end % NSEC_PER_SEC;
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts,
+				       NULL))
+			;
+		return;
+	}
+
+	do {
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+	} while (ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec < end);
+}
+
+static void print_stats(void)
+{
+	fprintf(stderr,
+		"acmsim: sysfs: %llu accesses, %llu bytes; msgbuf: %llu accesses, %llu bytes, %llu DMA waits; total delay %llu ns\n",
+		(unsigned long long)stats.sysfs_accesses,
+		(unsigned long long)stats.sysfs_bytes,
+		(unsigned long long)stats.msgbuf_accesses,
+		(unsigned long long)stats.msgbuf_bytes,
+		(unsigned long long)stats.dma_waits,
+		(unsigned long long)stats.delay_ns);
+}
+
+static void __attribute__((constructor)) acmsim_timing_init(void)
+{
+	param.sysfs_ns = getenv_ns("ACMSIM_SYSFS_LATENCY_NS", param.sysfs_ns);
+	param.msgbuf_ns = getenv_ns("ACMSIM_MSGBUF_LATENCY_NS",
+				    param.msgbuf_ns);
+	param.word_ns = getenv_ns("ACMSIM_MMIO_WORD_NS", param.word_ns);
+	param.dma_cmd_ns = getenv_ns("ACMSIM_DMA_CMD_NS", param.dma_cmd_ns);
+	param.dma_byte_ns = getenv_ns("ACMSIM_DMA_BYTE_NS", param.dma_byte_ns);
+	param.stats = getenv_ns("ACMSIM_STATS", 0) != 0;
+
+	if (param.stats)
+		atexit(print_stats);
+}
+
+static uint64_t transfer_ns(size_t size)
+{
+	return howmany(size, sizeof(uint32_t)) * param.word_ns;
+}
+
+/**
+ * @brief delay a SYSFS access of size bytes
+ */
+void acmsim_sysfs_delay(size_t size)
+{
+	__atomic_add_fetch(&stats.sysfs_accesses, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&stats.sysfs_bytes, size, __ATOMIC_RELAXED);
+
+	delay_ns(param.sysfs_ns + transfer_ns(size));
+}
+
+/* remaining DMA busy time for a message buffer access at now */
+static uint64_t dma_wait_ns(int msgbuf, uint64_t now)
+{
+	uint64_t wait = 0;
+	int i;
+
+	for (i = 0; i < ACMDRV_BYPASS_MODULES_COUNT; ++i) {
+		uint64_t busy, cycle, start, phase;
+
+		if (!(__atomic_load_n(&dma[i].msgbufs, __ATOMIC_RELAXED) &
+		      (1U << msgbuf)))
+			continue;
+
+		busy = __atomic_load_n(&dma[i].busy_ns, __ATOMIC_RELAXED);
+		cycle = __atomic_load_n(&dma[i].cycle_ns, __ATOMIC_RELAXED);
+		start = __atomic_load_n(&dma[i].start_ns, __ATOMIC_RELAXED);
+		if (cycle == 0 || now < start)
+			continue;
+
+		phase = (now - start) % cycle;
+		if (phase < busy && busy - phase > wait)
+			wait = busy - phase;
+	}
+
+	return wait;
+}
+
+/**
+ * @brief delay a message buffer access of size bytes
+ *
+ * @param msgbuf message buffer index, negative to skip the DMA contention
+ * @param size transferred bytes
+ */
+void acmsim_msgbuf_delay(int msgbuf, size_t size)
+{
+	uint64_t wait = 0;
+
+	__atomic_add_fetch(&stats.msgbuf_accesses, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&stats.msgbuf_bytes, size, __ATOMIC_RELAXED);
+
+	if (msgbuf >= 0)
+		wait = dma_wait_ns(msgbuf, now_ns());
+	if (wait)
+		__atomic_add_fetch(&stats.dma_waits, 1, __ATOMIC_RELAXED);
+
+	delay_ns(wait + param.msgbuf_ns + transfer_ns(size));
+}
+
+/**
+ * @brief derive the per cycle DMA load of a bypass module from its commands
+ *
+ * Only scatter and prefetch DMA access the message buffer memory, the gather
+ * DMA works on data already fetched.
+ */
+void acmsim_dma_update(int module,
+		       const struct acmdrv_bypass_dma_command *scatter,
+		       const struct acmdrv_bypass_dma_command *prefetch)
+{
+	uint64_t busy = 0;
+	uint32_t msgbufs = 0;
+	unsigned int i;
+
+	for (i = 0; i < ACMDRV_BYPASS_SCATTER_DMA_CMD_COUNT; ++i) {
+		uint32_t cmd = scatter[i].cmd;
+
+		if (RVAL(ACMDRV_BYPASS_DMA_CMD_S_COMMAND_BIT, cmd) ==
+		    ACMDRV_BYPASS_DMA_CMD_S_COMMAND_INVALID)
+			continue;
+
+		busy += param.dma_cmd_ns + param.dma_byte_ns *
+			RVAL(ACMDRV_BYPASS_DMA_CMD_S_LENGTH_BIT, cmd);
+		msgbufs |= 1U << RVAL(ACMDRV_BYPASS_DMA_CMD_S_RX_MSGBUF_ID_BIT,
+				      cmd);
+	}
+
+	for (i = 0; i < ACMDRV_BYPASS_PREFETCH_DMA_CMD_COUNT; ++i) {
+		uint32_t cmd = prefetch[i].cmd;
+
+		switch (RVAL(ACMDRV_BYPASS_DMA_CMD_P_COMMAND_BIT, cmd)) {
+		case ACMDRV_BYPASS_DMA_CMD_P_COMMAND_MOV_MSG_BUFF:
+			busy += param.dma_byte_ns *
+				RVAL(ACMDRV_BYPASS_DMA_CMD_P_LENGTH_BIT, cmd);
+			msgbufs |= 1U <<
+				RVAL(ACMDRV_BYPASS_DMA_CMD_P_MSGBUF_ID_BIT, cmd);
+			/* fall through */
+		case ACMDRV_BYPASS_DMA_CMD_P_COMMAND_NOP:
+		case ACMDRV_BYPASS_DMA_CMD_P_COMMAND_LOCK_MSG_BUFF:
+			busy += param.dma_cmd_ns;
+			break;
+		default:
+			break;
+		}
+	}
+
+	__atomic_store_n(&dma[module].busy_ns, busy, __ATOMIC_RELAXED);
+	__atomic_store_n(&dma[module].msgbufs, msgbufs, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief set the schedule the DMA load of a bypass module is aligned to
+ *
+ * @param module bypass module (i.e. scheduler) index
+ * @param cycle_ns schedule cycle time, 0 if the scheduler is stopped
+ * @param start schedule start time
+ */
+void acmsim_schedule_update(int module, uint64_t cycle_ns,
+			    const struct acmdrv_timespec64 *start)
+{
+	uint64_t start_ns = start->tv_sec * NSEC_PER_SEC + start->tv_nsec;
+
+	__atomic_store_n(&dma[module].start_ns, start_ns, __ATOMIC_RELAXED);
+	__atomic_store_n(&dma[module].cycle_ns, cycle_ns, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief stop all DMA activity
+ */
+void acmsim_dma_reset(void)
+{
+	memset(dma, 0, sizeof(dma));
+}
@@ -15,6 +15,7 @@ static const struct option arg_options[] = {
 	{ "help", 		no_argument, 		NULL, 'h' },
 	{ "cycles",		no_argument, 		NULL, 0 },
 	{ "missed",		no_argument, 		NULL, 0 },
+	{ "histogram",		no_argument, 		NULL, 0 },
 	{ "reconnect",		required_argument, 	NULL, 0 },
 	{ "diagnostics",	required_argument, 	NULL, 0 },
 	{ NULL, 		no_argument, 		NULL, 0 }
@@ -30,6 +31,7 @@ static void print_usage(char *name)
 	printf("\t-p / --port <portno> connect at port \"portno\" (default 6161).\n");
 	printf("\t     --cycles additionally dump cycle data\n");
 	printf("\t     --missed count missed intervals\n");
+	printf("\t     --histogram additionally dump latency percentiles of each interval\n");
 	printf("\t     --reconnect <millisecs> reconnect automatically after <millisecs>, 0 (default) means no reconnect\n");
 	printf("\t     --diagnostics <offset>[,<mult>[,<count>]] display diagnostic data read at\n");
 	printf("\t                                              <offset> with <mult> multiple of interval <count times>\n");
@@ -90,6 +92,8 @@ static void print_call_args(char *name, struct argv_param *param)
 	printf(" trying to connect %s at port %d", param->host, param->port);
 	if (param->missed)
 		printf(" requesting missed frame count");
+	if (param->histogram)
+		printf(" requesting latency percentiles");
 
 	if (param->reconnect)
 		printf(" trying reconnect each %ums", param->reconnect);
@@ -104,6 +108,7 @@ const struct argv_param default_args = {
 	.host = "127.0.0.1",	/* ... on localhost */
 	.cycles = false,	/* do not dump cycle data */
 	.missed = false,	/* do not dump missed frame counter */
+	.histogram = false,	/* do not dump latency percentiles */
 	.reconnect = 0,		/* do not reconnect automatically */
 	.diagnostics = { false, 0, 1, 1 }
 };
@@ -149,6 +154,9 @@ void parse_args(int argc, char *argv[], struct argv_param *args) {
 			if (strcmp( "missed", arg_options[index].name ) == 0) {
 				args->missed = true;
 			}
+			if (strcmp("histogram", arg_options[index].name) == 0) {
+				args->histogram = true;
+			}
 			if (strcmp("reconnect", arg_options[index].name) == 0) {
 				args->reconnect = atoi(optarg);
 			}
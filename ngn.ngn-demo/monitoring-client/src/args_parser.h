@@ -22,6 +22,7 @@ struct argv_param {
 	char host[64]; /* optional argument */
 	bool cycles;
 	bool missed;
+	bool histogram;
 	unsigned int reconnect; /* timeout for reconnect retry in ms */
 	unsigned int diag_offs;
 	struct diagnostics_param diagnostics;
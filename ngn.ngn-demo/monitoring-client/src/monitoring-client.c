@@ -219,6 +219,22 @@ retry:
 			free(dump_data);
 		}
 
+		if (args.histogram) {
+			/* restart histograms to get percentiles per interval */
+			const char *dump_hist_cmd = "DUMPHIST RESET\n";
+
+			ret = write_cmd(fd, dump_hist_cmd);
+			if (ret)
+				break;
+			ret = receive_response(fd, &dump_data);
+			if (ret)
+				goto close;
+			fprintf(stdout, "%s", dump_data);
+			fflush(stdout);
+
+			free(dump_data);
+		}
+
 		if (args.dump_counter >= 0)
 			args.dump_counter--;
 		if (args.dump_counter == 0)